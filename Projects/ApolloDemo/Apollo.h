@@ -8,6 +8,7 @@ extern "C"{
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <clib/exec_protos.h>
 #include <exec/types.h>
@@ -17,6 +18,8 @@ extern "C"{
 #include "ApolloWaitVBL.h"
 #include "ApolloEndianSwap8.h"
 #include "ApolloCPUDelay.h"
+#include "ApolloDebugLog.h"
+#include "ApolloEnvelope.h"
 
 #define AIFF_OFFSET				128
 #define DDS_OFFSET				128
@@ -117,6 +120,7 @@ extern void ApolloShow(UBYTE *buffer, ULONG buffer_lenght, UWORD gfx_mode, UWORD
 extern void ApolloStop(UWORD channel);
 extern void ApolloStart(UWORD channel);
 extern void ApolloFadeOut(UWORD channel, UWORD volume_start, UWORD volume_end);
+extern bool ApolloFadeDone(UWORD channel);
 extern void ApolloVolume(UWORD channel, UWORD volume_left, UWORD volume_right);
 
 extern void ApolloShowFile(const UBYTE *filename, UBYTE **buffer, UBYTE *buffer_lenght, UWORD offset, UWORD gfx_mode, UWORD gfx_modulo, bool endianswap);
@@ -0,0 +1,23 @@
+//*********************************************************
+//* Apollo IMA-ADPCM Decode (one channel of a block)      *
+//*********************************************************
+//* a0 = s = block channel: predictor.w, index.b, pad.b,  *
+//*          then two 4-bit codes a byte, low first        *
+//* a1 = d = destination, every other WORD (stereo)       *
+//* d0 = n = samples to decode                            *
+//*********************************************************
+
+#ifdef __cplusplus
+extern "C"{
+#endif 
+
+#include "stdint.h"
+#include "stdlib.h"
+#include <exec/types.h>
+#include "ApolloRegParam.h"
+
+extern void ApolloADPCMDecode(_A0(const UBYTE *s), _A1(WORD *d), _D0(ULONG n));
+
+#ifdef __cplusplus
+}
+#endif
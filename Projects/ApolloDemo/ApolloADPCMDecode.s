@@ -0,0 +1,120 @@
+*********************************************************
+* Apollo IMA-ADPCM Decode (one channel of a block)		*
+*********************************************************
+* a0 = s = block channel: predictor.w, index.b, pad.b,	*
+*          then two 4-bit codes a byte, low first		*
+* a1 = d = destination, every other WORD (stereo)		*
+* d0 = n = samples to decode							*
+*********************************************************
+* d1 = predictor, d2 = step index, d3 = code byte		*
+* d4 = step, d5 = difference, d6 = code, d7 = scratch	*
+* a2 = step table, a3 = index table						*
+*********************************************************
+
+	XDEF _ApolloADPCMDecode
+	CNOP 0,4
+
+*********************************************************
+* DECODE code register: one sample into (a1)+4			*
+*********************************************************
+DECODE MACRO
+	move.l (a2,d2.w*4),d4								* d4 = step for the index
+	move.l d4,d5
+	lsr.l #3,d5											* d5 = step/8
+	btst #2,\1
+	beq.s .b1\@
+	add.l d4,d5											* + step
+.b1\@:
+	btst #1,\1
+	beq.s .b0\@
+	move.l d4,d7
+	lsr.l #1,d7
+	add.l d7,d5											* + step/2
+.b0\@:
+	btst #0,\1
+	beq.s .sign\@
+	move.l d4,d7
+	lsr.l #2,d7
+	add.l d7,d5											* + step/4
+.sign\@:
+	btst #3,\1
+	beq.s .add\@
+	sub.l d5,d1											* negative code
+	cmp.l #-32768,d1
+	bge.s .store\@
+	move.l #-32768,d1
+	bra.s .store\@
+.add\@:
+	add.l d5,d1											* positive code
+	cmp.l #32767,d1
+	ble.s .store\@
+	move.l #32767,d1
+.store\@:
+	move.w d1,(a1)										* store the sample
+	addq.l #4,a1										* skip the other channel
+	add.w (a3,\1.w*2),d2								* next step index, kept 0-88
+	bpl.s .low\@
+	moveq #0,d2
+.low\@:
+	cmp.w #88,d2
+	ble.s .done\@
+	moveq #88,d2
+.done\@:
+	ENDM
+
+_ApolloADPCMDecode:
+	movem.l d2-d7/a2-a3,-(sp)							* Save registers to Stack
+	lea StepTable(pc),a2
+	lea IndexTable(pc),a3
+	move.w (a0)+,d1										* d1 = predictor from the header
+	ext.l d1
+	moveq #0,d2
+	move.b (a0)+,d2										* d2 = step index from the header
+	cmp.w #88,d2
+	bls.s .Index
+	moveq #88,d2										* a bad header stays in the table
+.Index:
+	addq.l #1,a0										* skip the pad byte
+	move.l d0,-(sp)										* keep n for the odd sample
+	lsr.l #1,d0											* d0 = code bytes
+	beq .Odd
+
+.Loop:
+	moveq #0,d3
+	move.b (a0)+,d3										* d3 = two codes
+	moveq #15,d6
+	and.w d3,d6											* d6 = low code first
+	DECODE d6
+	lsr.w #4,d3											* d3 = high code
+	DECODE d3
+	subq.l #1,d0
+	bne .Loop
+
+.Odd:
+	move.l (sp)+,d0
+	btst #0,d0
+	beq.s .Exit
+	moveq #15,d6
+	and.b (a0),d6										* last sample, low code
+	DECODE d6
+
+.Exit:
+	movem.l (sp)+,d2-d7/a2-a3							* Restore all registers from Stack
+	rts
+
+	CNOP 0,4
+
+StepTable:
+	dc.l 7,8,9,10,11,12,13,14,16,17
+	dc.l 19,21,23,25,28,31,34,37,41,45
+	dc.l 50,55,60,66,73,80,88,97,107,118
+	dc.l 130,143,157,173,190,209,230,253,279,307
+	dc.l 337,371,408,449,494,544,598,658,724,796
+	dc.l 876,963,1060,1166,1282,1411,1552,1707,1878,2066
+	dc.l 2272,2499,2749,3024,3327,3660,4026,4428,4871,5358
+	dc.l 5894,6484,7132,7845,8630,9493,10442,11487,12635,13899
+	dc.l 15289,16818,18500,20350,22385,24623,27086,29794,32767
+
+IndexTable:
+	dc.w -1,-1,-1,-1,2,4,6,8
+	dc.w -1,-1,-1,-1,2,4,6,8
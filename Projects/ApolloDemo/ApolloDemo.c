@@ -5,6 +5,9 @@
 #include "stdlib.h"
 #include "stdbool.h"
 #include "../_apollo/Apollo.h"  
+#include "../_apollo/ApolloVoice.h"
+#include "../_apollo/ApolloStream.h"
+#include "../_apollo/ApolloSample.h"
 
 #include "clib/exec_protos.h"
 
@@ -45,6 +48,7 @@ int main(void)
     ApolloDebugInit();         
 
     #ifdef APOLLODEBUG
+    ApolloLogSetLevel(APOLLOLOG_TRACE);
     ApolloDebugPutStr("\n\n\nWelcome to ApolloDemo Serial Debug Output\n");
     #endif
 
@@ -57,18 +61,25 @@ int main(void)
     ApolloShow(Screen_Video_Buffer, Screen_Video_Lenght, SAGA_MODE, SAGA_MODULO);
     
     // Audio Buffers
-    UBYTE   *BackGround_Audio_Buffer, *SoundEffect_Buffer1, *SoundEffect_Buffer2, *SoundEffect_Buffer3, *SoundEffect_Buffer4;
-    ULONG   BackGround_Audio_Lenght, SoundEffect_Length1, SoundEffect_Length2, SoundEffect_Length3, SoundEffect_Length4;
+    ApolloSample        SoundEffect1, SoundEffect2, SoundEffect3, SoundEffect4;
+    ApolloSampleFormat  BackGround_Audio_Format;
 
-    // Load and Play Background Music in a Loop
-    ApolloLoad("Data/Intro.aiff", &BackGround_Audio_Buffer, &BackGround_Audio_Lenght, AIFF_OFFSET, false);
-    ApolloPlay(BackGround_Audio_Buffer, BackGround_Audio_Lenght, 0, 0x7f, 0x7f, true);
+    // Stream Background Music in a Loop, only the stream buffers are in memory
+    ULONG   BackGround_Audio_Offset = ApolloSampleInfo("Data/Intro.aiff", &BackGround_Audio_Format) ? BackGround_Audio_Format.offset : AIFF_OFFSET;
+    ApolloStream *BackGround_Audio_Stream = ApolloStreamOpen("Data/Intro.aiff", BackGround_Audio_Offset, 0, true);
+    ApolloStreamPlay(BackGround_Audio_Stream, 0x7f, 0x7f);
 
     // Load Music Clips into Buffers
-    ApolloLoad("Data/SoundEffect1.aiff", &SoundEffect_Buffer1, &SoundEffect_Length1, AIFF_OFFSET, false);
-   	ApolloLoad("Data/SoundEffect2.aiff", &SoundEffect_Buffer2, &SoundEffect_Length2, AIFF_OFFSET, false);
-    ApolloLoad("Data/SoundEffect3.aiff", &SoundEffect_Buffer3, &SoundEffect_Length3, AIFF_OFFSET, false);
-   	ApolloLoad("Data/SoundEffect4.aiff", &SoundEffect_Buffer4, &SoundEffect_Length4, AIFF_OFFSET, false);
+    // Converted to 16-bit stereo 44.1 kHz on load, or read from the .snd or .adp ApolloSoundConvert made
+    ApolloSampleLoad("Data/SoundEffect1.aiff", &SoundEffect1, false);
+   	ApolloSampleLoad("Data/SoundEffect2.aiff", &SoundEffect2, false);
+    ApolloSampleLoad("Data/SoundEffect3.aiff", &SoundEffect3, false);
+   	ApolloSampleLoad("Data/SoundEffect4.aiff", &SoundEffect4, false);
+
+    // Sound effects on channels 1-15 by priority, channel 1 mixes more in software
+    ApolloVoiceInit(1, APOLLOVOICE_CHANNELS - 1, true);
+    ApolloVoiceHandle SoundEffect_Voice1 = APOLLOVOICE_NONE, SoundEffect_Voice2 = APOLLOVOICE_NONE;
+    ApolloVoiceHandle SoundEffect_Voice3 = APOLLOVOICE_NONE, SoundEffect_Voice4 = APOLLOVOICE_NONE;
 
     // Background Variables
     ULONG   BG_Lenght = 0; 
@@ -81,6 +92,7 @@ int main(void)
     ApolloJoypadState   JoypadState = {0};
 
     ApolloCPUDelay(5000);
+    // Fades while the map loads, the stream is closed once it is silent
     ApolloFadeOut(0, 0x7f, 0x00);
 
     // Load and Show Background Map
@@ -91,15 +103,23 @@ int main(void)
     while (MouseState.Button_Left == false)
     {
         ApolloWaitVBL();
+        ApolloVoiceUpdate();
+
+        if (BackGround_Audio_Stream && ApolloFadeDone(0))
+        {
+            ApolloStreamClose(BackGround_Audio_Stream);
+            BackGround_Audio_Stream = NULL;
+        }
 
         ApolloKeyboard(&KeyboardState);
         ApolloMouse(&MouseState);
         ApolloJoypad(&JoypadState);
         
-	    if (JoypadState.Joypad_A) ApolloPlay(SoundEffect_Buffer1, SoundEffect_Length1, 1, 0x7F, 0x7F, false);
-	    if (JoypadState.Joypad_B) ApolloPlay(SoundEffect_Buffer2, SoundEffect_Length2, 2, 0x7F, 0x7F, false);
-        if (JoypadState.Joypad_X) ApolloPlay(SoundEffect_Buffer3, SoundEffect_Length3, 3, 0x7F, 0x7F, false);
-	    if (JoypadState.Joypad_Y) ApolloPlay(SoundEffect_Buffer4, SoundEffect_Length4, 4, 0x7F, 0x7F, false);
+        // a held button plays its effect again once the last one has finished
+	    if (JoypadState.Joypad_A && !ApolloVoiceIsPlaying(SoundEffect_Voice1)) SoundEffect_Voice1 = ApolloVoicePlay((const uint8_t*)SoundEffect1.samples, SoundEffect1.length, 1, 0x7F, 0x7F, false);
+	    if (JoypadState.Joypad_B && !ApolloVoiceIsPlaying(SoundEffect_Voice2)) SoundEffect_Voice2 = ApolloVoicePlay((const uint8_t*)SoundEffect2.samples, SoundEffect2.length, 1, 0x7F, 0x7F, false);
+        if (JoypadState.Joypad_X && !ApolloVoiceIsPlaying(SoundEffect_Voice3)) SoundEffect_Voice3 = ApolloVoicePlay((const uint8_t*)SoundEffect3.samples, SoundEffect3.length, 1, 0x7F, 0x7F, false);
+	    if (JoypadState.Joypad_Y && !ApolloVoiceIsPlaying(SoundEffect_Voice4)) SoundEffect_Voice4 = ApolloVoicePlay((const uint8_t*)SoundEffect4.samples, SoundEffect4.length, 2, 0x7F, 0x7F, false);
 
         if (JoypadState.Joypad_X_Delta !=0) BG_X_Delta = JoypadState.Joypad_X_Delta; else BG_X_Delta = MouseState.MouseX_Value_Delta>>2;
         if (JoypadState.Joypad_Y_Delta !=0) BG_Y_Delta = JoypadState.Joypad_Y_Delta; else BG_Y_Delta = MouseState.MouseY_Value_Delta>>2;
@@ -120,12 +140,18 @@ int main(void)
         #ifdef APOLLODEBUG
         if (BG_X_Delta > 0 || BG_Y_Delta > 0)
         {
-          sprintf(ApolloDebugText,"BG_X_Position: %6d | BG_Y_Position: %6d\n", BG_X_Position, BG_Y_Position);
-		  ApolloDebugPutStr(ApolloDebugText);
+          ApolloLogPrintf(APOLLOLOG_TRACE, "BG_X_Position: %6d | BG_Y_Position: %6d\n", BG_X_Position, BG_Y_Position);
         }
         #endif
     }
 
+    ApolloVoiceClose();
+    ApolloStreamClose(BackGround_Audio_Stream);
+    ApolloSampleFree(&SoundEffect1);
+    ApolloSampleFree(&SoundEffect2);
+    ApolloSampleFree(&SoundEffect3);
+    ApolloSampleFree(&SoundEffect4);
+
     // Load and Show Stop Screen
     ApolloLoad("Data/Stop.16.dds", &Screen_Video_Buffer, &Screen_Video_Lenght, DDS_OFFSET, true);
     ApolloShow(Screen_Video_Buffer, Screen_Video_Lenght, SAGA_MODE, SAGA_MODULO);
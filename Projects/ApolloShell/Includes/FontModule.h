@@ -15,10 +15,24 @@
 
 //-----------------------------------------------------------------------------
 
+#include "stdint.h"
+#include "stdbool.h"
+#include "Hardware.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define FONTMODULE_CHAR_SIZE    ( 8 )       //!< Characters are 8x8
+#define FONTMODULE_NO_PAPER     ( -1 )      //!< Only the ink pixels are drawn
+#define FONTMODULE_COLOUR_CODE  ( 0x99 )    //!< In a string, the next byte is the ink
+
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
 
+extern void FontModule_Init( void );
+extern void FontModule_DrawText( _A0(uint8_t* pDest), _A1(const char* pText), _D0(uint32_t ulPitch), _D1(uint32_t ulInk), _D2(int32_t lPaper) );
 extern void FontModule_DisplayString( void );
 extern void FontModule_DisplayChar( void );
 extern void FontModule_DisplayHex( void );
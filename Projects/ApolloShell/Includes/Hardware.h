@@ -167,6 +167,24 @@
 
 #endif
 
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/**-----------------------------------------------------------------------------
+    @brief      VBL server counters, Hardware_GetFrameCounter
+    @ingroup 	MainShell
+ ---------------------------------------------------------------------------- */
+typedef enum
+{
+    eFrameCounter_Presented = 0,    //!< 0 Screens put on display
+    eFrameCounter_Dropped,          //!< 1 Fields with no new screen, the last one repeated
+    eFrameCounter_Late,             //!< 2 Screens shown after the field they were due, queued screens are due after the one before
+    eFrameCounter_VBL,              //!< 3 Vertical blanks since Hardware_Init
+    eFrameCounter_Total
+
+} eFrameCounter_t;
+
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
@@ -190,12 +208,17 @@ void Hardware_CheckKeyUp( void );
 void Hardware_CopyBackToScreen( void );
 void Hardware_CopyBackScreenMap( void );
 void Hardware_CopyBack2ToBack1( void );	
+void Hardware_CopyBack2ToBack1Rows( _D0(uint32_t ulFirstRow), _D1(uint32_t ulRows) );
+void Hardware_SwapBackScreens( void );
 void Hardware_SetBackscreenBuffers( void );
 uint32_t Hardware_SwapLong( _D0(uint32_t SwapLong) );
 uint32_t Hardware_GetScreenWidth( void );
 uint32_t Hardware_GetScreenHeight( void );
 uint32_t Hardware_GetScreenmode( void );
 uint32_t Hardware_GetDebug( _D0(uint32_t Debug) );
+uint32_t Hardware_GetFrameCounter( _D0(uint32_t Counter) );
+void Hardware_SetVBLHook( _A0(void (*pHook)( void )) );		// in the interrupt, scratch and fp0-fp1/FPCR/FPSR saved
+void Hardware_ReadCounters( _A0(uint32_t* pCounters) );
 void Hardware_SetMapX( _D0(uint32_t mapX) );
 void Hardware_SetMapY( _D0(uint32_t mapX) );
 uint32_t Hardware_GetMapX( void );
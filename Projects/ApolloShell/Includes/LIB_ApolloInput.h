@@ -51,6 +51,18 @@
 #define APOLLOMOUSE_RIGHTDOWN			0x0080
 #define APOLLOMOUSE_MIDDLEDOWN			0x0100
 
+#define APOLLOKEY_KEYS					128				// raw key codes, a bit each
+#define APOLLOKEY_LONGS					(APOLLOKEY_KEYS / 32)
+#define APOLLOKEY_NONE					127				// Current_Key when no key went down
+#define APOLLOKEY_REPEAT_DELAY			25				// ticks held before a key repeats
+#define APOLLOKEY_REPEAT_RATE			4				// ticks between repeats
+
+#define APOLLOKEY_BIT(Key)				(1UL << ((Key) & 31))
+#define ApolloKeyDown(State, Key)		(((State)->Keys_Down[(Key) >> 5] & APOLLOKEY_BIT(Key)) != 0)		// held now
+#define ApolloKeyPressed(State, Key)	(((State)->Keys_Pressed[(Key) >> 5] & APOLLOKEY_BIT(Key)) != 0)		// went down this tick
+#define ApolloKeyReleased(State, Key)	(((State)->Keys_Released[(Key) >> 5] & APOLLOKEY_BIT(Key)) != 0)	// came up this tick
+#define ApolloKeyRepeat(State, Key)		(((State)->Keys_Repeat[(Key) >> 5] & APOLLOKEY_BIT(Key)) != 0)		// went down or repeated this tick
+
 
 //-----------------------------------------------------------------------------
 // Typedefs
@@ -59,8 +71,18 @@
 
 typedef struct
 {
-	uint8_t Current_Key;
+	uint8_t Current_Key;						// First key down this tick, or APOLLOKEY_NONE
 	uint8_t Previous_Key;
+	uint8_t Last_Raw;							// Register as ApolloKeyboard last read it
+	uint8_t Repeat_Delay;						// Ticks, 0 for no repeat
+	uint8_t Repeat_Rate;
+
+	uint32_t Keys_Down[APOLLOKEY_LONGS];		// Bit per raw key code, see ApolloKeyDown
+	uint32_t Keys_Pressed[APOLLOKEY_LONGS];
+	uint32_t Keys_Released[APOLLOKEY_LONGS];
+	uint32_t Keys_Repeat[APOLLOKEY_LONGS];
+	uint32_t Keys_Was[APOLLOKEY_LONGS];			// Down at the start of the tick
+	uint8_t  Keys_Held[APOLLOKEY_KEYS];			// Ticks each key has been down, for repeat
 } ApolloKeyBoardState;
 
 typedef struct
@@ -124,6 +146,13 @@ void ApolloMouse(ApolloMouseState *MouseState);
 void ApolloKeyboard(ApolloKeyBoardState *KeyboardState);
 void ApolloJoypad(ApolloJoypadState *JoypadState);
 
+void ApolloKeyboardRepeat(ApolloKeyBoardState *KeyboardState, uint8_t Delay, uint8_t Rate);
+void ApolloKeyboardBegin(ApolloKeyBoardState *KeyboardState);
+void ApolloKeyboardKey(ApolloKeyBoardState *KeyboardState, uint8_t Key, bool Down);
+void ApolloKeyboardEnd(ApolloKeyBoardState *KeyboardState);
+void ApolloMouseApply(ApolloMouseState *MouseState, int16_t MouseX_Delta, int16_t MouseY_Delta, bool Left, bool Right, bool Middle);
+void ApolloJoypadDecode(ApolloJoypadState *JoypadState, uint16_t Joypad_Value);
+
 //-----------------------------------------------------------------------------
 // End of file LIB_ApolloInput.h
 //-----------------------------------------------------------------------------
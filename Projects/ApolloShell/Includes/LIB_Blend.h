@@ -0,0 +1,52 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Blend.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Translucency for the 8 bit screen, 256 by 256 blend tables
+	@date		2025-10-26
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_BLEND_H_
+#define _LIB_BLEND_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define BLEND_TABLE_SIZE    ( 256 * 256 )   //!< Indexed ( sprite << 8 ) | screen
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Blend tables
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eBlend_Mix = 0,                 //!< Half of each, smoke and glass
+    eBlend_Darken,                  //!< Screen times sprite colour, shadows
+    eBlend_Add,                     //!< Sum clamped to white, fire and glows
+    eBlend_Total
+
+} eBlend_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void            LIB_Blend_Build( void );
+const uint8_t*  LIB_Blend_GetTable( eBlend_t eBlend );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_BLEND_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Blend.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Collision.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Uniform grid broadphase and box and pixel collision tests
+	@date		2025-10-31
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_COLLISION_H_
+#define _LIB_COLLISION_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define COLLISION_WORLD_WIDTH   ( 1920 )
+#define COLLISION_WORLD_HEIGHT  ( 900 )
+#define COLLISION_CELL_SHIFT    ( 6 )           //!< 64 pixel cells
+#define COLLISION_CELL_SIZE     ( 1 << COLLISION_CELL_SHIFT )
+#define COLLISION_GRID_WIDTH    ( ( COLLISION_WORLD_WIDTH + COLLISION_CELL_SIZE - 1 ) >> COLLISION_CELL_SHIFT )
+#define COLLISION_GRID_HEIGHT   ( ( COLLISION_WORLD_HEIGHT + COLLISION_CELL_SIZE - 1 ) >> COLLISION_CELL_SHIFT )
+#define COLLISION_MAX_BODIES    ( 2048 )        //!< Bodies, the sprite manager has the first TOTAL_SPRITES
+#define COLLISION_MAX_ENTRIES   ( 8192 )        //!< Cells covered by all the bodies together
+#define COLLISION_MASKS         ( 64 )          //!< Sprite images with a pixel mask built
+#define COLLISION_MASK_LONGS    ( 32768 )       //!< Longs of mask shared by them, 128K
+#define COLLISION_NO_IMAGE      ( -1 )          //!< CollisionBox_t lBank, box test only
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Where a body is, and the sprite image for the pixel test
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    int32_t         x;                  //!< Box in the world
+    int32_t         y;
+    int32_t         w;
+    int32_t         h;
+    int32_t         lImageX;            //!< Top left of the sprite image in the world
+    int32_t         lImageY;
+    int32_t         lBank;              //!< Sprite bank, COLLISION_NO_IMAGE for none
+    uint32_t        ulFrame;            //!< Sprite number in the bank
+
+} CollisionBox_t, *pCollisionBox_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Two bodies touching, uwA the lower
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint16_t        uwA;
+    uint16_t        uwB;
+
+} CollisionPair_t, *pCollisionPair_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Counts of the last LIB_Collision_FindPairs
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        ulBodies;           //!< In the grid
+    uint32_t        ulEntries;          //!< Cells covered
+    uint32_t        ulRebinned;         //!< Bodies linked into new cells since LIB_Collision_GetStats
+    uint32_t        ulCandidates;       //!< Pairs sharing a cell, each once
+    uint32_t        ulBoxHits;          //!< Of those, boxes overlapping
+    uint32_t        ulPixelHits;        //!< Of those, pixels overlapping, when asked for
+    uint32_t        ulPairs;            //!< Returned
+
+} CollisionStats_t, *pCollisionStats_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void        LIB_Collision_Init( void );
+void        LIB_Collision_Clear( void );
+bool        LIB_Collision_Set( uint32_t ulBody, const CollisionBox_t* psBox );
+void        LIB_Collision_Remove( uint32_t ulBody );
+bool        LIB_Collision_Test( uint32_t ulA, uint32_t ulB, bool bPixels );
+uint32_t    LIB_Collision_FindPairs( CollisionPair_t* psPairs, uint32_t ulMax, bool bPixels );
+void        LIB_Collision_GetStats( CollisionStats_t* psStats );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_COLLISION_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Collision.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,41 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Decorations.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Terrain decoration placement, stamped in at generation time
+	@date		2025-10-24
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_DECORATIONS_H_
+#define _LIB_DECORATIONS_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define DECORATION_DARTS        ( 640 )     //!< Candidate positions tried per map
+#define DECORATION_MAX          ( 48 )      //!< Most decorations placed per map
+#define DECORATION_SPACING      ( 144 )     //!< Poisson disc radius, between centres
+#define DECORATION_MAX_WIDTH    ( 320 )     //!< Largest sprite used
+#define DECORATION_MAX_HEIGHT   ( 416 )
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+uint32_t    LIB_Decorations_Init( uint32_t ulTerrainSet );
+void        LIB_Decorations_Begin( uint32_t ulSeed, TerrainMask_t* psMask, uint8_t* pBuffer );
+bool        LIB_Decorations_Place( uint32_t ulDarts );
+uint32_t    LIB_Decorations_GetCount( void );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_DECORATIONS_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Decorations.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Hud.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		HUD widget tree, only changed widgets are redrawn per screen
+	@date		2025-10-27
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_HUD_H_
+#define _LIB_HUD_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define HUD_MAX_WIDGETS     ( 32 )
+#define HUD_BUFFERS         ( 3 )       //!< Screens drawn in turn, triple buffered
+#define HUD_LABEL_LENGTH    ( 31 )
+#define HUD_NO_PARENT       ( -1 )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Widget kinds
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eHudWidget_Panel = 0,           //!< Sprite that covers its area, a background
+    eHudWidget_Bar,                 //!< Part of a RAW sprite, as wide as the value
+    eHudWidget_Label,               //!< LIB_Text string
+    eHudWidget_Icon,                //!< Sprite frame picked by the value
+    eHudWidget_Total
+
+} eHudWidget_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void        LIB_Hud_Init( void );
+int32_t     LIB_Hud_AddPanel( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulFrame, bool bFlipped );
+int32_t     LIB_Hud_AddBar( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulMax, uint8_t uEmpty );
+int32_t     LIB_Hud_AddLabel( int32_t lParent, int32_t x, int32_t y, eTextFont_t eFont, int32_t lColour );
+int32_t     LIB_Hud_AddIcon( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulFrame );
+void        LIB_Hud_SetValue( int32_t lWidget, uint32_t ulValue );
+void        LIB_Hud_SetText( int32_t lWidget, const char* pText );
+void        LIB_Hud_Invalidate( void );
+uint32_t    LIB_Hud_Draw( void );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_HUD_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Hud.h
+//-----------------------------------------------------------------------------
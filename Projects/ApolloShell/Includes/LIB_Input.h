@@ -0,0 +1,86 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Input.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Input sampled at VBL into a queue of timestamped events
+	@date		2025-10-29
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_INPUT_H_
+#define _LIB_INPUT_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "LIB_ApolloInput.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define INPUT_QUEUE_SIZE        ( 128 )         //!< Events, a power of 2
+#define INPUT_KEYS              ( APOLLOKEY_KEYS )  //!< Raw key codes 0x00 to 0x7F
+#define INPUT_MOUSE_LEFT        ( 0x0001 )      //!< InputEvent_t uwButtons for a mouse event
+#define INPUT_MOUSE_RIGHT       ( 0x0002 )
+#define INPUT_MOUSE_MIDDLE      ( 0x0004 )
+#define INPUT_JOYPAD_BUTTONS    ( 0x07FE )      //!< Start to A in the joypad register
+#define INPUT_ALL_FIELDS        ( 0xFFFFFFFF )  //!< LIB_Input_Update up to now
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	What an input event records
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eInputEvent_KeyDown = 0,            //!< ubCode raw key code
+    eInputEvent_KeyUp,                  //!< ubCode raw key code
+    eInputEvent_MouseMove,              //!< wX wY counter movement over the field
+    eInputEvent_MouseButton,            //!< uwButtons INPUT_MOUSE_ buttons now down
+    eInputEvent_Joypad,                 //!< uwButtons joypad register now
+    eInputEvent_Total
+
+} eInputEvent_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	An input event, stamped with the vertical blank it was seen in
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        ulField;
+    uint8_t         ubType;             //!< eInputEvent_t
+    uint8_t         ubCode;
+    int16_t         wX;
+    int16_t         wY;
+    uint16_t        uwButtons;
+
+} InputEvent_t, *pInputEvent_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void        LIB_Input_Init( void );
+void        LIB_Input_VBL( void );
+uint32_t    LIB_Input_GetField( void );
+uint32_t    LIB_Input_GetLost( void );
+bool        LIB_Input_PeekEvent( InputEvent_t* psEvent );
+bool        LIB_Input_GetEvent( InputEvent_t* psEvent, uint32_t ulUpToField );
+void        LIB_Input_Update( ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse, uint32_t ulUpToField );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_INPUT_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Input.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_MapGenerator.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Time sliced map generation into the spare back screen
+	@date		2025-10-22
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_MAPGENERATOR_H_
+#define _LIB_MAPGENERATOR_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MAPGEN_MAP_WIDTH        ( 1920 )
+#define MAPGEN_MAP_HEIGHT       ( 900 )
+#define MAPGEN_NOISE_COLUMNS    ( 240 )     //!< Default height map columns per step
+#define MAPGEN_PAINT_ROWS       ( 60 )      //!< Default rows painted per step
+#define MAPGEN_COPY_ROWS        ( 100 )     //!< Default rows copied to back screen 1 per step
+#define MAPGEN_CACHE_ROWS       ( 60 )      //!< Default rows loaded from the map cache per step
+#define MAPGEN_MASK_TILES       ( 32 )      //!< Default mask tiles generated per step, samples noise
+#define MAPGEN_TILES            ( 120 )     //!< Default tiles cleaned or painted per step
+#define MAPGEN_PLACE_DARTS      ( 64 )      //!< Decoration darts thrown per step
+#define MAPGEN_PROGRESS_MAX     ( 100 )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+typedef enum
+{
+    eMapGen_Idle = 0,       //!< 0 Nothing to do, back screens hold the current map
+    eMapGen_Cache,          //!< 1 Try the map cache, opens the file and reads the height map
+    eMapGen_CacheRows,      //!< 2 Terrain from the map cache, in rows
+    eMapGen_Noise,          //!< 3 Height map, in columns
+    eMapGen_Mask,           //!< 4 Solidity mask, in tiles
+    eMapGen_Clean,          //!< 5 Mask cleanup, in tiles (caves only)
+    eMapGen_Paint,          //!< 6 Terrain, in rows or tiles
+    eMapGen_Save,           //!< 7 Save to the map cache
+    eMapGen_Place,          //!< 8 Decorations stamped in, in darts
+    eMapGen_Decorate,       //!< 9 Decoration callback
+    eMapGen_Swap,           //!< 10 Spare becomes the map shown
+    eMapGen_Copy,           //!< 11 Back screen 1 brought up to date, in rows
+    eMapGen_Total
+
+} eMapGenState_t;
+
+typedef void (*MapGenDecorate_t)( int32_t* pMapHeight, uint32_t ulWidth, uint32_t ulHeight );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void            LIB_MapGenerator_Init( uint32_t ulTerrainSet, bool bSaveToCache, MapGenDecorate_t pfnDecorate );
+void            LIB_MapGenerator_SetBudget( uint32_t ulNoiseColumns, uint32_t ulPaintRows, uint32_t ulCopyRows, uint32_t ulCacheRows );
+void            LIB_MapGenerator_SetTileBudget( uint32_t ulMaskTiles, uint32_t ulTiles );
+void            LIB_MapGenerator_SetCaves( bool bCaves );
+void            LIB_MapGenerator_SetWater( uint32_t ulRows );
+bool            LIB_MapGenerator_Start( uint32_t ulSeed );
+bool            LIB_MapGenerator_Step( void );
+void            LIB_MapGenerator_Run( uint32_t ulSeed );
+bool            LIB_MapGenerator_IsBusy( void );
+uint32_t        LIB_MapGenerator_GetProgress( void );
+eMapGenState_t  LIB_MapGenerator_GetState( void );
+int32_t*        LIB_MapGenerator_GetHeightMap( void );
+uint32_t        LIB_MapGenerator_GetSeed( void );
+TerrainMask_t*  LIB_MapGenerator_GetMask( void );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_MAPGENERATOR_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_MapGenerator.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Palette.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Palette animation, cycles fades and flashes run at VBL
+	@date		2025-10-25
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_PALETTE_H_
+#define _LIB_PALETTE_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define PALETTE_ENTRIES     ( 256 )
+#define PALETTE_MAX_CYCLES  ( 8 )
+#define PALETTE_MAX_FADES   ( 4 )
+#define PALETTE_RGB_MASK    ( 0x00FFFFFF )
+#define PALETTE_MAX_NAMED   ( 4 )
+#define PALETTE_NAME_LENGTH ( 16 )
+#define PALETTE_MAX_TRANSFORMS ( 8 )
+#define PALETTE_MAX_STEPS   ( 64 )      //!< Transform steps over all the transforms
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	What a transform does to each colour channel, over its steps
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    ePaletteTransform_Fade = 0,         //!< Mix towards the colour, fade to black or flash white
+    ePaletteTransform_Tint,             //!< Multiply by the colour, coloured filters
+    ePaletteTransform_Darken,           //!< Subtract the colour, shadow and night
+    ePaletteTransform_Total
+
+} ePaletteTransform_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	How a transform is played through its steps at VBL
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    ePalettePlay_Once = 0,              //!< First to last step, the last step is held
+    ePalettePlay_Reverse,               //!< Last to first step, then off
+    ePalettePlay_Bounce,                //!< First to last and back, then off
+    ePalettePlay_Total
+
+} ePalettePlay_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void        LIB_Palette_Init( const uint32_t* pPalette );
+void        LIB_Palette_SetColour( uint32_t ulIndex, uint32_t ulRGB );
+uint32_t    LIB_Palette_GetColour( uint32_t ulIndex );
+int32_t     LIB_Palette_AddCycle( uint32_t ulFirst, uint32_t ulCount, uint32_t ulFields, bool bReverse );
+void        LIB_Palette_StopCycle( int32_t lCycle );
+bool        LIB_Palette_Fade( uint32_t ulFirst, uint32_t ulCount, const uint32_t* pTarget, uint32_t ulFields );
+bool        LIB_Palette_Flash( uint32_t ulFirst, uint32_t ulCount, uint32_t ulRGB, uint32_t ulFields );
+bool        LIB_Palette_IsFading( void );
+void        LIB_Palette_VBL( void );
+
+int32_t     LIB_Palette_AddNamed( const char* pName, const uint32_t* pPalette );
+int32_t     LIB_Palette_FindNamed( const char* pName );
+bool        LIB_Palette_SelectNamed( int32_t lPalette, uint32_t ulFields );
+
+int32_t     LIB_Palette_BuildTransform( ePaletteTransform_t eType, uint32_t ulRGB, uint32_t ulSteps );
+bool        LIB_Palette_PlayTransform( int32_t lTransform, ePalettePlay_t ePlay, uint32_t ulFields );
+void        LIB_Palette_SetTransformStep( int32_t lTransform, uint32_t ulStep );
+bool        LIB_Palette_IsTransforming( void );
+
+bool        LIB_Palette_IsCycled( uint32_t ulIndex );
+uint32_t    LIB_Palette_Nearest( uint32_t ulRGB );
+uint32_t    LIB_Palette_Luma( uint32_t ulRGB );
+void        LIB_Palette_BuildRemap( uint8_t* pRemap, uint32_t ulFirst, uint32_t ulCount, uint32_t ulRGB );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_PALETTE_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Palette.h
+//-----------------------------------------------------------------------------
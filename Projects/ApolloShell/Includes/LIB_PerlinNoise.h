@@ -18,23 +18,34 @@
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-// Typedefs & Enumerators
+// Typedefs and enums
 //-----------------------------------------------------------------------------
 
+/** ----------------------------------------------------------------------------
+    @brief   	Sample parameters of one map, lets a map be built in parts
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
 typedef struct
 {
-    float x;
-    float y;
+    float       fRef;       //!< Base frequency of the first octave
+    uint32_t    xAdd;       //!< Sample offset along the row
+    uint32_t    yAdd;       //!< Sample offset down the noise field
+    uint32_t    refY;       //!< Row of the noise field used for the map
 
-} sVector2, *psVector2;
+} PerlinMap_t, *pPerlinMap_t;
 
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
 
-void    LIB_PerlinNoise_Init( float fSeed );
-float   LIB_PerlinNoise_Noise2D( float x, float y );
-void 	LIB_PerlinNoise_GenerateMap( uint32_t* pMapHeight, uint32_t width, uint32_t height, float fRef );
+void    	LIB_PerlinNoise_Init( uint32_t ulSeed );
+uint32_t	LIB_PerlinNoise_Random( void );
+float   	LIB_PerlinNoise_Noise2D( float x, float y );
+void 		LIB_PerlinNoise_GenerateMap( int32_t* pMapHeight, uint32_t width, uint32_t height, float fRef );
+void 		LIB_PerlinNoise_GenerateSeededMap( int32_t* pMapHeight, uint32_t width, uint32_t ulSeed );
+void 		LIB_PerlinNoise_BeginMap( PerlinMap_t* psMap, float fRef );
+void 		LIB_PerlinNoise_BeginSeededMap( PerlinMap_t* psMap, uint32_t ulSeed );
+void 		LIB_PerlinNoise_GenerateColumns( const PerlinMap_t* psMap, int32_t* pMapHeight, uint32_t ulStartX, uint32_t ulEndX );
 int32_t LIB_PerlinNoise_IntLerp( int32_t t, int32_t a, int32_t b );
 
 //-----------------------------------------------------------------------------
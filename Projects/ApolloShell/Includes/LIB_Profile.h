@@ -0,0 +1,119 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Profile.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Frame profiler, cycles and cache counts per marked scope
+	@date		2025-10-28
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Build with PROFILE_ENABLED 0 and the PROFILE_ macros are empty, the
+	profiler is gone from the code and LIB_Profile.c compiles to nothing.
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_PROFILE_H_
+#define _LIB_PROFILE_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED     ( 1 )       //!< 0 for release, removes the profiler
+#endif
+
+#define PROFILE_FRAMES      ( 16 )      //!< Frames kept, the last complete one is shown
+#define PROFILE_MAX_SCOPES  ( 32 )      //!< Scopes recorded a frame
+#define PROFILE_MAX_DEPTH   ( 8 )       //!< Deeper scopes are counted, not recorded
+#define PROFILE_CYCLES_MS   ( 92000 )   //!< 68080 clocks a millisecond
+#define PROFILE_FRAME_MS    ( 20 )      //!< One PAL frame, the width of the overlay bars
+#define PROFILE_HEIGHT      ( 42 )      //!< Overlay rows, the top HUD strip
+
+#if PROFILE_ENABLED
+#define PROFILE_INIT()              LIB_Profile_Init()
+#define PROFILE_BEGIN( name )       LIB_Profile_Begin( name )
+#define PROFILE_END()               LIB_Profile_End()
+#define PROFILE_FRAME()             LIB_Profile_Frame()
+#define PROFILE_DRAW( y )           LIB_Profile_Draw( y )
+#define PROFILE_DUMP()              LIB_Profile_Dump()
+#else
+#define PROFILE_INIT()              ( (void)0 )
+#define PROFILE_BEGIN( name )       ( (void)0 )
+#define PROFILE_END()               ( (void)0 )
+#define PROFILE_FRAME()             ( (void)0 )
+#define PROFILE_DRAW( y )           ( (void)0 )
+#define PROFILE_DUMP()              ( (void)0 )
+#endif
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Counters, in the order Hardware_ReadCounters writes them
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eProfileCounter_Cycles = 0,
+    eProfileCounter_DCacheHits,
+    eProfileCounter_DCacheMisses,
+    eProfileCounter_ICacheMisses,
+    eProfileCounter_Pipe1,          //!< Instructions issued down pipe 1
+    eProfileCounter_Pipe2,          //!< Instructions issued down pipe 2, paired
+    eProfileCounter_Total
+
+} eProfileCounter_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	One scope in a frame
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    const char*     pName;
+    uint32_t        ulDepth;                                //!< 0 outermost
+    uint32_t        ulStart;                                //!< Cycles from the frame start
+    uint32_t        Counters[ eProfileCounter_Total ];      //!< Counted inside the scope
+
+} ProfileScope_t, *pProfileScope_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	One frame, scopes in the order they began
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        ulFrame;                                //!< Frame number
+    uint32_t        ulScopes;
+    uint32_t        ulDropped;                              //!< Scopes past the limits
+    uint32_t        Counters[ eProfileCounter_Total ];      //!< The whole frame
+    ProfileScope_t  Scopes[ PROFILE_MAX_SCOPES ];
+
+} ProfileFrame_t, *pProfileFrame_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+#if PROFILE_ENABLED
+
+void                    LIB_Profile_Init( void );
+void                    LIB_Profile_Begin( const char* pName );
+void                    LIB_Profile_End( void );
+void                    LIB_Profile_Frame( void );
+const ProfileFrame_t*   LIB_Profile_GetFrame( uint32_t ulAgo );
+void                    LIB_Profile_Draw( int32_t y );
+void                    LIB_Profile_Dump( void );
+
+#endif
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_PROFILE_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Profile.h
+//-----------------------------------------------------------------------------
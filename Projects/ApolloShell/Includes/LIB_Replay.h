@@ -0,0 +1,89 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Replay.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Input recording and replay, for runs that can be compared
+	@date		2025-10-30
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_REPLAY_H_
+#define _LIB_REPLAY_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "LIB_ApolloInput.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define REPLAY_ID           ( 0x4152504C )  //!< "ARPL"
+#define REPLAY_VERSION      ( 2 )
+#define REPLAY_HEADER       ( 16 )          //!< Id, version, seed, ticks
+#define REPLAY_RECORD       ( 12 + ( 2 * APOLLOKEY_LONGS * 4 ) )   //!< Repeat count then one tick of state
+#define REPLAY_MAX_REPEAT   ( 0xFFFF )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	What the replay is doing with the input each tick
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eReplay_Off = 0,                    //!< Live input
+    eReplay_Record,                     //!< Live input, written to the file
+    eReplay_Play,                       //!< Input read from the file
+    eReplay_Total
+
+} eReplay_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	One tick of input, the parts of the state structs main.c reads
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        KeysDown[ APOLLOKEY_LONGS ];        //!< Keys_Down
+    uint32_t        KeysPressed[ APOLLOKEY_LONGS ];     //!< Keys_Pressed, the released and repeat bits follow from these
+    uint8_t         ubKey;              //!< Current_Key
+    uint8_t         ubPad;
+    uint16_t        uwJoypad;           //!< As the joypad register, for ApolloJoypadDecode
+    int16_t         wMouseX;            //!< MouseX_Pointer
+    int16_t         wMouseY;            //!< MouseY_Pointer
+    uint16_t        uwButtonState;      //!< Button_State
+
+} ReplayTick_t, *pReplayTick_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+bool        LIB_Replay_Record( const char* pFileName, uint32_t ulSeed );
+bool        LIB_Replay_Play( const char* pFileName, uint32_t* pulSeed );
+bool        LIB_Replay_Tick( ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse );
+bool        LIB_Replay_WriteTick( const ReplayTick_t* psTick );
+bool        LIB_Replay_ReadTick( ReplayTick_t* psTick );
+void        LIB_Replay_Close( void );
+eReplay_t   LIB_Replay_GetMode( void );
+uint32_t    LIB_Replay_GetTicks( void );
+uint32_t    LIB_Replay_GetRecords( void );
+
+void        LIB_Replay_FromState( ReplayTick_t* psTick, const ApolloKeyBoardState* psKeyboard, const ApolloJoypadState* psJoypad, const ApolloMouseState* psMouse );
+void        LIB_Replay_ToState( const ReplayTick_t* psTick, ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_REPLAY_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Replay.h
+//-----------------------------------------------------------------------------
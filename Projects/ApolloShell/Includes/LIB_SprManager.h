@@ -11,10 +11,207 @@
 #ifndef _LIB_SPRMANAGER_H_
 #define _LIB_SPRMANAGER_H_
 
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TOTAL_SPRITES		( 256 )		//!< Sprite pool, an index fits a byte
+#define SPR_Z_LEVELS		( 256 )		//!< SprZ values, 0 drawn first
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	What a frame of an animation does
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+	SPR_CMD_NONE = 0,					//!< Shows FrameID, as SPR_CMD_FRAME
+	SPR_CMD_MOVE,						//!< Shows FrameID, moves Positions[0] to Positions[1]
+	SPR_CMD_ROTATE,						//!< Turns by FrameData[0] degrees a step, FrameData[1] images
+	SPR_CMD_ANIM,						//!< Starts animation FrameData[0], takes no time
+	SPR_CMD_FRAME,						//!< Shows FrameID
+	SPR_CMD_END							//!< End of the animation, before AnimFrames
+
+} eSPRCMD;
+
+/** ----------------------------------------------------------------------------
+    @brief   	What an animation does at its end
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+	SPR_ANIM_NONE = 0,					//!< Stops, as SPR_ANIM_ONCE
+	SPR_ANIM_LOOP,						//!< From the first frame again
+	SPR_ANIM_PINGPONG,					//!< Back to the first frame, then forward again
+	SPR_ANIM_ONCE						//!< Stops on the last frame shown
+
+} eSPRANIMTYPE;
+
+struct SPRITE_s;
+
+// Callbacks
+typedef void (*fnSprControl)(struct SPRITE_s* pSprite);
+
+typedef struct
+{
+	uint16_t	X;
+	uint16_t	Y;
+
+} POSITION, *PPOSITION;
+
+typedef struct
+{
+	uint16_t	X;
+	uint16_t	Y;
+	uint16_t	W;
+	uint16_t	H;
+
+} RECT, *PRECT;
+
+typedef union
+{
+	struct
+	{
+		uint32_t    Active		: 1;
+		uint32_t    OnScreen	: 1;	//!< Set by LIB_SprManager_Draw
+		uint32_t    Paused		: 1;	//!< No control or animation
+		uint32_t    DeleteMe	: 1;	//!< Removed on the next update
+		uint32_t    Collidable	: 1;	//!< In the LIB_Collision grid as body SprID
+		uint32_t    Visible		: 1;
+		uint32_t    Animated	: 1;
+		uint32_t    Reserved	: 25;
+	};
+
+	uint32_t	Flags;
+
+} SPRFLAG,*PSPRFLAG;
+
+typedef union
+{
+	struct
+	{
+		uint16_t    Active : 1;			//!< Clear and the frame is skipped
+		uint16_t    Looping : 1;		//!< Repeats until the animation is changed
+		uint16_t    Reserved : 14;
+
+	};
+
+	uint16_t    Flags;
+
+} SPRFRAMEFLAGS, * PSPRFRAMEFLAGS;
+
+/** ----------------------------------------------------------------------------
+    @brief   	One frame of an animation, FrameCount steps of FrameDelay ticks
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+	SPRFRAMEFLAGS	FrameFlags;
+
+	// Reference Frame Information
+	uint16_t		FrameID;			//!< Image in the sprite's bank
+	uint16_t		FrameCMD;			//!< eSPRCMD
+	uint16_t		FrameData[ 2 ];
+	POSITION		Positions[ 2 ];		//!< World positions for SPR_CMD_MOVE
+	uint16_t		FrameCount;			//!< Steps, 0 is 1
+	uint16_t		FrameDelay;			//!< Ticks a step, 0 is 1
+
+	// Working Frame Data
+	uint16_t		FrameCurCount;
+	uint16_t		FrameCurDelay;
+	POSITION		FrameCurPos;
+
+} SPRFRAME, *PSPRFRAME;
+
+/** ----------------------------------------------------------------------------
+    @brief   	An animation, the frames hold working data so each sprite
+				animating needs its own copy
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+	uint16_t	AnimID;
+	uint16_t	AnimType;				//!< eSPRANIMTYPE
+	uint16_t	AnimFrames;
+	uint16_t	AnimCurFrame;
+	int16_t		AnimDir;				//!< 1 forward, -1 back for SPR_ANIM_PINGPONG
+	SPRFRAME*	pFrames;
+
+} SPRANIM, * PSPRANIM;
+
+typedef struct SPRITE_s
+{
+	// General Sprite Information
+	uint8_t		SprID;
+	uint8_t     SprGroup;
+	SPRFLAG		SprFlags;
+	uint32_t	SprResourceID;			//!< Sprite bank
+	uint16_t	SprFrameID;				//!< Image in the bank, set by the animation
+	int16_t		ScreenX;				//!< Set by LIB_SprManager_Draw
+	int16_t		ScreenY;
+	float		fWorldX;				//!< Top left in the map
+	float		fWorldY;
+	uint16_t	SprWidth;
+	uint16_t	SprHeight;
+	uint8_t		SprZ;
+
+	// Animation Information
+	PSPRANIM	pAnimData;				//!< AnimCount animations
+	uint16_t	AnimCount;
+	uint16_t	CurAnimIndex;
+
+	// Collision Information
+	RECT		CollisionRect;			//!< From the top left, no size for the whole image
+
+	// Movement Information
+	float		fMoveSpeed;
+	float		fMoveAngle;				//!< Degrees, turned by SPR_CMD_ROTATE
+	float		fMoveX;					//!< Added to the world position each update
+	float		fMoveY;
+
+	// Control Callbacks
+	fnSprControl	fnControl;			//!< Called each update before the animation
+
+} SPRITE,*PSPRITE;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Sprite counts of the last LIB_SprManager_Draw
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+	uint32_t	ulActive;				//!< In the pool
+	uint32_t	ulVisible;				//!< Visible and on screen, submitted
+	uint32_t	ulDrawn;				//!< Drawn by LIB_Sprites, not clipped out
+
+} SprStats_t, *pSprStats_t;
+
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
 
+void		LIB_SprManager_Init( void );
+void		LIB_SprManager_Clear( void );
+PSPRITE		LIB_SprManager_Add( uint32_t nResourceID, uint16_t nX, uint16_t nY, uint16_t nGroup, uint16_t nZ, fnSprControl fnControl );
+void		LIB_SprManager_Remove( PSPRITE pSprite );
+void		LIB_SprManager_SetAnim( PSPRITE pSprite, PSPRANIM pAnims, uint16_t nAnims, uint16_t nAnim );
+void		LIB_SprManager_SetView( int32_t x, int32_t y, int32_t w, int32_t h );
+void		LIB_SprManager_SetCamera( int32_t x, int32_t y );
+void		LIB_SprManager_Update( void );
+uint32_t	LIB_SprManager_Draw( void );
+void		LIB_SprManager_GetStats( SprStats_t* psStats );
+uint32_t	LIB_SprManager_GetCount( void );
+PSPRITE		LIB_SprManager_GetSprite( uint32_t nSpriteID );
 
 //-----------------------------------------------------------------------------
 
@@ -23,4 +220,3 @@
 //-----------------------------------------------------------------------------
 // End of file: LIB_SprManager.h
 //-----------------------------------------------------------------------------
-
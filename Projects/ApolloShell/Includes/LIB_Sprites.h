@@ -13,6 +13,13 @@
 #ifndef _LIB_SPRITES_H_
 #define _LIB_SPRITES_H_
 
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define SPRITE_REMAP_SIZE   ( 256 )     //!< Bytes in a colour remap table
+#define SPRITE_MAX_REMAPS   ( 16 )      //!< Shared remap tables
+
 //-----------------------------------------------------------------------------
 // typedefs and enums
 //-----------------------------------------------------------------------------
@@ -67,6 +74,19 @@ typedef struct
 
 } SpriteBank_t, *pSpriteBank_t;     //!< Sprite structure
 
+/**-----------------------------------------------------------------------------
+    @brief      One sprite of a LIB_Sprites_DrawBatch list
+    @ingroup 	MainShell
+ ---------------------------------------------------------------------------- */
+typedef struct
+{
+    uint16_t        uwBank;         //!< Sprite bank
+    uint16_t        uwFrame;        //!< Sprite number in the bank
+    int16_t         wX;             //!< Screen position
+    int16_t         wY;
+
+} SpriteDraw_t, *pSpriteDraw_t;     //!< Batched sprite draw
+
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
@@ -77,9 +97,17 @@ bool LIB_Sprites_RegisterBank( eSpriteBank_t eBank, eSpriteType_t eType, uint32_
 bool LIB_Sprites_Draw( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y );
 bool LIB_Sprites_DrawRawPart( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, uint32_t xOff, uint32_t yOff, uint32_t xSize, uint32_t ySize );
 bool LIB_Sprites_DrawFlipped( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y );
+bool LIB_Sprites_DrawRemapped( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pRemap );
+bool LIB_Sprites_DrawBlended( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pBlend );
+uint32_t LIB_Sprites_DrawBatch( const SpriteDraw_t* psDraws, uint32_t ulCount );
+int32_t LIB_Sprites_AddRemap( const uint8_t* pRemap );
+const uint8_t* LIB_Sprites_GetRemap( int32_t lRemap );
+bool LIB_Sprites_Decode( eSpriteBank_t eBank, uint32_t sprNum, uint8_t* pDest, uint32_t ulPitch );
 bool LIB_Sprites_Remap( eSpriteBank_t eSpriteBank, uint32_t ShiftBy );
 void LIB_Sprites_SetClipArea( uint32_t x, uint32_t y, uint32_t w, uint32_t h );
+void LIB_Sprites_GetClipArea( int32_t* pX, int32_t* pY, int32_t* pW, int32_t* pH );
 uint32_t LIB_Sprites_GetHeight( eSpriteBank_t eBank );
+uint32_t LIB_Sprites_GetWidth( eSpriteBank_t eBank );
 
 //-----------------------------------------------------------------------------
 
@@ -0,0 +1,59 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Terrain.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Terrain rasterizer, paints sky gradient and soil from a height map
+	@date		2025-10-21
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_TERRAIN_H_
+#define _LIB_TERRAIN_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TERRAIN_SOIL_SIZE       ( 256 )     //!< Soil texture is 256x256, wrapped
+#define TERRAIN_SURFACE_OFFSET  ( 350 )     //!< Height map value to surface row
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Everything the rasterizer needs to paint a terrain buffer
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint8_t*        pBuffer;            //!< Destination buffer, long aligned
+    uint32_t        ulWidth;            //!< Buffer width, multiple of 4
+    uint32_t        ulHeight;           //!< Buffer height
+    const int32_t*  pMapHeight;         //!< Height map, one entry per column
+    int32_t         lSurfaceOffset;     //!< Subtracted from the height map to give the surface row
+    const uint8_t*  pSoil;              //!< 256x256 soil texture
+    const uint8_t*  pGradient;          //!< Sky gradient strip, NULL for a clear sky
+    uint32_t        ulGradientWidth;    //!< Gradient strip width, power of 2 for the fast path
+    uint32_t        ulGradientHeight;   //!< Gradient strip height
+
+} TerrainPaint_t, *pTerrainPaint_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void LIB_Terrain_Paint( const TerrainPaint_t* psPaint );
+void LIB_Terrain_PaintArea( const TerrainPaint_t* psPaint, uint32_t x, uint32_t y, uint32_t w, uint32_t h );
+void LIB_Terrain_FillRow( uint8_t* pRow, const uint8_t* pSource, uint32_t ulPeriod, uint32_t x, uint32_t xEnd );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_TERRAIN_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Terrain.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_TerrainCache.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Seed keyed on-disk cache of generated maps
+	@date		2025-10-20
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_TERRAINCACHE_H_
+#define _LIB_TERRAINCACHE_H_
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TERRAINCACHE_DIRECTORY      "Data/Maps/"
+#define TERRAINCACHE_MAX_FILENAME   ( 64 )
+#define TERRAINCACHE_POOL_SIZE      ( 32 )      //!< Maps pre-baked by Tools/MapBaker
+#define TERRAINCACHE_READ_SIZE      ( 8192 )    //!< Packed bytes read from the file at a time
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	A cached map being loaded a few rows at a time
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    FILE*       fp;                 //!< NULL when closed
+    uint8_t*    pBuffer;            //!< Terrain buffer being filled
+    uint32_t    ulWidth;
+    uint32_t    ulHeight;
+    uint32_t    ulRow;              //!< Rows decoded
+    uint32_t    ulPackedLeft;       //!< Packed bytes still in the file
+    uint32_t    ulCount;            //!< Pixels left of the current run or literal
+    bool        bZero;              //!< Current command is a zero run
+    bool        bError;
+    uint32_t    ulRead;             //!< Bytes in pRead
+    uint32_t    ulReadPos;          //!< Next byte of pRead
+    uint8_t     pRead[ TERRAINCACHE_READ_SIZE ];
+    char        szFileName[ TERRAINCACHE_MAX_FILENAME ];
+
+} TerrainCacheReader_t, *pTerrainCacheReader_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+uint32_t LIB_TerrainCache_PoolSeed( uint32_t ulMapIndex );
+bool     LIB_TerrainCache_MakeDirectory( void );
+void     LIB_TerrainCache_GetFileName( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, char* pszFileName );
+bool     LIB_TerrainCache_Load( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, int32_t* pMapHeight, uint32_t ulMapWidth, uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight );
+bool     LIB_TerrainCache_Open( TerrainCacheReader_t* psReader, uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, int32_t* pMapHeight, uint32_t ulMapWidth, uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight );
+bool     LIB_TerrainCache_ReadRows( TerrainCacheReader_t* psReader, uint32_t ulRows );
+void     LIB_TerrainCache_Close( TerrainCacheReader_t* psReader );
+bool     LIB_TerrainCache_Save( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, const int32_t* pMapHeight, uint32_t ulMapWidth, const uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_TERRAINCACHE_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_TerrainCache.h
+//-----------------------------------------------------------------------------
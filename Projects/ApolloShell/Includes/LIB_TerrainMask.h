@@ -0,0 +1,90 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_TerrainMask.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		2D terrain solidity mask, generated and painted in 32x32 tiles
+	@date		2025-10-23
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_TERRAINMASK_H_
+#define _LIB_TERRAINMASK_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TERRAINMASK_TILE_SIZE   ( 32 )      //!< One long of mask per tile row
+#define TERRAINMASK_LONGS( w, h )   ( ( (w) / 32 ) * (h) )
+#define TERRAINMASK_TILES( w, h )   ( ( (w) / 32 ) * ( ( (h) + 31 ) / 32 ) )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+typedef enum
+{
+    eMaskTile_Air = 0,      //!< 0 No solid pixels
+    eMaskTile_Solid,        //!< 1 All solid
+    eMaskTile_Mixed,        //!< 2 Some of each
+
+} eMaskTile_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Solidity mask, one bit per pixel, bit 31 is the leftmost
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t*   pBits;          //!< ulPitch longs per row
+    uint8_t*    pTiles;         //!< eMaskTile_t per tile, row by row
+    uint32_t    ulWidth;        //!< Width in pixels, multiple of 32
+    uint32_t    ulHeight;       //!< Height in pixels
+    uint32_t    ulPitch;        //!< Longs per row, also tiles across
+    uint32_t    ulTilesY;       //!< Tiles down, last may be partial
+
+} TerrainMask_t, *pTerrainMask_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Shape of the terrain. A pixel is solid when
+                ( y - surface ) * fDepthScale + fCaveAmp * fbm( x, y ) >= 0,
+                so with fCaveAmp at 0 it is the plain height map.
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    const int32_t*  pMapHeight;     //!< Height map, one entry per column
+    int32_t         lSurfaceOffset; //!< Subtracted from the height map to give the surface row
+    float           fDepthScale;    //!< Density gained per row below the surface
+    float           fCaveAmp;       //!< Strength of the 2D noise, 0 for no caves
+    float           fCaveFreq;      //!< Frequency of the first noise octave
+    uint32_t        ulOctaves;      //!< Noise octaves
+    float           fOffsetX;       //!< Noise field offsets, picked from the map seed
+    float           fOffsetY;
+
+} TerrainShape_t, *pTerrainShape_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+void        LIB_TerrainMask_Setup( TerrainMask_t* psMask, uint32_t* pBits, uint8_t* pTiles, uint32_t ulWidth, uint32_t ulHeight );
+uint32_t    LIB_TerrainMask_GetTileCount( const TerrainMask_t* psMask );
+uint32_t    LIB_TerrainMask_CountTiles( const TerrainMask_t* psMask, eMaskTile_t eType );
+void        LIB_TerrainMask_GenerateTiles( TerrainMask_t* psMask, const TerrainShape_t* psShape, uint32_t ulFirst, uint32_t ulCount );
+void        LIB_TerrainMask_CleanTiles( TerrainMask_t* psDest, const TerrainMask_t* psSource, uint32_t ulFirst, uint32_t ulCount );
+void        LIB_TerrainMask_PaintTiles( const TerrainMask_t* psMask, const TerrainPaint_t* psPaint, uint32_t ulFirst, uint32_t ulCount );
+void        LIB_TerrainMask_Stamp( TerrainMask_t* psMask, int32_t x, int32_t y, const uint8_t* pPixels, uint32_t ulWidth, uint32_t ulHeight, uint32_t ulPitch );
+void        LIB_TerrainMask_ClearRows( TerrainMask_t* psMask, uint32_t ulFirst, uint32_t ulRows );
+bool        LIB_TerrainMask_IsSolid( const TerrainMask_t* psMask, int32_t x, int32_t y );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_TERRAINMASK_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_TerrainMask.h
+//-----------------------------------------------------------------------------
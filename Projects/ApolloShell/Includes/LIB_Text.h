@@ -0,0 +1,76 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Text.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Text from the font banks, strings kept as ready drawn surfaces
+	@date		2025-10-26
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_TEXT_H_
+#define _LIB_TEXT_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TEXT_GLYPHS         ( 160 )     //!< Frames in a font bank
+#define TEXT_FIRST_CHAR     ( 32 )      //!< Character of frame 0
+#define TEXT_MAX_LENGTH     ( 47 )      //!< Longest string kept as a surface
+#define TEXT_MAX_SURFACES   ( 24 )
+#define TEXT_SURFACE_WIDTH  ( 320 )     //!< Wider strings are drawn a glyph at a time
+#define TEXT_SURFACE_HEIGHT ( 24 )
+#define TEXT_GLYPH_POOL     ( 128 * 1024 )
+#define TEXT_NO_COLOUR      ( -1 )      //!< Draw in the font's own colours
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Fonts, in the order of the font group
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef enum
+{
+    eTextFont_Medium = 0,           //!< medwht1, 24x24
+    eTextFont_Small,                //!< smlwht1, 12x12
+    eTextFont_Total
+
+} eTextFont_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Text cache counts
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        ulHits;         //!< Strings drawn from a surface
+    uint32_t        ulMisses;       //!< Strings drawn into a surface first
+    uint32_t        ulGlyphs;       //!< Glyphs drawn, into surfaces or the screen
+    uint32_t        ulEvictions;    //!< Surfaces reused for another string
+
+} TextStats_t, *pTextStats_t;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+bool        LIB_Text_Init( uint32_t ulFontBank );
+uint32_t    LIB_Text_GetWidth( eTextFont_t eFont, const char* pText );
+uint32_t    LIB_Text_GetHeight( eTextFont_t eFont );
+bool        LIB_Text_Draw( eTextFont_t eFont, const char* pText, int32_t x, int32_t y, int32_t lColour );
+bool        LIB_Text_DrawDebug( const char* pText, int32_t x, int32_t y, uint32_t ulInk, int32_t lPaper );
+void        LIB_Text_EndFrame( void );
+void        LIB_Text_GetStats( TextStats_t* psFrame, TextStats_t* psTotal );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_TEXT_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Text.h
+//-----------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Water.h
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Water drawn once into the terrain, animated by palette cycling
+	@date		2025-10-25
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+--------------------------------------------------------------------------- */
+
+#ifndef _LIB_WATER_H_
+#define _LIB_WATER_H_
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define WATER_COLOURS       ( 16 )      //!< Most palette entries cycled, power of 2
+#define WATER_CYCLE_FIELDS  ( 4 )       //!< Vertical blanks per cycle step
+#define WATER_ROWS          ( 42 )      //!< Default depth at the bottom of the map
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+uint32_t    LIB_Water_Init( uint32_t ulWaterBank );
+void        LIB_Water_Draw( uint8_t* pBuffer, TerrainMask_t* psMask, uint32_t ulTop );
+
+//-----------------------------------------------------------------------------
+
+#endif // _LIB_WATER_H_
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Water.h
+//-----------------------------------------------------------------------------
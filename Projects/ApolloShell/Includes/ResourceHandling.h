@@ -15,6 +15,10 @@
 #define _RESOURCEHANDLING_H_
 
 //-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define RESOURCE_ALL_TERRAIN    ( 0xFFFFFFFF )  //!< Load every terrain set
 
 //-----------------------------------------------------------------------------
 // typedefs and enums
@@ -46,6 +50,7 @@ extern bool ResourceHandling_Get( uint32_t ulResourceID, eResourceGet_t eType, u
 bool ResourceHandling_LoadGroups( sFileGroup groups[] );
 uint32_t ResourceHandling_GetGroupStartResource( uint32_t nGroupIndex );
 void ResourceHandling_InitStatus( psFileGroup groups );
+void ResourceHandling_SetResidentTerrain( uint32_t ulTerrainSet );
 
 //-----------------------------------------------------------------------------
 
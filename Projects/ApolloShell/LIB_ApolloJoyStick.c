@@ -26,10 +26,19 @@
  void ApolloJoypad(ApolloJoypadState *JoypadState)
 {
 	uint16_t * const Joypad_Pointer  = (uint16_t*)0xDFF220;
-	uint16_t Joypad_Value;
 	
-	Joypad_Value = *Joypad_Pointer;
+	ApolloJoypadDecode(JoypadState, *Joypad_Pointer);
+}
 
+/** ---------------------------------------------------------------------------
+    @brief 		Sets the Joypad state from a reading of the Joypad register,
+				taken by ApolloJoypad or by LIB_Input
+    @ingroup 	ApolloSosurce
+    @param 		JoypadState		Pointer to the Joypad state
+    @param 		Joypad_Value	$DFF220 as read
+ --------------------------------------------------------------------------- */
+void ApolloJoypadDecode(ApolloJoypadState *JoypadState, uint16_t Joypad_Value)
+{
 	if ((Joypad_Value & 0x8000) == 0x8000) JoypadState->Joypad_X_Delta = 1;
 	else if ((Joypad_Value & 0x4000) == 0x4000) JoypadState->Joypad_X_Delta = -1;
 	else JoypadState->Joypad_X_Delta = 0;
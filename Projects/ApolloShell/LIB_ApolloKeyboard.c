@@ -6,12 +6,29 @@
  -----------------------------------------------------------------------------
 	Notes
 
+	The keyboard state keeps a bit for each of the 128 raw key codes, held
+	down, went down this tick, came up this tick and repeated this tick, so
+	any number of keys can be down together and a binding is one bit test,
+	ApolloKeyDown and the others in LIB_ApolloInput.h.
+
+	A tick is ApolloKeyboardBegin, a ApolloKeyboardKey for each key code in
+	the order they came, then ApolloKeyboardEnd. LIB_Input_Update does this
+	from the queue the VBL fills, ApolloKeyboard from one read of the
+	register. A key that went down and up inside one tick shows as pressed
+	and released but not down. The register only holds the last code, so
+	a key coming up that was never seen down was tapped between two reads,
+	the press is taken as read with the release, as LIB_Input_VBL does.
+
+	Repeat counts ticks a key is held, after Repeat_Delay ticks the repeat
+	bit is set every Repeat_Rate ticks, and on the tick it went down.
+
 --------------------------------------------------------------------------- */
 
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
 
+#include "string.h"
 #include "Includes/LIB_ApolloInput.h"
 
 //-----------------------------------------------------------------------------
@@ -19,26 +36,130 @@
 //-----------------------------------------------------------------------------
 
 /** ---------------------------------------------------------------------------
-    @brief 		Handles the Keyboard input
+    @brief 		Handles the Keyboard input, one read of the register
     @ingroup 	ApolloSosurce
     @param 		KeyboardState		Pointer to the Keyboard state
  --------------------------------------------------------------------------- */
 void ApolloKeyboard(ApolloKeyBoardState *KeyboardState)
 {
-	uint8_t* const 	Keyboard_Pointer = (uint8_t*)0xBFEC01; 
+	uint8_t* const 	Keyboard_Pointer = (uint8_t*)0xBFEC01;
 	uint8_t			Keyboard_Raw, Keyboard_Now;
 
 	Keyboard_Raw = *Keyboard_Pointer;														// retrieve RAW value from register
 	Keyboard_Raw = ~Keyboard_Raw;															// not.b
-	KeyboardState->Current_Key = (uint8_t) ((Keyboard_Raw>>1) | (Keyboard_Raw<<7));			// ror.b #1
+	Keyboard_Now = (uint8_t) ((Keyboard_Raw>>1) | (Keyboard_Raw<<7));						// ror.b #1
 
-	if ((KeyboardState->Current_Key < 127) && (KeyboardState->Current_Key!=KeyboardState->Previous_Key))
+	ApolloKeyboardBegin(KeyboardState);
+	if (Keyboard_Now != KeyboardState->Last_Raw)
 	{
-		KeyboardState->Previous_Key = KeyboardState->Current_Key;							// Use only "Low" KB values (0-127)
+		KeyboardState->Last_Raw = Keyboard_Now;
+		ApolloKeyboardKey(KeyboardState, Keyboard_Now & 0x7F, (Keyboard_Now & 0x80) == 0);
+	}
+	ApolloKeyboardEnd(KeyboardState);
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Sets how held keys repeat
+    @ingroup 	ApolloSosurce
+    @param 		KeyboardState		Pointer to the Keyboard state
+    @param 		Delay				Ticks held before the first repeat, 0 for none
+    @param 		Rate				Ticks between repeats after that
+ --------------------------------------------------------------------------- */
+void ApolloKeyboardRepeat(ApolloKeyBoardState *KeyboardState, uint8_t Delay, uint8_t Rate)
+{
+	KeyboardState->Repeat_Delay = Delay;
+	KeyboardState->Repeat_Rate = Rate ? Rate : 1;
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Starts a tick, the edges of the last one are cleared
+    @ingroup 	ApolloSosurce
+    @param 		KeyboardState		Pointer to the Keyboard state
+ --------------------------------------------------------------------------- */
+void ApolloKeyboardBegin(ApolloKeyBoardState *KeyboardState)
+{
+	memcpy(KeyboardState->Keys_Was, KeyboardState->Keys_Down, sizeof(KeyboardState->Keys_Was));
+	memset(KeyboardState->Keys_Pressed, 0, sizeof(KeyboardState->Keys_Pressed));
+	memset(KeyboardState->Keys_Released, 0, sizeof(KeyboardState->Keys_Released));
+	memset(KeyboardState->Keys_Repeat, 0, sizeof(KeyboardState->Keys_Repeat));
+	KeyboardState->Current_Key = APOLLOKEY_NONE;
+}
 
+/** ---------------------------------------------------------------------------
+    @brief 		A key going down or coming up
+    @ingroup 	ApolloSosurce
+    @param 		KeyboardState		Pointer to the Keyboard state
+    @param 		Key					Raw key code, 0-127
+    @param 		Down				true going down
+ --------------------------------------------------------------------------- */
+void ApolloKeyboardKey(ApolloKeyBoardState *KeyboardState, uint8_t Key, bool Down)
+{
+	uint32_t Bit = APOLLOKEY_BIT(Key);
+	uint32_t Long = (Key >> 5) & (APOLLOKEY_LONGS - 1);
 
+	if (Down)
+	{
+		if ((KeyboardState->Keys_Down[Long] & Bit) == 0)
+		{
+			KeyboardState->Keys_Down[Long] |= Bit;
+			KeyboardState->Keys_Pressed[Long] |= Bit;
+			if (KeyboardState->Current_Key == APOLLOKEY_NONE)
+			{
+				KeyboardState->Current_Key = Key;
+				KeyboardState->Previous_Key = Key;
+			}
+		}
 	} else {
-		KeyboardState->Current_Key = 127;
+		if ((KeyboardState->Keys_Down[Long] & Bit) == 0 && (KeyboardState->Keys_Pressed[Long] & Bit) == 0)
+		{
+			// tapped between reads, the press was missed
+			ApolloKeyboardKey(KeyboardState, Key, true);
+		}
+		KeyboardState->Keys_Down[Long] &= ~Bit;
+		KeyboardState->Keys_Released[Long] |= Bit;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Ends a tick, works out the releases and repeats
+    @ingroup 	ApolloSosurce
+    @param 		KeyboardState		Pointer to the Keyboard state
+ --------------------------------------------------------------------------- */
+void ApolloKeyboardEnd(ApolloKeyBoardState *KeyboardState)
+{
+	uint32_t Long, Bits;
+	uint8_t Key;
+
+	for (Long = 0; Long < APOLLOKEY_LONGS; Long++)
+	{
+		// down at the start and not now, or down and up inside the tick
+		KeyboardState->Keys_Released[Long] |= (KeyboardState->Keys_Was[Long] | KeyboardState->Keys_Pressed[Long]) & ~KeyboardState->Keys_Down[Long];
+		KeyboardState->Keys_Repeat[Long] = KeyboardState->Keys_Pressed[Long];
+
+		// only the keys held are counted, usually none or a few
+		Bits = KeyboardState->Keys_Down[Long] & ~KeyboardState->Keys_Pressed[Long];
+		for (Key = Long * 32; Bits != 0; Bits >>= 1, Key++)
+		{
+			if (Bits & 1)
+			{
+				uint8_t Held = KeyboardState->Keys_Held[Key];
+
+				if (Held < 255) KeyboardState->Keys_Held[Key] = ++Held;
+				if (KeyboardState->Repeat_Delay != 0 && Held >= KeyboardState->Repeat_Delay &&
+					((Held - KeyboardState->Repeat_Delay) % KeyboardState->Repeat_Rate) == 0)
+				{
+					KeyboardState->Keys_Repeat[Long] |= APOLLOKEY_BIT(Key);
+				}
+				// past the first repeat, the count wraps round to keep repeating
+				if (Held == 255) KeyboardState->Keys_Held[Key] = KeyboardState->Repeat_Delay;
+			}
+		}
+
+		Bits = KeyboardState->Keys_Pressed[Long];
+		for (Key = Long * 32; Bits != 0; Bits >>= 1, Key++)
+		{
+			if (Bits & 1) KeyboardState->Keys_Held[Key] = 0;
+		}
 	}
 }
 
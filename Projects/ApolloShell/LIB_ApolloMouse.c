@@ -28,33 +28,52 @@ void ApolloMouse(ApolloMouseState *MouseState)
 	uint8_t MouseButtonLeft_Value;	
 	uint16_t MouseButtonRight_Value;	
 	uint16_t MouseButtonMiddle_Value;
-
-	// Initialize Mouse Buttons
-	MouseState->Button_Left = false;
-	MouseState->Button_Right = false;
-	MouseState->Button_Middle = false;
+	int16_t MouseX_Delta, MouseY_Delta;
+	bool Left = false, Right = false, Middle = false;
 	
 	// Read Mouse Buttons 
 	MouseButtonLeft_Value = *((volatile uint8_t*)APOLLO_MOUSE_BUTTON1);
-	if ((MouseButtonLeft_Value & 0x40) == 0) MouseState->Button_Left = true;
+	if ((MouseButtonLeft_Value & 0x40) == 0) Left = true;
 	MouseButtonRight_Value= *((volatile uint16_t*)APOLLO_MOUSE_BUTTON2);
-	if ((MouseButtonRight_Value & 0x400) == 0) MouseState->Button_Right = true;
+	if ((MouseButtonRight_Value & 0x400) == 0) Right = true;
 	MouseButtonMiddle_Value= *((volatile uint16_t*)APOLLO_MOUSE_BUTTON3);
-	if ((MouseButtonMiddle_Value & 0x400) == 0) MouseState->Button_Middle = true;
+	if ((MouseButtonMiddle_Value & 0x400) == 0) Middle = true;
 
 	// Read Mouse Movement	
 	MouseState->MouseX_Value 		= *((signed char *)APOLLO_MOUSE_GET_X);
 	MouseState->MouseY_Value 		= *((signed char *)APOLLO_MOUSE_GET_Y);
-	MouseState->MouseX_Value_Delta 	= MouseState->MouseX_Value - MouseState->MouseX_Value_Old;
-	MouseState->MouseY_Value_Delta 	= MouseState->MouseY_Value - MouseState->MouseY_Value_Old;
+	MouseX_Delta 					= MouseState->MouseX_Value - MouseState->MouseX_Value_Old;
+	MouseY_Delta 					= MouseState->MouseY_Value - MouseState->MouseY_Value_Old;
 	MouseState->MouseX_Value_Old 	= MouseState->MouseX_Value;
 	MouseState->MouseY_Value_Old 	= MouseState->MouseY_Value;
 
 	// Correct Delta for BYTE overflow
-	if (MouseState->MouseX_Value_Delta < -128) MouseState->MouseX_Value_Delta += 256;
-	if (MouseState->MouseX_Value_Delta >  128) MouseState->MouseX_Value_Delta -= 256;
-	if (MouseState->MouseY_Value_Delta < -128) MouseState->MouseY_Value_Delta += 256;
-	if (MouseState->MouseY_Value_Delta >  128) MouseState->MouseY_Value_Delta -= 256;	
+	if (MouseX_Delta < -128) MouseX_Delta += 256;
+	if (MouseX_Delta >  128) MouseX_Delta -= 256;
+	if (MouseY_Delta < -128) MouseY_Delta += 256;
+	if (MouseY_Delta >  128) MouseY_Delta -= 256;	
+
+	ApolloMouseApply(MouseState, MouseX_Delta, MouseY_Delta, Left, Right, Middle);
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Moves the pointer and works out the button actions, from a
+				reading of the mouse taken by ApolloMouse or by LIB_Input
+    @ingroup 	ApolloSosurce
+    @param 		MouseState		Pointer to the Mouse state
+    @param 		MouseX_Delta	Counter movement since the last reading
+    @param 		MouseY_Delta	Counter movement since the last reading
+    @param 		Left			Button down
+    @param 		Right			Button down
+    @param 		Middle			Button down
+ --------------------------------------------------------------------------- */
+void ApolloMouseApply(ApolloMouseState *MouseState, int16_t MouseX_Delta, int16_t MouseY_Delta, bool Left, bool Right, bool Middle)
+{
+	MouseState->Button_Left = Left;
+	MouseState->Button_Right = Right;
+	MouseState->Button_Middle = Middle;
+	MouseState->MouseX_Value_Delta = MouseX_Delta;
+	MouseState->MouseY_Value_Delta = MouseY_Delta;
 
 	// Check for Mouse Screen Boundaries
 	if (MouseState->MouseX_Value_Delta != 0 || MouseState->MouseY_Value_Delta != 0)
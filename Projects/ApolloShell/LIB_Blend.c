@@ -0,0 +1,212 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Blend.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Translucency for the 8 bit screen, 256 by 256 blend tables
+	@date		2025-10-26
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The screen is palette indexed, so mixing two pixels means working out
+	the colour between them and finding the palette entry closest to it.
+	That is done once for every pair of entries when the palette is set,
+	into a 64K table per blend, and a translucent pixel is then a single
+	lookup of table[ sprite ][ screen ] (LIB_Sprites_DrawBlended).
+
+	All three blends give the same colour either way round, so only half
+	of each table is searched and the other half is a copy. Searches go
+	through a 15 bit colour cache, most pairs land on a colour already
+	found, so the palette is searched at most once per cache cell rather
+	than once for each of the 98K pairs.
+
+	Entries being cycled are never a result, their colour will not stay.
+	Build the tables again after changing the base palette.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/LIB_Palette.h"
+#include "Includes/LIB_Blend.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define CACHE_SIZE          ( 32768 )   // 5 bits per channel
+#define CACHE_EMPTY         ( 0 )       // entry 0 is transparent, never a result
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Blend control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    bool            bBuilt;
+    uint32_t        Colours[ PALETTE_ENTRIES ];     //!< Base palette at build time
+    uint8_t         Candidates[ PALETTE_ENTRIES ];  //!< Entries a blend may give
+    uint32_t        ulCandidates;
+    uint8_t         Cache[ CACHE_SIZE ];            //!< Nearest entry per 15 bit colour
+
+} BlendCtrl, *pBlendCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static BlendCtrl    sBlend;
+static uint8_t      pTables[ eBlend_Total ][ BLEND_TABLE_SIZE ];
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint32_t Combine( eBlend_t eBlend, uint32_t ulSprite, uint32_t ulScreen );
+static uint8_t  Nearest( uint32_t ulRGB );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Builds every blend table against the current base palette
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Blend_Build( void )
+{
+    sBlend.ulCandidates = 0;
+    for ( uint32_t i = 0; i < PALETTE_ENTRIES; i++ )
+    {
+        sBlend.Colours[ i ] = LIB_Palette_GetColour( i );
+        if ( i != 0 && LIB_Palette_IsCycled( i ) == false )
+        {
+            sBlend.Candidates[ sBlend.ulCandidates++ ] = (uint8_t)i;
+        }
+    }
+    memset( sBlend.Cache, CACHE_EMPTY, sizeof( sBlend.Cache ) );
+
+    for ( uint32_t eBlend = 0; eBlend < eBlend_Total; eBlend++ )
+    {
+        uint8_t* pTable = pTables[ eBlend ];
+
+        // row 0 is never read, sprite pixel 0 is not drawn
+        for ( uint32_t ulScreen = 0; ulScreen < PALETTE_ENTRIES; ulScreen++ )
+        {
+            pTable[ ulScreen ] = (uint8_t)ulScreen;
+        }
+
+        for ( uint32_t ulSprite = 1; ulSprite < PALETTE_ENTRIES; ulSprite++ )
+        {
+            for ( uint32_t ulScreen = 0; ulScreen < PALETTE_ENTRIES; ulScreen++ )
+            {
+                if ( ulScreen != 0 && ulScreen < ulSprite )
+                {
+                    pTable[ ( ulSprite << 8 ) | ulScreen ] = pTable[ ( ulScreen << 8 ) | ulSprite ];
+                    continue;
+                }
+                pTable[ ( ulSprite << 8 ) | ulScreen ] = Nearest( Combine( eBlend, sBlend.Colours[ ulSprite ], sBlend.Colours[ ulScreen ] ) );
+            }
+        }
+    }
+
+    sBlend.bBuilt = true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns a blend table for LIB_Sprites_DrawBlended
+    @ingroup 	MainShell
+    @param      eBlend          - Blend wanted
+    @return     const uint8_t*  - BLEND_TABLE_SIZE bytes, NULL if not built
+ -----------------------------------------------------------------------------*/
+const uint8_t* LIB_Blend_GetTable( eBlend_t eBlend )
+{
+    return ( sBlend.bBuilt == true && eBlend < eBlend_Total ) ? pTables[ eBlend ] : NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Blends two colours
+    @ingroup 	MainShell
+    @param      eBlend          - Blend
+    @param      ulSprite        - Sprite colour, 0x00RRGGBB
+    @param      ulScreen        - Screen colour, 0x00RRGGBB
+    @return     uint32_t        - Result, 0x00RRGGBB
+ -----------------------------------------------------------------------------*/
+static uint32_t Combine( eBlend_t eBlend, uint32_t ulSprite, uint32_t ulScreen )
+{
+    uint32_t ulRGB = 0;
+
+    for ( uint32_t ulShift = 0; ulShift <= 16; ulShift += 8 )
+    {
+        uint32_t a = ( ulSprite >> ulShift ) & 0xFF;
+        uint32_t b = ( ulScreen >> ulShift ) & 0xFF;
+        uint32_t c = 0;
+
+        switch ( eBlend )
+        {
+            case eBlend_Mix:    c = ( a + b ) >> 1;                 break;
+            case eBlend_Darken: c = ( a * b ) / 255;                break;
+            case eBlend_Add:    c = a + b > 255 ? 255 : a + b;      break;
+            default:                                                break;
+        }
+        ulRGB |= c << ulShift;
+    }
+
+    return ulRGB;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Nearest candidate entry to a colour, through the cache
+    @ingroup 	MainShell
+    @param      ulRGB           - 0x00RRGGBB
+    @return     uint8_t         - Entry
+ -----------------------------------------------------------------------------*/
+static uint8_t Nearest( uint32_t ulRGB )
+{
+    uint32_t ulKey      = ( ( ulRGB >> 9 ) & 0x7C00 ) | ( ( ulRGB >> 6 ) & 0x03E0 ) | ( ( ulRGB >> 3 ) & 0x001F );
+    uint32_t ulBestDist = 0xFFFFFFFF;
+    uint8_t  uBest      = sBlend.Cache[ ulKey ];
+    int32_t  lRed       = ( ( ulKey >> 7 ) & 0xF8 ) | 4;    // middle of the cache cell
+    int32_t  lGreen     = ( ( ulKey >> 2 ) & 0xF8 ) | 4;
+    int32_t  lBlue      = ( ( ulKey << 3 ) & 0xF8 ) | 4;
+
+    if ( uBest != CACHE_EMPTY || sBlend.ulCandidates == 0 )
+    {
+        return uBest;
+    }
+
+    for ( uint32_t i = 0; i < sBlend.ulCandidates && ulBestDist != 0; i++ )
+    {
+        uint32_t ulEntry = sBlend.Colours[ sBlend.Candidates[ i ] ];
+        int32_t  dR      = (int32_t)( ( ulEntry >> 16 ) & 0xFF ) - lRed;
+        int32_t  dG      = (int32_t)( ( ulEntry >> 8 ) & 0xFF ) - lGreen;
+        int32_t  dB      = (int32_t)( ulEntry & 0xFF ) - lBlue;
+        uint32_t ulDist  = ( dR * dR * 3 ) + ( dG * dG * 4 ) + ( dB * dB * 2 );
+
+        if ( ulDist < ulBestDist )
+        {
+            uBest      = sBlend.Candidates[ i ];
+            ulBestDist = ulDist;
+        }
+    }
+    sBlend.Cache[ ulKey ] = uBest;
+
+    return uBest;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Blend.c
+//-----------------------------------------------------------------------------
@@ -0,0 +1,588 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Collision.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Uniform grid broadphase and box and pixel collision tests
+	@date		2025-10-31
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The world is cut into 64 pixel cells, 30 by 15 over the 1920x900 map,
+	and each body is linked into every cell its box covers. Only bodies in
+	the same cell are ever tested, so the work follows how crowded the map
+	is rather than the square of the body count.
+
+	The grid is kept, not rebuilt. LIB_Collision_Set is called each tick
+	for each body, most move a pixel or two and stay in the same cells,
+	so only the box is copied. A body that crosses a cell edge has its
+	entries unlinked and linked again, each is in a doubly linked list of
+	its cell and a list of its own, so that is a few pointer writes.
+
+	Two bodies covering several cells together would be found in each of
+	them. A pair is only taken in the first cell both cover, the larger of
+	their two top left cells, so each pair comes out once with no table of
+	pairs seen.
+
+	Candidates are tested box against box, then if asked pixel against
+	pixel. Each sprite image has a 1 bit mask, made the first time it is
+	used from LIB_Sprites_Decode, a set bit for each opaque pixel, bit 31
+	the leftmost. The overlap is tested 32 pixels at a time, the rows of
+	one mask shifted to line up with the other and ANDed. Masks are never
+	freed, a body whose image did not fit is tested by its box.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/FlagStruct.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_Collision.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define NO_ENTRY            ( 0xFFFF )
+#define NO_MASK             ( 0xFFFF )
+#define GRID_CELLS          ( COLLISION_GRID_WIDTH * COLLISION_GRID_HEIGHT )
+#define MASK_SCRATCH        ( 512 * 512 )       // largest image a mask is made for
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	A body, its box and the cells it is linked into
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    bool            bInUse;
+    CollisionBox_t  sBox;
+    uint8_t         ubCellX0;                   //!< Cells covered, inclusive
+    uint8_t         ubCellY0;
+    uint8_t         ubCellX1;
+    uint8_t         ubCellY1;
+    uint16_t        uwFirst;                    //!< First of its entries
+    uint16_t        uwMask;                     //!< Mask of its image, NO_MASK for the box
+
+} CollisionBody_t, *pCollisionBody_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A body in a cell
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint16_t        uwBody;
+    uint16_t        uwCell;
+    uint16_t        uwNext;                     //!< In the cell
+    uint16_t        uwPrev;
+    uint16_t        uwBodyNext;                 //!< The body's next, or the next free
+
+} CollisionEntry_t, *pCollisionEntry_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A sprite image's pixel mask
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    int32_t         lBank;
+    uint32_t        ulFrame;
+    uint32_t        ulWidth;
+    uint32_t        ulHeight;
+    uint32_t        ulLongs;                    //!< A row, one spare so a shifted read stays in it
+    uint32_t        ulOffset;                   //!< Into MaskBits
+
+} CollisionMask_t, *pCollisionMask_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Collision control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    FlagStruct_t        sFlags;
+    CollisionBody_t     Bodies[ COLLISION_MAX_BODIES ];
+    CollisionEntry_t    Entries[ COLLISION_MAX_ENTRIES ];
+    uint16_t            Cells[ GRID_CELLS ];    //!< First entry in each cell
+    uint16_t            uwFree;                 //!< First free entry
+    CollisionMask_t     Masks[ COLLISION_MASKS ];
+    uint32_t            ulMasks;
+    uint32_t            ulMaskUsed;             //!< Longs of MaskBits used
+    uint32_t            MaskBits[ COLLISION_MASK_LONGS ];
+    CollisionStats_t    sStats;
+
+} CollisionCtrl, *pCollisionCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static CollisionCtrl    sCollision;
+static uint8_t          pScratch[ MASK_SCRATCH ];
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void         Unlink( CollisionBody_t* psBody );
+static bool         BoxOverlap( const CollisionBody_t* psA, const CollisionBody_t* psB );
+static bool         PixelOverlap( const CollisionBody_t* psA, const CollisionBody_t* psB );
+static uint16_t     FindMask( int32_t lBank, uint32_t ulFrame );
+static uint32_t     MaskBits( const uint32_t* pRow, uint32_t ulBit );
+static uint32_t     CellOf( int32_t lPos, uint32_t ulCells );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets up an empty grid, the masks made are kept
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Collision_Init( void )
+{
+    if ( sCollision.sFlags.Initialized == false )
+    {
+        memset( &sCollision, 0, sizeof( sCollision ) );
+        sCollision.sFlags.Initialized = true;
+    }
+    LIB_Collision_Clear();
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Removes every body
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Collision_Clear( void )
+{
+    memset( sCollision.Bodies, 0, sizeof( sCollision.Bodies ) );
+    memset( sCollision.Cells, 0xFF, sizeof( sCollision.Cells ) );
+    for ( uint32_t i = 0; i < COLLISION_MAX_ENTRIES; i++ )
+    {
+        sCollision.Entries[ i ].uwBodyNext = ( i + 1 < COLLISION_MAX_ENTRIES ) ? i + 1 : NO_ENTRY;
+    }
+    sCollision.uwFree = 0;
+    memset( &sCollision.sStats, 0, sizeof( sCollision.sStats ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a body or moves it, only relinked when its cells change
+    @ingroup 	MainShell
+    @param      ulBody          - Body, below COLLISION_MAX_BODIES
+    @param      psBox           - Where it is
+    @return     bool            - false if it is out of range or there were
+                                  not the entries for its cells, it is then
+                                  not in the grid
+ -----------------------------------------------------------------------------*/
+bool LIB_Collision_Set( uint32_t ulBody, const CollisionBox_t* psBox )
+{
+    if ( sCollision.sFlags.Initialized == false || ulBody >= COLLISION_MAX_BODIES || psBox == NULL )
+    {
+        return false;
+    }
+
+    CollisionBody_t* psBody = &sCollision.Bodies[ ulBody ];
+    int32_t          w      = psBox->w > 0 ? psBox->w : 1;
+    int32_t          h      = psBox->h > 0 ? psBox->h : 1;
+    uint8_t          ubX0   = CellOf( psBox->x, COLLISION_GRID_WIDTH );
+    uint8_t          ubY0   = CellOf( psBox->y, COLLISION_GRID_HEIGHT );
+    uint8_t          ubX1   = CellOf( psBox->x + w - 1, COLLISION_GRID_WIDTH );
+    uint8_t          ubY1   = CellOf( psBox->y + h - 1, COLLISION_GRID_HEIGHT );
+
+    // the mask only changes with the image
+    if ( psBody->bInUse == false || psBox->lBank != psBody->sBox.lBank || psBox->ulFrame != psBody->sBox.ulFrame )
+    {
+        psBody->uwMask = ( psBox->lBank == COLLISION_NO_IMAGE ) ? NO_MASK : FindMask( psBox->lBank, psBox->ulFrame );
+    }
+    psBody->sBox   = *psBox;
+    psBody->sBox.w = w;
+    psBody->sBox.h = h;
+
+    if ( psBody->bInUse == true && ubX0 == psBody->ubCellX0 && ubY0 == psBody->ubCellY0 && ubX1 == psBody->ubCellX1 && ubY1 == psBody->ubCellY1 )
+    {
+        return true;
+    }
+
+    Unlink( psBody );
+    if ( sCollision.sStats.ulEntries + ( ubX1 - ubX0 + 1 ) * ( ubY1 - ubY0 + 1 ) > COLLISION_MAX_ENTRIES )
+    {
+        return false;
+    }
+
+    psBody->uwFirst  = NO_ENTRY;
+    psBody->ubCellX0 = ubX0;
+    psBody->ubCellY0 = ubY0;
+    psBody->ubCellX1 = ubX1;
+    psBody->ubCellY1 = ubY1;
+    for ( uint32_t y = ubY0; y <= ubY1; y++ )
+    {
+        for ( uint32_t x = ubX0; x <= ubX1; x++ )
+        {
+            uint16_t          uwCell  = y * COLLISION_GRID_WIDTH + x;
+            uint16_t          uwEntry = sCollision.uwFree;
+            CollisionEntry_t* psEntry = &sCollision.Entries[ uwEntry ];
+
+            sCollision.uwFree = psEntry->uwBodyNext;
+            psEntry->uwBody     = ulBody;
+            psEntry->uwCell     = uwCell;
+            psEntry->uwPrev     = NO_ENTRY;
+            psEntry->uwNext     = sCollision.Cells[ uwCell ];
+            psEntry->uwBodyNext = psBody->uwFirst;
+            if ( psEntry->uwNext != NO_ENTRY )
+            {
+                sCollision.Entries[ psEntry->uwNext ].uwPrev = uwEntry;
+            }
+            sCollision.Cells[ uwCell ] = uwEntry;
+            psBody->uwFirst = uwEntry;
+        }
+    }
+    sCollision.sStats.ulEntries += ( ubX1 - ubX0 + 1 ) * ( ubY1 - ubY0 + 1 );
+    sCollision.sStats.ulBodies++;
+    sCollision.sStats.ulRebinned++;
+    psBody->bInUse = true;
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes a body out of the grid, nothing if it is not in it
+    @ingroup 	MainShell
+    @param      ulBody          - Body
+ -----------------------------------------------------------------------------*/
+void LIB_Collision_Remove( uint32_t ulBody )
+{
+    if ( ulBody < COLLISION_MAX_BODIES )
+    {
+        Unlink( &sCollision.Bodies[ ulBody ] );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Tests two bodies against each other
+    @ingroup 	MainShell
+    @param      ulA, ulB        - Bodies
+    @param      bPixels         - Test the pixels where the boxes overlap
+    @return     bool            - true if they touch
+ -----------------------------------------------------------------------------*/
+bool LIB_Collision_Test( uint32_t ulA, uint32_t ulB, bool bPixels )
+{
+    if ( ulA >= COLLISION_MAX_BODIES || ulB >= COLLISION_MAX_BODIES || ulA == ulB )
+    {
+        return false;
+    }
+
+    const CollisionBody_t* psA = &sCollision.Bodies[ ulA ];
+    const CollisionBody_t* psB = &sCollision.Bodies[ ulB ];
+
+    return psA->bInUse && psB->bInUse && BoxOverlap( psA, psB ) && ( bPixels == false || PixelOverlap( psA, psB ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Finds the bodies touching, each pair once
+    @ingroup 	MainShell
+    @param      psPairs         - Filled in, lower body first
+    @param      ulMax           - Room in psPairs, pairs past it are counted
+                                  in the stats but not returned
+    @param      bPixels         - Test the pixels where the boxes overlap
+    @return     uint32_t        - Pairs in psPairs
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Collision_FindPairs( CollisionPair_t* psPairs, uint32_t ulMax, bool bPixels )
+{
+    CollisionStats_t* psStats = &sCollision.sStats;
+
+    psStats->ulCandidates = 0;
+    psStats->ulBoxHits    = 0;
+    psStats->ulPixelHits  = 0;
+    psStats->ulPairs      = 0;
+    if ( psPairs == NULL )
+    {
+        ulMax = 0;
+    }
+
+    for ( uint32_t ulCell = 0; ulCell < GRID_CELLS; ulCell++ )
+    {
+        for ( uint16_t uwA = sCollision.Cells[ ulCell ]; uwA != NO_ENTRY; uwA = sCollision.Entries[ uwA ].uwNext )
+        {
+            uint16_t               uwBodyA = sCollision.Entries[ uwA ].uwBody;
+            const CollisionBody_t* psA     = &sCollision.Bodies[ uwBodyA ];
+
+            for ( uint16_t uwB = sCollision.Entries[ uwA ].uwNext; uwB != NO_ENTRY; uwB = sCollision.Entries[ uwB ].uwNext )
+            {
+                uint16_t               uwBodyB = sCollision.Entries[ uwB ].uwBody;
+                const CollisionBody_t* psB     = &sCollision.Bodies[ uwBodyB ];
+                uint32_t               ulX     = psA->ubCellX0 > psB->ubCellX0 ? psA->ubCellX0 : psB->ubCellX0;
+                uint32_t               ulY     = psA->ubCellY0 > psB->ubCellY0 ? psA->ubCellY0 : psB->ubCellY0;
+
+                // only in the first cell the two share
+                if ( ulY * COLLISION_GRID_WIDTH + ulX != ulCell )
+                {
+                    continue;
+                }
+                psStats->ulCandidates++;
+                if ( BoxOverlap( psA, psB ) == false )
+                {
+                    continue;
+                }
+                psStats->ulBoxHits++;
+                if ( bPixels == true )
+                {
+                    if ( PixelOverlap( psA, psB ) == false )
+                    {
+                        continue;
+                    }
+                    psStats->ulPixelHits++;
+                }
+                if ( psStats->ulPairs < ulMax )
+                {
+                    psPairs[ psStats->ulPairs ].uwA = uwBodyA < uwBodyB ? uwBodyA : uwBodyB;
+                    psPairs[ psStats->ulPairs ].uwB = uwBodyA < uwBodyB ? uwBodyB : uwBodyA;
+                    psStats->ulPairs++;
+                }
+            }
+        }
+    }
+
+    return psStats->ulPairs;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the counts of the last LIB_Collision_FindPairs, the
+                rebinned count is then started again
+    @ingroup 	MainShell
+    @param      psStats         - Filled in
+ -----------------------------------------------------------------------------*/
+void LIB_Collision_GetStats( CollisionStats_t* psStats )
+{
+    if ( psStats != NULL )
+    {
+        *psStats = sCollision.sStats;
+    }
+    sCollision.sStats.ulRebinned = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Unlinks a body's entries from their cells and frees them
+    @ingroup 	MainShell
+    @param      psBody          - Body
+ -----------------------------------------------------------------------------*/
+static void Unlink( CollisionBody_t* psBody )
+{
+    if ( psBody->bInUse == false )
+    {
+        return;
+    }
+
+    uint16_t uwEntry = psBody->uwFirst;
+
+    while ( uwEntry != NO_ENTRY )
+    {
+        CollisionEntry_t* psEntry = &sCollision.Entries[ uwEntry ];
+        uint16_t          uwNext  = psEntry->uwBodyNext;
+
+        if ( psEntry->uwPrev != NO_ENTRY )
+        {
+            sCollision.Entries[ psEntry->uwPrev ].uwNext = psEntry->uwNext;
+        }
+        else
+        {
+            sCollision.Cells[ psEntry->uwCell ] = psEntry->uwNext;
+        }
+        if ( psEntry->uwNext != NO_ENTRY )
+        {
+            sCollision.Entries[ psEntry->uwNext ].uwPrev = psEntry->uwPrev;
+        }
+        psEntry->uwBodyNext = sCollision.uwFree;
+        sCollision.uwFree   = uwEntry;
+        sCollision.sStats.ulEntries--;
+        uwEntry = uwNext;
+    }
+
+    psBody->uwFirst = NO_ENTRY;
+    psBody->bInUse  = false;
+    sCollision.sStats.ulBodies--;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Box against box
+    @ingroup 	MainShell
+    @param      psA, psB        - Bodies
+    @return     bool            - true if they overlap
+ -----------------------------------------------------------------------------*/
+static bool BoxOverlap( const CollisionBody_t* psA, const CollisionBody_t* psB )
+{
+    return psA->sBox.x < psB->sBox.x + psB->sBox.w && psB->sBox.x < psA->sBox.x + psA->sBox.w &&
+           psA->sBox.y < psB->sBox.y + psB->sBox.h && psB->sBox.y < psA->sBox.y + psA->sBox.h;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Pixel against pixel where the boxes and images overlap, a
+                body with no mask is solid over its box
+    @ingroup 	MainShell
+    @param      psA, psB        - Bodies, their boxes overlapping
+    @return     bool            - true if an opaque pixel of each is in the
+                                  same place
+ -----------------------------------------------------------------------------*/
+static bool PixelOverlap( const CollisionBody_t* psA, const CollisionBody_t* psB )
+{
+    const CollisionBody_t* psBody[ 2 ] = { psA, psB };
+    const CollisionMask_t* psMask[ 2 ];
+    int32_t                x0 = psA->sBox.x > psB->sBox.x ? psA->sBox.x : psB->sBox.x;
+    int32_t                y0 = psA->sBox.y > psB->sBox.y ? psA->sBox.y : psB->sBox.y;
+    int32_t                x1 = psA->sBox.x + psA->sBox.w < psB->sBox.x + psB->sBox.w ? psA->sBox.x + psA->sBox.w : psB->sBox.x + psB->sBox.w;
+    int32_t                y1 = psA->sBox.y + psA->sBox.h < psB->sBox.y + psB->sBox.h ? psA->sBox.y + psA->sBox.h : psB->sBox.y + psB->sBox.h;
+
+    if ( psA->uwMask == NO_MASK && psB->uwMask == NO_MASK )
+    {
+        return true;
+    }
+
+    // off its image a body with a mask has no pixels
+    for ( uint32_t i = 0; i < 2; i++ )
+    {
+        psMask[ i ] = NULL;
+        if ( psBody[ i ]->uwMask != NO_MASK )
+        {
+            psMask[ i ] = &sCollision.Masks[ psBody[ i ]->uwMask ];
+            if ( x0 < psBody[ i ]->sBox.lImageX ) x0 = psBody[ i ]->sBox.lImageX;
+            if ( y0 < psBody[ i ]->sBox.lImageY ) y0 = psBody[ i ]->sBox.lImageY;
+            if ( x1 > psBody[ i ]->sBox.lImageX + (int32_t)psMask[ i ]->ulWidth )  x1 = psBody[ i ]->sBox.lImageX + psMask[ i ]->ulWidth;
+            if ( y1 > psBody[ i ]->sBox.lImageY + (int32_t)psMask[ i ]->ulHeight ) y1 = psBody[ i ]->sBox.lImageY + psMask[ i ]->ulHeight;
+        }
+    }
+
+    for ( int32_t y = y0; y < y1; y++ )
+    {
+        const uint32_t* pRow[ 2 ];
+        uint32_t        ulBit[ 2 ];
+
+        for ( uint32_t i = 0; i < 2; i++ )
+        {
+            if ( psMask[ i ] != NULL )
+            {
+                pRow[ i ]  = &sCollision.MaskBits[ psMask[ i ]->ulOffset + ( y - psBody[ i ]->sBox.lImageY ) * psMask[ i ]->ulLongs ];
+                ulBit[ i ] = x0 - psBody[ i ]->sBox.lImageX;
+            }
+        }
+
+        for ( int32_t x = x0; x < x1; x += 32 )
+        {
+            uint32_t ulBits = ( x1 - x >= 32 ) ? 0xFFFFFFFF : ~( 0xFFFFFFFF >> ( x1 - x ) );
+            uint32_t ulOff  = x - x0;
+
+            if ( psMask[ 0 ] != NULL ) ulBits &= MaskBits( pRow[ 0 ], ulBit[ 0 ] + ulOff );
+            if ( psMask[ 1 ] != NULL ) ulBits &= MaskBits( pRow[ 1 ], ulBit[ 1 ] + ulOff );
+            if ( ulBits != 0 )
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Finds the mask of a sprite image, made the first time
+    @ingroup 	MainShell
+    @param      lBank           - Sprite bank
+    @param      ulFrame         - Sprite number
+    @return     uint16_t        - Mask, NO_MASK if it could not be made
+ -----------------------------------------------------------------------------*/
+static uint16_t FindMask( int32_t lBank, uint32_t ulFrame )
+{
+    for ( uint32_t i = 0; i < sCollision.ulMasks; i++ )
+    {
+        if ( sCollision.Masks[ i ].lBank == lBank && sCollision.Masks[ i ].ulFrame == ulFrame )
+        {
+            return i;
+        }
+    }
+
+    uint32_t ulWidth  = LIB_Sprites_GetWidth( (eSpriteBank_t)lBank );
+    uint32_t ulHeight = LIB_Sprites_GetHeight( (eSpriteBank_t)lBank );
+    uint32_t ulLongs  = ( ( ulWidth + 31 ) >> 5 ) + 1;
+
+    if ( sCollision.ulMasks >= COLLISION_MASKS || ulWidth == 0 || ulHeight == 0 || ulWidth * ulHeight > MASK_SCRATCH ||
+         sCollision.ulMaskUsed + ulLongs * ulHeight > COLLISION_MASK_LONGS )
+    {
+        return NO_MASK;
+    }
+
+    memset( pScratch, 0, ulWidth * ulHeight );
+    if ( LIB_Sprites_Decode( (eSpriteBank_t)lBank, ulFrame, pScratch, ulWidth ) == false )
+    {
+        return NO_MASK;
+    }
+
+    CollisionMask_t* psMask = &sCollision.Masks[ sCollision.ulMasks ];
+    uint32_t*        pBits  = &sCollision.MaskBits[ sCollision.ulMaskUsed ];
+    const uint8_t*   pPixel = pScratch;
+
+    psMask->lBank    = lBank;
+    psMask->ulFrame  = ulFrame;
+    psMask->ulWidth  = ulWidth;
+    psMask->ulHeight = ulHeight;
+    psMask->ulLongs  = ulLongs;
+    psMask->ulOffset = sCollision.ulMaskUsed;
+    memset( pBits, 0, ulLongs * ulHeight * sizeof( uint32_t ) );
+    for ( uint32_t y = 0; y < ulHeight; y++, pBits += ulLongs )
+    {
+        for ( uint32_t x = 0; x < ulWidth; x++, pPixel++ )
+        {
+            if ( *pPixel != 0 )
+            {
+                pBits[ x >> 5 ] |= 0x80000000 >> ( x & 31 );
+            }
+        }
+    }
+    sCollision.ulMaskUsed += ulLongs * ulHeight;
+    return sCollision.ulMasks++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		32 pixels of a mask row from any pixel, the first in bit 31
+    @ingroup 	MainShell
+    @param      pRow            - Mask row
+    @param      ulBit           - First pixel, inside the row
+    @return     uint32_t        - The bits
+ -----------------------------------------------------------------------------*/
+static uint32_t MaskBits( const uint32_t* pRow, uint32_t ulBit )
+{
+    uint32_t ulShift = ulBit & 31;
+
+    pRow += ulBit >> 5;
+    return ulShift == 0 ? pRow[ 0 ] : ( pRow[ 0 ] << ulShift ) | ( pRow[ 1 ] >> ( 32 - ulShift ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		The cell a world position is in, kept on the grid
+    @ingroup 	MainShell
+    @param      lPos            - World x or y
+    @param      ulCells         - Cells across or down
+    @return     uint32_t        - Cell column or row
+ -----------------------------------------------------------------------------*/
+static uint32_t CellOf( int32_t lPos, uint32_t ulCells )
+{
+    if ( lPos < 0 )
+    {
+        return 0;
+    }
+    lPos >>= COLLISION_CELL_SHIFT;
+    return (uint32_t)lPos < ulCells ? (uint32_t)lPos : ulCells - 1;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Collision.c
+//-----------------------------------------------------------------------------
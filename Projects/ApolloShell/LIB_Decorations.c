@@ -0,0 +1,432 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Decorations.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Terrain decoration placement, stamped in at generation time
+	@date		2025-10-24
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The sprites of the terrain set (trees, snowmen, presents...) are placed
+	once per map and stamped into the terrain buffer and the solidity mask,
+	so they cost nothing per frame and can be blown apart like the ground.
+
+	Placement is Poisson disc by dart throwing. A dart is a random column
+	and row, turned into either a surface spot (scan down to the first air
+	to solid edge, which also finds cave floors) or a buried spot (the
+	whole sprite inside solid ground). A spot is kept if no decoration
+	centre is within DECORATION_SPACING of it. The check uses a grid of
+	cells DECORATION_SPACING / sqrt(2) across, small enough that a cell
+	holds at most one centre, so only the 5x5 cells around the spot are
+	looked at.
+
+	Darts come from a generator seeded with the map seed, so a map always
+	gets the same decorations, including when it comes from the map cache
+	(which holds the map undecorated).
+
+	Sprite pixels are shifted into the terrain set's palette range the
+	same way the set's RAW files are on load.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/ResourceFiles.h"
+#include "Includes/ResourceHandling.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_Terrain.h"
+#include "Includes/LIB_TerrainMask.h"
+#include "Includes/LIB_Decorations.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MAX_CANDIDATES      ( 32 )
+#define GRID_CELL           ( 101 )     // DECORATION_SPACING / sqrt(2), rounded down
+#define GRID_REACH          ( 2 )       // cells either side that can be within the spacing
+#define GRID_WIDTH          ( 32 )      // cells, covers maps up to 3232 x 1616
+#define GRID_HEIGHT         ( 16 )
+#define GRID_EMPTY          ( 0xFF )
+#define SURFACE_SINK        ( 6 )       // rows a surface decoration is pushed into the ground
+#define TOP_MARGIN          ( 48 )      // rows kept clear at the top of the map
+#define BURIED_MAX_SIZE     ( 128 )     // largest sprite buried in solid ground
+#define BURIED_EVERY        ( 3 )       // one dart in this many is a buried one
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	A sprite that can be used as a decoration
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t    ulBank;             //!< Sprite bank, same as the resource ID
+    uint32_t    ulWidth;
+    uint32_t    ulHeight;
+
+} Decoration_t, *pDecoration_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Decoration placement control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    Decoration_t    Candidates[ MAX_CANDIDATES ];   //!< Usable sprites of the terrain set
+    uint32_t        ulCandidates;                   //!< Entries in Candidates
+    uint32_t        ulBuriedCandidates;             //!< Of those, small enough to bury
+    uint32_t        ulRemap;                        //!< Added to sprite pixels
+    uint32_t        ulRandom;                       //!< Dart generator state
+    uint32_t        ulDarts;                        //!< Darts thrown for this map
+    uint32_t        ulPlaced;                       //!< Decorations placed for this map
+    int16_t         CentreX[ DECORATION_MAX ];      //!< Centres of those placed
+    int16_t         CentreY[ DECORATION_MAX ];
+    uint8_t         Grid[ GRID_HEIGHT ][ GRID_WIDTH ];  //!< Index of the centre in each cell
+    TerrainMask_t*  psMask;                         //!< Mask being decorated
+    uint8_t*        pBuffer;                        //!< Terrain, psMask->ulWidth bytes per row
+
+} DecorationCtrl, *pDecorationCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static DecorationCtrl   sDecor = { .ulCandidates = 0 };
+static uint8_t          pScratch[ DECORATION_MAX_WIDTH * DECORATION_MAX_HEIGHT ];
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint32_t Random( void );
+static bool     IsClear( int32_t x, int32_t y );
+static void     AddCentre( int32_t x, int32_t y );
+static bool     FindSurfaceSpot( const Decoration_t* psDecor, int32_t* pX, int32_t* pY );
+static bool     FindBuriedSpot( const Decoration_t* psDecor, int32_t* pX, int32_t* pY );
+static void     Stamp( const Decoration_t* psDecor, int32_t x, int32_t y );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Picks out the decoration sprites of a terrain set, after the
+                resource groups are loaded. Bridges and debris are left out,
+                as are sprites bigger than DECORATION_MAX_WIDTH x HEIGHT.
+    @ingroup 	MainShell
+    @param      ulTerrainSet    - Resource group of the terrain
+    @return     uint32_t        - Sprites found
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Decorations_Init( uint32_t ulTerrainSet )
+{
+    psFileDetails psFile  = theFileGroups[ ulTerrainSet ].psFileDetails;
+    uint32_t      ulBank  = ResourceHandling_GetGroupStartResource( ulTerrainSet );
+    uint32_t      ulData  = 0;
+
+    sDecor.ulCandidates       = 0;
+    sDecor.ulBuriedCandidates = 0;
+    sDecor.ulRemap            = theFileGroups[ ulTerrainSet ].reMapValue ? theFileGroups[ ulTerrainSet ].reMapValue - 1 : 0;
+
+    while ( psFile->pszResourceName != NULL && sDecor.ulCandidates < MAX_CANDIDATES )
+    {
+        ulData = 0;
+        ResourceHandling_Get( ulBank, eResourceGet_Data, &ulData );
+
+        if ( psFile->eFileType == eSPR && ulData != 0 &&
+             strncmp( (char*)psFile->pszResourceName, "bridge", 6 ) != 0 &&
+             strncmp( (char*)psFile->pszResourceName, "debris", 6 ) != 0 &&
+             psFile->ulWidth <= DECORATION_MAX_WIDTH && psFile->ulHeight <= DECORATION_MAX_HEIGHT )
+        {
+            Decoration_t sEntry = { .ulBank = ulBank, .ulWidth = psFile->ulWidth, .ulHeight = psFile->ulHeight };
+
+            // buried ones are kept at the front
+            if ( sEntry.ulWidth <= BURIED_MAX_SIZE && sEntry.ulHeight <= BURIED_MAX_SIZE )
+            {
+                sDecor.Candidates[ sDecor.ulCandidates ] = sDecor.Candidates[ sDecor.ulBuriedCandidates ];
+                sDecor.Candidates[ sDecor.ulBuriedCandidates++ ] = sEntry;
+            }
+            else
+            {
+                sDecor.Candidates[ sDecor.ulCandidates ] = sEntry;
+            }
+            sDecor.ulCandidates++;
+        }
+        ulBank++;
+        psFile++;
+    }
+
+    return sDecor.ulCandidates;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Starts decorating a newly built map
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed, the same seed gives the same placement
+    @param      psMask          - Solidity mask of the map, updated as sprites go in
+    @param      pBuffer         - Terrain buffer, psMask->ulWidth bytes per row
+ -----------------------------------------------------------------------------*/
+void LIB_Decorations_Begin( uint32_t ulSeed, TerrainMask_t* psMask, uint8_t* pBuffer )
+{
+    sDecor.ulRandom = ( ulSeed ^ 0x5DEC0A7E ) | 1;
+    sDecor.ulDarts  = 0;
+    sDecor.ulPlaced = 0;
+    sDecor.psMask   = psMask;
+    sDecor.pBuffer  = pBuffer;
+    memset( sDecor.Grid, GRID_EMPTY, sizeof( sDecor.Grid ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Throws some darts, stamping in the decorations they place
+    @ingroup 	MainShell
+    @param      ulDarts         - Darts to throw this call
+    @return     bool            - true once DECORATION_DARTS have been thrown
+                                  or DECORATION_MAX placed
+ -----------------------------------------------------------------------------*/
+bool LIB_Decorations_Place( uint32_t ulDarts )
+{
+    if ( sDecor.ulCandidates == 0 )
+    {
+        sDecor.ulDarts = DECORATION_DARTS;
+    }
+
+    while ( ulDarts-- != 0 && sDecor.ulDarts < DECORATION_DARTS && sDecor.ulPlaced < DECORATION_MAX )
+    {
+        bool    bBuried = ( sDecor.ulDarts % BURIED_EVERY ) == BURIED_EVERY - 1 && sDecor.ulBuriedCandidates != 0;
+        int32_t x       = 0;
+        int32_t y       = 0;
+        bool    bFound  = false;
+        const Decoration_t* psDecor = bBuried ? &sDecor.Candidates[ Random() % sDecor.ulBuriedCandidates ]
+                                              : &sDecor.Candidates[ Random() % sDecor.ulCandidates ];
+
+        x = Random() % sDecor.psMask->ulWidth;
+        y = Random() % sDecor.psMask->ulHeight;
+        sDecor.ulDarts++;
+
+        bFound = bBuried ? FindBuriedSpot( psDecor, &x, &y ) : FindSurfaceSpot( psDecor, &x, &y );
+
+        // x, y is now the top left of the sprite
+        if ( bFound == true && IsClear( x + psDecor->ulWidth / 2, y + psDecor->ulHeight / 2 ) == true )
+        {
+            AddCentre( x + psDecor->ulWidth / 2, y + psDecor->ulHeight / 2 );
+            Stamp( psDecor, x, y );
+        }
+    }
+
+    return sDecor.ulDarts >= DECORATION_DARTS || sDecor.ulPlaced >= DECORATION_MAX;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Decorations placed on the current map
+    @ingroup 	MainShell
+    @return     uint32_t        - count
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Decorations_GetCount( void )
+{
+    return sDecor.ulPlaced;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Next dart value, xorshift
+    @ingroup 	MainShell
+    @return     uint32_t        - random value
+ -----------------------------------------------------------------------------*/
+static uint32_t Random( void )
+{
+    sDecor.ulRandom ^= sDecor.ulRandom << 13;
+    sDecor.ulRandom ^= sDecor.ulRandom >> 17;
+    sDecor.ulRandom ^= sDecor.ulRandom << 5;
+    return sDecor.ulRandom;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is a centre far enough from all those placed
+    @ingroup 	MainShell
+    @param      x               - Column
+    @param      y               - Row
+    @return     bool            - true if nothing is within DECORATION_SPACING
+ -----------------------------------------------------------------------------*/
+static bool IsClear( int32_t x, int32_t y )
+{
+    int32_t cx = x / GRID_CELL;
+    int32_t cy = y / GRID_CELL;
+
+    if ( cx >= GRID_WIDTH || cy >= GRID_HEIGHT )
+    {
+        return false;
+    }
+
+    for ( int32_t gy = cy - GRID_REACH; gy <= cy + GRID_REACH; gy++ )
+    {
+        for ( int32_t gx = cx - GRID_REACH; gx <= cx + GRID_REACH; gx++ )
+        {
+            if ( gx < 0 || gy < 0 || gx >= GRID_WIDTH || gy >= GRID_HEIGHT || sDecor.Grid[ gy ][ gx ] == GRID_EMPTY )
+            {
+                continue;
+            }
+
+            int32_t dx = sDecor.CentreX[ sDecor.Grid[ gy ][ gx ] ] - x;
+            int32_t dy = sDecor.CentreY[ sDecor.Grid[ gy ][ gx ] ] - y;
+
+            if ( ( dx * dx ) + ( dy * dy ) < DECORATION_SPACING * DECORATION_SPACING )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Records a placed centre in the list and the grid
+    @ingroup 	MainShell
+    @param      x               - Column
+    @param      y               - Row
+ -----------------------------------------------------------------------------*/
+static void AddCentre( int32_t x, int32_t y )
+{
+    sDecor.CentreX[ sDecor.ulPlaced ] = x;
+    sDecor.CentreY[ sDecor.ulPlaced ] = y;
+    sDecor.Grid[ y / GRID_CELL ][ x / GRID_CELL ] = sDecor.ulPlaced;
+    sDecor.ulPlaced++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Turns a dart into a spot standing on the ground, the first
+                air to solid edge at or below the dart
+    @ingroup 	MainShell
+    @param      psDecor         - Sprite to place
+    @param      pX              - In, dart column. Out, sprite left edge
+    @param      pY              - In, dart row. Out, sprite top edge
+    @return     bool            - true if the sprite fits there
+ -----------------------------------------------------------------------------*/
+static bool FindSurfaceSpot( const Decoration_t* psDecor, int32_t* pX, int32_t* pY )
+{
+    const TerrainMask_t* psMask = sDecor.psMask;
+    int32_t x      = *pX;
+    int32_t y      = *pY;
+    int32_t w      = psDecor->ulWidth;
+    int32_t h      = psDecor->ulHeight;
+    bool    bAir   = false;
+
+    for ( ; y < (int32_t)psMask->ulHeight; y++ )
+    {
+        bool bSolid = LIB_TerrainMask_IsSolid( psMask, x, y );
+
+        if ( bSolid == true && bAir == true )
+        {
+            break;
+        }
+        bAir = !bSolid;
+    }
+
+    int32_t left   = x - ( w / 2 );
+    int32_t base   = y + SURFACE_SINK;
+    int32_t top    = base - h;
+
+    if ( y >= (int32_t)psMask->ulHeight || left < 0 || left + w > (int32_t)psMask->ulWidth || top < TOP_MARGIN || base >= (int32_t)psMask->ulHeight )
+    {
+        return false;
+    }
+
+    // standing on something at both quarters, clear air at the top
+    if ( LIB_TerrainMask_IsSolid( psMask, left + ( w / 4 ), base ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, left + ( 3 * w / 4 ), base ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, left, top ) == true ||
+         LIB_TerrainMask_IsSolid( psMask, left + w - 1, top ) == true ||
+         LIB_TerrainMask_IsSolid( psMask, x, top ) == true ||
+         LIB_TerrainMask_IsSolid( psMask, x, top + ( h / 2 ) ) == true )
+    {
+        return false;
+    }
+
+    *pX = left;
+    *pY = top;
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Turns a dart into a spot wholly inside solid ground, the dart
+                being the sprite centre
+    @ingroup 	MainShell
+    @param      psDecor         - Sprite to place
+    @param      pX              - In, dart column. Out, sprite left edge
+    @param      pY              - In, dart row. Out, sprite top edge
+    @return     bool            - true if the corners and centre are all solid
+ -----------------------------------------------------------------------------*/
+static bool FindBuriedSpot( const Decoration_t* psDecor, int32_t* pX, int32_t* pY )
+{
+    const TerrainMask_t* psMask = sDecor.psMask;
+    int32_t left   = *pX - ( psDecor->ulWidth / 2 );
+    int32_t top    = *pY - ( psDecor->ulHeight / 2 );
+    int32_t right  = left + psDecor->ulWidth - 1;
+    int32_t bottom = top + psDecor->ulHeight - 1;
+
+    // IsSolid is false off the map, so this also keeps it on the map
+    if ( LIB_TerrainMask_IsSolid( psMask, left, top ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, right, top ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, left, bottom ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, right, bottom ) == false ||
+         LIB_TerrainMask_IsSolid( psMask, *pX, *pY ) == false )
+    {
+        return false;
+    }
+
+    *pX = left;
+    *pY = top;
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws a decoration into the terrain buffer and the mask
+    @ingroup 	MainShell
+    @param      psDecor         - Sprite
+    @param      x               - Left edge, the sprite is on the map
+    @param      y               - Top edge
+ -----------------------------------------------------------------------------*/
+static void Stamp( const Decoration_t* psDecor, int32_t x, int32_t y )
+{
+    uint32_t ulWidth  = psDecor->ulWidth;
+    uint32_t ulHeight = psDecor->ulHeight;
+    uint8_t* pSrc     = pScratch;
+
+    memset( pScratch, 0, ulWidth * ulHeight );
+    if ( LIB_Sprites_Decode( psDecor->ulBank, 0, pScratch, ulWidth ) == false )
+    {
+        return;
+    }
+
+    for ( uint32_t dy = 0; dy < ulHeight; dy++ )
+    {
+        uint8_t* pDest = sDecor.pBuffer + ( ( y + dy ) * sDecor.psMask->ulWidth ) + x;
+
+        for ( uint32_t dx = 0; dx < ulWidth; dx++ )
+        {
+            if ( *pSrc != 0 )
+            {
+                *pDest = *pSrc + sDecor.ulRemap;
+            }
+            pSrc++;
+            pDest++;
+        }
+    }
+
+    LIB_TerrainMask_Stamp( sDecor.psMask, x, y, pScratch, ulWidth, ulHeight, ulWidth );
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Decorations.c
+//-----------------------------------------------------------------------------
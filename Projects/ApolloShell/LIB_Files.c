@@ -17,6 +17,7 @@
 #include "stdint.h"
 #include "stdbool.h"
 #include "stdio.h"
+#include "stdlib.h"
 #include "Includes/ResourceFiles.h"
 #include "Includes/ResourceHandling.h"
 #include "Includes/LIB_Files.h"
@@ -0,0 +1,457 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Hud.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		HUD widget tree, only changed widgets are redrawn per screen
+	@date		2025-10-27
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The HUD lives in the rows the map copy never touches, above row 42 and
+	from row 402 down, so what is drawn there stays in that screen until
+	it is drawn over. With three screens in turn, a change has to be drawn
+	three times, once into each, and nothing else needs drawing at all.
+
+	Widgets form a tree, a child is placed relative to its parent and is
+	drawn after it. Each widget has a version, set from a counter when it
+	changes, and the version last drawn into each screen. LIB_Hud_Draw
+	draws a widget into the screen being built when the two differ, or
+	when its parent has just been drawn over it.
+
+	Panels, and bars with an empty colour, cover their whole area. Labels
+	and icons do not, the old text would show through, so a change to
+	one of them moves its nearest covering ancestor on instead and that
+	whole branch is drawn again. Give labels and icons a panel parent.
+
+	Widgets are added parents first and never removed, the array order is
+	the draw order.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/HWScreen.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_Text.h"
+#include "Includes/LIB_Hud.h"
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	One widget
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    eHudWidget_t    eType;
+    int32_t         lParent;
+    int32_t         x;                              //!< Screen position
+    int32_t         y;
+    bool            bCovers;                        //!< Draws over all of its area
+    bool            bFlipped;
+    uint32_t        ulBank;
+    uint32_t        ulValue;                        //!< Bar value or icon frame
+    uint32_t        ulMax;                          //!< Bar full value
+    uint8_t         uEmpty;                         //!< Bar colour past the value, 0 for none
+    eTextFont_t     eFont;
+    int32_t         lColour;
+    char            Text[ HUD_LABEL_LENGTH + 1 ];
+    uint32_t        ulVersion;
+    uint32_t        Drawn[ HUD_BUFFERS ];           //!< Version in each screen
+
+} HudWidget_t, *pHudWidget_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	HUD control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    HudWidget_t     Widgets[ HUD_MAX_WIDGETS ];
+    uint32_t        ulWidgets;
+    uint32_t        ulStamp;                        //!< Last version given out
+    uint8_t*        Buffers[ HUD_BUFFERS ];         //!< Screens seen, in the order found
+
+} HudCtrl, *pHudCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static HudCtrl sHud;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static int32_t  AddWidget( eHudWidget_t eType, int32_t lParent, int32_t x, int32_t y );
+static void     Changed( int32_t lWidget );
+static int32_t  BufferSlot( uint8_t* pScreen );
+static void     DrawWidget( HudWidget_t* psWidget, uint8_t* pScreen );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Clears the widget tree
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Hud_Init( void )
+{
+    memset( &sHud, 0, sizeof( sHud ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a sprite that covers its area, a panel or background
+    @ingroup 	MainShell
+    @param      lParent         - Parent widget, or HUD_NO_PARENT
+    @param      x               - X from the parent, or the screen
+    @param      y               - Y from the parent, or the screen
+    @param      ulBank          - Sprite bank
+    @param      ulFrame         - Frame
+    @param      bFlipped        - Drawn mirrored
+    @return     int32_t         - Widget, -1 if full
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Hud_AddPanel( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulFrame, bool bFlipped )
+{
+    int32_t lWidget = AddWidget( eHudWidget_Panel, lParent, x, y );
+
+    if ( lWidget >= 0 )
+    {
+        sHud.Widgets[ lWidget ].ulBank   = ulBank;
+        sHud.Widgets[ lWidget ].ulValue  = ulFrame;
+        sHud.Widgets[ lWidget ].bFlipped = bFlipped;
+        sHud.Widgets[ lWidget ].bCovers  = true;
+    }
+
+    return lWidget;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a bar, the left part of frame 0 of a RAW sprite as wide as
+                its value, starts full
+    @ingroup 	MainShell
+    @param      lParent         - Parent widget, or HUD_NO_PARENT
+    @param      x               - X from the parent, or the screen
+    @param      y               - Y from the parent, or the screen
+    @param      ulBank          - RAW sprite bank, the full bar
+    @param      ulMax           - Value of a full bar
+    @param      uEmpty          - Colour of the rest, 0 to leave the parent showing
+    @return     int32_t         - Widget, -1 if full
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Hud_AddBar( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulMax, uint8_t uEmpty )
+{
+    int32_t lWidget = AddWidget( eHudWidget_Bar, lParent, x, y );
+
+    if ( lWidget >= 0 )
+    {
+        sHud.Widgets[ lWidget ].ulBank  = ulBank;
+        sHud.Widgets[ lWidget ].ulMax   = ulMax ? ulMax : 1;
+        sHud.Widgets[ lWidget ].ulValue = sHud.Widgets[ lWidget ].ulMax;
+        sHud.Widgets[ lWidget ].uEmpty  = uEmpty;
+        sHud.Widgets[ lWidget ].bCovers = uEmpty != 0;
+    }
+
+    return lWidget;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a text label, empty until LIB_Hud_SetText
+    @ingroup 	MainShell
+    @param      lParent         - Parent widget, a panel behind it
+    @param      x               - X from the parent, or the screen
+    @param      y               - Y from the parent, or the screen
+    @param      eFont           - Font
+    @param      lColour         - LIB_Sprites remap handle, or TEXT_NO_COLOUR
+    @return     int32_t         - Widget, -1 if full
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Hud_AddLabel( int32_t lParent, int32_t x, int32_t y, eTextFont_t eFont, int32_t lColour )
+{
+    int32_t lWidget = AddWidget( eHudWidget_Label, lParent, x, y );
+
+    if ( lWidget >= 0 )
+    {
+        sHud.Widgets[ lWidget ].eFont   = eFont;
+        sHud.Widgets[ lWidget ].lColour = lColour;
+    }
+
+    return lWidget;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds an icon, a sprite frame picked by LIB_Hud_SetValue
+    @ingroup 	MainShell
+    @param      lParent         - Parent widget, a panel behind it
+    @param      x               - X from the parent, or the screen
+    @param      y               - Y from the parent, or the screen
+    @param      ulBank          - Sprite bank
+    @param      ulFrame         - First frame shown
+    @return     int32_t         - Widget, -1 if full
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Hud_AddIcon( int32_t lParent, int32_t x, int32_t y, uint32_t ulBank, uint32_t ulFrame )
+{
+    int32_t lWidget = AddWidget( eHudWidget_Icon, lParent, x, y );
+
+    if ( lWidget >= 0 )
+    {
+        sHud.Widgets[ lWidget ].ulBank  = ulBank;
+        sHud.Widgets[ lWidget ].ulValue = ulFrame;
+    }
+
+    return lWidget;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets a bar's value or an icon's frame, a same value is no
+                change
+    @ingroup 	MainShell
+    @param      lWidget         - Widget
+    @param      ulValue         - Value
+ -----------------------------------------------------------------------------*/
+void LIB_Hud_SetValue( int32_t lWidget, uint32_t ulValue )
+{
+    if ( lWidget >= 0 && lWidget < (int32_t)sHud.ulWidgets && sHud.Widgets[ lWidget ].ulValue != ulValue )
+    {
+        sHud.Widgets[ lWidget ].ulValue = ulValue;
+        Changed( lWidget );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets a label's text, the same text is no change so it can be
+                set every frame
+    @ingroup 	MainShell
+    @param      lWidget         - Label widget
+    @param      pText           - Text, cut to HUD_LABEL_LENGTH
+ -----------------------------------------------------------------------------*/
+void LIB_Hud_SetText( int32_t lWidget, const char* pText )
+{
+    HudWidget_t* psWidget = NULL;
+
+    if ( lWidget < 0 || lWidget >= (int32_t)sHud.ulWidgets || pText == NULL )
+    {
+        return;
+    }
+
+    psWidget = &sHud.Widgets[ lWidget ];
+    if ( strncmp( psWidget->Text, pText, HUD_LABEL_LENGTH ) != 0 )
+    {
+        strncpy( psWidget->Text, pText, HUD_LABEL_LENGTH );
+        psWidget->Text[ HUD_LABEL_LENGTH ] = 0;
+        Changed( lWidget );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Marks every widget out of date in every screen, for after
+                something else has drawn over the HUD
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Hud_Invalidate( void )
+{
+    uint32_t ulStamp = ++sHud.ulStamp;
+
+    for ( uint32_t i = 0; i < sHud.ulWidgets; i++ )
+    {
+        sHud.Widgets[ i ].ulVersion = ulStamp;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws the widgets out of date in the screen being built, once
+                a frame before it is flipped
+    @ingroup 	MainShell
+    @return     uint32_t        - Widgets drawn
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Hud_Draw( void )
+{
+    uint8_t* pScreen   = Hardware_GetScreenPtr();
+    int32_t  lSlot     = BufferSlot( pScreen );
+    uint32_t ulDrawn   = 0;
+    int32_t  lClip[ 4 ];
+    bool     Redrawn[ HUD_MAX_WIDGETS ];
+
+    if ( lSlot < 0 )
+    {
+        return 0;
+    }
+
+    for ( uint32_t i = 0; i < sHud.ulWidgets; i++ )
+    {
+        HudWidget_t* psWidget = &sHud.Widgets[ i ];
+
+        Redrawn[ i ] = psWidget->Drawn[ lSlot ] != psWidget->ulVersion || ( psWidget->lParent >= 0 && Redrawn[ psWidget->lParent ] == true );
+        if ( Redrawn[ i ] == true )
+        {
+            // the HUD is outside the map view clip area
+            if ( ulDrawn == 0 )
+            {
+                LIB_Sprites_GetClipArea( &lClip[ 0 ], &lClip[ 1 ], &lClip[ 2 ], &lClip[ 3 ] );
+                LIB_Sprites_SetClipArea( 0, 0, Hardware_GetScreenWidth(), Hardware_GetScreenHeight() );
+            }
+            DrawWidget( psWidget, pScreen );
+            psWidget->Drawn[ lSlot ] = psWidget->ulVersion;
+            ulDrawn++;
+        }
+    }
+
+    if ( ulDrawn != 0 )
+    {
+        LIB_Sprites_SetClipArea( lClip[ 0 ], lClip[ 1 ], lClip[ 2 ], lClip[ 3 ] );
+    }
+
+    return ulDrawn;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a widget, out of date in every screen
+    @ingroup 	MainShell
+    @param      eType           - Kind
+    @param      lParent         - Parent, or HUD_NO_PARENT
+    @param      x               - X from the parent, or the screen
+    @param      y               - Y from the parent, or the screen
+    @return     int32_t         - Widget, -1 if full or a bad parent
+ -----------------------------------------------------------------------------*/
+static int32_t AddWidget( eHudWidget_t eType, int32_t lParent, int32_t x, int32_t y )
+{
+    HudWidget_t* psWidget = NULL;
+
+    if ( sHud.ulWidgets >= HUD_MAX_WIDGETS || lParent >= (int32_t)sHud.ulWidgets )
+    {
+        return -1;
+    }
+
+    psWidget = &sHud.Widgets[ sHud.ulWidgets ];
+    memset( psWidget, 0, sizeof( HudWidget_t ) );
+    psWidget->eType     = eType;
+    psWidget->lParent   = lParent < 0 ? HUD_NO_PARENT : lParent;
+    psWidget->x         = x + ( lParent >= 0 ? sHud.Widgets[ lParent ].x : 0 );
+    psWidget->y         = y + ( lParent >= 0 ? sHud.Widgets[ lParent ].y : 0 );
+    psWidget->lColour   = TEXT_NO_COLOUR;
+    psWidget->ulVersion = ++sHud.ulStamp;
+
+    return sHud.ulWidgets++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Moves a widget on, or the nearest ancestor covering it
+    @ingroup 	MainShell
+    @param      lWidget         - Widget that changed
+ -----------------------------------------------------------------------------*/
+static void Changed( int32_t lWidget )
+{
+    uint32_t ulStamp = ++sHud.ulStamp;
+
+    while ( lWidget >= 0 )
+    {
+        sHud.Widgets[ lWidget ].ulVersion = ulStamp;
+        if ( sHud.Widgets[ lWidget ].bCovers == true )
+        {
+            break;
+        }
+        lWidget = sHud.Widgets[ lWidget ].lParent;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Which of the screens a buffer is, learning new ones
+    @ingroup 	MainShell
+    @param      pScreen         - Screen being built
+    @return     int32_t         - Slot, -1 if there are more screens than slots
+ -----------------------------------------------------------------------------*/
+static int32_t BufferSlot( uint8_t* pScreen )
+{
+    for ( int32_t i = 0; i < HUD_BUFFERS && pScreen != NULL; i++ )
+    {
+        if ( sHud.Buffers[ i ] == NULL )
+        {
+            sHud.Buffers[ i ] = pScreen;
+        }
+        if ( sHud.Buffers[ i ] == pScreen )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws one widget
+    @ingroup 	MainShell
+    @param      psWidget        - Widget
+    @param      pScreen         - Screen being built
+ -----------------------------------------------------------------------------*/
+static void DrawWidget( HudWidget_t* psWidget, uint8_t* pScreen )
+{
+    switch ( psWidget->eType )
+    {
+        case eHudWidget_Panel:
+            if ( psWidget->bFlipped == true )
+            {
+                LIB_Sprites_DrawFlipped( psWidget->ulBank, psWidget->ulValue, psWidget->x, psWidget->y );
+            }
+            else
+            {
+                LIB_Sprites_Draw( psWidget->ulBank, psWidget->ulValue, psWidget->x, psWidget->y );
+            }
+            break;
+
+        case eHudWidget_Icon:
+            LIB_Sprites_Draw( psWidget->ulBank, psWidget->ulValue, psWidget->x, psWidget->y );
+            break;
+
+        case eHudWidget_Label:
+            LIB_Text_Draw( psWidget->eFont, psWidget->Text, psWidget->x, psWidget->y, psWidget->lColour );
+            break;
+
+        case eHudWidget_Bar:
+        {
+            uint32_t ulWidth  = LIB_Sprites_GetWidth( psWidget->ulBank );
+            uint32_t ulHeight = LIB_Sprites_GetHeight( psWidget->ulBank );
+            uint32_t ulValue  = psWidget->ulValue < psWidget->ulMax ? psWidget->ulValue : psWidget->ulMax;
+            uint32_t ulFill   = ( ulWidth * ulValue ) / psWidget->ulMax;
+            int32_t  lScreenW = Hardware_GetScreenWidth();
+            int32_t  lScreenH = Hardware_GetScreenHeight();
+
+            if ( ulFill != 0 )
+            {
+                LIB_Sprites_DrawRawPart( psWidget->ulBank, 0, psWidget->x, psWidget->y, 0, 0, ulFill, ulHeight );
+            }
+            for ( int32_t y = psWidget->y; psWidget->uEmpty != 0 && y < psWidget->y + (int32_t)ulHeight; y++ )
+            {
+                int32_t xStart = psWidget->x + (int32_t)ulFill;
+                int32_t xEnd   = psWidget->x + (int32_t)ulWidth;
+
+                xStart = xStart < 0 ? 0 : xStart;
+                xEnd   = xEnd > lScreenW ? lScreenW : xEnd;
+
+                if ( y >= 0 && y < lScreenH && xStart < xEnd )
+                {
+                    memset( pScreen + ( y * lScreenW ) + xStart, psWidget->uEmpty, xEnd - xStart );
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Hud.c
+//-----------------------------------------------------------------------------
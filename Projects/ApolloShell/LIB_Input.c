@@ -0,0 +1,392 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Input.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Input sampled at VBL into a queue of timestamped events
+	@date		2025-10-29
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	LIB_Input_VBL is run by the VBL server every field. It reads the
+	keyboard, mouse and joypad registers and queues an event for each change,
+	stamped with the field it was seen in, so nothing is missed when a frame
+	of the main loop runs long. Only changes are queued, a still mouse and
+	no keys cost no events.
+
+	The queue has one writer, the interrupt, and one reader, the main loop.
+	The interrupt fills an event before it moves the head on, and the main
+	loop only moves the tail, so neither needs to lock the other out. A full
+	queue drops new events and counts them, LIB_Input_GetLost.
+
+	The keyboard serial register holds the last code the keyboard sent, a
+	key going down or coming up. A key tapped inside one field is only seen
+	coming up, its down event is queued then as well. A key tapped twice
+	inside one field leaves the register as it was and is not seen.
+
+	LIB_Input_Update drains the queue up to a field into the same state
+	structs ApolloKeyboard, ApolloJoypad and ApolloMouse fill, so the main
+	loop reads input the way it always has. Clicks, joypad presses and
+	keys shorter than a frame still show in them. Every key goes into the
+	keyboard bitmaps, Current_Key is the first to go down.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/LIB_Input.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define INPUT_QUEUE_MASK    ( INPUT_QUEUE_SIZE - 1 )
+#define KEYBOARD_PORT       ( 0xBFEC01 )    // CIA-A serial data, the last key code sent
+#define JOYPAD_PORT         ( 0xDFF220 )
+#define KEY_UP              ( 0x80 )
+#define KEY_SPECIAL         ( 0x78 )        // reset warning and keyboard status codes from here
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Input control, the interrupt's side then the main loop's side
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    InputEvent_t        Queue[ INPUT_QUEUE_SIZE ];
+    volatile uint32_t   ulHead;             //!< Written by the interrupt only
+    volatile uint32_t   ulTail;             //!< Written by the main loop only
+    volatile uint32_t   ulField;
+    volatile uint32_t   ulLost;
+    volatile bool       bActive;
+
+    uint8_t             ubLastKey;          //!< Register as last read
+    uint8_t             ubMouseX;
+    uint8_t             ubMouseY;
+    uint16_t            uwMouseButtons;
+    uint16_t            uwJoypad;
+    uint32_t            KeysDown[ APOLLOKEY_LONGS ];
+
+    uint16_t            uwUpdateMouse;      //!< Buttons as the last update left them
+    uint16_t            uwUpdateJoypad;
+
+} InputCtrl, *pInputCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static InputCtrl sInput;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint8_t  ReadKeyboard( void );
+static uint16_t ReadMouseButtons( void );
+static void     Post( eInputEvent_t eType, uint8_t ubCode, int16_t wX, int16_t wY, uint16_t uwButtons );
+static int16_t  CounterDelta( uint8_t ubNow, uint8_t ubOld );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Empties the queue and takes the registers as they are now, so
+                only changes from here are queued. Call before the VBL server
+                runs LIB_Input_VBL.
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Input_Init( void )
+{
+    sInput.bActive = false;
+    memset( &sInput, 0, sizeof( sInput ) );
+
+    sInput.ubLastKey      = ReadKeyboard();
+    sInput.ubMouseX       = *((volatile uint8_t*)APOLLO_MOUSE_GET_X);
+    sInput.ubMouseY       = *((volatile uint8_t*)APOLLO_MOUSE_GET_Y);
+    sInput.uwMouseButtons = ReadMouseButtons();
+    sInput.uwJoypad       = *((volatile uint16_t*)JOYPAD_PORT);
+    sInput.uwUpdateMouse  = sInput.uwMouseButtons;
+    sInput.uwUpdateJoypad = sInput.uwJoypad;
+    sInput.bActive        = true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		One field of input, a queued event for each change. Called
+                from the VBL server.
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Input_VBL( void )
+{
+    uint8_t     ubKey;
+    uint8_t     ubX, ubY;
+    uint16_t    uwButtons;
+
+    if ( sInput.bActive == false )
+    {
+        return;
+    }
+    sInput.ulField++;
+
+    // keyboard, the full code set from the serial register
+    ubKey = ReadKeyboard();
+    if ( ubKey != sInput.ubLastKey )
+    {
+        uint8_t     ubCode = ubKey & ~KEY_UP;
+        uint32_t    ulBit  = APOLLOKEY_BIT( ubCode );
+        uint32_t*   pDown  = &sInput.KeysDown[ ubCode >> 5 ];
+
+        sInput.ubLastKey = ubKey;
+        if ( ubCode < KEY_SPECIAL )
+        {
+            if ( ( *pDown & ulBit ) == 0 )
+            {
+                Post( eInputEvent_KeyDown, ubCode, 0, 0, 0 );
+            }
+            if ( ubKey & KEY_UP )
+            {
+                *pDown &= ~ulBit;
+                Post( eInputEvent_KeyUp, ubCode, 0, 0, 0 );
+            }
+            else
+            {
+                *pDown |= ulBit;
+            }
+        }
+    }
+
+    // mouse, the movement of the counters over the field
+    ubX = *((volatile uint8_t*)APOLLO_MOUSE_GET_X);
+    ubY = *((volatile uint8_t*)APOLLO_MOUSE_GET_Y);
+    if ( ubX != sInput.ubMouseX || ubY != sInput.ubMouseY )
+    {
+        Post( eInputEvent_MouseMove, 0, CounterDelta( ubX, sInput.ubMouseX ), CounterDelta( ubY, sInput.ubMouseY ), 0 );
+        sInput.ubMouseX = ubX;
+        sInput.ubMouseY = ubY;
+    }
+
+    uwButtons = ReadMouseButtons();
+    if ( uwButtons != sInput.uwMouseButtons )
+    {
+        sInput.uwMouseButtons = uwButtons;
+        Post( eInputEvent_MouseButton, 0, 0, 0, uwButtons );
+    }
+
+    // joypad, the whole register
+    uwButtons = *((volatile uint16_t*)JOYPAD_PORT);
+    if ( uwButtons != sInput.uwJoypad )
+    {
+        sInput.uwJoypad = uwButtons;
+        Post( eInputEvent_Joypad, 0, 0, 0, uwButtons );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the field count, the stamp the next event will not be
+                older than
+    @ingroup 	MainShell
+    @return     uint32_t        - Fields since LIB_Input_Init
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Input_GetField( void )
+{
+    return sInput.ulField;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the events dropped because the queue was full
+    @ingroup 	MainShell
+    @return     uint32_t        - Events lost
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Input_GetLost( void )
+{
+    return sInput.ulLost;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Copies the oldest event, leaving it queued
+    @ingroup 	MainShell
+    @param      psEvent         - Event
+    @return     bool            - false when the queue is empty
+ -----------------------------------------------------------------------------*/
+bool LIB_Input_PeekEvent( InputEvent_t* psEvent )
+{
+    uint32_t ulTail = sInput.ulTail;
+
+    if ( ulTail == sInput.ulHead )
+    {
+        return false;
+    }
+    *psEvent = sInput.Queue[ ulTail ];
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes the oldest event if it was seen by a field
+    @ingroup 	MainShell
+    @param      psEvent         - Event
+    @param      ulUpToField     - Last field to take events from, INPUT_ALL_FIELDS for all
+    @return     bool            - false when there is none that old
+ -----------------------------------------------------------------------------*/
+bool LIB_Input_GetEvent( InputEvent_t* psEvent, uint32_t ulUpToField )
+{
+    if ( LIB_Input_PeekEvent( psEvent ) == false || psEvent->ulField > ulUpToField )
+    {
+        return false;
+    }
+    sInput.ulTail = ( sInput.ulTail + 1 ) & INPUT_QUEUE_MASK;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Drains the events up to a field into the state structs, in
+                place of ApolloKeyboard, ApolloJoypad and ApolloMouse
+    @ingroup 	MainShell
+    @param      psKeyboard      - Keys down, pressed, released and repeated, Current_Key the first down
+    @param      psJoypad        - Buttons pressed at any time since the last update read down
+    @param      psMouse         - Moved by all the movement, clicks from every button change
+    @param      ulUpToField     - Last field to take events from, INPUT_ALL_FIELDS for all
+ -----------------------------------------------------------------------------*/
+void LIB_Input_Update( ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse, uint32_t ulUpToField )
+{
+    InputEvent_t    sEvent;
+    int16_t         wX = 0, wY = 0;
+    int16_t         wTotalX = 0, wTotalY = 0;
+    uint16_t        uwButtonState = 0;
+    uint16_t        uwPressed = 0;
+
+    ApolloKeyboardBegin( psKeyboard );
+
+    while ( LIB_Input_GetEvent( &sEvent, ulUpToField ) == true )
+    {
+        switch ( sEvent.ubType )
+        {
+            case eInputEvent_KeyDown:
+                ApolloKeyboardKey( psKeyboard, sEvent.ubCode, true );
+                break;
+
+            case eInputEvent_KeyUp:
+                ApolloKeyboardKey( psKeyboard, sEvent.ubCode, false );
+                break;
+
+            case eInputEvent_MouseMove:
+                wX += sEvent.wX;
+                wY += sEvent.wY;
+                wTotalX += sEvent.wX;
+                wTotalY += sEvent.wY;
+                break;
+
+            case eInputEvent_MouseButton:
+                // each change is seen by the click logic, a click inside a frame is not lost
+                ApolloMouseApply( psMouse, wX, wY, sEvent.uwButtons & INPUT_MOUSE_LEFT,
+                                  sEvent.uwButtons & INPUT_MOUSE_RIGHT, sEvent.uwButtons & INPUT_MOUSE_MIDDLE );
+                uwButtonState |= psMouse->Button_State;
+                sInput.uwUpdateMouse = sEvent.uwButtons;
+                wX = 0;
+                wY = 0;
+                break;
+
+            case eInputEvent_Joypad:
+                uwPressed |= sEvent.uwButtons;
+                sInput.uwUpdateJoypad = sEvent.uwButtons;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    ApolloKeyboardEnd( psKeyboard );
+
+    ApolloMouseApply( psMouse, wX, wY, sInput.uwUpdateMouse & INPUT_MOUSE_LEFT,
+                      sInput.uwUpdateMouse & INPUT_MOUSE_RIGHT, sInput.uwUpdateMouse & INPUT_MOUSE_MIDDLE );
+    psMouse->Button_State |= uwButtonState;
+
+    // the pointer moved a piece a button change, the delta is all of it
+    psMouse->MouseX_Value_Delta = wTotalX;
+    psMouse->MouseY_Value_Delta = wTotalY;
+
+    ApolloJoypadDecode( psJoypad, sInput.uwUpdateJoypad | ( uwPressed & INPUT_JOYPAD_BUTTONS ) );
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Reads the keyboard serial register as a raw key code
+    @ingroup 	MainShell
+    @return     uint8_t         - Key code, KEY_UP set when the key came up
+ -----------------------------------------------------------------------------*/
+static uint8_t ReadKeyboard( void )
+{
+    uint8_t ubRaw = ~*((volatile uint8_t*)KEYBOARD_PORT);
+
+    return (uint8_t)( ( ubRaw >> 1 ) | ( ubRaw << 7 ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Reads the mouse buttons, as ApolloMouse does
+    @ingroup 	MainShell
+    @return     uint16_t        - INPUT_MOUSE_ buttons down
+ -----------------------------------------------------------------------------*/
+static uint16_t ReadMouseButtons( void )
+{
+    uint16_t uwButtons = 0;
+
+    if ( ( *((volatile uint8_t*)APOLLO_MOUSE_BUTTON1) & 0x40 ) == 0 )   uwButtons |= INPUT_MOUSE_LEFT;
+    if ( ( *((volatile uint16_t*)APOLLO_MOUSE_BUTTON2) & 0x400 ) == 0 ) uwButtons |= INPUT_MOUSE_RIGHT;
+    if ( ( *((volatile uint16_t*)APOLLO_MOUSE_BUTTON3) & 0x400 ) == 0 ) uwButtons |= INPUT_MOUSE_MIDDLE;
+
+    return uwButtons;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Queues an event stamped with this field, or counts it lost
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+static void Post( eInputEvent_t eType, uint8_t ubCode, int16_t wX, int16_t wY, uint16_t uwButtons )
+{
+    uint32_t        ulHead = sInput.ulHead;
+    uint32_t        ulNext = ( ulHead + 1 ) & INPUT_QUEUE_MASK;
+    InputEvent_t*   psEvent = &sInput.Queue[ ulHead ];
+
+    if ( ulNext == sInput.ulTail )
+    {
+        sInput.ulLost++;
+        return;
+    }
+
+    psEvent->ulField   = sInput.ulField;
+    psEvent->ubType    = (uint8_t)eType;
+    psEvent->ubCode    = ubCode;
+    psEvent->wX        = wX;
+    psEvent->wY        = wY;
+    psEvent->uwButtons = uwButtons;
+
+    // filled before it is published
+    sInput.ulHead = ulNext;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Movement of an 8 bit mouse counter, which wraps
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+static int16_t CounterDelta( uint8_t ubNow, uint8_t ubOld )
+{
+    return (int16_t)(int8_t)( ubNow - ubOld );
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Input.c
+//-----------------------------------------------------------------------------
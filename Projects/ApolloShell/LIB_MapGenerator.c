@@ -0,0 +1,619 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_MapGenerator.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Time sliced map generation into the spare back screen
+	@date		2025-10-22
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	A new map is built in back screen 3 (the spare) while back screen 2 keeps
+	showing the current one. Each call to LIB_MapGenerator_Step does one
+	frame's worth of work -
+
+	Cache		open the map in the map cache and read its height map, skips
+				Noise, Paint and Save on a hit
+	CacheRows	ulCacheRows rows of terrain decoded from the map cache
+	Noise		ulNoiseColumns height map columns
+	Mask		ulMaskTiles tiles of the solidity mask, LIB_TerrainMask
+	Clean		ulTiles tiles of mask cleanup, caves only
+	Paint		ulPaintRows rows of terrain from the height map, or
+				ulTiles tiles from the mask when caves are on
+	Save		store the new map in the map cache (optional, one file write)
+	Place		MAPGEN_PLACE_DARTS darts of decoration placement, sprites are
+				stamped into the spare and its mask, LIB_Decorations. The
+				water rows go in at the end of it, LIB_Water
+	Decorate	callback draws into the spare (screen mode 3)
+	Swap		back screens 2 and 3 swap, the new map is shown from here on
+	Copy		ulCopyRows rows of back screen 2 copied to back screen 1
+
+	The height maps and masks are double buffered the same way, so the ones
+	returned by LIB_MapGenerator_GetHeightMap / GetMask always match the map
+	shown. LIB_MapGenerator_Run, before the display is up, loads a cache
+	hit in one go with LIB_TerrainCache_Load.
+
+	The cache holds maps before Place, placement comes from the seed so a
+	cache hit is decorated the same as a fresh build. It holds no mask, a
+	hit builds it again from the height map, and with caves from the seed's
+	noise offsets and cleans it. Cave maps are kept under their own name.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "Includes/Hardware.h"
+#include "Includes/ResourceFiles.h"
+#include "Includes/ResourceHandling.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_PerlinNoise.h"
+#include "Includes/LIB_Terrain.h"
+#include "Includes/LIB_TerrainCache.h"
+#include "Includes/LIB_TerrainMask.h"
+#include "Includes/LIB_Decorations.h"
+#include "Includes/LIB_Water.h"
+#include "Includes/LIB_MapGenerator.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define SCREENMODE_SPARE    ( 3 )
+#define GRADIENT_RESOURCE   ( 6 )       // offsets into the terrain group
+#define SOIL_RESOURCE       ( 21 )
+
+#define MASK_LONGS          ( TERRAINMASK_LONGS( MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT ) )
+#define MASK_TILES          ( TERRAINMASK_TILES( MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT ) )
+
+#define CAVE_DEPTH_SCALE    ( 1.0f / 120.0f )   // density 1 at 120 rows below the surface
+#define CAVE_AMPLITUDE      ( 1.1f )
+#define CAVE_FREQUENCY      ( 1.0f / 96.0f )
+#define CAVE_OCTAVES        ( 3 )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Map generator control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    eMapGenState_t      eState;             //!< Current step
+    uint32_t            ulTerrainSet;       //!< Resource group of the terrain
+    bool                bSaveToCache;       //!< Save generated maps to the map cache
+    MapGenDecorate_t    pfnDecorate;        //!< Called to draw into the finished spare
+    uint32_t            ulSeed;             //!< Seed being generated
+    uint32_t            ulShownSeed;        //!< Seed of the map shown
+    uint32_t            ulPosition;         //!< Column or row reached in the current step
+    uint32_t            ulWorkDone;         //!< Progress units completed
+    uint32_t            ulWorkTotal;        //!< Progress units for the whole build
+    bool                bCaves;             //!< 2D noise caves and overhangs
+    bool                bFromCache;         //!< Spare was loaded from the map cache
+    bool                bBlocking;          //!< LIB_MapGenerator_Run, cache loads are not sliced
+    uint32_t            ulMaskTiles;        //!< Budget, mask tiles per step
+    uint32_t            ulTiles;            //!< Budget, cleanup or paint tiles per step
+    uint32_t            ulNoiseColumns;     //!< Budget, columns per step
+    uint32_t            ulPaintRows;        //!< Budget, rows per step
+    uint32_t            ulCopyRows;         //!< Budget, rows per step
+    uint32_t            ulCacheRows;        //!< Budget, rows per step
+    uint32_t            ulWaterRows;        //!< Water depth at the bottom of the map
+    PerlinMap_t         sPerlin;            //!< Noise parameters of the map being built
+    TerrainPaint_t      sPaint;             //!< Paint setup, pBuffer is the spare
+    TerrainShape_t      sShape;             //!< Mask shape of the map being built
+    int32_t*            pShownHeight;       //!< Height map of the map shown
+    int32_t*            pSpareHeight;       //!< Height map being built
+    TerrainMask_t*      psShownMask;        //!< Mask of the map shown
+    TerrainMask_t*      psSpareMask;        //!< Mask being built
+    TerrainMask_t*      psCleanMask;        //!< Cleanup destination, swapped with the spare
+    TerrainCacheReader_t sReader;           //!< Map cache file being loaded
+
+} MapGenCtrl, *pMapGenCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static int32_t      pHeightMaps[ 2 ][ MAPGEN_MAP_WIDTH ];
+static uint32_t     pMaskBits[ 3 ][ MASK_LONGS ];
+static uint8_t      pMaskTiles[ 3 ][ MASK_TILES ];
+static TerrainMask_t sMasks[ 3 ];
+static MapGenCtrl   sMapGen = { .eState = eMapGen_Idle, .pShownHeight = pHeightMaps[ 0 ], .pSpareHeight = pHeightMaps[ 1 ] };
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint32_t Budget( uint32_t ulPosition, uint32_t ulBudget, uint32_t ulEnd );
+static uint32_t WorkTotal( bool bFromCache );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Initialise the generator, after the resource groups are loaded
+    @ingroup 	MainShell
+    @param      ulTerrainSet    - Resource group used for gradient and soil
+    @param      bSaveToCache    - Save maps that were not in the cache
+    @param      pfnDecorate     - Called with the spare selected, can be NULL
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_Init( uint32_t ulTerrainSet, bool bSaveToCache, MapGenDecorate_t pfnDecorate )
+{
+    uint32_t ulGradient = ResourceHandling_GetGroupStartResource( ulTerrainSet ) + GRADIENT_RESOURCE;
+    uint32_t ulSoil     = ResourceHandling_GetGroupStartResource( ulTerrainSet ) + SOIL_RESOURCE;
+
+    sMapGen.eState          = eMapGen_Idle;
+    sMapGen.ulTerrainSet    = ulTerrainSet;
+    sMapGen.bSaveToCache    = bSaveToCache;
+    sMapGen.pfnDecorate     = pfnDecorate;
+    sMapGen.bCaves          = false;
+    sMapGen.ulWaterRows     = 0;
+
+    LIB_MapGenerator_SetBudget( MAPGEN_NOISE_COLUMNS, MAPGEN_PAINT_ROWS, MAPGEN_COPY_ROWS, MAPGEN_CACHE_ROWS );
+    LIB_MapGenerator_SetTileBudget( MAPGEN_MASK_TILES, MAPGEN_TILES );
+
+    for ( uint32_t i = 0; i < 3; i++ )
+    {
+        LIB_TerrainMask_Setup( &sMasks[ i ], pMaskBits[ i ], pMaskTiles[ i ], MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT );
+    }
+    sMapGen.psShownMask = &sMasks[ 0 ];
+    sMapGen.psSpareMask = &sMasks[ 1 ];
+    sMapGen.psCleanMask = &sMasks[ 2 ];
+
+    sMapGen.sShape.lSurfaceOffset   = TERRAIN_SURFACE_OFFSET;
+    sMapGen.sShape.fDepthScale      = CAVE_DEPTH_SCALE;
+    sMapGen.sShape.fCaveFreq        = CAVE_FREQUENCY;
+    sMapGen.sShape.ulOctaves        = CAVE_OCTAVES;
+
+    sMapGen.sPaint.ulWidth          = MAPGEN_MAP_WIDTH;
+    sMapGen.sPaint.ulHeight         = MAPGEN_MAP_HEIGHT;
+    sMapGen.sPaint.lSurfaceOffset   = TERRAIN_SURFACE_OFFSET;
+    sMapGen.sPaint.ulGradientWidth  = LIB_Sprites_GetWidth( ulGradient );
+    sMapGen.sPaint.ulGradientHeight = LIB_Sprites_GetHeight( ulGradient );
+    sMapGen.sPaint.pGradient        = NULL;
+    sMapGen.sPaint.pSoil            = NULL;
+
+    ResourceHandling_Get( ulGradient, eResourceGet_Data, &sMapGen.sPaint.pGradient );
+    ResourceHandling_Get( ulSoil, eResourceGet_Data, &sMapGen.sPaint.pSoil );
+
+    LIB_Decorations_Init( ulTerrainSet );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets how much work is done per step
+    @ingroup 	MainShell
+    @param      ulNoiseColumns  - Height map columns per step
+    @param      ulPaintRows     - Terrain rows painted per step
+    @param      ulCopyRows      - Rows copied to back screen 1 per step
+    @param      ulCacheRows     - Rows loaded from the map cache per step
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_SetBudget( uint32_t ulNoiseColumns, uint32_t ulPaintRows, uint32_t ulCopyRows, uint32_t ulCacheRows )
+{
+    sMapGen.ulNoiseColumns  = ulNoiseColumns ? ulNoiseColumns : 1;
+    sMapGen.ulPaintRows     = ulPaintRows ? ulPaintRows : 1;
+    sMapGen.ulCopyRows      = ulCopyRows ? ulCopyRows : 1;
+    sMapGen.ulCacheRows     = ulCacheRows ? ulCacheRows : 1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets how many mask tiles are done per step
+    @ingroup 	MainShell
+    @param      ulMaskTiles     - Tiles generated per step, these sample noise
+    @param      ulTiles         - Tiles cleaned or painted per step
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_SetTileBudget( uint32_t ulMaskTiles, uint32_t ulTiles )
+{
+    sMapGen.ulMaskTiles = ulMaskTiles ? ulMaskTiles : 1;
+    sMapGen.ulTiles     = ulTiles ? ulTiles : 1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Turns the 2D noise caves and overhangs on or off, used from
+                the next LIB_MapGenerator_Start
+    @ingroup 	MainShell
+    @param      bCaves          - true for caves, false for the plain height map
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_SetCaves( bool bCaves )
+{
+    sMapGen.bCaves = bCaves;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets the depth of water drawn into new maps, used from the
+                next LIB_MapGenerator_Start
+    @ingroup 	MainShell
+    @param      ulRows          - Rows of water at the bottom, 0 for none
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_SetWater( uint32_t ulRows )
+{
+    sMapGen.ulWaterRows = ulRows < MAPGEN_MAP_HEIGHT ? ulRows : MAPGEN_MAP_HEIGHT;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Starts building a map in the spare back screen. A build
+                that has not been swapped in yet is abandoned.
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed
+    @return     bool            - false while the last map is still being
+                                  copied to back screen 1, try again later
+ -----------------------------------------------------------------------------*/
+bool LIB_MapGenerator_Start( uint32_t ulSeed )
+{
+    if ( sMapGen.eState == eMapGen_Copy )
+    {
+        return false;
+    }
+
+    uint32_t ulMode = Hardware_GetScreenmode();
+
+    // an abandoned build may be part way through a cache file
+    LIB_TerrainCache_Close( &sMapGen.sReader );
+
+    Hardware_SetScreenmode( SCREENMODE_SPARE );
+    sMapGen.sPaint.pBuffer = Hardware_GetScreenPtr();
+    Hardware_SetScreenmode( ulMode );
+
+    sMapGen.sPaint.pMapHeight   = sMapGen.pSpareHeight;
+    sMapGen.sShape.pMapHeight   = sMapGen.pSpareHeight;
+    sMapGen.sShape.fCaveAmp     = sMapGen.bCaves ? CAVE_AMPLITUDE : 0.0f;
+    sMapGen.ulSeed              = ulSeed;
+    sMapGen.ulPosition          = 0;
+    sMapGen.ulWorkDone          = 0;
+    sMapGen.bFromCache          = false;
+    sMapGen.eState              = eMapGen_Cache;
+    sMapGen.ulWorkTotal         = WorkTotal( false );
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Does one frame's worth of map generation
+    @ingroup 	MainShell
+    @return     bool            - true on the step the new map was swapped in
+ -----------------------------------------------------------------------------*/
+bool LIB_MapGenerator_Step( void )
+{
+    bool     bSwapped = false;
+    uint32_t ulEnd    = 0;
+
+    switch ( sMapGen.eState )
+    {
+        case eMapGen_Cache:
+            // the cave noise offsets come from the seed, a cache hit needs them for the mask
+            LIB_PerlinNoise_BeginSeededMap( &sMapGen.sPerlin, sMapGen.ulSeed );
+            sMapGen.sShape.fOffsetX = (float)( LIB_PerlinNoise_Random() % 4096 );
+            sMapGen.sShape.fOffsetY = (float)( LIB_PerlinNoise_Random() % 4096 );
+            sMapGen.eState          = eMapGen_Noise;
+
+            if ( sMapGen.bBlocking == true )
+            {
+                if ( LIB_TerrainCache_Load( sMapGen.ulSeed, sMapGen.ulTerrainSet, sMapGen.bCaves, sMapGen.pSpareHeight, MAPGEN_MAP_WIDTH,
+                                            sMapGen.sPaint.pBuffer, MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT ) == true )
+                {
+                    sMapGen.ulWorkTotal = WorkTotal( true );
+                    sMapGen.ulWorkDone += MAPGEN_MAP_HEIGHT;
+                    sMapGen.bFromCache  = true;
+                    sMapGen.eState      = eMapGen_Mask;
+                }
+            }
+            else if ( LIB_TerrainCache_Open( &sMapGen.sReader, sMapGen.ulSeed, sMapGen.ulTerrainSet, sMapGen.bCaves, sMapGen.pSpareHeight,
+                                             MAPGEN_MAP_WIDTH, sMapGen.sPaint.pBuffer, MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT ) == true )
+            {
+                sMapGen.ulWorkTotal = WorkTotal( true );
+                sMapGen.ulPosition  = 0;
+                sMapGen.eState      = eMapGen_CacheRows;
+            }
+            break;
+
+        case eMapGen_CacheRows:
+            ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulCacheRows, MAPGEN_MAP_HEIGHT );
+            if ( LIB_TerrainCache_ReadRows( &sMapGen.sReader, ulEnd - sMapGen.ulPosition ) == false )
+            {
+                // a bad file is built from the seed instead
+                LIB_TerrainCache_Close( &sMapGen.sReader );
+                LIB_PerlinNoise_BeginSeededMap( &sMapGen.sPerlin, sMapGen.ulSeed );
+                sMapGen.sShape.fOffsetX = (float)( LIB_PerlinNoise_Random() % 4096 );
+                sMapGen.sShape.fOffsetY = (float)( LIB_PerlinNoise_Random() % 4096 );
+                sMapGen.ulWorkTotal = WorkTotal( false );
+                sMapGen.ulWorkDone  = 0;
+                sMapGen.ulPosition  = 0;
+                sMapGen.eState      = eMapGen_Noise;
+                break;
+            }
+            sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+            sMapGen.ulPosition  = ulEnd;
+            if ( ulEnd == MAPGEN_MAP_HEIGHT )
+            {
+                LIB_TerrainCache_Close( &sMapGen.sReader );
+                sMapGen.ulPosition  = 0;
+                sMapGen.bFromCache  = true;
+                sMapGen.eState      = eMapGen_Mask;
+            }
+            break;
+
+        case eMapGen_Noise:
+            ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulNoiseColumns, MAPGEN_MAP_WIDTH );
+            LIB_PerlinNoise_GenerateColumns( &sMapGen.sPerlin, sMapGen.pSpareHeight, sMapGen.ulPosition, ulEnd );
+            sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+            sMapGen.ulPosition  = ulEnd;
+            if ( ulEnd == MAPGEN_MAP_WIDTH )
+            {
+                sMapGen.ulPosition = 0;
+                sMapGen.eState     = eMapGen_Mask;
+            }
+            break;
+
+        case eMapGen_Mask:
+            ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulMaskTiles, LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask ) );
+            LIB_TerrainMask_GenerateTiles( sMapGen.psSpareMask, &sMapGen.sShape, sMapGen.ulPosition, ulEnd - sMapGen.ulPosition );
+            sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+            sMapGen.ulPosition  = ulEnd;
+            if ( ulEnd == LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask ) )
+            {
+                sMapGen.ulPosition = 0;
+                if ( sMapGen.bCaves == true )
+                {
+                    sMapGen.eState = eMapGen_Clean;
+                }
+                else if ( sMapGen.bFromCache == true )
+                {
+                    sMapGen.eState = eMapGen_Place;
+                }
+                else
+                {
+                    sMapGen.eState = eMapGen_Paint;
+                }
+            }
+            break;
+
+        case eMapGen_Clean:
+            ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulTiles, LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask ) );
+            LIB_TerrainMask_CleanTiles( sMapGen.psCleanMask, sMapGen.psSpareMask, sMapGen.ulPosition, ulEnd - sMapGen.ulPosition );
+            sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+            sMapGen.ulPosition  = ulEnd;
+            if ( ulEnd == LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask ) )
+            {
+                TerrainMask_t* psMask = sMapGen.psSpareMask;
+
+                sMapGen.psSpareMask = sMapGen.psCleanMask;
+                sMapGen.psCleanMask = psMask;
+                sMapGen.ulPosition  = 0;
+                sMapGen.eState      = ( sMapGen.bFromCache == true ) ? eMapGen_Place : eMapGen_Paint;
+            }
+            break;
+
+        case eMapGen_Paint:
+            if ( sMapGen.bCaves == true )
+            {
+                uint32_t ulTiles = LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask );
+
+                ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulTiles, ulTiles );
+                LIB_TerrainMask_PaintTiles( sMapGen.psSpareMask, &sMapGen.sPaint, sMapGen.ulPosition, ulEnd - sMapGen.ulPosition );
+                sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+                sMapGen.ulPosition  = ulEnd;
+                if ( ulEnd < ulTiles ) break;
+            }
+            else
+            {
+                ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulPaintRows, MAPGEN_MAP_HEIGHT );
+                LIB_Terrain_PaintArea( &sMapGen.sPaint, 0, sMapGen.ulPosition, MAPGEN_MAP_WIDTH, ulEnd - sMapGen.ulPosition );
+                sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+                sMapGen.ulPosition  = ulEnd;
+                if ( ulEnd < MAPGEN_MAP_HEIGHT ) break;
+            }
+            sMapGen.ulPosition = 0;
+            sMapGen.eState     = eMapGen_Save;
+            break;
+
+        case eMapGen_Save:
+            if ( sMapGen.bSaveToCache == true )
+            {
+                LIB_TerrainCache_Save( sMapGen.ulSeed, sMapGen.ulTerrainSet, sMapGen.bCaves, sMapGen.pSpareHeight, MAPGEN_MAP_WIDTH,
+                                       sMapGen.sPaint.pBuffer, MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT );
+            }
+            sMapGen.ulWorkDone++;
+            sMapGen.eState = eMapGen_Place;
+            break;
+
+        case eMapGen_Place:
+            if ( sMapGen.ulPosition == 0 )
+            {
+                LIB_Decorations_Begin( sMapGen.ulSeed, sMapGen.psSpareMask, sMapGen.sPaint.pBuffer );
+            }
+            if ( LIB_Decorations_Place( MAPGEN_PLACE_DARTS ) == false )
+            {
+                sMapGen.ulWorkDone += MAPGEN_PLACE_DARTS;
+                sMapGen.ulPosition += MAPGEN_PLACE_DARTS;
+                break;
+            }
+            if ( sMapGen.ulWaterRows != 0 )
+            {
+                LIB_Water_Draw( sMapGen.sPaint.pBuffer, sMapGen.psSpareMask, MAPGEN_MAP_HEIGHT - sMapGen.ulWaterRows );
+            }
+            // placement can stop early once full, count the darts not thrown
+            sMapGen.ulWorkDone += DECORATION_DARTS - sMapGen.ulPosition;
+            sMapGen.ulPosition  = 0;
+            sMapGen.eState      = eMapGen_Decorate;
+            break;
+
+        case eMapGen_Decorate:
+            if ( sMapGen.pfnDecorate != NULL )
+            {
+                uint32_t ulMode = Hardware_GetScreenmode();
+
+                Hardware_SetScreenmode( SCREENMODE_SPARE );
+                sMapGen.pfnDecorate( sMapGen.pSpareHeight, MAPGEN_MAP_WIDTH, MAPGEN_MAP_HEIGHT );
+                Hardware_SetScreenmode( ulMode );
+            }
+            sMapGen.ulWorkDone++;
+            sMapGen.eState = eMapGen_Swap;
+            break;
+
+        case eMapGen_Swap:
+        {
+            int32_t*       pHeight = sMapGen.pShownHeight;
+            TerrainMask_t* psMask  = sMapGen.psShownMask;
+
+            Hardware_SwapBackScreens();
+            sMapGen.pShownHeight = sMapGen.pSpareHeight;
+            sMapGen.pSpareHeight = pHeight;
+            sMapGen.psShownMask  = sMapGen.psSpareMask;
+            sMapGen.psSpareMask  = psMask;
+            sMapGen.ulShownSeed  = sMapGen.ulSeed;
+            sMapGen.ulWorkDone++;
+            sMapGen.ulPosition   = 0;
+            sMapGen.eState       = eMapGen_Copy;
+            bSwapped = true;
+            break;
+        }
+
+        case eMapGen_Copy:
+            ulEnd = Budget( sMapGen.ulPosition, sMapGen.ulCopyRows, MAPGEN_MAP_HEIGHT );
+            Hardware_CopyBack2ToBack1Rows( sMapGen.ulPosition, ulEnd - sMapGen.ulPosition );
+            sMapGen.ulWorkDone += ulEnd - sMapGen.ulPosition;
+            sMapGen.ulPosition  = ulEnd;
+            if ( ulEnd == MAPGEN_MAP_HEIGHT )
+            {
+                sMapGen.eState = eMapGen_Idle;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return bSwapped;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Builds a map straight through, used before the display is up
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed
+ -----------------------------------------------------------------------------*/
+void LIB_MapGenerator_Run( uint32_t ulSeed )
+{
+    sMapGen.bBlocking = true;
+    while ( LIB_MapGenerator_Start( ulSeed ) == false )
+    {
+        LIB_MapGenerator_Step();
+    }
+    while ( sMapGen.eState != eMapGen_Idle )
+    {
+        LIB_MapGenerator_Step();
+    }
+    sMapGen.bBlocking = false;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is a map being built
+    @ingroup 	MainShell
+    @return     bool            - true until the last step has completed
+ -----------------------------------------------------------------------------*/
+bool LIB_MapGenerator_IsBusy( void )
+{
+    return sMapGen.eState != eMapGen_Idle;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Progress of the current build
+    @ingroup 	MainShell
+    @return     uint32_t        - 0 to MAPGEN_PROGRESS_MAX, MAX when idle
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_MapGenerator_GetProgress( void )
+{
+    if ( sMapGen.eState == eMapGen_Idle )
+    {
+        return MAPGEN_PROGRESS_MAX;
+    }
+
+    return ( sMapGen.ulWorkDone * MAPGEN_PROGRESS_MAX ) / sMapGen.ulWorkTotal;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Current step of the generator
+    @ingroup 	MainShell
+    @return     eMapGenState_t  - state
+ -----------------------------------------------------------------------------*/
+eMapGenState_t LIB_MapGenerator_GetState( void )
+{
+    return sMapGen.eState;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Height map of the map being shown
+    @ingroup 	MainShell
+    @return     int32_t*        - MAPGEN_MAP_WIDTH heights
+ -----------------------------------------------------------------------------*/
+int32_t* LIB_MapGenerator_GetHeightMap( void )
+{
+    return sMapGen.pShownHeight;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Seed of the map being shown
+    @ingroup 	MainShell
+    @return     uint32_t        - seed
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_MapGenerator_GetSeed( void )
+{
+    return sMapGen.ulShownSeed;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Solidity mask of the map being shown
+    @ingroup 	MainShell
+    @return     TerrainMask_t*  - mask, test with LIB_TerrainMask_IsSolid
+ -----------------------------------------------------------------------------*/
+TerrainMask_t* LIB_MapGenerator_GetMask( void )
+{
+    return sMapGen.psShownMask;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		End of this step's slice
+    @ingroup 	MainShell
+    @param      ulPosition      - Where the slice starts
+    @param      ulBudget        - Slice size
+    @param      ulEnd           - End of the whole job
+    @return     uint32_t        - End of the slice
+ -----------------------------------------------------------------------------*/
+static uint32_t Budget( uint32_t ulPosition, uint32_t ulBudget, uint32_t ulEnd )
+{
+    return ( ulEnd - ulPosition > ulBudget ) ? ulPosition + ulBudget : ulEnd;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Work in the whole build, for LIB_MapGenerator_GetProgress
+    @ingroup 	MainShell
+    @param      bFromCache      - Build loads the map from the cache
+    @return     uint32_t        - Work units
+ -----------------------------------------------------------------------------*/
+static uint32_t WorkTotal( bool bFromCache )
+{
+    uint32_t ulTiles = LIB_TerrainMask_GetTileCount( sMapGen.psSpareMask );
+    uint32_t ulTotal = ulTiles + ( sMapGen.bCaves ? ulTiles : 0 ) + DECORATION_DARTS + 2 + MAPGEN_MAP_HEIGHT;
+
+    if ( bFromCache == true )
+    {
+        // cache rows, mask tiles, cleanup, darts, decorate, swap, copy rows
+        return ulTotal + MAPGEN_MAP_HEIGHT;
+    }
+
+    // noise columns, mask tiles, cleanup and paint, save, darts, decorate, swap, copy rows
+    return ulTotal + MAPGEN_MAP_WIDTH + ( sMapGen.bCaves ? ulTiles : MAPGEN_MAP_HEIGHT ) + 1;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_MapGenerator.c
+//-----------------------------------------------------------------------------
@@ -0,0 +1,959 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Palette.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Palette animation, cycles fades and flashes run at VBL
+	@date		2025-10-25
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Two copies of the palette are kept. The base palette holds the colours
+	set by the game, and cycles rotate their ranges of it in place. The
+	shown palette is what the display has, base plus any fade or flash in
+	progress.
+
+	LIB_Palette_VBL is run by the VBL server (Hardware_SetVBLHook). It steps
+	the cycles and fades and writes only the entries that changed to the
+	palette port, so an idle palette costs nothing and a 16 colour water
+	cycle is 16 register writes.
+
+	Fades keep per entry 8.16 fixed point colours and deltas, worked out
+	when the fade is started, so a field of fading is adds only. Nothing
+	here uses floats, the VBL stays short.
+
+	Fades and cycles are set up from the main loop while the interrupt is
+	running. Only a free slot is set up and it is switched on last, so the
+	interrupt never sees half of one. Each entry records the fade moving
+	it, a new fade over the same entries takes them over from the old one.
+
+	Whole screen effects use transforms, tables built once of what every
+	channel value 0 to 255 becomes at each step of a fade, tint or darken.
+	Playing one only changes which step's tables the upload looks through,
+	so the effect follows the cycles and fades underneath it for three
+	byte lookups per entry. The last colour written to each entry is kept
+	and an entry is only written when it really changes, so a darken step
+	does not rewrite the colours that are already black.
+
+	Named palettes are copies of whole palettes, a level's palette can be
+	selected or faded to by name. Selecting one rewrites the whole base
+	palette the cycles rotate, so the VBL is held off for that field
+	rather than seeing half of the old palette and half of the new. LIB_Palette_BuildRemap makes the 256 byte
+	index tables that sprite draws look pixels up through, to show the
+	same sprite in a team colour using colours already in the palette.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/LIB_Palette.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#ifndef PALETTE_PORT
+#define PALETTE_PORT        ( 0xDFF388 )    // SAGA colour register, index in the top byte
+#endif
+#define NO_FADE             ( 0xFF )
+#define DIRTY_LONGS         ( PALETTE_ENTRIES / 32 )
+#define NOT_WRITTEN         ( 0xFFFFFFFF )  // never a colour, the top byte is clear
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	A range of the base palette rotated every few fields
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    volatile bool   bActive;
+    bool            bReverse;       //!< Rotate towards the start of the range
+    uint32_t        ulFirst;
+    uint32_t        ulCount;
+    uint32_t        ulFields;       //!< Fields per step
+    uint32_t        ulTimer;        //!< Fields to the next step
+
+} PaletteCycle_t, *pPaletteCycle_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A range of the shown palette moving to target colours
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    volatile bool   bActive;
+    uint32_t        ulFirst;
+    uint32_t        ulCount;
+    uint32_t        ulFieldsLeft;
+
+} PaletteFade_t, *pPaletteFade_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	One step of a transform, new value of each channel value
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint8_t         Red[ 256 ];
+    uint8_t         Green[ 256 ];
+    uint8_t         Blue[ 256 ];
+
+} PaletteLUT_t, *pPaletteLUT_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A transform, its steps are consecutive LUTs
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        ulFirstStep;
+    uint32_t        ulSteps;
+
+} PaletteTransform_t, *pPaletteTransform_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A transform being played at VBL
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    volatile bool   bActive;
+    ePalettePlay_t  ePlay;
+    uint32_t        ulTransform;
+    int32_t         lStep;
+    int32_t         lDirection;     //!< 1 or -1
+    uint32_t        ulFields;       //!< Fields per step
+    uint32_t        ulTimer;
+
+} PalettePlayer_t, *pPalettePlayer_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A whole palette kept by name
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    char            Name[ PALETTE_NAME_LENGTH ];
+    uint32_t        Colours[ PALETTE_ENTRIES ];
+
+} PaletteNamed_t, *pPaletteNamed_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Palette control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    uint32_t        Base[ PALETTE_ENTRIES ];        //!< Game colours, cycled in place
+    uint32_t        Shown[ PALETTE_ENTRIES ];       //!< Colours on the display
+    uint32_t        Dirty[ DIRTY_LONGS ];           //!< Shown entries not yet written
+    uint32_t        Target[ PALETTE_ENTRIES ];      //!< Fade end colour per entry
+    int32_t         Fixed[ PALETTE_ENTRIES ][ 3 ];  //!< Fade colour per entry, 8.16 R G B
+    int32_t         Delta[ PALETTE_ENTRIES ][ 3 ];  //!< Added each field
+    uint8_t         FadeOwner[ PALETTE_ENTRIES ];   //!< Fade moving the entry, or NO_FADE
+    PaletteCycle_t  Cycles[ PALETTE_MAX_CYCLES ];
+    PaletteFade_t   Fades[ PALETTE_MAX_FADES ];
+    uint32_t        Written[ PALETTE_ENTRIES ];     //!< Last value sent to each entry
+
+    PaletteLUT_t    LUTs[ PALETTE_MAX_STEPS ];
+    uint32_t        ulStepsUsed;
+    PaletteTransform_t Transforms[ PALETTE_MAX_TRANSFORMS ];
+    uint32_t        ulTransforms;
+    PalettePlayer_t Player;
+    const PaletteLUT_t* volatile pLUT;              //!< Step the upload goes through, NULL for none
+
+    PaletteNamed_t  Named[ PALETTE_MAX_NAMED ];
+    uint32_t        ulNamed;
+    volatile bool   bHold;                          //!< Base being rewritten, the VBL skips the field
+
+} PaletteCtrl, *pPaletteCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static PaletteCtrl sPalette;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void MarkDirty( uint32_t ulIndex );
+static void MarkAllDirty( void );
+static void StepPlayer( PalettePlayer_t* psPlayer );
+static void StepCycle( PaletteCycle_t* psCycle );
+static void StepFade( PaletteFade_t* psFade, uint32_t ulFade );
+static bool StartFade( uint32_t ulFirst, uint32_t ulCount, const uint32_t* pTarget, uint32_t ulFields, const uint32_t* pFromRGB );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets up the palette from a 256 long palette file, all of it is
+                written at the next VBL
+    @ingroup 	MainShell
+    @param      pPalette        - PALETTE_ENTRIES colours, 0x00RRGGBB (top byte ignored)
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_Init( const uint32_t* pPalette )
+{
+    memset( &sPalette, 0, sizeof( sPalette ) );
+    memset( sPalette.FadeOwner, NO_FADE, sizeof( sPalette.FadeOwner ) );
+    memset( sPalette.Written, 0xFF, sizeof( sPalette.Written ) );
+
+    for ( uint32_t i = 0; i < PALETTE_ENTRIES; i++ )
+    {
+        sPalette.Base[ i ]  = pPalette ? pPalette[ i ] & PALETTE_RGB_MASK : 0;
+        sPalette.Shown[ i ] = sPalette.Base[ i ];
+        MarkDirty( i );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets one base colour, shown at the next VBL unless it is fading
+    @ingroup 	MainShell
+    @param      ulIndex         - Entry
+    @param      ulRGB           - 0x00RRGGBB
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_SetColour( uint32_t ulIndex, uint32_t ulRGB )
+{
+    if ( ulIndex < PALETTE_ENTRIES )
+    {
+        sPalette.Base[ ulIndex ] = ulRGB & PALETTE_RGB_MASK;
+        if ( sPalette.FadeOwner[ ulIndex ] == NO_FADE )
+        {
+            sPalette.Shown[ ulIndex ] = sPalette.Base[ ulIndex ];
+            MarkDirty( ulIndex );
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns one base colour
+    @ingroup 	MainShell
+    @param      ulIndex         - Entry
+    @return     uint32_t        - 0x00RRGGBB
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Palette_GetColour( uint32_t ulIndex )
+{
+    return ulIndex < PALETTE_ENTRIES ? sPalette.Base[ ulIndex ] : 0;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Starts rotating a range of the base palette
+    @ingroup 	MainShell
+    @param      ulFirst         - First entry
+    @param      ulCount         - Entries in the range, 2 or more
+    @param      ulFields        - Vertical blanks per step
+    @param      bReverse        - Rotate colours towards ulFirst
+    @return     int32_t         - Cycle handle, -1 if none are free
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Palette_AddCycle( uint32_t ulFirst, uint32_t ulCount, uint32_t ulFields, bool bReverse )
+{
+    if ( ulCount < 2 || ulFirst + ulCount > PALETTE_ENTRIES )
+    {
+        return -1;
+    }
+
+    for ( int32_t i = 0; i < PALETTE_MAX_CYCLES; i++ )
+    {
+        PaletteCycle_t* psCycle = &sPalette.Cycles[ i ];
+
+        if ( psCycle->bActive == false )
+        {
+            psCycle->ulFirst  = ulFirst;
+            psCycle->ulCount  = ulCount;
+            psCycle->ulFields = ulFields ? ulFields : 1;
+            psCycle->ulTimer  = psCycle->ulFields;
+            psCycle->bReverse = bReverse;
+            psCycle->bActive  = true;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Stops a cycle, its range keeps the colours it had reached
+    @ingroup 	MainShell
+    @param      lCycle          - Handle from LIB_Palette_AddCycle
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_StopCycle( int32_t lCycle )
+{
+    if ( lCycle >= 0 && lCycle < PALETTE_MAX_CYCLES )
+    {
+        sPalette.Cycles[ lCycle ].bActive = false;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Fades a range of the shown palette to new colours. The base
+                palette is not changed, fade it back with pTarget NULL.
+    @ingroup 	MainShell
+    @param      ulFirst         - First entry
+    @param      ulCount         - Entries
+    @param      pTarget         - ulCount colours, NULL for the base palette
+    @param      ulFields        - Vertical blanks the fade takes
+    @return     bool            - false if no fade is free
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_Fade( uint32_t ulFirst, uint32_t ulCount, const uint32_t* pTarget, uint32_t ulFields )
+{
+    return StartFade( ulFirst, ulCount, pTarget, ulFields, NULL );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets a range to one colour, then fades it back to the base
+                palette, for explosions and hits
+    @ingroup 	MainShell
+    @param      ulFirst         - First entry
+    @param      ulCount         - Entries
+    @param      ulRGB           - Flash colour, 0x00RRGGBB
+    @param      ulFields        - Vertical blanks to fade back
+    @return     bool            - false if no fade is free
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_Flash( uint32_t ulFirst, uint32_t ulCount, uint32_t ulRGB, uint32_t ulFields )
+{
+    uint32_t ulFrom = ulRGB & PALETTE_RGB_MASK;
+
+    return StartFade( ulFirst, ulCount, NULL, ulFields, &ulFrom );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is any fade or flash still running
+    @ingroup 	MainShell
+    @return     bool            - true while fading
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_IsFading( void )
+{
+    for ( uint32_t i = 0; i < PALETTE_MAX_FADES; i++ )
+    {
+        if ( sPalette.Fades[ i ].bActive == true )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		One field of palette animation, then the changed entries are
+                written. Called from the VBL server.
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_VBL( void )
+{
+    volatile uint32_t*  pPort = (volatile uint32_t*)PALETTE_PORT;
+    const PaletteLUT_t* pLUT  = NULL;
+
+    // the dirty entries are still marked, they go out next field
+    if ( sPalette.bHold == true )
+    {
+        return;
+    }
+
+    for ( uint32_t i = 0; i < PALETTE_MAX_CYCLES; i++ )
+    {
+        if ( sPalette.Cycles[ i ].bActive == true && --sPalette.Cycles[ i ].ulTimer == 0 )
+        {
+            StepCycle( &sPalette.Cycles[ i ] );
+        }
+    }
+
+    for ( uint32_t i = 0; i < PALETTE_MAX_FADES; i++ )
+    {
+        if ( sPalette.Fades[ i ].bActive == true )
+        {
+            StepFade( &sPalette.Fades[ i ], i );
+        }
+    }
+
+    if ( sPalette.Player.bActive == true && --sPalette.Player.ulTimer == 0 )
+    {
+        StepPlayer( &sPalette.Player );
+    }
+
+    pLUT = sPalette.pLUT;
+    for ( uint32_t ulLong = 0; ulLong < DIRTY_LONGS; ulLong++ )
+    {
+        uint32_t ulBits = sPalette.Dirty[ ulLong ];
+
+        sPalette.Dirty[ ulLong ] = 0;
+        for ( uint32_t ulIndex = ulLong * 32; ulBits != 0; ulBits <<= 1, ulIndex++ )
+        {
+            if ( ulBits & 0x80000000 )
+            {
+                uint32_t ulRGB = sPalette.Shown[ ulIndex ];
+
+                if ( pLUT != NULL )
+                {
+                    ulRGB = ( (uint32_t)pLUT->Red[ ( ulRGB >> 16 ) & 0xFF ] << 16 )
+                          | ( (uint32_t)pLUT->Green[ ( ulRGB >> 8 ) & 0xFF ] << 8 )
+                          | pLUT->Blue[ ulRGB & 0xFF ];
+                }
+                if ( ulRGB != sPalette.Written[ ulIndex ] )
+                {
+                    sPalette.Written[ ulIndex ] = ulRGB;
+                    *pPort = ( ulIndex << 24 ) | ulRGB;
+                }
+            }
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Keeps a copy of a whole palette under a name
+    @ingroup 	MainShell
+    @param      pName           - Name, up to PALETTE_NAME_LENGTH-1 characters
+    @param      pPalette        - PALETTE_ENTRIES colours, 0x00RRGGBB (top byte ignored)
+    @return     int32_t         - Palette handle, -1 if there is no room
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Palette_AddNamed( const char* pName, const uint32_t* pPalette )
+{
+    PaletteNamed_t* psNamed = NULL;
+    int32_t         lPalette = LIB_Palette_FindNamed( pName );
+
+    if ( pPalette == NULL || pName == NULL )
+    {
+        return -1;
+    }
+    if ( lPalette < 0 )
+    {
+        if ( sPalette.ulNamed >= PALETTE_MAX_NAMED )
+        {
+            return -1;
+        }
+        lPalette = sPalette.ulNamed++;
+    }
+
+    psNamed = &sPalette.Named[ lPalette ];
+    strncpy( psNamed->Name, pName, PALETTE_NAME_LENGTH - 1 );
+    psNamed->Name[ PALETTE_NAME_LENGTH - 1 ] = 0;
+    for ( uint32_t i = 0; i < PALETTE_ENTRIES; i++ )
+    {
+        psNamed->Colours[ i ] = pPalette[ i ] & PALETTE_RGB_MASK;
+    }
+
+    return lPalette;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Finds a named palette
+    @ingroup 	MainShell
+    @param      pName           - Name given to LIB_Palette_AddNamed
+    @return     int32_t         - Palette handle, -1 if not found
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Palette_FindNamed( const char* pName )
+{
+    for ( uint32_t i = 0; pName != NULL && i < sPalette.ulNamed; i++ )
+    {
+        if ( strncmp( sPalette.Named[ i ].Name, pName, PALETTE_NAME_LENGTH - 1 ) == 0 )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Makes a named palette the base palette, at once or faded to
+    @ingroup 	MainShell
+    @param      lPalette        - Handle from LIB_Palette_AddNamed
+    @param      ulFields        - Vertical blanks to fade over, 0 to switch
+    @return     bool            - false for a bad handle or no free fade
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_SelectNamed( int32_t lPalette, uint32_t ulFields )
+{
+    if ( lPalette < 0 || lPalette >= (int32_t)sPalette.ulNamed )
+    {
+        return false;
+    }
+
+    // no cycle steps part way through the copy
+    sPalette.bHold = true;
+    memcpy( sPalette.Base, sPalette.Named[ lPalette ].Colours, sizeof( sPalette.Base ) );
+    if ( ulFields == 0 )
+    {
+        for ( uint32_t i = 0; i < PALETTE_ENTRIES; i++ )
+        {
+            if ( sPalette.FadeOwner[ i ] == NO_FADE )
+            {
+                sPalette.Shown[ i ] = sPalette.Base[ i ];
+                MarkDirty( i );
+            }
+        }
+    }
+    sPalette.bHold = false;
+
+    if ( ulFields != 0 )
+    {
+        return StartFade( 0, PALETTE_ENTRIES, NULL, ulFields, NULL );
+    }
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Builds the channel tables for every step of a transform. Step
+                0 leaves colours as they are, the last step is the full effect.
+    @ingroup 	MainShell
+    @param      eType           - Fade, tint or darken
+    @param      ulRGB           - Colour of the effect, 0x00RRGGBB
+    @param      ulSteps         - Steps, 2 or more
+    @return     int32_t         - Transform handle, -1 if there is no room
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Palette_BuildTransform( ePaletteTransform_t eType, uint32_t ulRGB, uint32_t ulSteps )
+{
+    PaletteTransform_t* psTransform = NULL;
+    int32_t             lLast       = (int32_t)ulSteps - 1;
+
+    if ( eType >= ePaletteTransform_Total || ulSteps < 2
+        || sPalette.ulTransforms >= PALETTE_MAX_TRANSFORMS
+        || sPalette.ulStepsUsed + ulSteps > PALETTE_MAX_STEPS )
+    {
+        return -1;
+    }
+
+    psTransform              = &sPalette.Transforms[ sPalette.ulTransforms ];
+    psTransform->ulFirstStep = sPalette.ulStepsUsed;
+    psTransform->ulSteps     = ulSteps;
+
+    for ( int32_t lStep = 0; lStep <= lLast; lStep++ )
+    {
+        PaletteLUT_t* psLUT = &sPalette.LUTs[ psTransform->ulFirstStep + lStep ];
+
+        for ( uint32_t c = 0; c < 3; c++ )
+        {
+            uint8_t* pTable = c == 0 ? psLUT->Red : ( c == 1 ? psLUT->Green : psLUT->Blue );
+            int32_t  lColour = ( ulRGB >> ( 16 - ( c * 8 ) ) ) & 0xFF;
+
+            for ( int32_t v = 0; v < 256; v++ )
+            {
+                int32_t lOut = v;
+
+                switch ( eType )
+                {
+                    case ePaletteTransform_Fade:
+                        lOut = v + ( ( lColour - v ) * lStep ) / lLast;
+                        break;
+                    case ePaletteTransform_Tint:
+                        lOut = ( v * ( ( 255 * lLast ) - ( ( 255 - lColour ) * lStep ) ) ) / ( 255 * lLast );
+                        break;
+                    case ePaletteTransform_Darken:
+                        lOut = v - ( ( lColour * lStep ) / lLast );
+                        lOut = lOut < 0 ? 0 : lOut;
+                        break;
+                    default:
+                        break;
+                }
+                pTable[ v ] = (uint8_t)lOut;
+            }
+        }
+    }
+
+    sPalette.ulStepsUsed += ulSteps;
+
+    return sPalette.ulTransforms++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Plays a transform over the whole palette, replacing any that
+                is playing
+    @ingroup 	MainShell
+    @param      lTransform      - Handle from LIB_Palette_BuildTransform
+    @param      ePlay           - Direction and what happens at the end
+    @param      ulFields        - Vertical blanks per step
+    @return     bool            - false for a bad handle
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_PlayTransform( int32_t lTransform, ePalettePlay_t ePlay, uint32_t ulFields )
+{
+    PalettePlayer_t*    psPlayer = &sPalette.Player;
+    PaletteTransform_t* psTransform = NULL;
+
+    if ( lTransform < 0 || lTransform >= (int32_t)sPalette.ulTransforms || ePlay >= ePalettePlay_Total )
+    {
+        return false;
+    }
+
+    psTransform = &sPalette.Transforms[ lTransform ];
+
+    psPlayer->bActive     = false;
+    psPlayer->ePlay       = ePlay;
+    psPlayer->ulTransform = lTransform;
+    psPlayer->lStep       = ePlay == ePalettePlay_Reverse ? psTransform->ulSteps - 1 : 0;
+    psPlayer->lDirection  = ePlay == ePalettePlay_Reverse ? -1 : 1;
+    psPlayer->ulFields    = ulFields ? ulFields : 1;
+    psPlayer->ulTimer     = psPlayer->ulFields;
+
+    sPalette.pLUT = &sPalette.LUTs[ psTransform->ulFirstStep + psPlayer->lStep ];
+    MarkAllDirty();
+    psPlayer->bActive = true;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Holds a transform at one step, stopping any that is playing
+    @ingroup 	MainShell
+    @param      lTransform      - Handle from LIB_Palette_BuildTransform, -1 for none
+    @param      ulStep          - Step, past the last is the last
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_SetTransformStep( int32_t lTransform, uint32_t ulStep )
+{
+    sPalette.Player.bActive = false;
+
+    if ( lTransform < 0 || lTransform >= (int32_t)sPalette.ulTransforms )
+    {
+        sPalette.pLUT = NULL;
+    }
+    else
+    {
+        PaletteTransform_t* psTransform = &sPalette.Transforms[ lTransform ];
+
+        ulStep = ulStep < psTransform->ulSteps ? ulStep : psTransform->ulSteps - 1;
+        sPalette.pLUT = &sPalette.LUTs[ psTransform->ulFirstStep + ulStep ];
+    }
+    MarkAllDirty();
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is a transform still playing
+    @ingroup 	MainShell
+    @return     bool            - true while playing
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_IsTransforming( void )
+{
+    return sPalette.Player.bActive;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is an entry in a running cycle's range
+    @ingroup 	MainShell
+    @param      ulIndex         - Entry
+    @return     bool            - true if its colour moves
+ -----------------------------------------------------------------------------*/
+bool LIB_Palette_IsCycled( uint32_t ulIndex )
+{
+    for ( uint32_t i = 0; i < PALETTE_MAX_CYCLES; i++ )
+    {
+        PaletteCycle_t* psCycle = &sPalette.Cycles[ i ];
+
+        if ( psCycle->bActive == true && ulIndex >= psCycle->ulFirst && ulIndex < psCycle->ulFirst + psCycle->ulCount )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Finds the base palette entry closest to a colour. Entry 0, the
+                transparent colour, and entries being cycled are not used.
+    @ingroup 	MainShell
+    @param      ulRGB           - 0x00RRGGBB
+    @return     uint32_t        - Entry
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Palette_Nearest( uint32_t ulRGB )
+{
+    uint32_t ulBest     = 1;
+    uint32_t ulBestDist = 0xFFFFFFFF;
+    int32_t  lRed       = ( ulRGB >> 16 ) & 0xFF;
+    int32_t  lGreen     = ( ulRGB >> 8 ) & 0xFF;
+    int32_t  lBlue      = ulRGB & 0xFF;
+
+    for ( uint32_t i = 1; i < PALETTE_ENTRIES && ulBestDist != 0; i++ )
+    {
+        uint32_t ulEntry = sPalette.Base[ i ];
+        int32_t  dR      = (int32_t)( ( ulEntry >> 16 ) & 0xFF ) - lRed;
+        int32_t  dG      = (int32_t)( ( ulEntry >> 8 ) & 0xFF ) - lGreen;
+        int32_t  dB      = (int32_t)( ulEntry & 0xFF ) - lBlue;
+        uint32_t ulDist  = ( dR * dR * 3 ) + ( dG * dG * 4 ) + ( dB * dB * 2 );
+
+        if ( ulDist < ulBestDist && LIB_Palette_IsCycled( i ) == false )
+        {
+            ulBest     = i;
+            ulBestDist = ulDist;
+        }
+    }
+
+    return ulBest;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Brightness of a colour
+    @ingroup 	MainShell
+    @param      ulRGB           - 0x00RRGGBB
+    @return     uint32_t        - 0 to 255
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Palette_Luma( uint32_t ulRGB )
+{
+    return ( ( ( ulRGB >> 16 ) & 0xFF ) * 77 + ( ( ulRGB >> 8 ) & 0xFF ) * 150 + ( ulRGB & 0xFF ) * 29 ) >> 8;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Builds a 256 byte index remap that recolours a range of the
+                palette. Each entry in the range keeps its brightness in the
+                new colour, matched to the nearest colour in the palette, all
+                other entries map to themselves.
+    @ingroup 	MainShell
+    @param      pRemap          - 256 bytes to fill
+    @param      ulFirst         - First entry to recolour, the team colour range
+    @param      ulCount         - Entries
+    @param      ulRGB           - New colour, 0x00RRGGBB
+ -----------------------------------------------------------------------------*/
+void LIB_Palette_BuildRemap( uint8_t* pRemap, uint32_t ulFirst, uint32_t ulCount, uint32_t ulRGB )
+{
+    uint32_t ulPeak = 1;
+
+    for ( uint32_t i = 0; i < PALETTE_ENTRIES; i++ )
+    {
+        pRemap[ i ] = (uint8_t)i;
+    }
+
+    // the brightest channel of the new colour follows the brightness
+    for ( uint32_t ulShift = 0; ulShift <= 16; ulShift += 8 )
+    {
+        ulPeak = ( ( ulRGB >> ulShift ) & 0xFF ) > ulPeak ? ( ulRGB >> ulShift ) & 0xFF : ulPeak;
+    }
+
+    for ( uint32_t i = ulFirst; i < ulFirst + ulCount && i < PALETTE_ENTRIES; i++ )
+    {
+        uint32_t ulLuma = LIB_Palette_Luma( sPalette.Base[ i ] );
+        uint32_t ulNew  = 0;
+
+        if ( i == 0 )
+        {
+            continue;
+        }
+        for ( uint32_t ulShift = 0; ulShift <= 16; ulShift += 8 )
+        {
+            uint32_t ulValue = ( ( ( ulRGB >> ulShift ) & 0xFF ) * ulLuma ) / ulPeak;
+
+            ulNew |= ( ulValue > 255 ? 255 : ulValue ) << ulShift;
+        }
+        pRemap[ i ] = (uint8_t)LIB_Palette_Nearest( ulNew );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Marks a shown entry to be written at the next VBL
+    @ingroup 	MainShell
+    @param      ulIndex         - Entry
+ -----------------------------------------------------------------------------*/
+static void MarkDirty( uint32_t ulIndex )
+{
+    sPalette.Dirty[ ulIndex >> 5 ] |= 0x80000000 >> ( ulIndex & 31 );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Marks every shown entry to be looked at next VBL, only those
+                whose output changed are written
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+static void MarkAllDirty( void )
+{
+    memset( sPalette.Dirty, 0xFF, sizeof( sPalette.Dirty ) );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Moves the playing transform on a step
+    @ingroup 	MainShell
+    @param      psPlayer        - Player
+ -----------------------------------------------------------------------------*/
+static void StepPlayer( PalettePlayer_t* psPlayer )
+{
+    PaletteTransform_t* psTransform = &sPalette.Transforms[ psPlayer->ulTransform ];
+    int32_t             lLast       = psTransform->ulSteps - 1;
+
+    psPlayer->ulTimer = psPlayer->ulFields;
+    psPlayer->lStep  += psPlayer->lDirection;
+
+    if ( psPlayer->lStep > lLast )
+    {
+        if ( psPlayer->ePlay == ePalettePlay_Bounce )
+        {
+            psPlayer->lDirection = -1;
+            psPlayer->lStep      = lLast - 1;
+        }
+        else
+        {
+            // Once holds the last step
+            psPlayer->bActive = false;
+            return;
+        }
+    }
+    if ( psPlayer->lStep < 0 )
+    {
+        psPlayer->bActive = false;
+        sPalette.pLUT     = NULL;
+        MarkAllDirty();
+        return;
+    }
+
+    sPalette.pLUT = &sPalette.LUTs[ psTransform->ulFirstStep + psPlayer->lStep ];
+    MarkAllDirty();
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Rotates a cycle's range of the base palette by one
+    @ingroup 	MainShell
+    @param      psCycle         - Cycle
+ -----------------------------------------------------------------------------*/
+static void StepCycle( PaletteCycle_t* psCycle )
+{
+    uint32_t* pFirst = &sPalette.Base[ psCycle->ulFirst ];
+    uint32_t  ulLast = psCycle->ulCount - 1;
+    uint32_t  ulKeep = 0;
+
+    psCycle->ulTimer = psCycle->ulFields;
+
+    if ( psCycle->bReverse == true )
+    {
+        ulKeep = pFirst[ 0 ];
+        memmove( pFirst, pFirst + 1, ulLast * sizeof( uint32_t ) );
+        pFirst[ ulLast ] = ulKeep;
+    }
+    else
+    {
+        ulKeep = pFirst[ ulLast ];
+        memmove( pFirst + 1, pFirst, ulLast * sizeof( uint32_t ) );
+        pFirst[ 0 ] = ulKeep;
+    }
+
+    // entries being faded pick the cycle up when the fade ends
+    for ( uint32_t i = psCycle->ulFirst; i <= psCycle->ulFirst + ulLast; i++ )
+    {
+        if ( sPalette.FadeOwner[ i ] == NO_FADE )
+        {
+            sPalette.Shown[ i ] = sPalette.Base[ i ];
+            MarkDirty( i );
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Moves a fade's entries on by one field
+    @ingroup 	MainShell
+    @param      psFade          - Fade
+    @param      ulFade          - Its index, the owner value of its entries
+ -----------------------------------------------------------------------------*/
+static void StepFade( PaletteFade_t* psFade, uint32_t ulFade )
+{
+    bool bLast = --psFade->ulFieldsLeft == 0;
+
+    for ( uint32_t i = psFade->ulFirst; i < psFade->ulFirst + psFade->ulCount; i++ )
+    {
+        if ( sPalette.FadeOwner[ i ] != ulFade )
+        {
+            continue;
+        }
+
+        if ( bLast == true )
+        {
+            sPalette.Shown[ i ]     = sPalette.Target[ i ];
+            sPalette.FadeOwner[ i ] = NO_FADE;
+        }
+        else
+        {
+            int32_t* pFixed = sPalette.Fixed[ i ];
+
+            pFixed[ 0 ] += sPalette.Delta[ i ][ 0 ];
+            pFixed[ 1 ] += sPalette.Delta[ i ][ 1 ];
+            pFixed[ 2 ] += sPalette.Delta[ i ][ 2 ];
+            sPalette.Shown[ i ] = ( ( pFixed[ 0 ] >> 16 ) << 16 ) | ( ( pFixed[ 1 ] >> 16 ) << 8 ) | ( pFixed[ 2 ] >> 16 );
+        }
+        MarkDirty( i );
+    }
+
+    if ( bLast == true )
+    {
+        psFade->bActive = false;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets up a fade, taking over the entries from any fade
+                already moving them
+    @ingroup 	MainShell
+    @param      ulFirst         - First entry
+    @param      ulCount         - Entries
+    @param      pTarget         - ulCount colours, NULL for the base palette
+    @param      ulFields        - Vertical blanks the fade takes
+    @param      pFromRGB        - Start colour for the whole range, NULL to
+                                  start from the shown colours
+    @return     bool            - false if no fade is free
+ -----------------------------------------------------------------------------*/
+static bool StartFade( uint32_t ulFirst, uint32_t ulCount, const uint32_t* pTarget, uint32_t ulFields, const uint32_t* pFromRGB )
+{
+    PaletteFade_t* psFade = NULL;
+    uint32_t       ulFade = 0;
+
+    if ( ulCount == 0 || ulFirst + ulCount > PALETTE_ENTRIES )
+    {
+        return false;
+    }
+
+    for ( ulFade = 0; ulFade < PALETTE_MAX_FADES; ulFade++ )
+    {
+        if ( sPalette.Fades[ ulFade ].bActive == false )
+        {
+            psFade = &sPalette.Fades[ ulFade ];
+            break;
+        }
+    }
+    if ( psFade == NULL )
+    {
+        return false;
+    }
+
+    ulFields = ulFields ? ulFields : 1;
+
+    for ( uint32_t i = ulFirst; i < ulFirst + ulCount; i++ )
+    {
+        uint32_t ulFrom = pFromRGB ? *pFromRGB : sPalette.Shown[ i ];
+        uint32_t ulTo   = pTarget ? pTarget[ i - ulFirst ] & PALETTE_RGB_MASK : sPalette.Base[ i ];
+
+        // claim the entry first, the owner change stops the old fade touching it
+        sPalette.FadeOwner[ i ] = ulFade;
+        sPalette.Target[ i ]    = ulTo;
+        for ( uint32_t c = 0; c < 3; c++ )
+        {
+            int32_t lFrom = ( ulFrom >> ( 16 - ( c * 8 ) ) ) & 0xFF;
+            int32_t lTo   = ( ulTo >> ( 16 - ( c * 8 ) ) ) & 0xFF;
+
+            sPalette.Fixed[ i ][ c ] = lFrom << 16;
+            sPalette.Delta[ i ][ c ] = ( ( lTo - lFrom ) << 16 ) / (int32_t)ulFields;
+        }
+        if ( pFromRGB != NULL )
+        {
+            sPalette.Shown[ i ] = ulFrom;
+            MarkDirty( i );
+        }
+    }
+
+    psFade->ulFirst      = ulFirst;
+    psFade->ulCount      = ulCount;
+    psFade->ulFieldsLeft = ulFields;
+    psFade->bActive      = true;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Palette.c
+//-----------------------------------------------------------------------------
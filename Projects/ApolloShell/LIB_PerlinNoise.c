@@ -19,9 +19,7 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "math.h"
-#include "Includes/Hardware.h"
-
-//#include "Includes/LIB_PerlinNoise.h"
+#include "Includes/LIB_PerlinNoise.h"
 
 //-----------------------------------------------------------------------------
 // Defines
@@ -29,6 +27,8 @@
 
 #define PERM_TABLE_SIZE ( 256*2 ) // 256 * 2 
 #define PERM_MAX_MASK   ( 255 )
+#define MAP_OCTAVES     ( 8 )
+#define SEED_DEFAULT    ( 0x12345678 )   // xorshift state must never be zero
 
 //-----------------------------------------------------------------------------
 // Typedefs & Enumerators
@@ -54,9 +54,8 @@ typedef struct
 {
     bool        bInitialized;
     uint8_t     pPermTable[ PERM_TABLE_SIZE ];
-    float       fSeed;
-
-    sVector2    sVectors[ eVectorCorner_Total ];
+    uint32_t    ulSeed;         //!< Seed passed to LIB_PerlinNoise_Init
+    uint32_t    ulRandState;    //!< Working state of the seeded random generator
 
 } sPerlinCtrl, *psPerlinCtrl;
 
@@ -76,7 +75,7 @@ static float randomFloat( void );
 // Variables
 //-----------------------------------------------------------------------------
 
-sPerlinCtrl sPerlin = { .bInitialized = false, .pPermTable = NULL, .fSeed = 0.0f };
+sPerlinCtrl sPerlin = { .bInitialized = false, .ulSeed = 0, .ulRandState = SEED_DEFAULT };
 
 //-----------------------------------------------------------------------------
 // External Functionality
@@ -85,14 +84,34 @@ sPerlinCtrl sPerlin = { .bInitialized = false, .pPermTable = NULL, .fSeed = 0.0f
 /** ---------------------------------------------------------------------------
     @brief 		Initialize the Perlin Noise
     @ingroup 	MainShell
-    @param 		fSeed - the seed value
+    @param 		ulSeed - the seed value, the same seed always gives the
+                         same permutation table and random sequence
     @return 	none
  --------------------------------------------------------------------------- */
-void LIB_PerlinNoise_Init( float fSeed )
+void LIB_PerlinNoise_Init( uint32_t ulSeed )
 {
+    sPerlin.ulSeed      = ulSeed;
+    sPerlin.ulRandState = ( ulSeed != 0 ) ? ulSeed : SEED_DEFAULT;
+
     GeneratePermutation();
     sPerlin.bInitialized = true;
-    sPerlin.fSeed = fSeed;
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Returns the next value from the seeded random generator
+    @ingroup 	MainShell
+    @return 	uint32_t - random value (xorshift32, never zero)
+ --------------------------------------------------------------------------- */
+uint32_t LIB_PerlinNoise_Random( void )
+{
+    uint32_t ulState = sPerlin.ulRandState;
+
+    ulState ^= ulState << 13;
+    ulState ^= ulState >> 17;
+    ulState ^= ulState << 5;
+    sPerlin.ulRandState = ulState;
+
+    return ulState;
 }
 
 
@@ -102,32 +121,35 @@ void LIB_PerlinNoise_Init( float fSeed )
     @param 		x - the x value
     @param 		y - the y value
     @return 	float - the noise value
+    @note       Only reads the permutation table, so can be called from
+                several tasks at once after LIB_PerlinNoise_Init
  --------------------------------------------------------------------------- */
 float LIB_PerlinNoise_Noise2D( float x, float y )
 {
+    sVector2 sVectors[ eVectorCorner_Total ];
     uint32_t X = (uint32_t)floor(x) & PERM_MAX_MASK;
     uint32_t Y = (uint32_t)floor(y) & PERM_MAX_MASK;
     float fXf = x - floor( x );
     float fYf = y - floor( y );
 
-    sPerlin.sVectors[ eVectorCorner_TopRight    ].x = fXf - 1.0;
-    sPerlin.sVectors[ eVectorCorner_TopRight    ].y = fYf - 1.0;
-    sPerlin.sVectors[ eVectorCorner_TopLeft     ].x = fXf;
-    sPerlin.sVectors[ eVectorCorner_TopLeft     ].y = fYf - 1.0;
-    sPerlin.sVectors[ eVectorCorner_BottomRight ].x = fXf - 1.0;
-    sPerlin.sVectors[ eVectorCorner_BottomRight ].y = fYf;
-    sPerlin.sVectors[ eVectorCorner_BottomLeft  ].x = fXf;
-    sPerlin.sVectors[ eVectorCorner_BottomLeft  ].y = fYf;
+    sVectors[ eVectorCorner_TopRight    ].x = fXf - 1.0;
+    sVectors[ eVectorCorner_TopRight    ].y = fYf - 1.0;
+    sVectors[ eVectorCorner_TopLeft     ].x = fXf;
+    sVectors[ eVectorCorner_TopLeft     ].y = fYf - 1.0;
+    sVectors[ eVectorCorner_BottomRight ].x = fXf - 1.0;
+    sVectors[ eVectorCorner_BottomRight ].y = fYf;
+    sVectors[ eVectorCorner_BottomLeft  ].x = fXf;
+    sVectors[ eVectorCorner_BottomLeft  ].y = fYf;
 
     uint8_t valueTopRight    = sPerlin.pPermTable[ sPerlin.pPermTable[ X + 1] + Y + 1 ];      
     uint8_t valueTopLeft     = sPerlin.pPermTable[ sPerlin.pPermTable[ X] + Y + 1 ];      
     uint8_t valueBottomRight = sPerlin.pPermTable[ sPerlin.pPermTable[ X + 1] + Y ];      
     uint8_t valueBottomLeft  = sPerlin.pPermTable[ sPerlin.pPermTable[ X] + Y ];      
 
-    float dotTopRight    = Dot( sPerlin.sVectors[ eVectorCorner_TopRight    ], GetConstantVector( valueTopRight ) );
-    float dotTopLeft     = Dot( sPerlin.sVectors[ eVectorCorner_TopLeft     ], GetConstantVector( valueTopLeft ) );
-    float dotBottomRight = Dot( sPerlin.sVectors[ eVectorCorner_BottomRight ], GetConstantVector( valueBottomRight ) );
-    float dotBottomLeft  = Dot( sPerlin.sVectors[ eVectorCorner_BottomLeft  ], GetConstantVector( valueBottomLeft ) );
+    float dotTopRight    = Dot( sVectors[ eVectorCorner_TopRight    ], GetConstantVector( valueTopRight ) );
+    float dotTopLeft     = Dot( sVectors[ eVectorCorner_TopLeft     ], GetConstantVector( valueTopLeft ) );
+    float dotBottomRight = Dot( sVectors[ eVectorCorner_BottomRight ], GetConstantVector( valueBottomRight ) );
+    float dotBottomLeft  = Dot( sVectors[ eVectorCorner_BottomLeft  ], GetConstantVector( valueBottomLeft ) );
     
     float u = Fade( fXf );
     float v = Fade( fYf );
@@ -136,32 +158,58 @@ float LIB_PerlinNoise_Noise2D( float x, float y )
 }
 
 /** ---------------------------------------------------------------------------
-    @brief 		Generate a Perlin Noise map
+    @brief 		Picks the sample offsets for a map, using the current seed
     @ingroup 	MainShell
-    @param 		pMapHeight - the height of the map
-    @param 		width - the width of the map
-    @param 		height - the height of the map
-    @param 		x - X offset from the reference 0 to width
-    @param 		y - Y offset from the reference 0 to height
+    @param 		psMap - map parameters to fill
+    @param 		fRef - base frequency of the first octave
     @return 	none
  --------------------------------------------------------------------------- */
-void LIB_PerlinNoise_GenerateMap( uint32_t* pMapHeight, uint32_t width, uint32_t height, float fRef )
+void LIB_PerlinNoise_BeginMap( PerlinMap_t* psMap, float fRef )
 {
-    uint32_t ulIndex = 0;
+    psMap->fRef = fRef;
+    psMap->xAdd = LIB_PerlinNoise_Random() % 1200;
+    psMap->yAdd = LIB_PerlinNoise_Random() % 1200;
+    psMap->refY = LIB_PerlinNoise_Random() % 1200;
+}
 
-    uint32_t xAdd = rand() % 1200;
-    uint32_t yAdd = rand() % 1200;
-    uint32_t refY = rand() % 1200;
+/** ---------------------------------------------------------------------------
+    @brief 		Seeds the noise and picks the map parameters for a map seed
+    @ingroup 	MainShell
+    @param 		psMap - map parameters to fill
+    @param 		ulSeed - the map seed, same seed gives the same map
+    @return 	none
+ --------------------------------------------------------------------------- */
+void LIB_PerlinNoise_BeginSeededMap( PerlinMap_t* psMap, uint32_t ulSeed )
+{
+    LIB_PerlinNoise_Init( ulSeed );
+
+    // base frequency picked from the seed, 0.00075 to 0.00375
+    float fRef = 0.00075f + ( 0.003f * randomFloat() );
 
-    for( uint32_t ulX = 0; ulX < width; ulX++ )
+    LIB_PerlinNoise_BeginMap( psMap, fRef );
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Generates a range of height map columns, so a map can be
+                built over several frames
+    @ingroup 	MainShell
+    @param 		psMap - map parameters from a Begin call
+    @param 		pMapHeight - the height map to fill
+    @param 		ulStartX - first column
+    @param 		ulEndX - column after the last
+    @return 	none
+ --------------------------------------------------------------------------- */
+void LIB_PerlinNoise_GenerateColumns( const PerlinMap_t* psMap, int32_t* pMapHeight, uint32_t ulStartX, uint32_t ulEndX )
+{
+    for( uint32_t ulX = ulStartX; ulX < ulEndX; ulX++ )
     {
         float n = 0.0f;
         float a = 1.0f;
-        float f = fRef;
+        float f = psMap->fRef;
 
-        for (uint32_t ulOctave = 0; ulOctave < 8; ulOctave++)
+        for (uint32_t ulOctave = 0; ulOctave < MAP_OCTAVES; ulOctave++)
         {
-            n += a * LIB_PerlinNoise_Noise2D( (float)(ulX + xAdd) * f, (float)(refY + yAdd) * f);
+            n += a * LIB_PerlinNoise_Noise2D( (float)(ulX + psMap->xAdd) * f, (float)(psMap->refY + psMap->yAdd) * f);
             a *= 0.5f;
             f *= 2.0f;
         }
@@ -172,6 +220,39 @@ void LIB_PerlinNoise_GenerateMap( uint32_t* pMapHeight, uint32_t width, uint32_t
     }
 }
 
+/** ---------------------------------------------------------------------------
+    @brief 		Generate a Perlin Noise map
+    @ingroup 	MainShell
+    @param 		pMapHeight - the height of the map
+    @param 		width - the width of the map
+    @param 		height - the height of the map
+    @param 		fRef - base frequency of the first octave
+    @return 	none
+ --------------------------------------------------------------------------- */
+void LIB_PerlinNoise_GenerateMap( int32_t* pMapHeight, uint32_t width, uint32_t height, float fRef )
+{
+    PerlinMap_t sMap;
+
+    LIB_PerlinNoise_BeginMap( &sMap, fRef );
+    LIB_PerlinNoise_GenerateColumns( &sMap, pMapHeight, 0, width );
+}
+
+/** ---------------------------------------------------------------------------
+    @brief 		Generate the height map for a map seed
+    @ingroup 	MainShell
+    @param 		pMapHeight - the height map to fill
+    @param 		width - the width of the map
+    @param 		ulSeed - the map seed, same seed gives the same map
+    @return 	none
+ --------------------------------------------------------------------------- */
+void LIB_PerlinNoise_GenerateSeededMap( int32_t* pMapHeight, uint32_t width, uint32_t ulSeed )
+{
+    PerlinMap_t sMap;
+
+    LIB_PerlinNoise_BeginSeededMap( &sMap, ulSeed );
+    LIB_PerlinNoise_GenerateColumns( &sMap, pMapHeight, 0, width );
+}
+
 /** ---------------------------------------------------------------------------
     @brief 		Linear Interpolation
     @ingroup 	MainShell
@@ -203,9 +284,10 @@ static void Shuffle( uint8_t* pArray, uint32_t ulArraySize )
     uint8_t  ucTemp = 0;
     uint32_t ulRandom = 0;
 
-    for( ulIndex = ulArraySize; ulIndex > 0; ulIndex-- )
+    // Fisher-Yates, driven by the seeded generator
+    for( ulIndex = ulArraySize - 1; ulIndex > 0; ulIndex-- )
     {
-        ulRandom = randomFloat() * (ulIndex -1);
+        ulRandom = LIB_PerlinNoise_Random() % ( ulIndex + 1 );
         ucTemp = pArray[ulIndex];
         pArray[ulIndex] = pArray[ulRandom];
         pArray[ulRandom] = ucTemp;
@@ -317,7 +399,7 @@ static float Lerp( float t, float a, float b )
  --------------------------------------------------------------------------- */
 static float randomFloat( void )
 {
-    return 1.0f / (float)rand();
+    return (float)( LIB_PerlinNoise_Random() >> 8 ) * ( 1.0f / 16777216.0f );
 }
 
 
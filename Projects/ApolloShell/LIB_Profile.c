@@ -0,0 +1,484 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Profile.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Frame profiler, cycles and cache counts per marked scope
+	@date		2025-10-28
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Code to be measured is put between PROFILE_BEGIN and PROFILE_END,
+	scopes can nest. Each end of a scope reads the 68080 cycle and cache
+	counters, six movec reads, so a scope costs a few dozen cycles and
+	can be left in the main loop. PROFILE_FRAME once a frame closes the
+	frame's record and starts the next in a ring of PROFILE_FRAMES.
+
+	Scopes still open at the end of a frame are closed there. Scopes past
+	PROFILE_MAX_SCOPES or PROFILE_MAX_DEPTH are counted as dropped.
+
+	The overlay is drawn over the top HUD strip, so it covers the panels
+	there. The bars are PROFILE_FRAME_MS wide, one row for the outer
+	scopes and one for the scopes inside them, the text is the debug
+	font. LIB_Hud_Invalidate puts the panels back when it is turned off.
+
+	LIB_Profile_Dump sends the whole ring to the serial port as text,
+	waiting on each character. It is for a key press, not every frame.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "string.h"
+#include "Includes/HWScreen.h"
+#include "Includes/FontModule.h"
+#include "Includes/LIB_Palette.h"
+#include "Includes/LIB_Text.h"
+#include "Includes/LIB_Profile.h"
+
+#if PROFILE_ENABLED
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define SCOPE_COLOURS       ( 6 )
+#define BAR_TOP             ( 11 )      // rows from the top of the overlay
+#define BAR_HEIGHT          ( 8 )
+#define INNER_TOP           ( 20 )
+#define INNER_HEIGHT        ( 4 )
+#define LEGEND_TOP          ( 26 )
+#define LEGEND_LINES        ( 2 )
+
+#define SERDATR             ( 0xDFF018 )
+#define SERDAT              ( 0xDFF030 )
+#define SERPER              ( 0xDFF032 )
+#define SERDATR_TBE         ( 1 << 13 )
+#define SERDAT_STOP         ( 1 << 8 )
+#define SERPER_115200       ( ( 3546895 / 115200 ) - 1 )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Profiler control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    ProfileFrame_t  Frames[ PROFILE_FRAMES ];
+    uint32_t        ulCurrent;                              //!< Frame being recorded
+    uint32_t        ulFrames;                               //!< Frames completed
+    uint32_t        FrameStart[ eProfileCounter_Total ];
+    int32_t         Stack[ PROFILE_MAX_DEPTH ];             //!< Open scopes, -1 if dropped
+    uint32_t        ulDepth;
+    uint8_t         uInk;
+    uint8_t         uPaper;
+    uint8_t         uBudget;                                //!< Frame time behind the bars
+    uint8_t         Colours[ SCOPE_COLOURS ];
+    bool            bSerial;                                //!< Baud rate set
+
+} ProfileCtrl, *pProfileCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static ProfileCtrl sProfile;
+
+static const uint32_t ScopeRGB[ SCOPE_COLOURS ] =
+{
+    0xE04040, 0x40C040, 0x4080F0, 0xE0C040, 0xC040C0, 0x40C0C0
+};
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void     CloseScope( ProfileFrame_t* psFrame, int32_t lScope, const uint32_t* pNow );
+static void     FillBar( int32_t y, uint32_t ulHeight, uint32_t ulStart, uint32_t ulCycles, uint8_t uColour );
+static uint32_t Hundredths( uint32_t ulCycles );
+static uint32_t PerMille( uint32_t ulPart, uint32_t ulWhole );
+static void     SerialPutStr( const char* pText );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Clears the record and picks the overlay colours, after the
+                palette is set
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_Init( void )
+{
+    memset( &sProfile, 0, sizeof( sProfile ) );
+
+    sProfile.uInk    = LIB_Palette_Nearest( 0xFFFFFF );
+    sProfile.uPaper  = LIB_Palette_Nearest( 0x000000 );
+    sProfile.uBudget = LIB_Palette_Nearest( 0x404040 );
+    for ( uint32_t i = 0; i < SCOPE_COLOURS; i++ )
+    {
+        sProfile.Colours[ i ] = LIB_Palette_Nearest( ScopeRGB[ i ] );
+    }
+
+    Hardware_ReadCounters( sProfile.FrameStart );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Opens a scope inside the one open, if any
+    @ingroup 	MainShell
+    @param      pName           - Name, a string literal, only the pointer is kept
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_Begin( const char* pName )
+{
+    ProfileFrame_t* psFrame = &sProfile.Frames[ sProfile.ulCurrent ];
+    int32_t         lScope  = -1;
+
+    if ( sProfile.ulDepth < PROFILE_MAX_DEPTH && psFrame->ulScopes < PROFILE_MAX_SCOPES )
+    {
+        ProfileScope_t* psScope = &psFrame->Scopes[ psFrame->ulScopes ];
+
+        lScope = psFrame->ulScopes++;
+        psScope->pName   = pName;
+        psScope->ulDepth = sProfile.ulDepth;
+
+        // start values, turned into counts by CloseScope
+        Hardware_ReadCounters( psScope->Counters );
+        psScope->ulStart = psScope->Counters[ eProfileCounter_Cycles ] - sProfile.FrameStart[ eProfileCounter_Cycles ];
+    }
+    else
+    {
+        psFrame->ulDropped++;
+    }
+
+    if ( sProfile.ulDepth < PROFILE_MAX_DEPTH )
+    {
+        sProfile.Stack[ sProfile.ulDepth ] = lScope;
+    }
+    sProfile.ulDepth++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Closes the scope last opened
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_End( void )
+{
+    uint32_t Now[ eProfileCounter_Total ];
+
+    Hardware_ReadCounters( Now );
+
+    if ( sProfile.ulDepth == 0 )
+    {
+        return;
+    }
+
+    sProfile.ulDepth--;
+    if ( sProfile.ulDepth < PROFILE_MAX_DEPTH )
+    {
+        CloseScope( &sProfile.Frames[ sProfile.ulCurrent ], sProfile.Stack[ sProfile.ulDepth ], Now );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Ends the frame being recorded and starts the next, once a frame
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_Frame( void )
+{
+    ProfileFrame_t* psFrame = &sProfile.Frames[ sProfile.ulCurrent ];
+    uint32_t        Now[ eProfileCounter_Total ];
+
+    Hardware_ReadCounters( Now );
+
+    // scopes left open end with the frame
+    while ( sProfile.ulDepth > 0 )
+    {
+        sProfile.ulDepth--;
+        if ( sProfile.ulDepth < PROFILE_MAX_DEPTH )
+        {
+            CloseScope( psFrame, sProfile.Stack[ sProfile.ulDepth ], Now );
+        }
+    }
+
+    for ( uint32_t i = 0; i < eProfileCounter_Total; i++ )
+    {
+        psFrame->Counters[ i ] = Now[ i ] - sProfile.FrameStart[ i ];
+        sProfile.FrameStart[ i ] = Now[ i ];
+    }
+    psFrame->ulFrame = sProfile.ulFrames++;
+
+    sProfile.ulCurrent = ( sProfile.ulCurrent + 1 ) % PROFILE_FRAMES;
+    psFrame = &sProfile.Frames[ sProfile.ulCurrent ];
+    psFrame->ulScopes  = 0;
+    psFrame->ulDropped = 0;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		A completed frame
+    @ingroup 	MainShell
+    @param      ulAgo           - 0 for the last frame, up to PROFILE_FRAMES - 2
+    @return     ProfileFrame_t* - Frame, NULL if not recorded yet
+ -----------------------------------------------------------------------------*/
+const ProfileFrame_t* LIB_Profile_GetFrame( uint32_t ulAgo )
+{
+    if ( ulAgo >= PROFILE_FRAMES - 1 || ulAgo >= sProfile.ulFrames )
+    {
+        return NULL;
+    }
+
+    return &sProfile.Frames[ ( sProfile.ulCurrent + PROFILE_FRAMES - 1 - ulAgo ) % PROFILE_FRAMES ];
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws the last frame as bars and text over PROFILE_HEIGHT rows
+                of the screen being built
+    @ingroup 	MainShell
+    @param      y               - Top row, 0 for the top HUD strip
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_Draw( int32_t y )
+{
+    const ProfileFrame_t* psFrame  = LIB_Profile_GetFrame( 0 );
+    uint8_t*              pScreen  = Hardware_GetScreenPtr();
+    int32_t               lScreenW = Hardware_GetScreenWidth();
+    int32_t               x        = 0;
+    int32_t               lLine    = 0;
+    char                  szText[ 80 ];
+
+    if ( psFrame == NULL || pScreen == NULL || y < 0 || y + PROFILE_HEIGHT > (int32_t)Hardware_GetScreenHeight() )
+    {
+        return;
+    }
+
+    memset( pScreen + ( y * lScreenW ), sProfile.uPaper, PROFILE_HEIGHT * lScreenW );
+
+    snprintf( szText, sizeof( szText ), "FRAME %d.%02dMS DC HIT %d%% IC MISS %d PAIRED %d%% DROP %d",
+             Hundredths( psFrame->Counters[ eProfileCounter_Cycles ] ) / 100,
+             Hundredths( psFrame->Counters[ eProfileCounter_Cycles ] ) % 100,
+             PerMille( psFrame->Counters[ eProfileCounter_DCacheHits ], psFrame->Counters[ eProfileCounter_DCacheHits ] + psFrame->Counters[ eProfileCounter_DCacheMisses ] ) / 10,
+             psFrame->Counters[ eProfileCounter_ICacheMisses ],
+             PerMille( psFrame->Counters[ eProfileCounter_Pipe2 ], psFrame->Counters[ eProfileCounter_Pipe1 ] ) / 10,
+             psFrame->ulDropped );
+    LIB_Text_DrawDebug( szText, 4, y + 1, sProfile.uInk, FONTMODULE_NO_PAPER );
+
+    // the frame, then the scopes over it
+    FillBar( y + BAR_TOP, BAR_HEIGHT, 0, psFrame->Counters[ eProfileCounter_Cycles ], sProfile.uBudget );
+    for ( uint32_t i = 0; i < psFrame->ulScopes; i++ )
+    {
+        const ProfileScope_t* psScope = &psFrame->Scopes[ i ];
+        uint8_t               uColour = sProfile.Colours[ i % SCOPE_COLOURS ];
+
+        if ( psScope->ulDepth == 0 )
+        {
+            FillBar( y + BAR_TOP, BAR_HEIGHT, psScope->ulStart, psScope->Counters[ eProfileCounter_Cycles ], uColour );
+        }
+        else if ( psScope->ulDepth == 1 )
+        {
+            FillBar( y + INNER_TOP, INNER_HEIGHT, psScope->ulStart, psScope->Counters[ eProfileCounter_Cycles ], uColour );
+        }
+    }
+
+    // names of the outer scopes in their colours, as many as fit
+    for ( uint32_t i = 0; i < psFrame->ulScopes && lLine < LEGEND_LINES; i++ )
+    {
+        const ProfileScope_t* psScope = &psFrame->Scopes[ i ];
+        uint32_t              ulTime  = Hundredths( psScope->Counters[ eProfileCounter_Cycles ] );
+        int32_t               lWidth  = 0;
+
+        if ( psScope->ulDepth != 0 )
+        {
+            continue;
+        }
+
+        snprintf( szText, sizeof( szText ), "%s %d.%02d", psScope->pName, ulTime / 100, ulTime % 100 );
+        lWidth = strlen( szText ) * FONTMODULE_CHAR_SIZE;
+        if ( x + lWidth > lScreenW - 4 && x != 0 )
+        {
+            x = 0;
+            lLine++;
+        }
+        if ( lLine < LEGEND_LINES )
+        {
+            LIB_Text_DrawDebug( szText, x + 4, y + LEGEND_TOP + ( lLine * ( FONTMODULE_CHAR_SIZE + 1 ) ), sProfile.Colours[ i % SCOPE_COLOURS ], FONTMODULE_NO_PAPER );
+            x += lWidth + FONTMODULE_CHAR_SIZE * 2;
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sends every frame in the ring to the serial port, oldest
+                first, one line per frame and one per scope
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Profile_Dump( void )
+{
+    char szLine[ 160 ];
+
+    sprintf( szLine, "PROFILE %d frames, %d cycles/ms\n", sProfile.ulFrames < PROFILE_FRAMES - 1 ? sProfile.ulFrames : PROFILE_FRAMES - 1, PROFILE_CYCLES_MS );
+    SerialPutStr( szLine );
+
+    for ( int32_t lAgo = PROFILE_FRAMES - 2; lAgo >= 0; lAgo-- )
+    {
+        const ProfileFrame_t* psFrame = LIB_Profile_GetFrame( lAgo );
+
+        if ( psFrame == NULL )
+        {
+            continue;
+        }
+
+        sprintf( szLine, "frame %d cycles %d dhit %d dmiss %d imiss %d pipe1 %d pipe2 %d dropped %d\n",
+                 psFrame->ulFrame,
+                 psFrame->Counters[ eProfileCounter_Cycles ],
+                 psFrame->Counters[ eProfileCounter_DCacheHits ],
+                 psFrame->Counters[ eProfileCounter_DCacheMisses ],
+                 psFrame->Counters[ eProfileCounter_ICacheMisses ],
+                 psFrame->Counters[ eProfileCounter_Pipe1 ],
+                 psFrame->Counters[ eProfileCounter_Pipe2 ],
+                 psFrame->ulDropped );
+        SerialPutStr( szLine );
+
+        for ( uint32_t i = 0; i < psFrame->ulScopes; i++ )
+        {
+            const ProfileScope_t* psScope = &psFrame->Scopes[ i ];
+
+            sprintf( szLine, "%*s%-12s start %d cycles %d dhit %d dmiss %d imiss %d pipe1 %d pipe2 %d\n",
+                     (int)( 2 + psScope->ulDepth * 2 ), "",
+                     psScope->pName,
+                     psScope->ulStart,
+                     psScope->Counters[ eProfileCounter_Cycles ],
+                     psScope->Counters[ eProfileCounter_DCacheHits ],
+                     psScope->Counters[ eProfileCounter_DCacheMisses ],
+                     psScope->Counters[ eProfileCounter_ICacheMisses ],
+                     psScope->Counters[ eProfileCounter_Pipe1 ],
+                     psScope->Counters[ eProfileCounter_Pipe2 ] );
+            SerialPutStr( szLine );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Turns a scope's start values into counts
+    @ingroup 	MainShell
+    @param      psFrame         - Frame the scope is in
+    @param      lScope          - Scope, -1 for a dropped one
+    @param      pNow            - Counters at the end
+ -----------------------------------------------------------------------------*/
+static void CloseScope( ProfileFrame_t* psFrame, int32_t lScope, const uint32_t* pNow )
+{
+    if ( lScope < 0 )
+    {
+        return;
+    }
+
+    for ( uint32_t i = 0; i < eProfileCounter_Total; i++ )
+    {
+        psFrame->Scopes[ lScope ].Counters[ i ] = pNow[ i ] - psFrame->Scopes[ lScope ].Counters[ i ];
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Fills part of a bar, the screen width is PROFILE_FRAME_MS
+    @ingroup 	MainShell
+    @param      y               - Top row
+    @param      ulHeight        - Rows
+    @param      ulStart         - Cycles from the frame start
+    @param      ulCycles        - Cycles long
+    @param      uColour         - Palette entry
+ -----------------------------------------------------------------------------*/
+static void FillBar( int32_t y, uint32_t ulHeight, uint32_t ulStart, uint32_t ulCycles, uint8_t uColour )
+{
+    uint8_t* pScreen    = Hardware_GetScreenPtr();
+    uint32_t ulScreenW  = Hardware_GetScreenWidth();
+    uint32_t ulPerPixel = ( PROFILE_CYCLES_MS * PROFILE_FRAME_MS ) / ulScreenW;
+    uint32_t ulLeft     = ulStart / ulPerPixel;
+    uint32_t ulRight    = ( ulStart + ulCycles ) / ulPerPixel;
+
+    ulRight = ulRight > ulScreenW ? ulScreenW : ulRight;
+    if ( ulLeft >= ulRight )
+    {
+        // a scope too short for a pixel still shows
+        if ( ulLeft >= ulScreenW || ulCycles == 0 )
+        {
+            return;
+        }
+        ulRight = ulLeft + 1;
+    }
+
+    for ( uint32_t ulRow = 0; ulRow < ulHeight; ulRow++ )
+    {
+        memset( pScreen + ( ( y + ulRow ) * ulScreenW ) + ulLeft, uColour, ulRight - ulLeft );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Cycles to hundredths of a millisecond
+    @ingroup 	MainShell
+    @param      ulCycles        - Cycles
+    @return     uint32_t        - Hundredths of a millisecond
+ -----------------------------------------------------------------------------*/
+static uint32_t Hundredths( uint32_t ulCycles )
+{
+    return ulCycles / ( PROFILE_CYCLES_MS / 100 );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		A part of a whole in thousandths, with no overflow
+    @ingroup 	MainShell
+    @param      ulPart          - Part
+    @param      ulWhole         - Whole
+    @return     uint32_t        - 0 to 1000 for a part no more than the whole
+ -----------------------------------------------------------------------------*/
+static uint32_t PerMille( uint32_t ulPart, uint32_t ulWhole )
+{
+    if ( ulWhole == 0 )
+    {
+        return 0;
+    }
+
+    return (uint32_t)( ( (uint64_t)ulPart * 1000 ) / ulWhole );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sends a string to the serial port, waiting for each character
+    @ingroup 	MainShell
+    @param      pText           - String, '\n' sent as "\r\n"
+ -----------------------------------------------------------------------------*/
+static void SerialPutStr( const char* pText )
+{
+    volatile uint16_t* pSerDatR = (volatile uint16_t*)SERDATR;
+    volatile uint16_t* pSerDat  = (volatile uint16_t*)SERDAT;
+
+    if ( sProfile.bSerial == false )
+    {
+        *(volatile uint16_t*)SERPER = SERPER_115200;
+        sProfile.bSerial = true;
+    }
+
+    for ( ; *pText != 0; pText++ )
+    {
+        if ( *pText == '\n' )
+        {
+            while ( ( *pSerDatR & SERDATR_TBE ) == 0 );
+            *pSerDat = SERDAT_STOP | '\r';
+        }
+        while ( ( *pSerDatR & SERDATR_TBE ) == 0 );
+        *pSerDat = SERDAT_STOP | (uint8_t)*pText;
+    }
+}
+
+#endif // PROFILE_ENABLED
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Profile.c
+//-----------------------------------------------------------------------------
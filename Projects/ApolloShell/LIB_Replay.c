@@ -0,0 +1,459 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Replay.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Input recording and replay, for runs that can be compared
+	@date		2025-10-30
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	A recording is the input main.c acted on each tick, one pass of the
+	main loop, and the seed rand() was started from. Played back into the
+	same build it gives the same frames, so two builds can be timed on the
+	same work. Map generation works a fixed slice a frame, so it follows
+	the ticks too.
+
+	Only what main.c reads is kept, the keys down and the keys that went
+	down, the joypad as its register, the pointer position and the mouse
+	button actions. Key releases and repeats are worked out again from the
+	keys down, as ApolloKeyboardEnd does for live input. The
+	pointer is kept where it ended up, not how the mouse moved, so a replay
+	does not depend on the click and boundary logic.
+
+	The file is big endian, a header then records of a repeat count and
+	one tick of state. A tick the same as the one before adds to the count,
+	so holding still costs nothing and a minute of input is a few KB. The
+	file is written with stdio, the same on the Amiga and a host build.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "string.h"
+#include "Includes/LIB_Replay.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define REPLAY_TICKS_AT     ( 12 )          // header offset of the tick count
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Replay control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    eReplay_t       eMode;
+    FILE*           pFile;
+    ReplayTick_t    sRun;               //!< Tick being repeated
+    uint32_t        ulRunLeft;          //!< Record, ticks in the run. Play, ticks left of it
+    uint32_t        ulTicks;            //!< Ticks recorded or played
+    uint32_t        ulTotal;            //!< Play, ticks in the file
+    uint32_t        ulRecords;
+
+} ReplayCtrl, *pReplayCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static ReplayCtrl sReplay;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static bool     WriteRun( void );
+static void     Put16( uint8_t* pOut, uint16_t uwValue );
+static void     Put32( uint8_t* pOut, uint32_t ulValue );
+static uint16_t Get16( const uint8_t* pIn );
+static uint32_t Get32( const uint8_t* pIn );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Starts recording the input of each tick into a file
+    @ingroup 	MainShell
+    @param      pFileName       - Recording, replaced
+    @param      ulSeed          - Seed the caller gives srand()
+    @return     bool            - false if the file cannot be written
+ -----------------------------------------------------------------------------*/
+bool LIB_Replay_Record( const char* pFileName, uint32_t ulSeed )
+{
+    uint8_t Header[ REPLAY_HEADER ];
+
+    LIB_Replay_Close();
+    memset( &sReplay, 0, sizeof( sReplay ) );
+
+    sReplay.pFile = fopen( pFileName, "wb" );
+    if ( sReplay.pFile == NULL )
+    {
+        return false;
+    }
+
+    // the tick count is filled in by LIB_Replay_Close
+    Put32( Header, REPLAY_ID );
+    Put32( Header + 4, REPLAY_VERSION );
+    Put32( Header + 8, ulSeed );
+    Put32( Header + REPLAY_TICKS_AT, 0 );
+    if ( fwrite( Header, 1, REPLAY_HEADER, sReplay.pFile ) != REPLAY_HEADER )
+    {
+        LIB_Replay_Close();
+        return false;
+    }
+    sReplay.eMode = eReplay_Record;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Starts playing the input back from a recording
+    @ingroup 	MainShell
+    @param      pFileName       - Recording
+    @param      pulSeed         - Seed it was recorded with, for srand()
+    @return     bool            - false if the file is missing or not a recording
+ -----------------------------------------------------------------------------*/
+bool LIB_Replay_Play( const char* pFileName, uint32_t* pulSeed )
+{
+    uint8_t Header[ REPLAY_HEADER ];
+
+    LIB_Replay_Close();
+    memset( &sReplay, 0, sizeof( sReplay ) );
+
+    sReplay.pFile = fopen( pFileName, "rb" );
+    if ( sReplay.pFile == NULL )
+    {
+        return false;
+    }
+    if ( fread( Header, 1, REPLAY_HEADER, sReplay.pFile ) != REPLAY_HEADER ||
+         Get32( Header ) != REPLAY_ID || Get32( Header + 4 ) != REPLAY_VERSION )
+    {
+        LIB_Replay_Close();
+        return false;
+    }
+
+    *pulSeed        = Get32( Header + 8 );
+    sReplay.ulTotal = Get32( Header + REPLAY_TICKS_AT );
+    sReplay.eMode   = eReplay_Play;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		One tick, after the live input has been read. Recording, the
+                states are written. Playing, they are replaced from the file,
+                without the live input read first, the repeats count the ticks
+                a key is held so the keyboard must tick once.
+    @ingroup 	MainShell
+    @param      psKeyboard      - Keyboard state
+    @param      psJoypad        - Joypad state
+    @param      psMouse         - Mouse state
+    @return     bool            - false at the end of a playback, or a failed write
+ -----------------------------------------------------------------------------*/
+bool LIB_Replay_Tick( ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse )
+{
+    ReplayTick_t sTick;
+
+    switch ( sReplay.eMode )
+    {
+        case eReplay_Record:
+            LIB_Replay_FromState( &sTick, psKeyboard, psJoypad, psMouse );
+            return LIB_Replay_WriteTick( &sTick );
+
+        case eReplay_Play:
+            if ( LIB_Replay_ReadTick( &sTick ) == false )
+            {
+                return false;
+            }
+            LIB_Replay_ToState( &sTick, psKeyboard, psJoypad, psMouse );
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds one tick to a recording, made up by a tool or taken from
+                the states by LIB_Replay_Tick
+    @ingroup 	MainShell
+    @param      psTick          - Tick
+    @return     bool            - false on a failed write
+ -----------------------------------------------------------------------------*/
+bool LIB_Replay_WriteTick( const ReplayTick_t* psTick )
+{
+    if ( sReplay.eMode != eReplay_Record )
+    {
+        return false;
+    }
+    sReplay.ulTicks++;
+
+    if ( sReplay.ulRunLeft != 0 && sReplay.ulRunLeft < REPLAY_MAX_REPEAT &&
+         memcmp( &sReplay.sRun, psTick, sizeof( ReplayTick_t ) ) == 0 )
+    {
+        sReplay.ulRunLeft++;
+        return true;
+    }
+    if ( sReplay.ulRunLeft != 0 && WriteRun() == false )
+    {
+        return false;
+    }
+
+    sReplay.sRun      = *psTick;
+    sReplay.ulRunLeft = 1;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes the next tick of a recording being played
+    @ingroup 	MainShell
+    @param      psTick          - Tick
+    @return     bool            - false at the end of the recording
+ -----------------------------------------------------------------------------*/
+bool LIB_Replay_ReadTick( ReplayTick_t* psTick )
+{
+    uint8_t Record[ REPLAY_RECORD ];
+
+    if ( sReplay.eMode != eReplay_Play )
+    {
+        return false;
+    }
+
+    while ( sReplay.ulRunLeft == 0 )
+    {
+        if ( fread( Record, 1, REPLAY_RECORD, sReplay.pFile ) != REPLAY_RECORD )
+        {
+            return false;
+        }
+        sReplay.ulRunLeft           = Get16( Record );
+        sReplay.sRun.ubKey          = Record[ 2 ];
+        sReplay.sRun.ubPad          = 0;
+        sReplay.sRun.uwJoypad       = Get16( Record + 4 );
+        sReplay.sRun.wMouseX        = (int16_t)Get16( Record + 6 );
+        sReplay.sRun.wMouseY        = (int16_t)Get16( Record + 8 );
+        sReplay.sRun.uwButtonState  = Get16( Record + 10 );
+        for ( uint32_t i = 0; i < APOLLOKEY_LONGS; i++ )
+        {
+            sReplay.sRun.KeysDown[ i ]    = Get32( Record + 12 + ( i * 4 ) );
+            sReplay.sRun.KeysPressed[ i ] = Get32( Record + 12 + ( ( APOLLOKEY_LONGS + i ) * 4 ) );
+        }
+        sReplay.ulRecords++;
+    }
+
+    sReplay.ulRunLeft--;
+    sReplay.ulTicks++;
+    *psTick = sReplay.sRun;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Ends a recording or playback. A recording has its last run
+                and the tick count written.
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Replay_Close( void )
+{
+    if ( sReplay.pFile != NULL )
+    {
+        if ( sReplay.eMode == eReplay_Record )
+        {
+            uint8_t Ticks[ 4 ];
+
+            if ( sReplay.ulRunLeft != 0 )
+            {
+                WriteRun();
+            }
+            Put32( Ticks, sReplay.ulTicks );
+            fseek( sReplay.pFile, REPLAY_TICKS_AT, SEEK_SET );
+            fwrite( Ticks, 1, sizeof( Ticks ), sReplay.pFile );
+        }
+        fclose( sReplay.pFile );
+    }
+
+    // the counts are kept for the end of run report
+    sReplay.eMode     = eReplay_Off;
+    sReplay.pFile     = NULL;
+    sReplay.ulRunLeft = 0;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns what the replay is doing
+    @ingroup 	MainShell
+    @return     eReplay_t       - Mode
+ -----------------------------------------------------------------------------*/
+eReplay_t LIB_Replay_GetMode( void )
+{
+    return sReplay.eMode;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the ticks recorded or played, or with a playback open
+                and nothing played yet, the ticks in the file
+    @ingroup 	MainShell
+    @return     uint32_t        - Ticks
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Replay_GetTicks( void )
+{
+    if ( sReplay.eMode == eReplay_Play && sReplay.ulTicks == 0 )
+    {
+        return sReplay.ulTotal;
+    }
+
+    return sReplay.ulTicks;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the records written or read, the size of a recording
+                is REPLAY_HEADER plus REPLAY_RECORD for each
+    @ingroup 	MainShell
+    @return     uint32_t        - Records
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Replay_GetRecords( void )
+{
+    return sReplay.ulRecords;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes a tick of input from the state structs
+    @ingroup 	MainShell
+    @param      psTick          - Tick
+    @param      psKeyboard      - Keyboard state
+    @param      psJoypad        - Joypad state
+    @param      psMouse         - Mouse state
+ -----------------------------------------------------------------------------*/
+void LIB_Replay_FromState( ReplayTick_t* psTick, const ApolloKeyBoardState* psKeyboard, const ApolloJoypadState* psJoypad, const ApolloMouseState* psMouse )
+{
+    uint16_t uwJoypad = 0;
+
+    // cleared first, ticks are compared whole
+    memset( psTick, 0, sizeof( ReplayTick_t ) );
+    memcpy( psTick->KeysDown, psKeyboard->Keys_Down, sizeof( psTick->KeysDown ) );
+    memcpy( psTick->KeysPressed, psKeyboard->Keys_Pressed, sizeof( psTick->KeysPressed ) );
+
+    // the joypad register bits ApolloJoypadDecode reads
+    if ( psJoypad->Joypad_X_Delta > 0 ) uwJoypad |= 0x8000;
+    if ( psJoypad->Joypad_X_Delta < 0 ) uwJoypad |= 0x4000;
+    if ( psJoypad->Joypad_Y_Delta > 0 ) uwJoypad |= 0x2000;
+    if ( psJoypad->Joypad_Y_Delta < 0 ) uwJoypad |= 0x1000;
+    if ( psJoypad->Joypad_Start )       uwJoypad |= 0x0400;
+    if ( psJoypad->Joypad_Back )        uwJoypad |= 0x0200;
+    if ( psJoypad->Joypad_TR )          uwJoypad |= 0x0100;
+    if ( psJoypad->Joypad_TL )          uwJoypad |= 0x0080;
+    if ( psJoypad->Joypad_BR )          uwJoypad |= 0x0040;
+    if ( psJoypad->Joypad_BL )          uwJoypad |= 0x0020;
+    if ( psJoypad->Joypad_Y )           uwJoypad |= 0x0010;
+    if ( psJoypad->Joypad_X )           uwJoypad |= 0x0008;
+    if ( psJoypad->Joypad_B )           uwJoypad |= 0x0004;
+    if ( psJoypad->Joypad_A )           uwJoypad |= 0x0002;
+    if ( psJoypad->Joypad_Connect )     uwJoypad |= 0x0001;
+
+    psTick->ubKey         = psKeyboard->Current_Key;
+    psTick->ubPad         = 0;
+    psTick->uwJoypad      = uwJoypad;
+    psTick->wMouseX       = psMouse->MouseX_Pointer;
+    psTick->wMouseY       = psMouse->MouseY_Pointer;
+    psTick->uwButtonState = psMouse->Button_State;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Puts a tick of input into the state structs, the joypad
+                actioned flags main.c keeps are left alone
+    @ingroup 	MainShell
+    @param      psTick          - Tick
+    @param      psKeyboard      - Keyboard state
+    @param      psJoypad        - Joypad state
+    @param      psMouse         - Mouse state
+ -----------------------------------------------------------------------------*/
+void LIB_Replay_ToState( const ReplayTick_t* psTick, ApolloKeyBoardState* psKeyboard, ApolloJoypadState* psJoypad, ApolloMouseState* psMouse )
+{
+    ApolloKeyboardBegin( psKeyboard );
+    memcpy( psKeyboard->Keys_Down, psTick->KeysDown, sizeof( psKeyboard->Keys_Down ) );
+    memcpy( psKeyboard->Keys_Pressed, psTick->KeysPressed, sizeof( psKeyboard->Keys_Pressed ) );
+    ApolloKeyboardEnd( psKeyboard );
+
+    psKeyboard->Current_Key = psTick->ubKey;
+    if ( psTick->ubKey != APOLLOKEY_NONE )
+    {
+        psKeyboard->Previous_Key = psTick->ubKey;
+    }
+
+    ApolloJoypadDecode( psJoypad, psTick->uwJoypad );
+
+    psMouse->MouseX_Pointer = psTick->wMouseX;
+    psMouse->MouseY_Pointer = psTick->wMouseY;
+    psMouse->Button_State   = psTick->uwButtonState;
+    psMouse->Button_Left    = ( psTick->uwButtonState & APOLLOMOUSE_LEFTDOWN ) != 0;
+    psMouse->Button_Right   = ( psTick->uwButtonState & APOLLOMOUSE_RIGHTDOWN ) != 0;
+    psMouse->Button_Middle  = ( psTick->uwButtonState & APOLLOMOUSE_MIDDLEDOWN ) != 0;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Writes the run being recorded
+    @ingroup 	MainShell
+    @return     bool            - false on a failed write
+ -----------------------------------------------------------------------------*/
+static bool WriteRun( void )
+{
+    uint8_t Record[ REPLAY_RECORD ];
+
+    Put16( Record, (uint16_t)sReplay.ulRunLeft );
+    Record[ 2 ] = sReplay.sRun.ubKey;
+    Record[ 3 ] = 0;
+    Put16( Record + 4, sReplay.sRun.uwJoypad );
+    Put16( Record + 6, (uint16_t)sReplay.sRun.wMouseX );
+    Put16( Record + 8, (uint16_t)sReplay.sRun.wMouseY );
+    Put16( Record + 10, sReplay.sRun.uwButtonState );
+    for ( uint32_t i = 0; i < APOLLOKEY_LONGS; i++ )
+    {
+        Put32( Record + 12 + ( i * 4 ), sReplay.sRun.KeysDown[ i ] );
+        Put32( Record + 12 + ( ( APOLLOKEY_LONGS + i ) * 4 ), sReplay.sRun.KeysPressed[ i ] );
+    }
+    sReplay.ulRecords++;
+
+    return fwrite( Record, 1, REPLAY_RECORD, sReplay.pFile ) == REPLAY_RECORD;
+}
+
+static void Put16( uint8_t* pOut, uint16_t uwValue )
+{
+    pOut[ 0 ] = (uint8_t)( uwValue >> 8 );
+    pOut[ 1 ] = (uint8_t)uwValue;
+}
+
+static void Put32( uint8_t* pOut, uint32_t ulValue )
+{
+    Put16( pOut, (uint16_t)( ulValue >> 16 ) );
+    Put16( pOut + 2, (uint16_t)ulValue );
+}
+
+static uint16_t Get16( const uint8_t* pIn )
+{
+    return (uint16_t)( ( pIn[ 0 ] << 8 ) | pIn[ 1 ] );
+}
+
+static uint32_t Get32( const uint8_t* pIn )
+{
+    return ( (uint32_t)Get16( pIn ) << 16 ) | Get16( pIn + 2 );
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Replay.c
+//-----------------------------------------------------------------------------
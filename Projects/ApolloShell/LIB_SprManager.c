@@ -6,6 +6,32 @@
  -----------------------------------------------------------------------------
 	Notes
 
+	A fixed pool of TOTAL_SPRITES sprites. LIB_SprManager_Update is the
+	tick, each sprite's control callback, its move and its animation.
+	LIB_SprManager_Draw is the frame, world to screen against the camera,
+	off screen sprites culled, and the rest drawn back to front by SprZ.
+
+	An animation is a list of SPRFRAMEs run in turn. A frame shows its
+	image for FrameCount steps of FrameDelay ticks, a zero is one, then
+	the next frame starts. SPR_CMD_MOVE puts the sprite on the line from
+	Positions[0] to Positions[1] each step, reaching the end on the last.
+	SPR_CMD_ROTATE turns fMoveAngle by FrameData[0] degrees each step and
+	shows one of FrameData[1] images from FrameID by the angle. SPR_CMD_ANIM
+	starts animation FrameData[0] of the sprite's list, and inactive frames
+	are passed over, neither takes a tick. SPR_CMD_END, or the last frame,
+	is the end, what happens then is the AnimType.
+
+	Draw is a counting sort, the 256 SprZ values are counted, the counts
+	give each Z its start in the list, then the visible sprites are placed
+	in pool order. One pass each way, no compares, and equal Z keeps pool
+	order so the picture does not flicker between frames. The list goes to
+	LIB_Sprites_DrawBatch in one call.
+
+	Collidable sprites are kept in the LIB_Collision grid as the body of
+	their SprID, moved there at the end of each update, by CollisionRect
+	when it has a size or the whole image if not. LIB_Collision_FindPairs
+	then gives the sprites touching.
+
 --------------------------------------------------------------------------- */
 
 //-----------------------------------------------------------------------------
@@ -14,163 +40,44 @@
 
 #include "stdint.h"
 #include "stdbool.h"
+#include "string.h"
 #include "Includes/FlagStruct.h"
-#include "Includes/defines.h"
 #include "Includes/LIB_Sprites.h"
 #include "Includes/LIB_SprManager.h"
+#include "Includes/LIB_Collision.h"
 
 //-----------------------------------------------------------------------------
 // Defines
 //-----------------------------------------------------------------------------
 
-#define TOTAL_SPRITES		( 256 )
 #define ON					( 1 )
 #define OFF					( 0 )
+#define MAX_INSTANT			( 16 )		// frames taking no time, run in one tick
 
 //-----------------------------------------------------------------------------
 // Typedefs and enums
 //-----------------------------------------------------------------------------
 
-typedef enum
-{
-	SPR_CMD_NONE = 0,
-	SPR_CMD_MOVE,
-	SPR_CMD_ROTATE,
-	SPR_CMD_ANIM,
-	SPR_CMD_FRAME,
-	SPR_CMD_END
-
-} eSPRCMD;
-
-typedef enum
-{
-	SPR_ANIM_NONE = 0,
-	SPR_ANIM_LOOP,
-	SPR_ANIM_PINGPONG,
-	SPR_ANIM_ONCE
-
-} eSPRANIMTYPE;
-
-// Callbacks
-typedef void (*fnSprControl)(PSPRITE pSprite);
-
-typedef struct
-{
-    uint16_t	X;
-	uint16_t    Y;
-
-} POSITION, *POSITION;
-
-typedef struct
-{
-	uint16_t	X;
-	uint16_t	Y;
-	uint16_t	W;
-	uint16_t	H;
-
-} RECT, *RECT;
-
-typedef union
-{
-	struct
-	{
-		uint32_t    Active		: 1;
-		uint32_t    OnScreen	: 1;
-		uint32_t    Paused		: 1;
-		uint32_t    DeleteMe	: 1;
-		uint32_t    Collidable	: 1;
-		uint32_t    Visible		: 1;
-		uint32_t    Animated	: 1;
-		uint32_t    Reserved	: 25;
-	};
-
-	uint32_t	Flags;
-
-} SPRFLAG,*PSPRFLAG;
-
-typedef union
-{
-	struct
-	{
-		uint16_t    Active : 1;
-		uint16_t    Looping : 1;
-		uint16_t    Reserved : 14;
-
-	};
-
-	uint16_t    Flags;
-
-} SPRFRAMEFLAGS, * PSPRFRAMEFLAGS;
-
-typedef struct
-{
-	SPRFRAMEFLAGS	FrameFlags;
-
-	// Reference Frame Information	
-	uint16_t		FrameID;
-	uint16_t		FrameCMD;
-	uint16_t		FrameData[ 2 ];
-	POSITION		Positions[ 2 ];			
-	uint16_t		FrameCount;
-	uint16_t		FrameDelay;
-
-	// Working Frame Data
-	uint16_t		FrameCurCount;
-	uint16_t		FrameCurDelay;
-	POSITION		FrameCurPos;
-
-} SPRFRAME, *PSPRFRAME;
-
-
-typedef struct
-{
-	uint16_t	AnimID;
-	uint16_t	AnimType;
-	uint16_t	AnimFrames;
-	uint16_t	AnimCurFrame;
-	SPRFRAME*	pFrames;
-
-} SPRANIM, * PSPRANIM;
-
-typedef struct
-{
-	// General Sprite Information
-	uint8_t		SprID;
-	uint8_t     SprGroup;
-	SPRFLAG		SprFlags;
-	uint32_t	SprResourceID;
-	uint16_t	ScreenX;
-	uint16_t	ScreenY;
-	float		fWorldX;
-	float		fWorldY;
-	uint16_t	SprWidth;
-	uint16_t	SprHeight;
-	uint8_t		SprZ;	
-
-	// Animation Information
-	PSPRANIM	pAnimData;
-	uint16_t	CurAnimIndex;
-
-	// Collision Information
-	RECT		CollisionRect;
-
-	// Movement Information
-	float		fMoveSpeed;
-	float		fMoveAngle;
-	float		fMoveX;
-	float		fMoveY;
-
-	// Control Callbacks
-	fnSprControl	fnControl;
-
-} SPRITE,*PSPRITE;
-
 typedef struct
 {
 	FlagStruct_t	sFlags;
 	uint16_t		SprCount;
 	SPRITE			Sprites[ TOTAL_SPRITES ];
 
+	// Camera and the screen area the world is shown in
+	int32_t			CameraX;
+	int32_t			CameraY;
+	int32_t			ViewX;
+	int32_t			ViewY;
+	int32_t			ViewW;
+	int32_t			ViewH;
+
+	// Draw pass
+	uint8_t			Visible[ TOTAL_SPRITES ];
+	uint16_t		ZStart[ SPR_Z_LEVELS ];
+	SpriteDraw_t	Batch[ TOTAL_SPRITES ];
+	SprStats_t		sStats;
+
 } SPRITEMANAGER, *PSPRITEMANAGER;
 
 //-----------------------------------------------------------------------------
@@ -179,6 +86,17 @@ typedef struct
 
 SPRITEMANAGER sSprMgr = { .sFlags.Flags = 0 };
 
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void StepAnim( PSPRITE pSprite );
+static bool StartAnim( PSPRITE pSprite, uint16_t nAnim );
+static bool NextFrame( PSPRITE pSprite );
+static void StartFrame( PSPRITE pSprite, PSPRFRAME pFrame );
+static void StepFrame( PSPRITE pSprite, PSPRFRAME pFrame );
+static void SetBody( PSPRITE pSprite );
+
 //-----------------------------------------------------------------------------
 // External Functionality
 //-----------------------------------------------------------------------------
@@ -193,31 +111,45 @@ void LIB_SprManager_Init(void)
 	if ( sSprMgr.sFlags.Initialized == OFF )
 	{
 		// Clear the sprite manager
-		sSprMgr.SprCount			= 0;
+		memset( &sSprMgr, 0, sizeof( sSprMgr ) );
+		sSprMgr.ViewW				= 640;
+		sSprMgr.ViewH				= 480;
 		sSprMgr.sFlags.Initialized	= ON;
+		LIB_Collision_Init();
+	}
+}
 
-		// Clear all sprites
+/** ---------------------------------------------------------------------------
+	@brief		Remove all sprites
+	@param		None
+	@return		None
+--------------------------------------------------------------------------- */
+void LIB_SprManager_Clear(void)
+{
+	if (sSprMgr.sFlags.Initialized == ON)
+	{
+		memset( sSprMgr.Sprites, 0, sizeof( sSprMgr.Sprites ) );
+		sSprMgr.SprCount = 0;
 		for (uint16_t i = 0; i < TOTAL_SPRITES; i++)
 		{
-			sSprMgr.Sprites[i] = { 0 };
+			LIB_Collision_Remove( i );
 		}
-
 	}
 }
 
 /** ---------------------------------------------------------------------------
 	@brief		Add Sprite to the manager
-	@param		nResourceID - Resource ID of the sprite (from LIB_Sprites)
-				nX			- X position of the sprite
-				nY			- Y position of the sprite
+	@param		nResourceID - Sprite bank of the sprite (from LIB_Sprites)
+				nX			- X world position of the sprite
+				nY			- Y world position of the sprite
 				nGroup		- Group ID of the sprite
-				nZ			- Z order of the sprite
-				fnControl	- Control function for the sprite
-	@return		bool		- True if successful
+				nZ			- Z order of the sprite, 0 at the back
+				fnControl	- Control function for the sprite, may be NULL
+	@return		PSPRITE		- The sprite, NULL if the pool is full
 ---------------------------------------------------------------------------- */
-bool LIB_SprManager_Add(uin32_t nResourceID, uint16_t nX, uint16_t nY, uint16_t nGroup, uint16_t nZ, fnSprControl fnControl)
+PSPRITE LIB_SprManager_Add(uint32_t nResourceID, uint16_t nX, uint16_t nY, uint16_t nGroup, uint16_t nZ, fnSprControl fnControl)
 {
-	bool bResult = false;
+	PSPRITE pResult = NULL;
 
 	if (sSprMgr.sFlags.Initialized == ON)
 	{
@@ -228,25 +160,29 @@ bool LIB_SprManager_Add(uin32_t nResourceID, uint16_t nX, uint16_t nY, uint16_t
 			{
 				if (sSprMgr.Sprites[i].SprFlags.Active == OFF)
 				{
+					PSPRITE pSprite = &sSprMgr.Sprites[i];
+
 					// Set the sprite data
-					sSprMgr.Sprites[i].SprID = i;
-					sSprMgr.Sprites[i].SprGroup = nGroup;
-					sSprMgr.Sprites[i].SprResourceID = nResourceID;
-					sSprMgr.Sprites[i].ScreenX = nX;
-					sSprMgr.Sprites[i].ScreenY = nY;
-					sSprMgr.Sprites[i].SprZ = nZ;
-					sSprMgr.Sprites[i].fnControl = fnControl;
+					memset( pSprite, 0, sizeof( SPRITE ) );
+					pSprite->SprID = i;
+					pSprite->SprGroup = nGroup;
+					pSprite->SprResourceID = nResourceID;
+					pSprite->fWorldX = nX;
+					pSprite->fWorldY = nY;
+					pSprite->SprWidth = LIB_Sprites_GetWidth( nResourceID );
+					pSprite->SprHeight = LIB_Sprites_GetHeight( nResourceID );
+					pSprite->SprZ = nZ;
+					pSprite->fnControl = fnControl;
 
 					// Set the sprite flags
-					sSprMgr.Sprites[i].SprFlags.Active = ON;
-					sSprMgr.Sprites[i].SprFlags.OnScreen = ON;
-					sSprMgr.Sprites[i].SprFlags.Visible = ON;
+					pSprite->SprFlags.Active = ON;
+					pSprite->SprFlags.Visible = ON;
 
 					// Increment the sprite count
 					sSprMgr.SprCount++;
 
 					// Set the result
-					bResult = true;
+					pResult = pSprite;
 
 					// Break out of the loop
 					break;
@@ -255,12 +191,68 @@ bool LIB_SprManager_Add(uin32_t nResourceID, uint16_t nX, uint16_t nY, uint16_t
 		}
 	}
 
-	return bResult;
+	return pResult;
 }
 
 /** ---------------------------------------------------------------------------
-	@brief		Remove a sprite from the manager
-	@param		uint16_t nSpriteID
+	@brief		Remove a sprite from the manager, safe from its own callback
+	@param		pSprite		- Sprite to remove
+	@return		None
+ --------------------------------------------------------------------------- */
+void LIB_SprManager_Remove(PSPRITE pSprite)
+{
+	if (pSprite != NULL && pSprite->SprFlags.Active == ON)
+	{
+		pSprite->SprFlags.DeleteMe = ON;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Give a sprite its animations and start one
+	@param		pSprite		- Sprite to animate
+				pAnims		- Its animations, its own copy
+				nAnims		- Animations in pAnims
+				nAnim		- Animation to start
+	@return		None
+ --------------------------------------------------------------------------- */
+void LIB_SprManager_SetAnim(PSPRITE pSprite, PSPRANIM pAnims, uint16_t nAnims, uint16_t nAnim)
+{
+	if (pSprite != NULL)
+	{
+		pSprite->pAnimData = pAnims;
+		pSprite->AnimCount = nAnims;
+		pSprite->SprFlags.Animated = StartAnim( pSprite, nAnim ) ? ON : OFF;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Set the screen area the world is drawn into
+	@param		x, y		- Top left on the screen
+				w, h		- Size
+	@return		None
+ --------------------------------------------------------------------------- */
+void LIB_SprManager_SetView(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	sSprMgr.ViewX = x;
+	sSprMgr.ViewY = y;
+	sSprMgr.ViewW = w;
+	sSprMgr.ViewH = h;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Set the world position shown at the top left of the view
+	@param		x, y		- World position
+	@return		None
+ --------------------------------------------------------------------------- */
+void LIB_SprManager_SetCamera(int32_t x, int32_t y)
+{
+	sSprMgr.CameraX = x;
+	sSprMgr.CameraY = y;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Run all the sprites for a tick
+	@param		None
 	@return		None
  --------------------------------------------------------------------------- */
 void LIB_SprManager_Update(void)
@@ -269,11 +261,39 @@ void LIB_SprManager_Update(void)
 	{
 		for (uint16_t i = 0; i < TOTAL_SPRITES; i++)
 		{
-			if (sSprMgr.Sprites[i].SprFlags.Active == ON)
+			PSPRITE pSprite = &sSprMgr.Sprites[i];
+
+			if (pSprite->SprFlags.Active == ON)
 			{
-				if (sSprMgr.Sprites[i].fnControl != NULL)
+				if (pSprite->SprFlags.DeleteMe == OFF && pSprite->SprFlags.Paused == OFF)
+				{
+					if (pSprite->fnControl != NULL)
+					{
+						pSprite->fnControl(pSprite);
+					}
+
+					pSprite->fWorldX += pSprite->fMoveX;
+					pSprite->fWorldY += pSprite->fMoveY;
+
+					if (pSprite->SprFlags.Animated == ON)
+					{
+						StepAnim(pSprite);
+					}
+				}
+
+				if (pSprite->SprFlags.DeleteMe == ON)
+				{
+					LIB_Collision_Remove( i );
+					pSprite->SprFlags.Flags = 0;
+					sSprMgr.SprCount--;
+				}
+				else if (pSprite->SprFlags.Collidable == ON)
 				{
-					sSprMgr.Sprites[i].fnControl(&sSprMgr.Sprites[i]);
+					SetBody(pSprite);
+				}
+				else
+				{
+					LIB_Collision_Remove( i );
 				}
 			}
 		}
@@ -281,29 +301,329 @@ void LIB_SprManager_Update(void)
 }
 
 /** ---------------------------------------------------------------------------
-	@brief		Draw all sprites
+	@brief		Draw all sprites in the view, back to front
 	@param		None
-	@return		None
+	@return		uint32_t	- Sprites drawn
  --------------------------------------------------------------------------- */
-void LIB_SprManager_Draw(void)
+uint32_t LIB_SprManager_Draw(void)
 {
+	uint32_t nVisible = 0;
+
+	memset( &sSprMgr.sStats, 0, sizeof( sSprMgr.sStats ) );
 	if (sSprMgr.sFlags.Initialized == ON)
 	{
+		int32_t nOffX = sSprMgr.ViewX - sSprMgr.CameraX;
+		int32_t nOffY = sSprMgr.ViewY - sSprMgr.CameraY;
+
+		// Transform, cull and count each Z
+		memset( sSprMgr.ZStart, 0, sizeof( sSprMgr.ZStart ) );
 		for (uint16_t i = 0; i < TOTAL_SPRITES; i++)
 		{
-			if (sSprMgr.Sprites[i].SprFlags.Active == ON)
+			PSPRITE pSprite = &sSprMgr.Sprites[i];
+
+			if (pSprite->SprFlags.Active == ON)
 			{
-				if (sSprMgr.Sprites[i].SprFlags.Visible == ON)
+				int32_t x = (int32_t)pSprite->fWorldX + nOffX;
+				int32_t y = (int32_t)pSprite->fWorldY + nOffY;
+
+				sSprMgr.sStats.ulActive++;
+				pSprite->ScreenX = x;
+				pSprite->ScreenY = y;
+				pSprite->SprFlags.OnScreen = ( x + pSprite->SprWidth > sSprMgr.ViewX && x < sSprMgr.ViewX + sSprMgr.ViewW &&
+											   y + pSprite->SprHeight > sSprMgr.ViewY && y < sSprMgr.ViewY + sSprMgr.ViewH ) ? ON : OFF;
+
+				if (pSprite->SprFlags.OnScreen == ON && pSprite->SprFlags.Visible == ON)
 				{
-					LIB_Sprites_Draw(sSprMgr.Sprites[i].SprResourceID, sSprMgr.Sprites[i].ScreenX, sSprMgr.Sprites[i].ScreenY);
+					sSprMgr.Visible[nVisible++] = i;
+					sSprMgr.ZStart[pSprite->SprZ]++;
 				}
 			}
 		}
+
+		// Counts to the start of each Z in the batch
+		uint16_t nStart = 0;
+		for (uint16_t z = 0; z < SPR_Z_LEVELS; z++)
+		{
+			uint16_t nCount = sSprMgr.ZStart[z];
+
+			sSprMgr.ZStart[z] = nStart;
+			nStart += nCount;
+		}
+
+		// Place each in its Z, pool order within a Z
+		for (uint32_t i = 0; i < nVisible; i++)
+		{
+			PSPRITE pSprite = &sSprMgr.Sprites[sSprMgr.Visible[i]];
+			pSpriteDraw_t psDraw = &sSprMgr.Batch[sSprMgr.ZStart[pSprite->SprZ]++];
+
+			psDraw->uwBank = pSprite->SprResourceID;
+			psDraw->uwFrame = pSprite->SprFrameID;
+			psDraw->wX = pSprite->ScreenX;
+			psDraw->wY = pSprite->ScreenY;
+		}
+
+		sSprMgr.sStats.ulVisible = nVisible;
+		sSprMgr.sStats.ulDrawn = LIB_Sprites_DrawBatch( sSprMgr.Batch, nVisible );
 	}
+
+	return sSprMgr.sStats.ulDrawn;
 }
 
+/** ---------------------------------------------------------------------------
+	@brief		Sprite counts of the last draw
+	@param		psStats		- Filled in
+	@return		None
+ --------------------------------------------------------------------------- */
+void LIB_SprManager_GetStats(SprStats_t* psStats)
+{
+	if (psStats != NULL)
+	{
+		*psStats = sSprMgr.sStats;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Sprites in the pool
+	@param		None
+	@return		uint32_t	- Active sprites
+ --------------------------------------------------------------------------- */
+uint32_t LIB_SprManager_GetCount(void)
+{
+	return sSprMgr.SprCount;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		A sprite by its SprID
+	@param		nSpriteID	- SprID
+	@return		PSPRITE		- The sprite, NULL if not in use
+ --------------------------------------------------------------------------- */
+PSPRITE LIB_SprManager_GetSprite(uint32_t nSpriteID)
+{
+	if (nSpriteID < TOTAL_SPRITES && sSprMgr.Sprites[nSpriteID].SprFlags.Active == ON)
+	{
+		return &sSprMgr.Sprites[nSpriteID];
+	}
+	return NULL;
+}
 
 //-----------------------------------------------------------------------------
-// End of file: LIB_SprManager.c
+// Internal Functionality
 //-----------------------------------------------------------------------------
 
+/** ---------------------------------------------------------------------------
+	@brief		Runs a sprite's animation for a tick
+	@param		pSprite		- Sprite
+	@return		None
+ --------------------------------------------------------------------------- */
+static void StepAnim(PSPRITE pSprite)
+{
+	PSPRANIM pAnim = &pSprite->pAnimData[pSprite->CurAnimIndex];
+	PSPRFRAME pFrame = &pAnim->pFrames[pAnim->AnimCurFrame];
+	uint16_t nCount = pFrame->FrameCount ? pFrame->FrameCount : 1;
+	uint16_t nDelay = pFrame->FrameDelay ? pFrame->FrameDelay : 1;
+
+	if (++pFrame->FrameCurDelay < nDelay)
+	{
+		return;
+	}
+	pFrame->FrameCurDelay = 0;
+	pFrame->FrameCurCount++;
+	StepFrame(pSprite, pFrame);
+
+	if (pFrame->FrameCurCount >= nCount)
+	{
+		if (pFrame->FrameFlags.Looping == ON)
+		{
+			StartFrame(pSprite, pFrame);
+		}
+		else if (NextFrame(pSprite) == false)
+		{
+			pSprite->SprFlags.Animated = OFF;
+		}
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Starts one of a sprite's animations from its first frame
+	@param		pSprite		- Sprite
+				nAnim		- Animation
+	@return		bool		- false if there is nothing to run
+ --------------------------------------------------------------------------- */
+static bool StartAnim(PSPRITE pSprite, uint16_t nAnim)
+{
+	if (pSprite->pAnimData == NULL || nAnim >= pSprite->AnimCount ||
+		pSprite->pAnimData[nAnim].pFrames == NULL || pSprite->pAnimData[nAnim].AnimFrames == 0)
+	{
+		return false;
+	}
+
+	PSPRANIM pAnim = &pSprite->pAnimData[nAnim];
+
+	// From before the first frame, it may take no time as any after it
+	pSprite->CurAnimIndex = nAnim;
+	pAnim->AnimCurFrame = (uint16_t)-1;
+	pAnim->AnimDir = 1;
+	return NextFrame(pSprite);
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Moves on to the next frame that takes time, by the AnimType
+				at the end
+	@param		pSprite		- Sprite
+	@return		bool		- false if the animation has stopped
+ --------------------------------------------------------------------------- */
+static bool NextFrame(PSPRITE pSprite)
+{
+	for (uint16_t nInstant = 0; nInstant < MAX_INSTANT; nInstant++)
+	{
+		PSPRANIM pAnim = &pSprite->pAnimData[pSprite->CurAnimIndex];
+		int32_t nNext = (int16_t)pAnim->AnimCurFrame + pAnim->AnimDir;
+
+		if (nNext < 0)
+		{
+			// Ping pong, back at the start
+			pAnim->AnimDir = 1;
+			nNext = ( pAnim->AnimFrames > 1 && pAnim->pFrames[1].FrameCMD != SPR_CMD_END ) ? 1 : 0;
+		}
+		else if (nNext >= pAnim->AnimFrames || pAnim->pFrames[nNext].FrameCMD == SPR_CMD_END)
+		{
+			if (pAnim->AnimType == SPR_ANIM_LOOP)
+			{
+				nNext = 0;
+			}
+			else if (pAnim->AnimType == SPR_ANIM_PINGPONG)
+			{
+				pAnim->AnimDir = -1;
+				nNext = nNext >= 2 ? nNext - 2 : 0;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		PSPRFRAME pFrame = &pAnim->pFrames[nNext];
+
+		pAnim->AnimCurFrame = nNext;
+		if (pFrame->FrameFlags.Active == OFF)
+		{
+			continue;
+		}
+		if (pFrame->FrameCMD == SPR_CMD_ANIM)
+		{
+			if (pFrame->FrameData[0] >= pSprite->AnimCount || pSprite->pAnimData[pFrame->FrameData[0]].AnimFrames == 0)
+			{
+				continue;
+			}
+			pSprite->CurAnimIndex = pFrame->FrameData[0];
+			pAnim = &pSprite->pAnimData[pSprite->CurAnimIndex];
+			pAnim->AnimCurFrame = (uint16_t)-1;
+			pAnim->AnimDir = 1;
+			continue;
+		}
+
+		StartFrame(pSprite, pFrame);
+		return true;
+	}
+
+	// Stopped, or frames that take no time all the way round
+	if (pSprite->pAnimData[pSprite->CurAnimIndex].AnimCurFrame == (uint16_t)-1)
+	{
+		pSprite->pAnimData[pSprite->CurAnimIndex].AnimCurFrame = 0;
+	}
+	return false;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Starts a frame, shows its image and puts a move at its start
+	@param		pSprite		- Sprite
+				pFrame		- Frame
+	@return		None
+ --------------------------------------------------------------------------- */
+static void StartFrame(PSPRITE pSprite, PSPRFRAME pFrame)
+{
+	pFrame->FrameCurCount = 0;
+	pFrame->FrameCurDelay = 0;
+	StepFrame(pSprite, pFrame);
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		A step of a frame's command
+	@param		pSprite		- Sprite
+				pFrame		- Frame, FrameCurCount steps done
+	@return		None
+ --------------------------------------------------------------------------- */
+static void StepFrame(PSPRITE pSprite, PSPRFRAME pFrame)
+{
+	uint16_t nCount = pFrame->FrameCount ? pFrame->FrameCount : 1;
+
+	pSprite->SprFrameID = pFrame->FrameID;
+	switch (pFrame->FrameCMD)
+	{
+		case SPR_CMD_MOVE:
+		{
+			int32_t nX = pFrame->Positions[0].X + ( ( (int32_t)pFrame->Positions[1].X - pFrame->Positions[0].X ) * pFrame->FrameCurCount ) / nCount;
+			int32_t nY = pFrame->Positions[0].Y + ( ( (int32_t)pFrame->Positions[1].Y - pFrame->Positions[0].Y ) * pFrame->FrameCurCount ) / nCount;
+
+			pFrame->FrameCurPos.X = nX;
+			pFrame->FrameCurPos.Y = nY;
+			pSprite->fWorldX = nX;
+			pSprite->fWorldY = nY;
+			break;
+		}
+
+		case SPR_CMD_ROTATE:
+		{
+			if (pFrame->FrameCurCount != 0)
+			{
+				pSprite->fMoveAngle += (int16_t)pFrame->FrameData[0];
+				while (pSprite->fMoveAngle >= 360.0f) pSprite->fMoveAngle -= 360.0f;
+				while (pSprite->fMoveAngle < 0.0f) pSprite->fMoveAngle += 360.0f;
+			}
+			if (pFrame->FrameData[1] > 1)
+			{
+				uint32_t nImage = (uint32_t)( pSprite->fMoveAngle * pFrame->FrameData[1] / 360.0f );
+
+				pSprite->SprFrameID += nImage < pFrame->FrameData[1] ? nImage : 0;
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief		Moves a sprite's collision body to where it is now
+	@param		pSprite		- Sprite
+	@return		None
+ --------------------------------------------------------------------------- */
+static void SetBody(PSPRITE pSprite)
+{
+	CollisionBox_t sBox;
+
+	sBox.lImageX = (int32_t)pSprite->fWorldX;
+	sBox.lImageY = (int32_t)pSprite->fWorldY;
+	sBox.lBank = pSprite->SprResourceID;
+	sBox.ulFrame = pSprite->SprFrameID;
+	if (pSprite->CollisionRect.W != 0 && pSprite->CollisionRect.H != 0)
+	{
+		sBox.x = sBox.lImageX + pSprite->CollisionRect.X;
+		sBox.y = sBox.lImageY + pSprite->CollisionRect.Y;
+		sBox.w = pSprite->CollisionRect.W;
+		sBox.h = pSprite->CollisionRect.H;
+	}
+	else
+	{
+		sBox.x = sBox.lImageX;
+		sBox.y = sBox.lImageY;
+		sBox.w = pSprite->SprWidth;
+		sBox.h = pSprite->SprHeight;
+	}
+	LIB_Collision_Set(pSprite->SprID, &sBox);
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_SprManager.c
+//-----------------------------------------------------------------------------
@@ -8,6 +8,15 @@
  -----------------------------------------------------------------------------
 	Notes
 
+	LIB_Sprites_DrawRemapped looks every pixel up through a 256 byte table
+	as it is drawn, so one bank can be shown in each team's colours. The
+	tables are kept here, shared by anything drawing that team, and built
+	by LIB_Palette_BuildRemap. The load time remap still moves each group
+	into its part of the palette, the tables work on top of it.
+
+	LIB_Sprites_DrawBlended is the same walk with a 64K LIB_Blend table,
+	each pixel becomes table[ sprite ][ screen ] for smoke and shadows.
+
 --------------------------------------------------------------------------- */
 
 //-----------------------------------------------------------------------------
@@ -47,15 +56,31 @@ typedef struct
     int32_t        ulClipTop;                           //!< Clip top
     int32_t        ulClipRight;                         //!< Clip right
     int32_t        ulClipBottom;                        //!< Clip bottom
+    uint8_t        Remaps[ SPRITE_MAX_REMAPS ][ SPRITE_REMAP_SIZE ];  //!< Shared colour remaps
+    uint32_t       ulRemaps;                            //!< Remaps in use
 
 } SpriteCtrl, *pSpriteCtrl;                             //!< Sprite Control structure
 
+/**-----------------------------------------------------------------------------
+    @brief      Draws a clipped span of sprite pixels through a table
+    @ingroup 	MainShell
+ ---------------------------------------------------------------------------- */
+typedef void (*SpanFunc_t)( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount, const uint8_t* pTable );
+
 //-----------------------------------------------------------------------------
 // Variables
 //-----------------------------------------------------------------------------
 
 SpriteCtrl     SprCtrl = { .Flags = { .Flags = 0 } };   //!< Sprite Control structure
 
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static bool DrawSpans( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pTable, SpanFunc_t pSpan );
+static void RemapSpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount, const uint8_t* pRemap );
+static void BlendSpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount, const uint8_t* pBlend );
+
 //-----------------------------------------------------------------------------
 // Code
 //-----------------------------------------------------------------------------
@@ -109,6 +134,24 @@ uint32_t LIB_Sprites_GetHeight( eSpriteBank_t eBank )
     return ulRet;
 }
 
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the width of the sprites in the bank
+    @ingroup 	MainShell
+    @param      eBank           - Sprite bank to draw from
+    @return     uint32_t        - Sprite width
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Sprites_GetWidth( eSpriteBank_t eBank )
+{
+    uint32_t ulRet = 0;
+
+    if ( eBank < MAX_SPRITE_BANKS && SprCtrl.Flags.Initialized == true )
+    {
+        ulRet = SprCtrl.SpriteBanks[ eBank ].ulSpriteWidth;
+    }
+
+    return ulRet;
+}
+
 /** ----------------------------------------------------------------------------
     @brief 		Register a sprite bank
     @ingroup 	MainShell
@@ -161,6 +204,21 @@ void LIB_Sprites_SetClipArea( uint32_t x, uint32_t y, uint32_t w, uint32_t h )
     SprCtrl.ulClipBottom = y + h;
 }
 
+/** ----------------------------------------------------------------------------
+    @brief      Returns the clip area, to put it back after changing it
+    @ingroup    MainShell
+    @param      pX              - X position
+    @param      pY              - Y position
+    @param      pW              - Width
+    @param      pH              - Height
+ ---------------------------------------------------------------------------- */
+void LIB_Sprites_GetClipArea( int32_t* pX, int32_t* pY, int32_t* pW, int32_t* pH )
+{
+    *pX = SprCtrl.ulClipLeft;
+    *pY = SprCtrl.ulClipTop;
+    *pW = SprCtrl.ulClipRight - SprCtrl.ulClipLeft;
+    *pH = SprCtrl.ulClipBottom - SprCtrl.ulClipTop;
+}
 
 /** -----------------------------------------------------------------------------
     @brief      Draw a sprite flipped
@@ -518,6 +576,185 @@ bool LIB_Sprites_Draw( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t
     return bRet;
 }
 
+/** ----------------------------------------------------------------------------
+    @brief 		Draw a sprite with every pixel looked up through a remap table
+    @ingroup 	MainShell
+    @param      eBank           - Sprite bank to draw from
+    @param      sprNum          - Sprite number
+    @param      x               - X position
+    @param      y               - Y position
+    @param      pRemap          - SPRITE_REMAP_SIZE bytes, new index for each
+                                  pixel index, 0 stays transparent
+    @return 	bool            - true if successful
+ -----------------------------------------------------------------------------*/
+bool LIB_Sprites_DrawRemapped( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pRemap )
+{
+    return DrawSpans( eBank, sprNum, x, y, pRemap, RemapSpan );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draw a sprite see through, every pixel is looked up in a blend
+                table with the screen pixel under it
+    @ingroup 	MainShell
+    @param      eBank           - Sprite bank to draw from
+    @param      sprNum          - Sprite number
+    @param      x               - X position
+    @param      y               - Y position
+    @param      pBlend          - 64K table from LIB_Blend_GetTable, indexed
+                                  ( sprite << 8 ) | screen
+    @return 	bool            - true if successful
+ -----------------------------------------------------------------------------*/
+bool LIB_Sprites_DrawBlended( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pBlend )
+{
+    return DrawSpans( eBank, sprNum, x, y, pBlend, BlendSpan );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draw a list of sprites in order, the first is at the back
+    @ingroup 	MainShell
+    @param      psDraws         - Sprites to draw
+    @param      ulCount         - Entries in psDraws
+    @return 	uint32_t        - Sprites drawn, the rest were clipped out
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Sprites_DrawBatch( const SpriteDraw_t* psDraws, uint32_t ulCount )
+{
+    uint32_t ulDrawn = 0;
+
+    if ( SprCtrl.Flags.Initialized == true && psDraws != NULL )
+    {
+        while ( ulCount-- != 0 )
+        {
+            if ( LIB_Sprites_Draw( psDraws->uwBank, psDraws->uwFrame, psDraws->wX, psDraws->wY ) == true )
+            {
+                ulDrawn++;
+            }
+            psDraws++;
+        }
+    }
+    return ulDrawn;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Keeps a copy of a remap table for all sprite draws to share
+    @ingroup 	MainShell
+    @param      pRemap          - SPRITE_REMAP_SIZE bytes
+    @return 	int32_t         - Remap handle, -1 if there is no room
+ -----------------------------------------------------------------------------*/
+int32_t LIB_Sprites_AddRemap( const uint8_t* pRemap )
+{
+    if ( pRemap == NULL || SprCtrl.ulRemaps >= SPRITE_MAX_REMAPS )
+    {
+        return -1;
+    }
+
+    for( uint32_t i = 0; i < SPRITE_REMAP_SIZE; i++ )
+    {
+        SprCtrl.Remaps[ SprCtrl.ulRemaps ][ i ] = pRemap[ i ];
+    }
+    // index 0 is transparent whatever the table says
+    SprCtrl.Remaps[ SprCtrl.ulRemaps ][ 0 ] = 0;
+
+    return SprCtrl.ulRemaps++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns a shared remap table
+    @ingroup 	MainShell
+    @param      lRemap          - Handle from LIB_Sprites_AddRemap
+    @return 	const uint8_t*  - Table for LIB_Sprites_DrawRemapped, NULL if none
+ -----------------------------------------------------------------------------*/
+const uint8_t* LIB_Sprites_GetRemap( int32_t lRemap )
+{
+    return ( lRemap >= 0 && lRemap < (int32_t)SprCtrl.ulRemaps ) ? SprCtrl.Remaps[ lRemap ] : NULL;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Decodes a sprite into a buffer, unclipped, at (0,0). Only the
+                opaque pixels are written, clear the buffer first.
+    @ingroup 	MainShell
+    @param      eBank           - Sprite bank to decode from
+    @param      sprNum          - Sprite number
+    @param      pDest           - Buffer, at least sprite width by height
+    @param      ulPitch         - Bytes per row of pDest
+    @return 	bool            - true if successful
+ -----------------------------------------------------------------------------*/
+bool LIB_Sprites_Decode( eSpriteBank_t eBank, uint32_t sprNum, uint8_t* pDest, uint32_t ulPitch )
+{
+    bool bRet = false;
+
+    // long list of protective checks
+    if ( (eBank < MAX_SPRITE_BANKS) && SprCtrl.Flags.Initialized == true && SprCtrl.SpriteBanks[ eBank ].pSpriteData != NULL && pDest != NULL && sprNum < SprCtrl.SpriteBanks[ eBank ].ulNumSprites )
+    {
+        uint8_t* pSpriteData = SprCtrl.SpriteBanks[ eBank ].pSpriteData;
+        uint32_t ulWidth     = SprCtrl.SpriteBanks[ eBank ].ulSpriteWidth;
+        uint32_t ulHeight    = SprCtrl.SpriteBanks[ eBank ].ulSpriteHeight;
+
+        if ( SprCtrl.SpriteBanks[ eBank ].ulSpriteType == eSpriteType_Raw )
+        {
+            pSpriteData += sprNum * ( ulWidth * ulHeight );
+            for( uint32_t y = 0; y < ulHeight; y++ )
+            {
+                for( uint32_t x = 0; x < ulWidth; x++ )
+                {
+                    if ( *pSpriteData != 0 )
+                    {
+                        pDest[ x ] = *pSpriteData;
+                    }
+                    pSpriteData++;
+                }
+                pDest += ulPitch;
+            }
+        }
+        else
+        {
+            //get to start of index for sprites..
+            uint8_t* pSprite = pSpriteData + 12;
+            uint8_t* pEnd    = pSpriteData + SprCtrl.SpriteBanks[ eBank ].ulSpriteSize;
+            uint32_t x = 0, y = 0;
+
+            while( *pSprite != ':' )
+            {
+                pSprite++;
+            }
+            pSprite++;
+            uint32_t ulOffset = *(((uint32_t*)pSprite) + sprNum);
+            ulOffset = Hardware_SwapLong( ulOffset );
+            pSprite += (SprCtrl.SpriteBanks[ eBank ].ulNumSprites * 4) + ulOffset;
+
+            // same command stream as LIB_Sprites_Draw, pixels outside the
+            // sprite's stated size are dropped
+            while( pSprite < pEnd && *pSprite != 0xFF )
+            {
+                uint8_t uCmd = *pSprite++;
+                if ( uCmd == 0xC9 )
+                {
+                    y++;
+                    x = 0;
+                    continue;
+                }
+                x += uCmd;
+                uint32_t ulIndex = *pSprite++;
+
+                while( ulIndex != 0 )
+                {
+                    if ( x < ulWidth && y < ulHeight )
+                    {
+                        pDest[ ( y * ulPitch ) + x ] = *pSprite;
+                    }
+                    x++;
+                    pSprite++;
+                    ulIndex--;
+                }
+            }
+        }
+
+        bRet = true;
+    }
+
+    // return the result
+    return bRet;
+}
+
 /** ----------------------------------------------------------------------------
     @brief 		Remap the sprite colours
     @ingroup 	MainShell
@@ -608,6 +845,147 @@ bool LIB_Sprites_Remap( eSpriteBank_t eSpriteBank, uint32_t ShiftBy )
     return bRet;
 }
 
+/** ----------------------------------------------------------------------------
+    @brief 		Walks a sprite's visible pixels a span at a time, for the
+                table driven draws
+    @ingroup 	MainShell
+    @param      eBank           - Sprite bank to draw from
+    @param      sprNum          - Sprite number
+    @param      x               - X position
+    @param      y               - Y position
+    @param      pTable          - Table passed to pSpan
+    @param      pSpan           - Draws one clipped span
+    @return 	bool            - true if successful
+ -----------------------------------------------------------------------------*/
+static bool DrawSpans( eSpriteBank_t eBank, uint32_t sprNum, int32_t x, int32_t y, const uint8_t* pTable, SpanFunc_t pSpan )
+{
+    bool bRet = false;
+
+    // long list of protective checks
+    if ( (eBank < MAX_SPRITE_BANKS) && SprCtrl.Flags.Initialized == true && SprCtrl.SpriteBanks[ eBank ].pSpriteData != NULL && pTable != NULL && sprNum < SprCtrl.SpriteBanks[ eBank ].ulNumSprites )
+    {
+        uint8_t* pSpriteData = SprCtrl.SpriteBanks[ eBank ].pSpriteData;
+        uint8_t* pScreen     = Hardware_GetScreenPtr();
+        uint32_t screenWidth = Hardware_GetScreenWidth();
+        int32_t  lWidth      = SprCtrl.SpriteBanks[ eBank ].ulSpriteWidth;
+        int32_t  lHeight     = SprCtrl.SpriteBanks[ eBank ].ulSpriteHeight;
+
+        if ( SprCtrl.SpriteBanks[ eBank ].ulSpriteType == eSpriteType_Raw )
+        {
+            // clip to the visible part of the sprite
+            int32_t xLeft   = x < SprCtrl.ulClipLeft ? SprCtrl.ulClipLeft - x : 0;
+            int32_t yTop    = y < SprCtrl.ulClipTop ? SprCtrl.ulClipTop - y : 0;
+            int32_t xRight  = x + lWidth > SprCtrl.ulClipRight ? SprCtrl.ulClipRight - x : lWidth;
+            int32_t yBottom = y + lHeight > SprCtrl.ulClipBottom ? SprCtrl.ulClipBottom - y : lHeight;
+
+            pSpriteData += sprNum * ( lWidth * lHeight );
+            for( int32_t dy = yTop; dy < yBottom && xLeft < xRight; dy++ )
+            {
+                pSpan( pScreen + ( ( y + dy ) * screenWidth ) + x + xLeft, pSpriteData + ( dy * lWidth ) + xLeft, xRight - xLeft, pTable );
+            }
+        }
+        else
+        {
+            //get to start of index for sprites..
+            uint8_t* pSprite = pSpriteData + 12;
+            int32_t  xStart  = x;
+
+            while( *pSprite != ':' )
+            {
+                pSprite++;
+            }
+            pSprite++;
+            uint32_t ulOffset = *(((uint32_t*)pSprite) + sprNum);
+            ulOffset = Hardware_SwapLong( ulOffset );
+            pSprite += (SprCtrl.SpriteBanks[ eBank ].ulNumSprites * 4) + ulOffset;
+
+            // same command stream as LIB_Sprites_Draw, each run clipped once
+            while( *pSprite != 0xFF )
+            {
+                uint8_t uCmd = *pSprite++;
+                if ( uCmd == 0xC9 )
+                {
+                    y++;
+                    x = xStart;
+                    continue;
+                }
+                x += uCmd;
+                int32_t lRun = *pSprite++;
+
+                if ( y >= SprCtrl.ulClipTop && y < SprCtrl.ulClipBottom )
+                {
+                    int32_t lSkip = x < SprCtrl.ulClipLeft ? SprCtrl.ulClipLeft - x : 0;
+                    int32_t lEnd  = x + lRun > SprCtrl.ulClipRight ? SprCtrl.ulClipRight - x : lRun;
+
+                    if ( lSkip < lEnd )
+                    {
+                        pSpan( pScreen + ( y * screenWidth ) + x + lSkip, pSprite + lSkip, lEnd - lSkip, pTable );
+                    }
+                }
+                x       += lRun;
+                pSprite += lRun;
+            }
+        }
+
+        bRet = true;
+    }
+
+    // return the result
+    return bRet;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Copies a span of pixels through a remap table, skipping
+                transparent ones, four pixels a pass
+    @ingroup 	MainShell
+    @param      pDest           - Screen
+    @param      pSrc            - Sprite pixels
+    @param      lCount          - Pixels
+    @param      pRemap          - Remap table
+ -----------------------------------------------------------------------------*/
+static void RemapSpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount, const uint8_t* pRemap )
+{
+    uint8_t uPixel = 0;
+
+    for( ; lCount >= 4; lCount -= 4, pSrc += 4, pDest += 4 )
+    {
+        if ( ( uPixel = pSrc[ 0 ] ) != 0 ) pDest[ 0 ] = pRemap[ uPixel ];
+        if ( ( uPixel = pSrc[ 1 ] ) != 0 ) pDest[ 1 ] = pRemap[ uPixel ];
+        if ( ( uPixel = pSrc[ 2 ] ) != 0 ) pDest[ 2 ] = pRemap[ uPixel ];
+        if ( ( uPixel = pSrc[ 3 ] ) != 0 ) pDest[ 3 ] = pRemap[ uPixel ];
+    }
+    for( ; lCount > 0; lCount--, pSrc++, pDest++ )
+    {
+        if ( ( uPixel = *pSrc ) != 0 ) *pDest = pRemap[ uPixel ];
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Blends a span of pixels with the screen, skipping transparent
+                ones, four pixels a pass
+    @ingroup 	MainShell
+    @param      pDest           - Screen
+    @param      pSrc            - Sprite pixels
+    @param      lCount          - Pixels
+    @param      pBlend          - Blend table
+ -----------------------------------------------------------------------------*/
+static void BlendSpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount, const uint8_t* pBlend )
+{
+    uint32_t ulPixel = 0;
+
+    for( ; lCount >= 4; lCount -= 4, pSrc += 4, pDest += 4 )
+    {
+        if ( ( ulPixel = pSrc[ 0 ] ) != 0 ) pDest[ 0 ] = pBlend[ ( ulPixel << 8 ) | pDest[ 0 ] ];
+        if ( ( ulPixel = pSrc[ 1 ] ) != 0 ) pDest[ 1 ] = pBlend[ ( ulPixel << 8 ) | pDest[ 1 ] ];
+        if ( ( ulPixel = pSrc[ 2 ] ) != 0 ) pDest[ 2 ] = pBlend[ ( ulPixel << 8 ) | pDest[ 2 ] ];
+        if ( ( ulPixel = pSrc[ 3 ] ) != 0 ) pDest[ 3 ] = pBlend[ ( ulPixel << 8 ) | pDest[ 3 ] ];
+    }
+    for( ; lCount > 0; lCount--, pSrc++, pDest++ )
+    {
+        if ( ( ulPixel = *pSrc ) != 0 ) *pDest = pBlend[ ( ulPixel << 8 ) | *pDest ];
+    }
+}
+
 //-----------------------------------------------------------------------------
 // End of file: LIB_Sprites.c
 //-----------------------------------------------------------------------------
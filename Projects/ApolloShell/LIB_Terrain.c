@@ -0,0 +1,178 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Terrain.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Terrain rasterizer, paints sky gradient and soil from a height map
+	@date		2025-10-21
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The buffer is painted a row at a time, left to right. Each column's
+	surface row comes from the height map, so on any row a column is either
+	sky (above the surface) or soil. Rows above the highest surface are all
+	sky and rows below the lowest are all soil, only the band in between is
+	split into spans.
+
+	Both sources repeat along the row (soil every 256 pixels, the gradient
+	every ulGradientWidth pixels), so a span is filled with long word copies
+	from a wrapped source row. Spans are aligned on the column, not the
+	pointer, so a long never straddles the wrap point.
+
+	Plain C, shared with the host tools.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/LIB_Terrain.h"
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Paints the whole terrain buffer
+    @ingroup 	MainShell
+    @param      psPaint         - Buffer, height map and textures
+ -----------------------------------------------------------------------------*/
+void LIB_Terrain_Paint( const TerrainPaint_t* psPaint )
+{
+    LIB_Terrain_PaintArea( psPaint, 0, 0, psPaint->ulWidth, psPaint->ulHeight );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Paints part of the terrain buffer, used after edits and for
+                time sliced generation
+    @ingroup 	MainShell
+    @param      psPaint         - Buffer, height map and textures
+    @param      x               - Left column
+    @param      y               - Top row
+    @param      w               - Width in pixels
+    @param      h               - Height in rows
+ -----------------------------------------------------------------------------*/
+void LIB_Terrain_PaintArea( const TerrainPaint_t* psPaint, uint32_t x, uint32_t y, uint32_t w, uint32_t h )
+{
+    uint32_t xEnd = x + w;
+    uint32_t yEnd = y + h;
+    uint32_t ulMinSurface = 0xFFFFFFFF;
+    uint32_t ulMaxSurface = 0;
+
+    if ( xEnd > psPaint->ulWidth )  xEnd = psPaint->ulWidth;
+    if ( yEnd > psPaint->ulHeight ) yEnd = psPaint->ulHeight;
+    if ( x >= xEnd || y >= yEnd ) return;
+
+    // range of surface rows across the area, unsigned so columns whose
+    // surface is above the buffer never get soil (as the old column fill)
+    for ( uint32_t gx = x; gx < xEnd; gx++ )
+    {
+        uint32_t ulSurface = (uint32_t)( psPaint->pMapHeight[ gx ] - psPaint->lSurfaceOffset );
+
+        if ( ulSurface < ulMinSurface ) ulMinSurface = ulSurface;
+        if ( ulSurface > ulMaxSurface ) ulMaxSurface = ulSurface;
+    }
+
+    for ( uint32_t gy = y; gy < yEnd; gy++ )
+    {
+        uint8_t*        pRow  = psPaint->pBuffer + ( gy * psPaint->ulWidth );
+        const uint8_t*  pSoil = psPaint->pSoil + ( ( gy & ( TERRAIN_SOIL_SIZE - 1 ) ) * TERRAIN_SOIL_SIZE );
+        const uint8_t*  pSky  = NULL;
+
+        if ( psPaint->pGradient != NULL && gy < psPaint->ulGradientHeight )
+        {
+            pSky = psPaint->pGradient + ( gy * psPaint->ulGradientWidth );
+        }
+
+        if ( gy >= ulMaxSurface )
+        {
+            LIB_Terrain_FillRow( pRow, pSoil, TERRAIN_SOIL_SIZE, x, xEnd );
+        }
+        else if ( gy < ulMinSurface )
+        {
+            LIB_Terrain_FillRow( pRow, pSky, psPaint->ulGradientWidth, x, xEnd );
+        }
+        else
+        {
+            // surface band, split the row into sky and soil spans
+            uint32_t gx = x;
+
+            while ( gx < xEnd )
+            {
+                uint32_t ulStart = gx;
+                bool     bSoil   = gy >= (uint32_t)( psPaint->pMapHeight[ gx ] - psPaint->lSurfaceOffset );
+
+                while ( ++gx < xEnd && ( gy >= (uint32_t)( psPaint->pMapHeight[ gx ] - psPaint->lSurfaceOffset ) ) == bSoil );
+
+                if ( bSoil ) LIB_Terrain_FillRow( pRow, pSoil, TERRAIN_SOIL_SIZE, ulStart, gx );
+                else         LIB_Terrain_FillRow( pRow, pSky, psPaint->ulGradientWidth, ulStart, gx );
+            }
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Fills pRow[x..xEnd) from a source row repeating every ulPeriod,
+                long word stores once the column is long aligned
+    @ingroup 	MainShell
+    @param      pRow            - Start of the destination row
+    @param      pSource         - Source row, NULL fills with colour 0
+    @param      ulPeriod        - Source row width
+    @param      x               - First column
+    @param      xEnd            - Column after the last
+ -----------------------------------------------------------------------------*/
+void LIB_Terrain_FillRow( uint8_t* pRow, const uint8_t* pSource, uint32_t ulPeriod, uint32_t x, uint32_t xEnd )
+{
+    if ( pSource == NULL )
+    {
+        memset( pRow + x, 0, xEnd - x );
+        return;
+    }
+
+    if ( ulPeriod < 4 || ( ulPeriod & ( ulPeriod - 1 ) ) != 0 )
+    {
+        // odd sized source, byte at a time
+        for ( ; x < xEnd; x++ ) pRow[ x ] = pSource[ x % ulPeriod ];
+        return;
+    }
+
+    uint32_t ulMask = ulPeriod - 1;
+
+    // lead in to a long aligned column
+    for ( ; ( x & 3 ) && x < xEnd; x++ ) pRow[ x ] = pSource[ x & ulMask ];
+
+    while ( xEnd - x >= 4 )
+    {
+        uint32_t        ulOffset = x & ulMask;
+        uint32_t        ulLongs  = ( ulPeriod - ulOffset ) >> 2;
+        uint32_t*       pDst     = (uint32_t*)( pRow + x );
+        const uint32_t* pSrc     = (const uint32_t*)( pSource + ulOffset );
+
+        // up to the wrap point or the end of the span
+        if ( ulLongs > ( ( xEnd - x ) >> 2 ) ) ulLongs = ( xEnd - x ) >> 2;
+        x += ulLongs << 2;
+
+        while ( ulLongs >= 4 )
+        {
+            pDst[ 0 ] = pSrc[ 0 ];
+            pDst[ 1 ] = pSrc[ 1 ];
+            pDst[ 2 ] = pSrc[ 2 ];
+            pDst[ 3 ] = pSrc[ 3 ];
+            pDst += 4;
+            pSrc += 4;
+            ulLongs -= 4;
+        }
+        while ( ulLongs-- ) *pDst++ = *pSrc++;
+    }
+
+    // lead out
+    for ( ; x < xEnd; x++ ) pRow[ x ] = pSource[ x & ulMask ];
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Terrain.c
+//-----------------------------------------------------------------------------
@@ -0,0 +1,616 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_TerrainCache.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Seed keyed on-disk cache of generated maps
+	@date		2025-10-20
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Each map is stored as Data/Maps/SSSSSSSS-TT.map, S being the map seed and
+	T the terrain set (resource group). A map with caves paints differently
+	from the same seed, it is SSSSSSSS-TTC.map with the caves flag in the
+	header. The file holds the height map and the rendered terrain buffer,
+	all longs stored big endian so files baked on the host load directly on
+	the Amiga.
+
+	The shell runs without the baked pool. The first save that finds
+	Data/Maps/ missing makes it, with dos.library on the Amiga.
+
+	CACHE_VERSION goes up whenever the file or the maps painted into it
+	change, older files are then rebuilt rather than misread.
+
+	The terrain buffer is compressed by predicting each pixel from the pixel
+	one texture period (256) to the left, or 256 rows up for the first 256
+	columns. Soil and gradient both tile on that period, so the residual is
+	almost all zero and a simple zero-run / literal RLE packs it well.
+
+	The packed stream only looks back at pixels already decoded, so a map
+	can be loaded a few rows a step (LIB_TerrainCache_ReadRows), reading
+	TERRAINCACHE_READ_SIZE bytes of the file at a time.
+
+	Packed stream -
+	- 0x00-0x7F		n+1 literal residual bytes follow
+	- 0x80-0xFF		zero run, length ((n & 0x7F) << 8 | next byte) + 1
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "Includes/LIB_TerrainCache.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#include "dos/dos.h"
+#include "clib/dos_protos.h"
+#else
+#include "sys/stat.h"
+#endif
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define CACHE_MAGIC         ( 0x414D4150 )  // 'AMAP'
+#define CACHE_VERSION       ( 3 )
+#define CACHE_HEADER_LONGS  ( 9 )
+#define CACHE_FLAG_CAVES    ( 0x00000001 )  // header flags, long 8
+#define CACHE_PERIOD        ( 256 )
+#define CACHE_MAX_LITERAL   ( 128 )
+#define CACHE_MAX_RUN       ( 32768 )
+#define CACHE_STAGE_SIZE    ( 4096 )
+#define CACHE_DIRECTORY     "Data/Maps"     // TERRAINCACHE_DIRECTORY without the trailing '/'
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	Staged output used while packing straight to file
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    FILE*       fp;
+    uint32_t    ulUsed;
+    uint32_t    ulTotal;
+    bool        bError;
+    uint8_t     pStage[ CACHE_STAGE_SIZE ];
+
+} CacheWriter_t, *pCacheWriter_t;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void     PutLong( uint8_t* pDst, uint32_t ulValue );
+static uint32_t GetLong( const uint8_t* pSrc );
+static void     WriterPut( pCacheWriter_t pWriter, uint8_t ucValue );
+static void     WriterFlush( pCacheWriter_t pWriter );
+static uint8_t  ReaderGet( pTerrainCacheReader_t pReader );
+static uint8_t  Predict( const uint8_t* pPixel, uint32_t x, uint32_t y, uint32_t ulWidth );
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static CacheWriter_t        sWriter;
+static TerrainCacheReader_t sReader;
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the seed of a map in the shared pool
+    @ingroup 	MainShell
+    @param      ulMapIndex      - Index of the map, 0 upwards
+    @return 	uint32_t        - Map seed, never zero
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_TerrainCache_PoolSeed( uint32_t ulMapIndex )
+{
+    // integer hash so neighbouring indexes give unrelated maps
+    uint32_t ulSeed = ( ulMapIndex + 1 ) * 0x9E3779B9;
+
+    ulSeed ^= ulSeed >> 16;
+    ulSeed *= 0x85EBCA6B;
+    ulSeed ^= ulSeed >> 13;
+
+    return ( ulSeed != 0 ) ? ulSeed : 1;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Builds the cache file name for a map
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed
+    @param      ulTerrainSet    - Terrain set (resource group)
+    @param      bCaves          - Map built with caves
+    @param      pszFileName     - Buffer of TERRAINCACHE_MAX_FILENAME bytes
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainCache_GetFileName( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, char* pszFileName )
+{
+    sprintf( pszFileName, "%s%08lX-%02lX%s.map", TERRAINCACHE_DIRECTORY, (unsigned long)ulSeed, (unsigned long)( ulTerrainSet & 0xff ),
+             bCaves ? "C" : "" );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Makes the cache directory if it is not there
+    @ingroup 	MainShell
+    @return 	bool            - true if the directory is there now
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainCache_MakeDirectory( void )
+{
+#if defined(__amigaos__) || defined(AMIGA)
+    BPTR lLock = Lock( (CONST_STRPTR)CACHE_DIRECTORY, ACCESS_READ );
+
+    if ( lLock == 0 )
+    {
+        lLock = CreateDir( (CONST_STRPTR)CACHE_DIRECTORY );
+    }
+    if ( lLock == 0 )
+    {
+        return false;
+    }
+    UnLock( lLock );
+
+    return true;
+#else
+    struct stat sStat;
+
+    return mkdir( CACHE_DIRECTORY, 0755 ) == 0 || ( stat( CACHE_DIRECTORY, &sStat ) == 0 && S_ISDIR( sStat.st_mode ) );
+#endif
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Loads a cached map, if there is one, all in one go. Used
+                before the display is up, LIB_TerrainCache_Open and ReadRows
+                load it a slice at a time.
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed
+    @param      ulTerrainSet    - Terrain set (resource group)
+    @param      bCaves          - Map built with caves
+    @param      pMapHeight      - Height map to fill
+    @param      ulMapWidth      - Entries in the height map
+    @param      pBuffer         - Terrain buffer to fill
+    @param      ulWidth         - Terrain buffer width
+    @param      ulHeight        - Terrain buffer height
+    @return 	bool            - true if the map was loaded
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainCache_Load( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, int32_t* pMapHeight, uint32_t ulMapWidth, uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight )
+{
+    bool bReturn = false;
+
+    if ( LIB_TerrainCache_Open( &sReader, ulSeed, ulTerrainSet, bCaves, pMapHeight, ulMapWidth, pBuffer, ulWidth, ulHeight ) == true )
+    {
+        bReturn = LIB_TerrainCache_ReadRows( &sReader, ulHeight );
+        LIB_TerrainCache_Close( &sReader );
+    }
+
+    return bReturn;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Opens a cached map, if there is one, and reads its height map.
+                The terrain is then decoded by LIB_TerrainCache_ReadRows.
+    @ingroup 	MainShell
+    @param      psReader        - Reader, closed
+    @param      ulSeed          - Map seed
+    @param      ulTerrainSet    - Terrain set (resource group)
+    @param      bCaves          - Map built with caves
+    @param      pMapHeight      - Height map to fill
+    @param      ulMapWidth      - Entries in the height map
+    @param      pBuffer         - Terrain buffer to fill
+    @param      ulWidth         - Terrain buffer width
+    @param      ulHeight        - Terrain buffer height
+    @return 	bool            - true if the map is there and its header
+                                  matches, the reader is then open
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainCache_Open( TerrainCacheReader_t* psReader, uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, int32_t* pMapHeight, uint32_t ulMapWidth, uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight )
+{
+    uint8_t pHeader[ CACHE_HEADER_LONGS * 4 ];
+
+    psReader->fp = NULL;
+    if ( pMapHeight == NULL || pBuffer == NULL )
+    {
+        return false;
+    }
+
+    // no file is quietly a miss
+    LIB_TerrainCache_GetFileName( ulSeed, ulTerrainSet, bCaves, psReader->szFileName );
+    psReader->fp = fopen( psReader->szFileName, "rb" );
+    if ( psReader->fp == NULL )
+    {
+        return false;
+    }
+
+    // validate the header against what we have been asked for, then the
+    // height map is read in place and turned round from big endian
+    if ( fread( pHeader, 1, sizeof( pHeader ), psReader->fp ) == sizeof( pHeader ) &&
+         GetLong( pHeader +  0 ) == CACHE_MAGIC                            &&
+         GetLong( pHeader +  4 ) == CACHE_VERSION                          &&
+         GetLong( pHeader +  8 ) == ulSeed                                 &&
+         GetLong( pHeader + 12 ) == ulTerrainSet                           &&
+         GetLong( pHeader + 16 ) == ulMapWidth                             &&
+         GetLong( pHeader + 20 ) == ulWidth                                &&
+         GetLong( pHeader + 24 ) == ulHeight                               &&
+         GetLong( pHeader + 32 ) == ( bCaves ? CACHE_FLAG_CAVES : 0 )     &&
+         fread( pMapHeight, 4, ulMapWidth, psReader->fp ) == ulMapWidth )
+    {
+        for ( uint32_t ulIndex = 0; ulIndex < ulMapWidth; ulIndex++ )
+        {
+            pMapHeight[ ulIndex ] = (int32_t)GetLong( (const uint8_t*)&pMapHeight[ ulIndex ] );
+        }
+
+        psReader->pBuffer      = pBuffer;
+        psReader->ulWidth      = ulWidth;
+        psReader->ulHeight     = ulHeight;
+        psReader->ulRow        = 0;
+        psReader->ulPackedLeft = GetLong( pHeader + 28 );
+        psReader->ulCount      = 0;
+        psReader->bZero        = false;
+        psReader->bError       = false;
+        psReader->ulRead       = 0;
+        psReader->ulReadPos    = 0;
+        return true;
+    }
+
+    printf( "Map cache invalid: %s\n", psReader->szFileName );
+    fclose( psReader->fp );
+    psReader->fp = NULL;
+
+    return false;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Decodes the next rows of an open cached map
+    @ingroup 	MainShell
+    @param      psReader        - Reader from LIB_TerrainCache_Open
+    @param      ulRows          - Rows to decode, fewer at the bottom
+    @return 	bool            - false if the file is bad, the buffer is
+                                  then part filled and the reader should
+                                  be closed
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainCache_ReadRows( TerrainCacheReader_t* psReader, uint32_t ulRows )
+{
+    uint32_t ulEnd = psReader->ulRow + ulRows;
+
+    if ( psReader->fp == NULL || psReader->bError == true )
+    {
+        return false;
+    }
+    if ( ulEnd > psReader->ulHeight )
+    {
+        ulEnd = psReader->ulHeight;
+    }
+
+    // unpack, each pixel rebuilt from its already decoded predictor
+    for ( uint32_t y = psReader->ulRow; y < ulEnd && psReader->bError == false; y++ )
+    {
+        uint8_t* pDst = psReader->pBuffer + ( y * psReader->ulWidth );
+
+        for ( uint32_t x = 0; x < psReader->ulWidth; x++ )
+        {
+            uint8_t ucPred = Predict( pDst, x, y, psReader->ulWidth );
+
+            if ( psReader->ulCount == 0 )
+            {
+                uint8_t ucCmd = ReaderGet( psReader );
+
+                if ( ucCmd & 0x80 )
+                {
+                    psReader->ulCount = ( ( (uint32_t)( ucCmd & 0x7f ) << 8 ) | ReaderGet( psReader ) ) + 1;
+                    psReader->bZero   = true;
+                }
+                else
+                {
+                    psReader->ulCount = (uint32_t)ucCmd + 1;
+                    psReader->bZero   = false;
+                }
+            }
+
+            // a run past the end of the buffer is caught at the last row
+            *pDst++ = psReader->bZero ? ucPred : ( ucPred ^ ReaderGet( psReader ) );
+            psReader->ulCount--;
+        }
+    }
+
+    psReader->ulRow = ulEnd;
+    if ( ulEnd == psReader->ulHeight && psReader->ulCount != 0 )
+    {
+        psReader->bError = true;
+    }
+    if ( psReader->bError == true )
+    {
+        printf( "Map cache invalid: %s\n", psReader->szFileName );
+        return false;
+    }
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Closes a cached map, finished with or not
+    @ingroup 	MainShell
+    @param      psReader        - Reader, can be closed already
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainCache_Close( TerrainCacheReader_t* psReader )
+{
+    if ( psReader->fp != NULL )
+    {
+        fclose( psReader->fp );
+        psReader->fp = NULL;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Saves a generated map to the cache
+    @ingroup 	MainShell
+    @param      ulSeed          - Map seed
+    @param      ulTerrainSet    - Terrain set (resource group)
+    @param      bCaves          - Map built with caves
+    @param      pMapHeight      - Height map
+    @param      ulMapWidth      - Entries in the height map
+    @param      pBuffer         - Rendered terrain buffer
+    @param      ulWidth         - Terrain buffer width
+    @param      ulHeight        - Terrain buffer height
+    @return 	bool            - true if the map was saved
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainCache_Save( uint32_t ulSeed, uint32_t ulTerrainSet, bool bCaves, const int32_t* pMapHeight, uint32_t ulMapWidth, const uint8_t* pBuffer, uint32_t ulWidth, uint32_t ulHeight )
+{
+    char        szFileName[ TERRAINCACHE_MAX_FILENAME ];
+    uint8_t     pHeader[ CACHE_HEADER_LONGS * 4 ];
+    uint32_t    ulTotal = ulWidth * ulHeight;
+    uint32_t    ulPos   = 0;
+    uint32_t    ulRun   = 0;
+    uint32_t    ulLit   = 0;
+    uint8_t     pLiteral[ CACHE_MAX_LITERAL ];
+
+    if ( pMapHeight == NULL || pBuffer == NULL )
+    {
+        return false;
+    }
+
+    LIB_TerrainCache_GetFileName( ulSeed, ulTerrainSet, bCaves, szFileName );
+
+    sWriter.fp      = fopen( szFileName, "wb" );
+    if ( sWriter.fp == NULL && LIB_TerrainCache_MakeDirectory() == true )
+    {
+        // the first map saved makes Data/Maps/
+        sWriter.fp = fopen( szFileName, "wb" );
+    }
+    sWriter.ulUsed  = 0;
+    sWriter.ulTotal = 0;
+    sWriter.bError  = false;
+
+    if ( sWriter.fp == NULL )
+    {
+        printf( "Map cache not writable: %s\n", szFileName );
+        return false;
+    }
+
+    // header, packed size is patched in once known
+    PutLong( pHeader +  0, CACHE_MAGIC );
+    PutLong( pHeader +  4, CACHE_VERSION );
+    PutLong( pHeader +  8, ulSeed );
+    PutLong( pHeader + 12, ulTerrainSet );
+    PutLong( pHeader + 16, ulMapWidth );
+    PutLong( pHeader + 20, ulWidth );
+    PutLong( pHeader + 24, ulHeight );
+    PutLong( pHeader + 28, 0 );
+    PutLong( pHeader + 32, bCaves ? CACHE_FLAG_CAVES : 0 );
+    fwrite( pHeader, 1, sizeof( pHeader ), sWriter.fp );
+
+    for ( uint32_t ulIndex = 0; ulIndex < ulMapWidth; ulIndex++ )
+    {
+        uint8_t pLong[ 4 ];
+
+        PutLong( pLong, (uint32_t)pMapHeight[ ulIndex ] );
+        fwrite( pLong, 1, 4, sWriter.fp );
+    }
+
+    // pack the residuals
+    for ( uint32_t y = 0; y < ulHeight; y++ )
+    {
+        for ( uint32_t x = 0; x < ulWidth; x++ )
+        {
+            uint8_t ucResidual = pBuffer[ ulPos ] ^ Predict( &pBuffer[ ulPos ], x, y, ulWidth );
+
+            ulPos++;
+
+            if ( ucResidual == 0 )
+            {
+                if ( ulLit != 0 )
+                {
+                    WriterPut( &sWriter, (uint8_t)( ulLit - 1 ) );
+                    for ( uint32_t ulIndex = 0; ulIndex < ulLit; ulIndex++ )
+                    {
+                        WriterPut( &sWriter, pLiteral[ ulIndex ] );
+                    }
+                    ulLit = 0;
+                }
+                if ( ++ulRun == CACHE_MAX_RUN )
+                {
+                    WriterPut( &sWriter, (uint8_t)( 0x80 | ( ( ulRun - 1 ) >> 8 ) ) );
+                    WriterPut( &sWriter, (uint8_t)( ulRun - 1 ) );
+                    ulRun = 0;
+                }
+            }
+            else
+            {
+                if ( ulRun != 0 )
+                {
+                    WriterPut( &sWriter, (uint8_t)( 0x80 | ( ( ulRun - 1 ) >> 8 ) ) );
+                    WriterPut( &sWriter, (uint8_t)( ulRun - 1 ) );
+                    ulRun = 0;
+                }
+                pLiteral[ ulLit++ ] = ucResidual;
+                if ( ulLit == CACHE_MAX_LITERAL )
+                {
+                    WriterPut( &sWriter, (uint8_t)( ulLit - 1 ) );
+                    for ( uint32_t ulIndex = 0; ulIndex < ulLit; ulIndex++ )
+                    {
+                        WriterPut( &sWriter, pLiteral[ ulIndex ] );
+                    }
+                    ulLit = 0;
+                }
+            }
+        }
+    }
+
+    // flush whatever is pending
+    if ( ulRun != 0 )
+    {
+        WriterPut( &sWriter, (uint8_t)( 0x80 | ( ( ulRun - 1 ) >> 8 ) ) );
+        WriterPut( &sWriter, (uint8_t)( ulRun - 1 ) );
+    }
+    if ( ulLit != 0 )
+    {
+        WriterPut( &sWriter, (uint8_t)( ulLit - 1 ) );
+        for ( uint32_t ulIndex = 0; ulIndex < ulLit; ulIndex++ )
+        {
+            WriterPut( &sWriter, pLiteral[ ulIndex ] );
+        }
+    }
+    WriterFlush( &sWriter );
+
+    // patch in the packed size
+    PutLong( pHeader + 28, sWriter.ulTotal );
+    if ( fseek( sWriter.fp, 28, SEEK_SET ) != 0 || fwrite( pHeader + 28, 1, 4, sWriter.fp ) != 4 )
+    {
+        sWriter.bError = true;
+    }
+
+    if ( fclose( sWriter.fp ) != 0 )
+    {
+        sWriter.bError = true;
+    }
+    sWriter.fp = NULL;
+
+    if ( sWriter.bError == true )
+    {
+        printf( "Map cache write failed: %s\n", szFileName );
+        remove( szFileName );
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Stores a long big endian
+    @ingroup 	MainShell
+    @param      pDst            - Destination, 4 bytes
+    @param      ulValue         - Value to store
+ -----------------------------------------------------------------------------*/
+static void PutLong( uint8_t* pDst, uint32_t ulValue )
+{
+    pDst[ 0 ] = (uint8_t)( ulValue >> 24 );
+    pDst[ 1 ] = (uint8_t)( ulValue >> 16 );
+    pDst[ 2 ] = (uint8_t)( ulValue >> 8 );
+    pDst[ 3 ] = (uint8_t)( ulValue );
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Reads a big endian long
+    @ingroup 	MainShell
+    @param      pSrc            - Source, 4 bytes
+    @return 	uint32_t        - Value read
+ -----------------------------------------------------------------------------*/
+static uint32_t GetLong( const uint8_t* pSrc )
+{
+    return ( (uint32_t)pSrc[ 0 ] << 24 ) | ( (uint32_t)pSrc[ 1 ] << 16 ) | ( (uint32_t)pSrc[ 2 ] << 8 ) | (uint32_t)pSrc[ 3 ];
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Adds a byte to the staged output
+    @ingroup 	MainShell
+    @param      pWriter         - Writer
+    @param      ucValue         - Byte to add
+ -----------------------------------------------------------------------------*/
+static void WriterPut( pCacheWriter_t pWriter, uint8_t ucValue )
+{
+    pWriter->pStage[ pWriter->ulUsed++ ] = ucValue;
+    if ( pWriter->ulUsed == CACHE_STAGE_SIZE )
+    {
+        WriterFlush( pWriter );
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Writes the staged output to the file
+    @ingroup 	MainShell
+    @param      pWriter         - Writer
+ -----------------------------------------------------------------------------*/
+static void WriterFlush( pCacheWriter_t pWriter )
+{
+    if ( pWriter->ulUsed != 0 )
+    {
+        if ( fwrite( pWriter->pStage, 1, pWriter->ulUsed, pWriter->fp ) != pWriter->ulUsed )
+        {
+            pWriter->bError = true;
+        }
+        pWriter->ulTotal += pWriter->ulUsed;
+        pWriter->ulUsed   = 0;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes the next packed byte, reading more of the file when
+                the last read is used up
+    @ingroup 	MainShell
+    @param      pReader         - Reader
+    @return 	uint8_t         - Byte, 0 past the end with bError set
+ -----------------------------------------------------------------------------*/
+static uint8_t ReaderGet( pTerrainCacheReader_t pReader )
+{
+    if ( pReader->ulReadPos == pReader->ulRead )
+    {
+        uint32_t ulBytes = pReader->ulPackedLeft < TERRAINCACHE_READ_SIZE ? pReader->ulPackedLeft : TERRAINCACHE_READ_SIZE;
+
+        if ( ulBytes == 0 || fread( pReader->pRead, 1, ulBytes, pReader->fp ) != ulBytes )
+        {
+            pReader->bError = true;
+            return 0;
+        }
+        pReader->ulPackedLeft -= ulBytes;
+        pReader->ulRead        = ulBytes;
+        pReader->ulReadPos     = 0;
+    }
+
+    return pReader->pRead[ pReader->ulReadPos++ ];
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Predicts a pixel from the one a texture period away
+    @ingroup 	MainShell
+    @param      pPixel          - The pixel being predicted
+    @param      x               - X position of the pixel
+    @param      y               - Y position of the pixel
+    @param      ulWidth         - Width of the buffer
+    @return 	uint8_t         - Predicted value
+ -----------------------------------------------------------------------------*/
+static uint8_t Predict( const uint8_t* pPixel, uint32_t x, uint32_t y, uint32_t ulWidth )
+{
+    if ( x >= CACHE_PERIOD )
+    {
+        return pPixel[ -CACHE_PERIOD ];
+    }
+    if ( y >= CACHE_PERIOD )
+    {
+        return pPixel[ -(int32_t)( CACHE_PERIOD * ulWidth ) ];
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_TerrainCache.c
+//-----------------------------------------------------------------------------
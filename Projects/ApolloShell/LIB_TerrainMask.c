@@ -0,0 +1,535 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_TerrainMask.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		2D terrain solidity mask, generated and painted in 32x32 tiles
+	@date		2025-10-23
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The height map gives the rough surface and LIB_PerlinNoise_Noise2D over
+	the whole field is added to it as a density, thresholded at zero. Noise
+	below the surface carves caves, noise above it raises overhangs and
+	floating islands.
+
+	Work is done in 32x32 tiles, a tile being one long of mask per row, so
+	any set of tiles can be handed to a different task (or frame) without
+	two of them touching the same long. Each tile works out the range its
+	density can reach from the height map and the noise amplitude; tiles
+	that cannot cross zero are filled as all air or all solid without
+	sampling any noise.
+
+	Cleanup is a 3x3 majority filter (a pixel is solid if 5 or more of the
+	9 are), done a long at a time with a bit sliced counter. It removes
+	single pixel specks and fills pin holes. It reads one mask and writes
+	another, so it is tile parallel as well.
+
+	Painting from the mask uses the same wrapped long word row fill as
+	LIB_Terrain_Paint. Plain C, shared with the host tools.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/LIB_PerlinNoise.h"
+#include "Includes/LIB_Terrain.h"
+#include "Includes/LIB_TerrainMask.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TILE_SIZE       ( TERRAINMASK_TILE_SIZE )
+#define ALL_SOLID       ( 0xFFFFFFFF )
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint32_t FillTile( TerrainMask_t* psMask, uint32_t ulTile, uint32_t ulValue );
+static bool     IsUniformArea( const TerrainMask_t* psMask, uint32_t tx, uint32_t ty );
+static void     PaintRow( uint8_t* pRow, uint32_t ulBits, uint32_t x, const uint8_t* pSoil, const uint8_t* pSky, uint32_t ulSkyWidth );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Sets up a mask over caller supplied storage
+    @ingroup 	MainShell
+    @param      psMask          - Mask to set up
+    @param      pBits           - TERRAINMASK_LONGS( w, h ) longs
+    @param      pTiles          - TERRAINMASK_TILES( w, h ) bytes
+    @param      ulWidth         - Width, multiple of 32
+    @param      ulHeight        - Height
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_Setup( TerrainMask_t* psMask, uint32_t* pBits, uint8_t* pTiles, uint32_t ulWidth, uint32_t ulHeight )
+{
+    psMask->pBits    = pBits;
+    psMask->pTiles   = pTiles;
+    psMask->ulWidth  = ulWidth & ~( TILE_SIZE - 1 );
+    psMask->ulHeight = ulHeight;
+    psMask->ulPitch  = psMask->ulWidth / TILE_SIZE;
+    psMask->ulTilesY = ( ulHeight + TILE_SIZE - 1 ) / TILE_SIZE;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Number of tiles in the mask
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @return     uint32_t        - Tiles across times tiles down
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_TerrainMask_GetTileCount( const TerrainMask_t* psMask )
+{
+    return psMask->ulPitch * psMask->ulTilesY;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Counts the tiles of one type
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      eType           - Tile type to count
+    @return     uint32_t        - Number of tiles
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_TerrainMask_CountTiles( const TerrainMask_t* psMask, eMaskTile_t eType )
+{
+    uint32_t ulCount = 0;
+
+    for ( uint32_t ulTile = 0; ulTile < LIB_TerrainMask_GetTileCount( psMask ); ulTile++ )
+    {
+        if ( psMask->pTiles[ ulTile ] == eType ) ulCount++;
+    }
+
+    return ulCount;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Generates a run of tiles from the terrain shape
+    @ingroup 	MainShell
+    @param      psMask          - Mask to fill
+    @param      psShape         - Height map and noise settings
+    @param      ulFirst         - First tile
+    @param      ulCount         - Number of tiles
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_GenerateTiles( TerrainMask_t* psMask, const TerrainShape_t* psShape, uint32_t ulFirst, uint32_t ulCount )
+{
+    uint32_t ulEnd = ulFirst + ulCount;
+    float    fRange = 0.0f;
+    float    fAmp = psShape->fCaveAmp;
+
+    if ( ulEnd > LIB_TerrainMask_GetTileCount( psMask ) ) ulEnd = LIB_TerrainMask_GetTileCount( psMask );
+
+    // furthest the noise can move the density
+    for ( uint32_t ulOctave = 0; ulOctave < psShape->ulOctaves; ulOctave++ )
+    {
+        fRange += fAmp;
+        fAmp   *= 0.5f;
+    }
+
+    for ( uint32_t ulTile = ulFirst; ulTile < ulEnd; ulTile++ )
+    {
+        uint32_t tx = ulTile % psMask->ulPitch;
+        uint32_t ty = ulTile / psMask->ulPitch;
+        int32_t  x0 = tx * TILE_SIZE;
+        int32_t  y0 = ty * TILE_SIZE;
+        int32_t  y1 = y0 + TILE_SIZE;
+        int32_t  lSurface[ TILE_SIZE ];
+        int32_t  lMin = 0x7FFFFFFF;
+        int32_t  lMax = -0x7FFFFFFF;
+
+        if ( y1 > (int32_t)psMask->ulHeight ) y1 = psMask->ulHeight;
+
+        for ( uint32_t i = 0; i < TILE_SIZE; i++ )
+        {
+            lSurface[ i ] = psShape->pMapHeight[ x0 + i ] - psShape->lSurfaceOffset;
+            if ( lSurface[ i ] < lMin ) lMin = lSurface[ i ];
+            if ( lSurface[ i ] > lMax ) lMax = lSurface[ i ];
+        }
+
+        // whole tile out of reach of the noise
+        if ( ( (float)( y1 - 1 - lMin ) * psShape->fDepthScale ) + fRange < 0.0f )
+        {
+            psMask->pTiles[ ulTile ] = FillTile( psMask, ulTile, 0 );
+            continue;
+        }
+        if ( ( (float)( y0 - lMax ) * psShape->fDepthScale ) - fRange >= 0.0f )
+        {
+            psMask->pTiles[ ulTile ] = FillTile( psMask, ulTile, ALL_SOLID );
+            continue;
+        }
+
+        uint32_t  ulOr  = 0;
+        uint32_t  ulAnd = ALL_SOLID;
+        uint32_t* pBits = psMask->pBits + ( y0 * psMask->ulPitch ) + tx;
+
+        for ( int32_t y = y0; y < y1; y++, pBits += psMask->ulPitch )
+        {
+            uint32_t ulWord = 0;
+
+            for ( uint32_t i = 0; i < TILE_SIZE; i++ )
+            {
+                float fDensity = (float)( y - lSurface[ i ] ) * psShape->fDepthScale;
+
+                if ( fDensity + fRange >= 0.0f && fDensity - fRange < 0.0f )
+                {
+                    float fNoise = 0.0f;
+                    float a = psShape->fCaveAmp;
+                    float f = psShape->fCaveFreq;
+
+                    for ( uint32_t ulOctave = 0; ulOctave < psShape->ulOctaves; ulOctave++ )
+                    {
+                        fNoise += a * LIB_PerlinNoise_Noise2D( ( (float)( x0 + i ) + psShape->fOffsetX ) * f, ( (float)y + psShape->fOffsetY ) * f );
+                        a *= 0.5f;
+                        f *= 2.0f;
+                    }
+                    fDensity += fNoise;
+                }
+
+                if ( fDensity >= 0.0f ) ulWord |= 0x80000000 >> i;
+            }
+
+            *pBits = ulWord;
+            ulOr  |= ulWord;
+            ulAnd &= ulWord;
+        }
+
+        psMask->pTiles[ ulTile ] = ( ulOr == 0 ) ? eMaskTile_Air : ( ulAnd == ALL_SOLID ) ? eMaskTile_Solid : eMaskTile_Mixed;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		3x3 majority filter of a run of tiles, source to destination
+    @ingroup 	MainShell
+    @param      psDest          - Mask written, same size as the source
+    @param      psSource        - Mask read, must be complete
+    @param      ulFirst         - First tile
+    @param      ulCount         - Number of tiles
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_CleanTiles( TerrainMask_t* psDest, const TerrainMask_t* psSource, uint32_t ulFirst, uint32_t ulCount )
+{
+    uint32_t ulEnd   = ulFirst + ulCount;
+    uint32_t ulPitch = psSource->ulPitch;
+
+    if ( ulEnd > LIB_TerrainMask_GetTileCount( psSource ) ) ulEnd = LIB_TerrainMask_GetTileCount( psSource );
+
+    for ( uint32_t ulTile = ulFirst; ulTile < ulEnd; ulTile++ )
+    {
+        uint32_t tx = ulTile % ulPitch;
+        uint32_t ty = ulTile / ulPitch;
+        uint32_t y0 = ty * TILE_SIZE;
+        uint32_t y1 = y0 + TILE_SIZE;
+
+        // nothing to smooth if every neighbour is the same solid colour
+        if ( IsUniformArea( psSource, tx, ty ) == true )
+        {
+            psDest->pTiles[ ulTile ] = FillTile( psDest, ulTile, ( psSource->pTiles[ ulTile ] == eMaskTile_Solid ) ? ALL_SOLID : 0 );
+            continue;
+        }
+
+        if ( y1 > psSource->ulHeight ) y1 = psSource->ulHeight;
+
+        uint32_t ulOr  = 0;
+        uint32_t ulAnd = ALL_SOLID;
+
+        for ( uint32_t y = y0; y < y1; y++ )
+        {
+            uint32_t ulRows[ 3 ];
+            uint32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+
+            ulRows[ 0 ] = ( ( y > 0 ) ? y - 1 : y ) * ulPitch;
+            ulRows[ 1 ] = y * ulPitch;
+            ulRows[ 2 ] = ( ( y + 1 < psSource->ulHeight ) ? y + 1 : y ) * ulPitch;
+
+            for ( uint32_t r = 0; r < 3; r++ )
+            {
+                const uint32_t* pRow  = psSource->pBits + ulRows[ r ];
+                uint32_t        w     = pRow[ tx ];
+                uint32_t        ulPrev = ( tx > 0 ) ? pRow[ tx - 1 ] : ( w >> 31 );
+                uint32_t        ulNext = ( tx + 1 < ulPitch ) ? pRow[ tx + 1 ] : ( w << 31 );
+                uint32_t        ulAdd[ 3 ];
+
+                // each bit lined up with its left and right neighbour, edges repeat
+                ulAdd[ 0 ] = ( w >> 1 ) | ( ulPrev << 31 );
+                ulAdd[ 1 ] = w;
+                ulAdd[ 2 ] = ( w << 1 ) | ( ulNext >> 31 );
+
+                for ( uint32_t i = 0; i < 3; i++ )
+                {
+                    uint32_t v = ulAdd[ i ];
+                    uint32_t k;
+
+                    k = c0 & v; c0 ^= v; v = k;
+                    k = c1 & v; c1 ^= v; v = k;
+                    k = c2 & v; c2 ^= v;
+                    c3 |= k;
+                }
+            }
+
+            // count of 5 or more
+            uint32_t ulWord = c3 | ( c2 & ( c1 | c0 ) );
+
+            psDest->pBits[ ulRows[ 1 ] + tx ] = ulWord;
+            ulOr  |= ulWord;
+            ulAnd &= ulWord;
+        }
+
+        psDest->pTiles[ ulTile ] = ( ulOr == 0 ) ? eMaskTile_Air : ( ulAnd == ALL_SOLID ) ? eMaskTile_Solid : eMaskTile_Mixed;
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Paints a run of tiles, soil where solid and gradient elsewhere
+    @ingroup 	MainShell
+    @param      psMask          - Mask to paint from
+    @param      psPaint         - Buffer and textures, same size as the mask
+    @param      ulFirst         - First tile
+    @param      ulCount         - Number of tiles
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_PaintTiles( const TerrainMask_t* psMask, const TerrainPaint_t* psPaint, uint32_t ulFirst, uint32_t ulCount )
+{
+    uint32_t ulEnd = ulFirst + ulCount;
+
+    if ( ulEnd > LIB_TerrainMask_GetTileCount( psMask ) ) ulEnd = LIB_TerrainMask_GetTileCount( psMask );
+
+    for ( uint32_t ulTile = ulFirst; ulTile < ulEnd; ulTile++ )
+    {
+        uint32_t tx = ulTile % psMask->ulPitch;
+        uint32_t x0 = tx * TILE_SIZE;
+        uint32_t y0 = ( ulTile / psMask->ulPitch ) * TILE_SIZE;
+        uint32_t y1 = y0 + TILE_SIZE;
+
+        if ( y1 > psMask->ulHeight ) y1 = psMask->ulHeight;
+
+        for ( uint32_t y = y0; y < y1; y++ )
+        {
+            uint8_t*        pRow  = psPaint->pBuffer + ( y * psPaint->ulWidth );
+            const uint8_t*  pSoil = psPaint->pSoil + ( ( y & ( TERRAIN_SOIL_SIZE - 1 ) ) * TERRAIN_SOIL_SIZE );
+            const uint8_t*  pSky  = NULL;
+
+            if ( psPaint->pGradient != NULL && y < psPaint->ulGradientHeight )
+            {
+                pSky = psPaint->pGradient + ( y * psPaint->ulGradientWidth );
+            }
+
+            switch ( psMask->pTiles[ ulTile ] )
+            {
+                case eMaskTile_Air:
+                    LIB_Terrain_FillRow( pRow, pSky, psPaint->ulGradientWidth, x0, x0 + TILE_SIZE );
+                    break;
+                case eMaskTile_Solid:
+                    LIB_Terrain_FillRow( pRow, pSoil, TERRAIN_SOIL_SIZE, x0, x0 + TILE_SIZE );
+                    break;
+                default:
+                    PaintRow( pRow, psMask->pBits[ ( y * psMask->ulPitch ) + tx ], x0, pSoil, pSky, psPaint->ulGradientWidth );
+                    break;
+            }
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Makes the opaque pixels of an image solid, clipped to the
+                mask. Air tiles touched become mixed.
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      x               - Column of the image's left edge
+    @param      y               - Row of the image's top edge
+    @param      pPixels         - Image, 0 is transparent
+    @param      ulWidth         - Image width
+    @param      ulHeight        - Image height
+    @param      ulPitch         - Bytes per image row
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_Stamp( TerrainMask_t* psMask, int32_t x, int32_t y, const uint8_t* pPixels, uint32_t ulWidth, uint32_t ulHeight, uint32_t ulPitch )
+{
+    int32_t x0 = x < 0 ? 0 : x;
+    int32_t y0 = y < 0 ? 0 : y;
+    int32_t x1 = x + (int32_t)ulWidth;
+    int32_t y1 = y + (int32_t)ulHeight;
+
+    if ( x1 > (int32_t)psMask->ulWidth )  x1 = psMask->ulWidth;
+    if ( y1 > (int32_t)psMask->ulHeight ) y1 = psMask->ulHeight;
+
+    for ( int32_t py = y0; py < y1; py++ )
+    {
+        const uint8_t* pSrc  = pPixels + ( ( py - y ) * ulPitch ) + ( x0 - x );
+        uint32_t*      pRow  = psMask->pBits + ( py * psMask->ulPitch );
+        uint8_t*       pTile = psMask->pTiles + ( ( py / TILE_SIZE ) * psMask->ulPitch );
+        uint32_t       ulBits = 0;
+
+        // build each long of the row, then merge it in one go
+        for ( int32_t px = x0; px < x1; px++ )
+        {
+            if ( *pSrc++ != 0 )
+            {
+                ulBits |= 0x80000000 >> ( px & 31 );
+            }
+            if ( ( px & 31 ) == 31 || px == x1 - 1 )
+            {
+                if ( ulBits != 0 )
+                {
+                    pRow[ px >> 5 ] |= ulBits;
+                    if ( pTile[ px >> 5 ] == eMaskTile_Air )
+                    {
+                        pTile[ px >> 5 ] = eMaskTile_Mixed;
+                    }
+                }
+                ulBits = 0;
+            }
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Makes a band of rows air
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      ulFirst         - First row
+    @param      ulRows          - Rows, clipped to the mask
+ -----------------------------------------------------------------------------*/
+void LIB_TerrainMask_ClearRows( TerrainMask_t* psMask, uint32_t ulFirst, uint32_t ulRows )
+{
+    if ( ulFirst >= psMask->ulHeight )
+    {
+        return;
+    }
+    if ( ulRows > psMask->ulHeight - ulFirst )
+    {
+        ulRows = psMask->ulHeight - ulFirst;
+    }
+
+    memset( psMask->pBits + ( ulFirst * psMask->ulPitch ), 0, ulRows * psMask->ulPitch * sizeof( uint32_t ) );
+
+    for ( uint32_t ty = ulFirst / TILE_SIZE; ty * TILE_SIZE < ulFirst + ulRows; ty++ )
+    {
+        uint32_t y0     = ty * TILE_SIZE;
+        uint32_t y1     = ( y0 + TILE_SIZE < psMask->ulHeight ) ? y0 + TILE_SIZE : psMask->ulHeight;
+        bool     bWhole = y0 >= ulFirst && y1 <= ulFirst + ulRows;
+        uint8_t* pTile  = psMask->pTiles + ( ty * psMask->ulPitch );
+
+        for ( uint32_t tx = 0; tx < psMask->ulPitch; tx++ )
+        {
+            if ( bWhole == true )
+            {
+                pTile[ tx ] = eMaskTile_Air;
+            }
+            else if ( pTile[ tx ] == eMaskTile_Solid )
+            {
+                pTile[ tx ] = eMaskTile_Mixed;
+            }
+        }
+    }
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Tests a single pixel of the mask
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      x               - Column
+    @param      y               - Row
+    @return     bool            - true if solid, false if air or off the map
+ -----------------------------------------------------------------------------*/
+bool LIB_TerrainMask_IsSolid( const TerrainMask_t* psMask, int32_t x, int32_t y )
+{
+    if ( x < 0 || y < 0 || x >= (int32_t)psMask->ulWidth || y >= (int32_t)psMask->ulHeight )
+    {
+        return false;
+    }
+
+    return ( psMask->pBits[ ( y * psMask->ulPitch ) + ( x >> 5 ) ] & ( 0x80000000 >> ( x & 31 ) ) ) != 0;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Fills every row of a tile with one value
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      ulTile          - Tile
+    @param      ulValue         - 0 or ALL_SOLID
+    @return     uint32_t        - Tile type for the value
+ -----------------------------------------------------------------------------*/
+static uint32_t FillTile( TerrainMask_t* psMask, uint32_t ulTile, uint32_t ulValue )
+{
+    uint32_t  tx = ulTile % psMask->ulPitch;
+    uint32_t  y0 = ( ulTile / psMask->ulPitch ) * TILE_SIZE;
+    uint32_t  y1 = y0 + TILE_SIZE;
+    uint32_t* pBits = psMask->pBits + ( y0 * psMask->ulPitch ) + tx;
+
+    if ( y1 > psMask->ulHeight ) y1 = psMask->ulHeight;
+
+    for ( uint32_t y = y0; y < y1; y++, pBits += psMask->ulPitch )
+    {
+        *pBits = ulValue;
+    }
+
+    return ( ulValue != 0 ) ? eMaskTile_Solid : eMaskTile_Air;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Is a tile and its eight neighbours all air or all solid
+    @ingroup 	MainShell
+    @param      psMask          - Mask
+    @param      tx              - Tile column
+    @param      ty              - Tile row
+    @return     bool            - true if the filter cannot change the tile
+ -----------------------------------------------------------------------------*/
+static bool IsUniformArea( const TerrainMask_t* psMask, uint32_t tx, uint32_t ty )
+{
+    uint8_t ucType = psMask->pTiles[ ( ty * psMask->ulPitch ) + tx ];
+
+    if ( ucType == eMaskTile_Mixed ) return false;
+
+    for ( int32_t dy = -1; dy <= 1; dy++ )
+    {
+        for ( int32_t dx = -1; dx <= 1; dx++ )
+        {
+            int32_t nx = (int32_t)tx + dx;
+            int32_t ny = (int32_t)ty + dy;
+
+            // off the edge the filter repeats the tile's own pixels
+            if ( nx < 0 || ny < 0 || nx >= (int32_t)psMask->ulPitch || ny >= (int32_t)psMask->ulTilesY ) continue;
+            if ( psMask->pTiles[ ( ny * psMask->ulPitch ) + nx ] != ucType ) return false;
+        }
+    }
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Paints one 32 pixel row of a mixed tile as soil and sky spans
+    @ingroup 	MainShell
+    @param      pRow            - Start of the buffer row
+    @param      ulBits          - Mask long for the row
+    @param      x               - First column of the tile
+    @param      pSoil           - Soil texture row
+    @param      pSky            - Gradient row, NULL for colour 0
+    @param      ulSkyWidth      - Gradient width
+ -----------------------------------------------------------------------------*/
+static void PaintRow( uint8_t* pRow, uint32_t ulBits, uint32_t x, const uint8_t* pSoil, const uint8_t* pSky, uint32_t ulSkyWidth )
+{
+    uint32_t ulStart = 0;
+
+    for ( uint32_t i = 1; i <= TILE_SIZE; i++ )
+    {
+        uint32_t ulBit = ulBits >> ( 31 - ulStart ) & 1;
+
+        if ( i == TILE_SIZE || ( ( ulBits >> ( 31 - i ) ) & 1 ) != ulBit )
+        {
+            if ( ulBit ) LIB_Terrain_FillRow( pRow, pSoil, TERRAIN_SOIL_SIZE, x + ulStart, x + i );
+            else         LIB_Terrain_FillRow( pRow, pSky, ulSkyWidth, x + ulStart, x + i );
+            ulStart = i;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_TerrainMask.c
+//-----------------------------------------------------------------------------
@@ -0,0 +1,614 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Text.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Text from the font banks, strings kept as ready drawn surfaces
+	@date		2025-10-26
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The fonts are compressed sprite banks, one frame per character from
+	TEXT_FIRST_CHAR. At start up every glyph is decoded once into a raw
+	cache, trimmed to the columns it uses, and its advance worked out from
+	that width. Kerning comes from the glyph shapes, for each pair the
+	right edge of the first and the left edge of the second are compared
+	row by row and the pair is pulled together until the closest rows are
+	the font's spacing apart, by no more than an eighth of the cell.
+
+	A string is drawn once into a surface, keyed by font, colour and the
+	text, and after that it is one transparent rectangle copy a frame. A
+	label or a counter that changes once a second costs a glyph draw per
+	character once a second. Surfaces are reused least recently used
+	first. Strings too long or wide for a surface are drawn a glyph at a
+	time straight to the screen.
+
+	Colours are LIB_Sprites remap handles, applied when the surface is
+	drawn so the white fonts can be shown in any colour.
+
+	Text is clipped to the screen, not the sprite clip area, so the HUD
+	can draw outside the map view.
+
+	LIB_Text_DrawDebug is the 8x8 FontModule font for overlays and the
+	console, drawn straight to the screen with no cache, it is already
+	two long word stores per glyph row.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/HWScreen.h"
+#include "Includes/FontModule.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_Text.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MAX_CELL            ( 32 )      // largest font cell, width and height
+#define NO_EDGE             ( 0xFF )
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief   	One font, its glyphs decoded and measured
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    bool            bLoaded;
+    uint32_t        ulCellWidth;
+    uint32_t        ulHeight;
+    uint32_t        ulSpacing;                          //!< Gap between glyphs
+    uint8_t*        Pixels[ TEXT_GLYPHS ];              //!< Width by height, NULL if blank
+    uint8_t         Width[ TEXT_GLYPHS ];               //!< Columns used
+    uint8_t         Advance[ TEXT_GLYPHS ];             //!< Pen move after the glyph
+    int8_t          Kern[ TEXT_GLYPHS ][ TEXT_GLYPHS ]; //!< Added between a pair, 0 or less
+
+} TextFont_t, *pTextFont_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	A string drawn ready to copy
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    bool            bUsed;
+    uint32_t        ulHash;
+    eTextFont_t     eFont;
+    int32_t         lColour;
+    uint32_t        ulWidth;
+    uint32_t        ulHeight;
+    uint32_t        ulLastUsed;                         //!< Frame last drawn
+    char            Text[ TEXT_MAX_LENGTH + 1 ];
+    uint8_t         Pixels[ TEXT_SURFACE_WIDTH * TEXT_SURFACE_HEIGHT ];
+
+} TextSurface_t, *pTextSurface_t;
+
+/** ----------------------------------------------------------------------------
+    @brief   	Text control
+    @ingroup 	MainShell
+----------------------------------------------------------------------------- */
+typedef struct
+{
+    TextFont_t      Fonts[ eTextFont_Total ];
+    TextSurface_t   Surfaces[ TEXT_MAX_SURFACES ];
+    uint32_t        ulPoolUsed;
+    uint32_t        ulFrame;
+    TextStats_t     sFrame;                             //!< Counts for the frame so far
+    TextStats_t     sLastFrame;
+    TextStats_t     sTotal;
+
+} TextCtrl, *pTextCtrl;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static TextCtrl     sText;
+static uint8_t      pGlyphPool[ TEXT_GLYPH_POOL ];
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static bool     LoadFont( TextFont_t* psFont, uint32_t ulBank );
+static uint32_t Glyph( char c );
+static uint32_t Hash( eTextFont_t eFont, int32_t lColour, const char* pText );
+static uint32_t Render( TextFont_t* psFont, const char* pText, uint8_t* pDest, uint32_t ulPitch, int32_t x, int32_t y, int32_t lRight, int32_t lBottom, const uint8_t* pRemap );
+static void     CopySpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount );
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Decodes and measures the fonts, after the resource groups are
+                loaded
+    @ingroup 	MainShell
+    @param      ulFontBank      - First bank of the font group
+    @return     bool            - false if a font did not fit or decode
+ -----------------------------------------------------------------------------*/
+bool LIB_Text_Init( uint32_t ulFontBank )
+{
+    bool bRet = true;
+
+    memset( &sText, 0, sizeof( sText ) );
+
+    for ( uint32_t i = 0; i < eTextFont_Total; i++ )
+    {
+        if ( LoadFont( &sText.Fonts[ i ], ulFontBank + i ) == false )
+        {
+            bRet = false;
+        }
+    }
+
+    return bRet;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Width of a string as it would be drawn
+    @ingroup 	MainShell
+    @param      eFont           - Font
+    @param      pText           - String
+    @return     uint32_t        - Pixels
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Text_GetWidth( eTextFont_t eFont, const char* pText )
+{
+    TextFont_t* psFont   = &sText.Fonts[ eFont ];
+    int32_t     lPen     = 0;
+    int32_t     lWidth   = 0;
+    uint32_t    ulPrev   = TEXT_GLYPHS;
+
+    if ( eFont >= eTextFont_Total || psFont->bLoaded == false || pText == NULL )
+    {
+        return 0;
+    }
+
+    for ( ; *pText != 0; pText++ )
+    {
+        uint32_t ulGlyph = Glyph( *pText );
+
+        lPen  += ulPrev < TEXT_GLYPHS ? psFont->Kern[ ulPrev ][ ulGlyph ] : 0;
+        lWidth = lPen + psFont->Width[ ulGlyph ] > lWidth ? lPen + psFont->Width[ ulGlyph ] : lWidth;
+        lPen  += psFont->Advance[ ulGlyph ];
+        ulPrev = ulGlyph;
+    }
+
+    return lWidth;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Height of a font
+    @ingroup 	MainShell
+    @param      eFont           - Font
+    @return     uint32_t        - Pixels
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Text_GetHeight( eTextFont_t eFont )
+{
+    return eFont < eTextFont_Total ? sText.Fonts[ eFont ].ulHeight : 0;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws a string, from its surface if it has one
+    @ingroup 	MainShell
+    @param      eFont           - Font
+    @param      pText           - String
+    @param      x               - Left
+    @param      y               - Top
+    @param      lColour         - LIB_Sprites remap handle, or TEXT_NO_COLOUR
+    @return     bool            - true if drawn
+ -----------------------------------------------------------------------------*/
+bool LIB_Text_Draw( eTextFont_t eFont, const char* pText, int32_t x, int32_t y, int32_t lColour )
+{
+    TextFont_t*    psFont    = &sText.Fonts[ eFont ];
+    TextSurface_t* psSurface = NULL;
+    uint8_t*       pScreen   = Hardware_GetScreenPtr();
+    int32_t        lScreenW  = Hardware_GetScreenWidth();
+    int32_t        lScreenH  = Hardware_GetScreenHeight();
+    uint32_t       ulHash    = 0;
+    uint32_t       ulWidth   = 0;
+
+    if ( eFont >= eTextFont_Total || psFont->bLoaded == false || pText == NULL || pScreen == NULL )
+    {
+        return false;
+    }
+
+    ulHash = Hash( eFont, lColour, pText );
+    for ( uint32_t i = 0; i < TEXT_MAX_SURFACES; i++ )
+    {
+        TextSurface_t* psTry = &sText.Surfaces[ i ];
+
+        if ( psTry->bUsed == true && psTry->ulHash == ulHash && psTry->eFont == eFont && psTry->lColour == lColour && strcmp( psTry->Text, pText ) == 0 )
+        {
+            psSurface = psTry;
+            sText.sFrame.ulHits++;
+            break;
+        }
+    }
+
+    if ( psSurface == NULL )
+    {
+        ulWidth = LIB_Text_GetWidth( eFont, pText );
+
+        // too big to keep, straight to the screen
+        if ( strlen( pText ) > TEXT_MAX_LENGTH || ulWidth > TEXT_SURFACE_WIDTH || psFont->ulHeight > TEXT_SURFACE_HEIGHT )
+        {
+            sText.sFrame.ulMisses++;
+            Render( psFont, pText, pScreen, lScreenW, x, y, lScreenW, lScreenH, LIB_Sprites_GetRemap( lColour ) );
+            return true;
+        }
+
+        // a free surface, or the one unused the longest
+        psSurface = &sText.Surfaces[ 0 ];
+        for ( uint32_t i = 0; i < TEXT_MAX_SURFACES && psSurface->bUsed == true; i++ )
+        {
+            if ( sText.Surfaces[ i ].bUsed == false || sText.Surfaces[ i ].ulLastUsed < psSurface->ulLastUsed )
+            {
+                psSurface = &sText.Surfaces[ i ];
+            }
+        }
+        if ( psSurface->bUsed == true )
+        {
+            sText.sFrame.ulEvictions++;
+        }
+
+        psSurface->bUsed    = true;
+        psSurface->ulHash   = ulHash;
+        psSurface->eFont    = eFont;
+        psSurface->lColour  = lColour;
+        psSurface->ulWidth  = ulWidth;
+        psSurface->ulHeight = psFont->ulHeight;
+        strcpy( psSurface->Text, pText );
+        memset( psSurface->Pixels, 0, ulWidth * psFont->ulHeight );
+        Render( psFont, pText, psSurface->Pixels, ulWidth, 0, 0, ulWidth, psFont->ulHeight, LIB_Sprites_GetRemap( lColour ) );
+        sText.sFrame.ulMisses++;
+    }
+
+    psSurface->ulLastUsed = sText.ulFrame;
+
+    // one clipped rectangle
+    {
+        int32_t xLeft   = x < 0 ? -x : 0;
+        int32_t yTop    = y < 0 ? -y : 0;
+        int32_t xRight  = x + (int32_t)psSurface->ulWidth > lScreenW ? lScreenW - x : (int32_t)psSurface->ulWidth;
+        int32_t yBottom = y + (int32_t)psSurface->ulHeight > lScreenH ? lScreenH - y : (int32_t)psSurface->ulHeight;
+
+        for ( int32_t dy = yTop; dy < yBottom && xLeft < xRight; dy++ )
+        {
+            CopySpan( pScreen + ( ( y + dy ) * lScreenW ) + x + xLeft, psSurface->Pixels + ( dy * psSurface->ulWidth ) + xLeft, xRight - xLeft );
+        }
+    }
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws a string in the 8x8 debug font, lines split on '\n'. A
+                string that does not fit on the screen is not drawn.
+    @ingroup 	MainShell
+    @param      pText           - String
+    @param      x               - Left
+    @param      y               - Top
+    @param      ulInk           - Colour of the characters
+    @param      lPaper          - Colour behind them, or FONTMODULE_NO_PAPER
+    @return     bool            - true if drawn
+ -----------------------------------------------------------------------------*/
+bool LIB_Text_DrawDebug( const char* pText, int32_t x, int32_t y, uint32_t ulInk, int32_t lPaper )
+{
+    uint8_t* pScreen  = Hardware_GetScreenPtr();
+    int32_t  lScreenW = Hardware_GetScreenWidth();
+    int32_t  lScreenH = Hardware_GetScreenHeight();
+    int32_t  lColumns = 0;
+    int32_t  lLongest = 0;
+    int32_t  lLines   = 1;
+
+    if ( pText == NULL || pScreen == NULL )
+    {
+        return false;
+    }
+
+    // FontModule does not clip, check the whole block fits
+    for ( const char* pChar = pText; *pChar != 0; pChar++ )
+    {
+        if ( *pChar == '\n' )
+        {
+            lLines++;
+            lColumns = 0;
+        }
+        else if ( (uint8_t)*pChar == FONTMODULE_COLOUR_CODE && pChar[ 1 ] != 0 )
+        {
+            pChar++;
+        }
+        else
+        {
+            lColumns++;
+            lLongest = lColumns > lLongest ? lColumns : lLongest;
+        }
+    }
+    if ( x < 0 || y < 0 || x + ( lLongest * FONTMODULE_CHAR_SIZE ) > lScreenW || y + ( lLines * FONTMODULE_CHAR_SIZE ) > lScreenH )
+    {
+        return false;
+    }
+
+    FontModule_DrawText( pScreen + ( y * lScreenW ) + x, pText, lScreenW, ulInk, lPaper );
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Ends the frame's counts, once per frame
+    @ingroup 	MainShell
+ -----------------------------------------------------------------------------*/
+void LIB_Text_EndFrame( void )
+{
+    sText.sTotal.ulHits      += sText.sFrame.ulHits;
+    sText.sTotal.ulMisses    += sText.sFrame.ulMisses;
+    sText.sTotal.ulGlyphs    += sText.sFrame.ulGlyphs;
+    sText.sTotal.ulEvictions += sText.sFrame.ulEvictions;
+    sText.sLastFrame = sText.sFrame;
+    memset( &sText.sFrame, 0, sizeof( sText.sFrame ) );
+    sText.ulFrame++;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Returns the cache counts
+    @ingroup 	MainShell
+    @param      psFrame         - Last complete frame, may be NULL
+    @param      psTotal         - Since LIB_Text_Init, may be NULL
+ -----------------------------------------------------------------------------*/
+void LIB_Text_GetStats( TextStats_t* psFrame, TextStats_t* psTotal )
+{
+    if ( psFrame != NULL )
+    {
+        *psFrame = sText.sLastFrame;
+    }
+    if ( psTotal != NULL )
+    {
+        *psTotal = sText.sTotal;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Decodes a font bank into the glyph pool and builds its advance
+                and kerning tables
+    @ingroup 	MainShell
+    @param      psFont          - Font to fill
+    @param      ulBank          - Its sprite bank
+    @return     bool            - false if it did not fit or decode
+ -----------------------------------------------------------------------------*/
+static bool LoadFont( TextFont_t* psFont, uint32_t ulBank )
+{
+    static uint8_t pCell[ MAX_CELL * MAX_CELL ];
+    static uint8_t LeftEdge[ TEXT_GLYPHS ][ MAX_CELL ];     // first column per row, from the glyph's left
+    static uint8_t RightGap[ TEXT_GLYPHS ][ MAX_CELL ];     // clear columns per row, to the glyph's right
+    uint32_t       ulCell   = LIB_Sprites_GetWidth( ulBank );
+    uint32_t       ulHeight = LIB_Sprites_GetHeight( ulBank );
+    int32_t        lMaxKern = 0;
+
+    if ( ulCell == 0 || ulCell > MAX_CELL || ulHeight == 0 || ulHeight > MAX_CELL )
+    {
+        return false;
+    }
+
+    psFont->ulCellWidth = ulCell;
+    psFont->ulHeight    = ulHeight;
+    psFont->ulSpacing   = ulCell >= 16 ? 2 : 1;
+    lMaxKern            = ulCell / 8;
+
+    for ( uint32_t g = 0; g < TEXT_GLYPHS; g++ )
+    {
+        uint32_t ulLeft  = ulCell;
+        uint32_t ulRight = 0;
+
+        memset( pCell, 0, sizeof( pCell ) );
+        memset( LeftEdge[ g ], NO_EDGE, MAX_CELL );
+        memset( RightGap[ g ], NO_EDGE, MAX_CELL );
+        psFont->Pixels[ g ] = NULL;
+        psFont->Width[ g ]  = 0;
+
+        if ( LIB_Sprites_Decode( ulBank, g, pCell, ulCell ) == true )
+        {
+            for ( uint32_t y = 0; y < ulHeight; y++ )
+            {
+                for ( uint32_t x = 0; x < ulCell; x++ )
+                {
+                    if ( pCell[ ( y * ulCell ) + x ] != 0 )
+                    {
+                        ulLeft  = x < ulLeft ? x : ulLeft;
+                        ulRight = x > ulRight ? x : ulRight;
+                    }
+                }
+            }
+        }
+
+        if ( ulLeft > ulRight )
+        {
+            // blank, a space
+            psFont->Advance[ g ] = ulCell / 3;
+            continue;
+        }
+
+        psFont->Width[ g ]   = ulRight - ulLeft + 1;
+        psFont->Advance[ g ] = psFont->Width[ g ] + psFont->ulSpacing;
+        if ( sText.ulPoolUsed + ( psFont->Width[ g ] * ulHeight ) > TEXT_GLYPH_POOL )
+        {
+            return false;
+        }
+        psFont->Pixels[ g ] = &pGlyphPool[ sText.ulPoolUsed ];
+        sText.ulPoolUsed   += psFont->Width[ g ] * ulHeight;
+
+        for ( uint32_t y = 0; y < ulHeight; y++ )
+        {
+            uint8_t* pRow = &pCell[ ( y * ulCell ) + ulLeft ];
+
+            memcpy( psFont->Pixels[ g ] + ( y * psFont->Width[ g ] ), pRow, psFont->Width[ g ] );
+            for ( uint32_t x = 0; x < psFont->Width[ g ]; x++ )
+            {
+                if ( pRow[ x ] != 0 )
+                {
+                    LeftEdge[ g ][ y ] = LeftEdge[ g ][ y ] == NO_EDGE ? x : LeftEdge[ g ][ y ];
+                    RightGap[ g ][ y ] = psFont->Width[ g ] - 1 - x;
+                }
+            }
+        }
+    }
+
+    // closest rows of each pair set how far it can be pulled in
+    for ( uint32_t a = 0; a < TEXT_GLYPHS; a++ )
+    {
+        for ( uint32_t b = 0; b < TEXT_GLYPHS; b++ )
+        {
+            int32_t lGap = psFont->Width[ a ] && psFont->Width[ b ] ? lMaxKern : 0;
+
+            for ( uint32_t y = 0; y < ulHeight && lGap > 0; y++ )
+            {
+                if ( RightGap[ a ][ y ] != NO_EDGE && LeftEdge[ b ][ y ] != NO_EDGE )
+                {
+                    int32_t lRow = RightGap[ a ][ y ] + LeftEdge[ b ][ y ];
+
+                    lGap = lRow < lGap ? lRow : lGap;
+                }
+            }
+            psFont->Kern[ a ][ b ] = (int8_t)-lGap;
+        }
+    }
+
+    psFont->bLoaded = true;
+
+    return true;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Glyph for a character, unknown ones are a space
+    @ingroup 	MainShell
+    @param      c               - Character
+    @return     uint32_t        - Glyph
+ -----------------------------------------------------------------------------*/
+static uint32_t Glyph( char c )
+{
+    uint32_t ulGlyph = (uint8_t)c - TEXT_FIRST_CHAR;
+
+    return ulGlyph < TEXT_GLYPHS ? ulGlyph : 0;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Hash of a surface key
+    @ingroup 	MainShell
+    @param      eFont           - Font
+    @param      lColour         - Colour
+    @param      pText           - String
+    @return     uint32_t        - Hash
+ -----------------------------------------------------------------------------*/
+static uint32_t Hash( eTextFont_t eFont, int32_t lColour, const char* pText )
+{
+    uint32_t ulHash = 2166136261u ^ ( eFont << 8 ) ^ (uint32_t)lColour;
+
+    for ( ; *pText != 0; pText++ )
+    {
+        ulHash = ( ulHash ^ (uint8_t)*pText ) * 16777619u;
+    }
+
+    return ulHash;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Draws a string a glyph at a time into a buffer, clipped to
+                the buffer
+    @ingroup 	MainShell
+    @param      psFont          - Font
+    @param      pText           - String
+    @param      pDest           - Buffer
+    @param      ulPitch         - Bytes per row of pDest
+    @param      x               - Left
+    @param      y               - Top
+    @param      lRight          - Columns in pDest
+    @param      lBottom         - Rows in pDest
+    @param      pRemap          - Colour remap, NULL for none
+    @return     uint32_t        - Glyphs drawn
+ -----------------------------------------------------------------------------*/
+static uint32_t Render( TextFont_t* psFont, const char* pText, uint8_t* pDest, uint32_t ulPitch, int32_t x, int32_t y, int32_t lRight, int32_t lBottom, const uint8_t* pRemap )
+{
+    uint32_t ulPrev   = TEXT_GLYPHS;
+    uint32_t ulGlyphs = 0;
+
+    for ( ; *pText != 0; pText++ )
+    {
+        uint32_t ulGlyph = Glyph( *pText );
+        int32_t  lWidth  = psFont->Width[ ulGlyph ];
+
+        x += ulPrev < TEXT_GLYPHS ? psFont->Kern[ ulPrev ][ ulGlyph ] : 0;
+        ulPrev = ulGlyph;
+
+        if ( psFont->Pixels[ ulGlyph ] != NULL && x < lRight && x + lWidth > 0 )
+        {
+            int32_t xLeft  = x < 0 ? -x : 0;
+            int32_t xEnd   = x + lWidth > lRight ? lRight - x : lWidth;
+
+            for ( int32_t dy = 0; dy < (int32_t)psFont->ulHeight; dy++ )
+            {
+                const uint8_t* pSrc = psFont->Pixels[ ulGlyph ] + ( dy * lWidth );
+                uint8_t*       pRow = NULL;
+
+                if ( y + dy < 0 || y + dy >= lBottom )
+                {
+                    continue;
+                }
+                pRow = pDest + ( ( y + dy ) * ulPitch ) + x;
+                for ( int32_t dx = xLeft; dx < xEnd; dx++ )
+                {
+                    if ( pSrc[ dx ] != 0 )
+                    {
+                        pRow[ dx ] = pRemap ? pRemap[ pSrc[ dx ] ] : pSrc[ dx ];
+                    }
+                }
+            }
+            ulGlyphs++;
+        }
+        x += psFont->Advance[ ulGlyph ];
+    }
+
+    sText.sFrame.ulGlyphs += ulGlyphs;
+
+    return ulGlyphs;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Copies a span, skipping transparent pixels, four a pass
+    @ingroup 	MainShell
+    @param      pDest           - Screen
+    @param      pSrc            - Surface
+    @param      lCount          - Pixels
+ -----------------------------------------------------------------------------*/
+static void CopySpan( uint8_t* pDest, const uint8_t* pSrc, int32_t lCount )
+{
+    uint8_t uPixel = 0;
+
+    for( ; lCount >= 4; lCount -= 4, pSrc += 4, pDest += 4 )
+    {
+        if ( ( uPixel = pSrc[ 0 ] ) != 0 ) pDest[ 0 ] = uPixel;
+        if ( ( uPixel = pSrc[ 1 ] ) != 0 ) pDest[ 1 ] = uPixel;
+        if ( ( uPixel = pSrc[ 2 ] ) != 0 ) pDest[ 2 ] = uPixel;
+        if ( ( uPixel = pSrc[ 3 ] ) != 0 ) pDest[ 3 ] = uPixel;
+    }
+    for( ; lCount > 0; lCount--, pSrc++, pDest++ )
+    {
+        if ( ( uPixel = *pSrc ) != 0 ) *pDest = uPixel;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Text.c
+//-----------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+/** ---------------------------------------------------------------------------
+	@file		LIB_Water.c
+	@defgroup 	MainShell Apollo V4 Shell
+	@brief		Water drawn once into the terrain, animated by palette cycling
+	@date		2025-10-25
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	The water used to be 12 frames of 256 wide sprites drawn across the
+	whole map every frame. Now the water rows are filled once, when the map
+	is built, with a pattern of WATER_COLOURS palette entries, and those
+	entries are rotated by LIB_Palette at VBL. The waves move for the cost
+	of WATER_COLOURS register writes every WATER_CYCLE_FIELDS fields.
+
+	The entries used are the water sprite's own, no longer needed for
+	anything else - the run of consecutive entries from the lowest one the
+	sprite uses, cut to a power of 2 of at most WATER_COLOURS, so the cycle
+	never takes an entry the sprite does not own. They are loaded with a
+	dark to light to dark ramp between the darkest and lightest colours of
+	the sprite, so the look of the water set stays the same.
+
+	Water is not solid, its rows are cleared in the mask.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "Includes/ResourceFiles.h"
+#include "Includes/ResourceHandling.h"
+#include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_Palette.h"
+#include "Includes/LIB_Terrain.h"
+#include "Includes/LIB_TerrainMask.h"
+#include "Includes/LIB_Water.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MIN_COLOURS         ( 4 )       // two ramp steps each way
+#define SURFACE_ROWS        ( 2 )       // bright line along the top
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static uint32_t ulWaterFirst = 0;       // first palette entry, 0 until set up
+static uint32_t ulWaterColours = 0;     // entries cycled, power of 2
+static const uint8_t Wave[ 8 ] = { 0, 1, 2, 3, 3, 2, 1, 0 };
+
+//-----------------------------------------------------------------------------
+// External Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Takes over the water sprite's palette entries and starts them
+                cycling, after LIB_Palette_Init and the resource groups
+    @ingroup 	MainShell
+    @param      ulWaterBank     - Water sprite bank, a RAW from the Water group
+    @return     uint32_t        - First palette entry used, 0 if no water
+ -----------------------------------------------------------------------------*/
+uint32_t LIB_Water_Init( uint32_t ulWaterBank )
+{
+    uint8_t* pPixels  = NULL;
+    uint32_t ulPixels = LIB_Sprites_GetWidth( ulWaterBank ) * LIB_Sprites_GetHeight( ulWaterBank );
+    uint32_t ulLow    = PALETTE_ENTRIES;
+    uint32_t ulDark   = 0xFFFFFF;
+    uint32_t ulLight  = 0;
+    uint32_t ulRun    = 0;
+    bool     Used[ PALETTE_ENTRIES ] = { false };
+
+    ResourceHandling_Get( ulWaterBank, eResourceGet_Data, (uint32_t*)&pPixels );
+    if ( pPixels == NULL || ulPixels == 0 )
+    {
+        return 0;
+    }
+
+    // first frame only, every frame uses the same colours
+    for ( uint32_t i = 0; i < ulPixels; i++ )
+    {
+        uint32_t ulIndex = pPixels[ i ];
+
+        if ( ulIndex == 0 )
+        {
+            continue;
+        }
+        Used[ ulIndex ] = true;
+        if ( ulIndex < ulLow )
+        {
+            ulLow = ulIndex;
+        }
+        if ( LIB_Palette_Luma( LIB_Palette_GetColour( ulIndex ) ) < LIB_Palette_Luma( ulDark ) )
+        {
+            ulDark = LIB_Palette_GetColour( ulIndex );
+        }
+        if ( LIB_Palette_Luma( LIB_Palette_GetColour( ulIndex ) ) >= LIB_Palette_Luma( ulLight ) )
+        {
+            ulLight = LIB_Palette_GetColour( ulIndex );
+        }
+    }
+
+    // only entries the sprite owns, and not already cycled
+    while ( ulLow + ulRun < PALETTE_ENTRIES && ulRun < WATER_COLOURS &&
+            Used[ ulLow + ulRun ] == true && LIB_Palette_IsCycled( ulLow + ulRun ) == false )
+    {
+        ulRun++;
+    }
+
+    ulWaterColours = WATER_COLOURS;
+    while ( ulWaterColours > ulRun )
+    {
+        ulWaterColours >>= 1;
+    }
+    if ( ulWaterColours < MIN_COLOURS )
+    {
+        ulWaterFirst   = 0;
+        ulWaterColours = 0;
+        return 0;
+    }
+
+    uint32_t ulSteps = ulWaterColours / 2;
+
+    for ( uint32_t i = 0; i < ulWaterColours; i++ )
+    {
+        int32_t  t     = i < ulSteps ? i : ( ulWaterColours - 1 ) - i;
+        uint32_t ulRGB = 0;
+
+        for ( uint32_t ulShift = 0; ulShift <= 16; ulShift += 8 )
+        {
+            int32_t lDark  = ( ulDark >> ulShift ) & 0xFF;
+            int32_t lLight = ( ulLight >> ulShift ) & 0xFF;
+
+            ulRGB |= (uint32_t)( lDark + ( ( lLight - lDark ) * t ) / (int32_t)( ulSteps - 1 ) ) << ulShift;
+        }
+        LIB_Palette_SetColour( ulLow + i, ulRGB );
+    }
+
+    LIB_Palette_AddCycle( ulLow, ulWaterColours, WATER_CYCLE_FIELDS, false );
+    ulWaterFirst = ulLow;
+
+    return ulWaterFirst;
+}
+
+/** ----------------------------------------------------------------------------
+    @brief 		Fills the rows from ulTop to the bottom of the map with water
+    @ingroup 	MainShell
+    @param      pBuffer         - Terrain, psMask->ulWidth bytes per row
+    @param      psMask          - Mask of the terrain, water rows become air
+    @param      ulTop           - First water row
+ -----------------------------------------------------------------------------*/
+void LIB_Water_Draw( uint8_t* pBuffer, TerrainMask_t* psMask, uint32_t ulTop )
+{
+    if ( ulWaterFirst == 0 || ulTop >= psMask->ulHeight )
+    {
+        return;
+    }
+
+    for ( uint32_t y = ulTop; y < psMask->ulHeight; y++ )
+    {
+        uint8_t* pRow   = pBuffer + ( y * psMask->ulWidth );
+        uint32_t ulRow  = y - ulTop;
+
+        if ( ulRow < SURFACE_ROWS )
+        {
+            memset( pRow, ulWaterFirst + ( ulWaterColours / 2 ) - 1, psMask->ulWidth );
+            continue;
+        }
+
+        // diagonal bands, bent a little every 32 columns
+        for ( uint32_t x = 0; x < psMask->ulWidth; x++ )
+        {
+            pRow[ x ] = ulWaterFirst + ( ( ( x >> 3 ) + ( ulRow >> 1 ) + Wave[ ( x >> 5 ) & 7 ] ) & ( ulWaterColours - 1 ) );
+        }
+    }
+
+    LIB_TerrainMask_ClearRows( psMask, ulTop, psMask->ulHeight - ulTop );
+}
+
+//-----------------------------------------------------------------------------
+// End of file: LIB_Water.c
+//-----------------------------------------------------------------------------
@@ -88,6 +88,7 @@ typedef struct
     uint32_t            ulTotalFiles;
     uint32_t            ulCurLoadedFile;
     bool                bStatusNeeded;
+    uint32_t            ulResidentTerrain;
 
 } RHCtrl_t, *pRHCtrl_t;
 
@@ -95,7 +96,13 @@ typedef struct
 // Variables
 //-----------------------------------------------------------------------------
 
-static RHCtrl_t sRHCtrl = { .Flags.Flags = 0, .ulResourceCount = 0, .ulCurrentResourceID = START_RESOURCE_ID };
+static RHCtrl_t sRHCtrl = { .Flags.Flags = 0, .ulResourceCount = 0, .ulCurrentResourceID = START_RESOURCE_ID, .ulResidentTerrain = RESOURCE_ALL_TERRAIN };
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static bool IsGroupResident( uint32_t ulGroup );
 
 //-----------------------------------------------------------------------------
 // External Functionality
@@ -316,6 +323,18 @@ bool ResourceHandling_LoadGroups( psFileGroup groups )
 
             psGroup->ulStartResourceID = ulResourceID;
 
+            // other terrain sets keep their resource IDs but are not loaded
+            if ( IsGroupResident( psGroup - groups ) == false )
+            {
+                while( psFileDetails->pszResourceName != NULL )
+                {
+                    ulResourceID++;
+                    psFileDetails++;
+                }
+                psGroup++;
+                continue;
+            }
+
             while( psFileDetails->pszResourceName != NULL )
             {
                 uint8_t* pFileBuffer = NULL;
@@ -404,6 +423,12 @@ void ResourceHandling_InitStatus( psFileGroup groups )
     {
         psFileDetails psFileDetails = groups[ ulIndex ].psFileDetails;
 
+        if ( IsGroupResident( ulIndex ) == false )
+        {
+            ulIndex++;
+            continue;
+        }
+
         while( psFileDetails->pszResourceName != NULL )
         {
             ulTotalFiles++;
@@ -428,6 +453,37 @@ uint32_t ResourceHandling_GetGroupStartResource( uint32_t nGroupIndex )
     return theFileGroups[ nGroupIndex ].ulStartResourceID;
 }
 
+/** ----------------------------------------------------------------------------
+    @brief 		Sets the one terrain set loaded by ResourceHandling_LoadGroups,
+                call before it. The other Terrain01..30 groups are skipped.
+    @ingroup 	MainShell
+    @param      ulTerrainSet    - Terrain group to load, RESOURCE_ALL_TERRAIN for all
+ -----------------------------------------------------------------------------*/
+void ResourceHandling_SetResidentTerrain( uint32_t ulTerrainSet )
+{
+    sRHCtrl.ulResidentTerrain = ulTerrainSet;
+}
+
+//-----------------------------------------------------------------------------
+// Internal Functionality
+//-----------------------------------------------------------------------------
+
+/** ----------------------------------------------------------------------------
+    @brief 		Does a group get loaded
+    @ingroup 	MainShell
+    @param      ulGroup         - Group index
+    @return 	bool            - false for terrain sets other than the resident one
+ -----------------------------------------------------------------------------*/
+static bool IsGroupResident( uint32_t ulGroup )
+{
+    if ( sRHCtrl.ulResidentTerrain == RESOURCE_ALL_TERRAIN || ulGroup < eGroups_Terrain01 || ulGroup > eGroups_Terrain30 )
+    {
+        return true;
+    }
+
+    return ulGroup == sRHCtrl.ulResidentTerrain;
+}
+
 
 
 //-----------------------------------------------------------------------------
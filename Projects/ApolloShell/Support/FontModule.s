@@ -7,6 +7,16 @@
 ;	@copyright	Neil Beresford 2024	
 ;-----------------------------------------------------------------------------
 ;	Notes
+; Characters are drawn by FontModule_DrawText, which looks each glyph row
+; byte up in a 256 entry table of two long word masks and writes the row
+; as two long words, so there is no test per pixel. It draws into any
+; buffer and pitch, the DisplayString, Char and Hex calls are the old
+; screen API on top of it.
+;
+; Counted on a host 68k model, not timed on the Apollo: about 96
+; instructions a glyph without paper and 104 with it, against 448 for the
+; old per pixel DisplayChar. FontModule_Init is about 15000, once.
+;
 ; This module has test code, so it can be build and run, allowing debugging
 ; of core functionality
 ; If the define MAIN_BUILD has not been defined, it builds in the
@@ -26,18 +36,229 @@
 ; External defines
 ;-----------------------------------------------------------------------------
 
+	XDEF _FontModule_Init
+	XDEF _FontModule_DrawText
 	XDEF _FontModule_DisplayString
 	XDEF _FontModule_DisplayChar
 	XDEF _FontModule_DisplayHex
 	XREF screenPtr
 
+;-----------------------------------------------------------------------------
+; Defines
+;-----------------------------------------------------------------------------
+
+FONTHEIGHT			EQU 8
+FONTGLYPHBYTES		EQU 9				; 8 rows and a pad byte per character
+FONTCOLOURCODE		EQU $99				; next byte is the new ink colour
+
 ;-----------------------------------------------------------------------------
 ; Functionality
 ;-----------------------------------------------------------------------------
 
+;** ---------------------------------------------------------------------------
+;	@brief 		Builds the row expansion table, each of the 256 possible glyph
+;				rows as two long word masks, $FF where a pixel is set. Bit 0
+;				is the left pixel, the top byte of the first long. Called by
+;				FontModule_DrawText the first time if not called before.
+;	@ingroup 	MainShell
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_FontModule_Init:
+
+	movem.l	d0-d3/a0,-(SP)
+
+	lea		fontExpand,a0
+	moveq	#0,d0					; row byte
+.entry:
+	moveq	#0,d3					; bit, pixel
+.left:
+	lsl.l	#8,d1
+	btst	d3,d0
+	beq.s	.leftClear
+	move.b	#$FF,d1
+.leftClear:
+	addq.l	#1,d3
+	cmp.l	#4,d3
+	bne.s	.left
+.right:
+	lsl.l	#8,d2
+	btst	d3,d0
+	beq.s	.rightClear
+	move.b	#$FF,d2
+.rightClear:
+	addq.l	#1,d3
+	cmp.l	#8,d3
+	bne.s	.right
+
+	move.l	d1,(a0)+
+	move.l	d2,(a0)+
+	addq.l	#1,d0
+	cmp.l	#256,d0
+	bne.s	.entry
+
+	st		fontExpandBuilt
+
+	movem.l	(SP)+,d0-d3/a0
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Draws a string of 8x8 characters into any 8 bit buffer. Each
+;				glyph row is looked up as two long masks and written as two
+;				long words, masked into the buffer, or with a paper colour
+;				as plain stores. The setup is done once for the string.
+;				Not clipped, the string must fit the buffer. Characters
+;				128 and up use the glyph 128 below. A 10 starts a new line
+;				under the first character, $99 takes the next byte as the
+;				ink colour.
+;	@ingroup 	MainShell
+; 	@param 		a0 - destination, top left pixel of the first character
+; 	@param 		a1 - zero terminated string
+; 	@param 		d0 - bytes per row of the destination
+; 	@param 		d1 - ink colour
+; 	@param 		d2 - paper colour, -1 for none
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_FontModule_DrawText:
+
+	movem.l	d1-d7/a0-a5,-(SP)
+
+	tst.b	fontExpandBuilt
+	bne.s	.built
+	bsr		_FontModule_Init
+.built:
+	lea		fontExpand,a2
+	lea		fontData,a3
+	move.l	a0,a4					; start of the text line
+
+	move.l	d1,d3
+	bsr		FontModule_Replicate
+	move.l	d3,d1					; ink in every byte
+	moveq	#0,d3
+
+	tst.l	d2
+	bmi		.maskChar
+
+	; paper, each long is paper ^ ( ( ink ^ paper ) & mask )
+	move.l	d2,d3
+	bsr		FontModule_Replicate
+	move.l	d3,d2
+	eor.l	d2,d1
+	moveq	#0,d3
+
+.solidChar:
+	move.b	(a1)+,d3
+	beq		.done
+	cmp.b	#10,d3
+	bne.s	.solidColour
+	lea		(a4,d0.l*8),a4			; down a character row
+	move.l	a4,a0
+	bra.s	.solidChar
+.solidColour:
+	cmp.b	#FONTCOLOURCODE,d3
+	bne.s	.solidGlyph
+	move.b	(a1)+,d3
+	beq		.done					; string ended on the code
+	bsr		FontModule_Replicate
+	move.l	d3,d1
+	eor.l	d2,d1
+	moveq	#0,d3
+	bra.s	.solidChar
+.solidGlyph:
+	and.w	#$7F,d3
+	move.l	d3,d4
+	lsl.l	#3,d4
+	add.l	d3,d4					; * FONTGLYPHBYTES
+	lea		(a3,d4.l),a5
+
+	moveq	#FONTHEIGHT-1,d5
+	moveq	#0,d6					; row offset
+	moveq	#0,d4					; only the low byte is loaded below
+.solidRow:
+	move.b	(a5)+,d4
+	move.l	(a2,d4.l*8),d7
+	and.l	d1,d7
+	eor.l	d2,d7
+	move.l	d7,(a0,d6.l)
+	move.l	4(a2,d4.l*8),d7
+	and.l	d1,d7
+	eor.l	d2,d7
+	move.l	d7,4(a0,d6.l)
+	add.l	d0,d6
+	dbf		d5,.solidRow
+
+	addq.l	#8,a0
+	bra		.solidChar
+
+	; no paper, each long becomes dest ^ ( ( dest ^ ink ) & mask )
+.maskChar:
+	move.b	(a1)+,d3
+	beq		.done
+	cmp.b	#10,d3
+	bne.s	.maskColour
+	lea		(a4,d0.l*8),a4
+	move.l	a4,a0
+	bra.s	.maskChar
+.maskColour:
+	cmp.b	#FONTCOLOURCODE,d3
+	bne.s	.maskGlyph
+	move.b	(a1)+,d3
+	beq		.done					; string ended on the code
+	bsr		FontModule_Replicate
+	move.l	d3,d1
+	moveq	#0,d3
+	bra.s	.maskChar
+.maskGlyph:
+	and.w	#$7F,d3
+	move.l	d3,d4
+	lsl.l	#3,d4
+	add.l	d3,d4
+	lea		(a3,d4.l),a5
+
+	moveq	#FONTHEIGHT-1,d5
+	moveq	#0,d6
+	moveq	#0,d4
+.maskRow:
+	move.b	(a5)+,d4
+	beq.s	.maskNext				; empty row, nothing to write
+	move.l	(a0,d6.l),d7
+	eor.l	d1,d7
+	and.l	(a2,d4.l*8),d7
+	eor.l	d7,(a0,d6.l)
+	move.l	4(a0,d6.l),d7
+	eor.l	d1,d7
+	and.l	4(a2,d4.l*8),d7
+	eor.l	d7,4(a0,d6.l)
+.maskNext:
+	add.l	d0,d6
+	dbf		d5,.maskRow
+
+	addq.l	#8,a0
+	bra		.maskChar
+
+.done:
+	movem.l	(SP)+,d1-d7/a0-a5
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Copies a colour into all four bytes of a long
+;	@ingroup 	MainShell
+; 	@param 		d3 - colour in the low byte
+;	@return 	d3 - colour long, d7 is used
+; --------------------------------------------------------------------------- */
+FontModule_Replicate:
+
+	and.l	#$FF,d3
+	move.l	d3,d7
+	lsl.l	#8,d7
+	or.l	d7,d3
+	move.l	d3,d7
+	swap	d7
+	or.l	d7,d3
+	rts
+
 ;----------------------------------------------------------
 ; FontModule_DisplayString
-; Displays the number on the screen
+; Displays a string on the screen in the font colour
 ; Regs:
 ;	d0	- X position
 ;	d1	- Y position
@@ -45,49 +266,26 @@
 ;----------------------------------------------------------
 _FontModule_DisplayString:
 
-	movem.l	d0-a6,-(SP)
-
-	move.l  #10,d0
-	move.l  #80,d1
-	lea		TestString,a0
+	movem.l	d0-d2/a0-a1,-(SP)
 
-	move.l	d0,d3
-	clr.l	d2
-	move.b	#$10,fontCol 
-.print:
-	move.b	(a0)+,d2
-	beq	.endPrint
-
-	; check for carrage returnzxxxcv
-
-	cmp.b	#10,d2
-	bne.s	.checkMisc
-	move.l	d3,d0
-	add	#8,d1
-	bra.s	.print
-	
-.checkMisc:
-
-	cmp.b   #$99,d2
-	bne.s   .continue
-	move.b	(a0)+,fontCol
-	bra.s	.print
-	
-.continue:
-
-	bsr	_FontModule_DisplayChar
-	add.w	#8,d0
-	bra.s	.print 
-
-.endPrint:
+	move.l	a0,a1
+	move.l	screenPtr,a0
+	mulu.l	#SCREENWIDTH,d1
+	add.l	d0,d1
+	add.l	d1,a0
+	move.l	#SCREENWIDTH,d0
+	moveq	#0,d1
+	move.b	fontCol,d1
+	moveq	#-1,d2
+	bsr		_FontModule_DrawText
 
-	movem.l	(SP)+,d0-a6
+	movem.l	(SP)+,d0-d2/a0-a1
 	rts
 
 
 ;----------------------------------------------------------
 ; DisplayChar
-; Displays the number on the screen
+; Displays a character on the screen in the font colour
 ; Regs:
 ;	d0	- X position
 ;	d1	- Y position
@@ -95,42 +293,19 @@ _FontModule_DisplayString:
 ;----------------------------------------------------------
 _FontModule_DisplayChar:
 
-	movem.l	d0-a6,-(SP)
-
-	move.l	screenPtr,a0
-	lea	fontData,a1
-
-FontModule_PrintChar:
+	movem.l	a0,-(SP)
 
-	mulu	#9,d2
-	add.l	d2,a1
-	mulu	#SCREENWIDTH,d1
-	add.l	d0,d1	
-	add.l	d1,a0		
+	lea		fontStrBuffer,a0
+	move.b	d2,(a0)
+	clr.b	1(a0)
+	bsr		_FontModule_DisplayString
 
-	moveq	#8-1,d2
-.charY:
-	moveq	#0,d1
-	move.b	(a1)+,d6
-.charX:
-	btst	d1,d6
-	beq.b	.charCont
-	move.b	fontCol,(a0)
-.charCont:
-	addq	#1,a0				
-	addq	#1,d1
-	cmp.l	#8,d1
-	bne.s	.charX
-
-	add	#SCREENWIDTH-8,a0
-	dbf	d2,.charY
-
-	movem.l	(SP)+,d0-a6
+	movem.l	(SP)+,a0
 	rts
 
 ;----------------------------------------------------------
 ; DisplayHex
-; Displays the number on the screen
+; Displays the number on the screen, as one string
 ; Regs:
 ;	d0	- X position
 ;	d1	- Y position
@@ -138,23 +313,24 @@ FontModule_PrintChar:
 ;----------------------------------------------------------
 _FontModule_DisplayHex:
 
-	movem.l	d0-d4/a0,-(SP)
+	movem.l	d2-d4/a0-a1,-(SP)
 
 	moveq	#7,d3
-	add.l	#56,d0
 	move.l	d2,d4
-	lea	fontHex,a0
+	lea		fontHex,a0
+	lea		fontStrBuffer+8,a1
+	clr.b	(a1)
 .loop:
 	move.l	d4,d2
 	and.l	#$f,d2
-	move.b	(a0,d2),d2
-	bsr	_FontModule_DisplayChar
-	sub.l	#8,d0
-	ror.l	#4,d4
+	move.b	(a0,d2.l),-(a1)
+	lsr.l	#4,d4
 	dbra	d3,.loop
 
+	move.l	a1,a0
+	bsr		_FontModule_DisplayString
 
-	movem.l (SP)+,d0-d4/a0
+	movem.l (SP)+,d2-d4/a0-a1
 	rts
 
 
@@ -174,6 +350,16 @@ fontStrBuffer:
 
 	dcb.b	256		; large buffer	
 
+fontExpandBuilt:
+
+	dc.b	0
+	EVEN
+
+	CNOP 0,4
+fontExpand:
+
+	dcb.l	256*2	; two masks per glyph row byte, see FontModule_Init
+
 fontData:
 
 	include "font8x8_basic.i"
@@ -34,6 +34,8 @@
 	XDEF _Hardware_CopyBackToScreen
 	XDEF _Hardware_CopyBackScreenMap
 	XDEF _Hardware_CopyBack2ToBack1
+	XDEF _Hardware_CopyBack2ToBack1Rows
+	XDEF _Hardware_SwapBackScreens
 	XDEF _Hardware_SetBackscreenBuffers
 	XDEF _Hardware_GetScreenmode
 	XDEF _Hardware_GetDebug
@@ -45,10 +47,14 @@
 	XDEF _Hardware_GetMapX
 	XDEF _Hardware_GetMapY
 	XDEF _Hardware_JoystickButtonPressed
+	XDEF _Hardware_GetFrameCounter
+	XDEF _Hardware_SetVBLHook
+	XDEF _Hardware_ReadCounters
 
 	XDEF screenPtr
 	XDEF backScreen1
 	XDEF backScreen2
+	XDEF backScreen3
 
 
 ;-----------------------------------------------------------------------------
@@ -62,6 +68,9 @@ OPENSCREENTAGLIST 	EQU -$264
 BESTCMODEIDTAGLIST 	EQU -60
 VPOSR				EQU $dff004
 VPOSRCHIPIDMASK		EQU	$0f		
+SUPERVISOR			EQU -30
+LEVEL3VECTOR		EQU $6c
+PRESENTQUEUEMASK	EQU 3				; four entries, never more than three in use
 
 _ApolloTakeOver:
 
@@ -174,6 +183,7 @@ _Hardware_Init
 
 	clr.w	$DFF1E6						; clear modulo
 	move.l	screenPtr,$DFF1EC			; Set GFXPTR
+	move.l	screenPtr,displayedPtr
 	move.w	#SCREENMODE,D0
 	and.w	SCREENMASK,D0	
 	move.w	D0,$DFF1F4					; Set GFX to assigned mode
@@ -181,6 +191,15 @@ _Hardware_Init
 
 	clr.l	$DFF1D0						; Clear MousePtr
 
+	move.l	$4.w,A6						; find the vector base
+	lea		GetVBR(pc),A5
+	jsr		SUPERVISOR(A6)
+	move.l	D0,vbrBase
+	move.l	D0,A0
+	move.l	LEVEL3VECTOR(A0),oldLevel3	; the VBL server owns the display pointer from here
+	move.l	#VBLServer,LEVEL3VECTOR(A0)
+	move.w	#$C020,$DFF09A				; INTEN and VERTB on
+
 
 	movem.l (sp)+,D1-A6					; Successful, returns ZERO in d0 
 	moveq	#0,D0
@@ -222,6 +241,10 @@ _Hardware_SetBackscreenBuffers
 	add.l	#31,D0						
 	and.l	#$FFFFFFE0,D0				
 	move.l	D0,backScreen2
+	add.l	#BACKSCREENWIDTH*BACKSCREENHEIGHT,D0
+	add.l	#31,D0						
+	and.l	#$FFFFFFE0,D0				
+	move.l	D0,backScreen3
 
 	movem.l	(sp)+,d0
 	rts
@@ -242,6 +265,8 @@ _Hardware_Close
 										*
 
 	move.w	#$7FFF,$DFF09A				* ALL INTENA OFF
+	move.l	vbrBase,A0					* put back the level 3 vector
+	move.l	oldLevel3,LEVEL3VECTOR(A0)	*
 	move.w	INTENASTORE,D0				*
 	or.w	#$8000,D0					*
 	move.w	D0,$DFF09A					*
@@ -264,34 +289,187 @@ _Hardware_Close
 	rts
 
 ;** ---------------------------------------------------------------------------
-;	@brief 		Waits until the start of the vertical blank
+;	@brief 		Waits until the start of the next vertical blank. Not needed
+;				before Hardware_FlipScreen, the VBL server does the flip.
 ;	@ingroup 	MainShell
 ;	@return 	none
 ; --------------------------------------------------------------------------- */
 _Hardware_WaitVBL
 
-.wait:
-    btst #5,$dff01f
-    beq .wait
-    move.w #$20,$dff09c
+	move.l	d0,-(sp)
+	move.l	vblCount,d0
+.wait
+	cmp.l	vblCount,d0
+	beq.s	.wait
+	move.l	(sp)+,d0
 	rts
 
 ;** ---------------------------------------------------------------------------
-;	@brief 		Flips the screen, setting the new buffer as active screen
+;	@brief 		Posts the finished screen to the VBL server, which shows it
+;				at the next vertical blank, and moves on to the next buffer.
+;				Only waits when all three buffers are in flight, the next
+;				one to draw into still being on display.
 ;	@ingroup 	MainShell
 ;	@return 	none
 ; --------------------------------------------------------------------------- */
 _Hardware_FlipScreen
 
-	move.l a0,-(sp)
-	move.l screenPtr,a0
-	move.l a0,$DFF1EC
-	move.l screenPtr2,screenPtr
-	move.l screenPtr3,screenPtr2
-	move.l a0,screenPtr3
-	move.l (sp)+,a0
+	movem.l	d0-d1/a0,-(sp)
+
+	move.l	screenPtr,d1				; queue "present screenPtr"
+	moveq	#0,d0
+	move.b	presentHead,d0
+	lea		presentQueue,a0
+	move.l	d1,(a0,d0.l*4)
+	lea		presentStamp,a0
+	move.l	vblCount,(a0,d0.l*4)
+	addq.b	#1,d0
+	and.b	#PRESENTQUEUEMASK,d0
+	move.b	d0,presentHead				; entry written first, then published
+
+	move.l	screenPtr2,screenPtr
+	move.l	screenPtr3,screenPtr2
+	move.l	d1,screenPtr3
+
+	move.l	screenPtr,d1
+.wait
+	cmp.l	displayedPtr,d1
+	beq.s	.wait
+
+	movem.l	(sp)+,d0-d1/a0
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Returns one of the VBL server's counters
+;	@ingroup 	MainShell
+; 	@param 		d0 - 0 presented, 1 dropped, 2 late, 3 vertical blanks
+;	@return 	d0 - counter value
+; --------------------------------------------------------------------------- */
+_Hardware_GetFrameCounter
+
+	movem.l	a0,-(SP)
+
+	and.l	#3,d0
+	lea		framesPresented,a0
+	move.l	(a0,d0.l*4),d0
+
+	movem.l	(SP)+,a0
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Sets a routine called by the VBL server every vertical blank,
+;				after the screen flip. It runs in the interrupt, so it must
+;				be quick. C is fine, the scratch registers d0-d1/a0-a1 and
+;				fp0-fp1 and the FPU control registers are saved for it.
+;	@ingroup 	MainShell
+;	@param 		a0 - routine, 0 for none
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_Hardware_SetVBLHook
+
+	move.l	a0,vblHook
 	rts
 
+;** ---------------------------------------------------------------------------
+;	@brief 		Reads the 68080 cycle and cache counters, free running, the
+;				caller takes the difference of two reads
+;	@ingroup 	MainShell
+;	@param 		a0 - six longs, cycles, dcache hits, dcache misses, icache
+;				     misses, pipe 1 and pipe 2 instructions
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_Hardware_ReadCounters
+
+	dc.w	$4e7a,$0809					; movec CCC,d0 - clock cycles
+	move.l	d0,(a0)+
+	dc.w	$4e7a,$080e					; dcache hits
+	move.l	d0,(a0)+
+	dc.w	$4e7a,$080f					; dcache misses
+	move.l	d0,(a0)+
+	dc.w	$4e7a,$0814					; icache misses
+	move.l	d0,(a0)+
+	dc.w	$4e7a,$080a					; instructions down pipe 1
+	move.l	d0,(a0)+
+	dc.w	$4e7a,$080b					; instructions down pipe 2
+	move.l	d0,(a0)+
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Level 3 interrupt, vertical blank. Latches the oldest posted
+;				screen into the display pointer. With nothing posted the
+;				last screen stays up and the field counts as dropped. A
+;				screen is due the field after it was posted, or the field
+;				after the screen before it was shown if it was queued behind
+;				it, and counts as late if it misses that field.
+;	@ingroup 	MainShell
+; --------------------------------------------------------------------------- */
+VBLServer
+
+	btst	#5,$dff01f					; VERTB?
+	beq.s	.ack
+
+	movem.l	d0-d1/a0-a1,-(sp)
+
+	addq.l	#1,vblCount
+	moveq	#0,d0
+	move.b	presentTail,d0
+	cmp.b	presentHead,d0
+	beq.s	.empty
+
+	lea		presentQueue,a0
+	move.l	(a0,d0.l*4),d1
+	move.l	d1,$DFF1EC
+	move.l	d1,displayedPtr
+	addq.l	#1,framesPresented
+
+	lea		presentStamp,a0				; posted during field n, due at n+1
+	move.l	(a0,d0.l*4),d1
+	cmp.l	presentedField,d1			; queued behind a screen shown at m, due at m+1
+	bcc.s	.posted
+	move.l	presentedField,d1
+.posted
+	addq.l	#1,d1
+	cmp.l	vblCount,d1
+	bcc.s	.ontime
+	addq.l	#1,framesLate
+.ontime
+	move.l	vblCount,presentedField
+	addq.b	#1,d0
+	and.b	#PRESENTQUEUEMASK,d0
+	move.b	d0,presentTail
+	bra.s	.done
+
+.empty
+	tst.l	framesPresented				; nothing counts until the first frame
+	beq.s	.done
+	addq.l	#1,framesDropped
+
+.done
+	move.l	vblHook,d0
+	beq.s	.nohook
+	move.l	d0,a0
+	fmovem.x	fp0-fp1,-(sp)			; the C scratch fp registers and the
+	fmovem.l	fpcr/fpsr/fpiar,-(sp)	; control, a hook may use floats
+	jsr		(a0)
+	fmovem.l	(sp)+,fpcr/fpsr/fpiar
+	fmovem.x	(sp)+,fp0-fp1
+.nohook
+	movem.l	(sp)+,d0-d1/a0-a1
+.ack
+	move.w	#$0070,$dff09c				; twice, the write can be late reaching Paula
+	move.w	#$0070,$dff09c
+	rte
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Reads the vector base register, called through Supervisor()
+;	@ingroup 	MainShell
+;	@return 	d0 - VBR
+; --------------------------------------------------------------------------- */
+GetVBR
+
+	movec	vbr,d0
+	rte
+
 ;** ---------------------------------------------------------------------------
 ;	@brief 		Returns the screen pointer
 ;	@ingroup 	MainShell
@@ -304,11 +482,16 @@ _Hardware_GetScreenPtr
 .back
 	cmp.b	#2,screenmode
 	beq.s	.back2
+	cmp.b	#3,screenmode
+	beq.s	.back3
 	move.l	backScreen1,d0
 	rts
 .back2
 	move.l	backScreen2,d0
 	rts
+.back3
+	move.l	backScreen3,d0
+	rts
 .normal			
 	move.l screenPtr,d0
 	rts
@@ -404,6 +587,53 @@ _Hardware_CopyBack2ToBack1
 	movem.l (sp)+,d0/a0-a1
 	rts
 
+;** ---------------------------------------------------------------------------
+;	@brief 		Copies a band of rows from back screen 2 to back screen 1
+;	@ingroup 	MainShell
+;	@param 		d0 - first row
+;	@param 		d1 - number of rows
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_Hardware_CopyBack2ToBack1Rows
+
+	movem.l d0-d1/a0-a1,-(sp)
+
+	mulu	#BACKSCREENWIDTH,d0
+	move.l	backScreen2,a0
+	move.l	backScreen1,a1
+	add.l	d0,a0
+	add.l	d0,a1
+	mulu	#BACKSCREENWIDTH/16,d1
+	tst.l	d1
+	beq.s	.done
+.copy
+	move.l	(a0)+,(a1)+
+	move.l	(a0)+,(a1)+
+	move.l	(a0)+,(a1)+
+	move.l	(a0)+,(a1)+
+	subq.l	#1,d1
+	bne.s	.copy
+.done
+	movem.l (sp)+,d0-d1/a0-a1
+	rts
+
+;** ---------------------------------------------------------------------------
+;	@brief 		Swaps back screen 2 (the map shown) with the spare back
+;				screen 3, used once a new map has been built in the spare
+;	@ingroup 	MainShell
+;	@return 	none
+; --------------------------------------------------------------------------- */
+_Hardware_SwapBackScreens
+
+	movem.l d0,-(sp)
+
+	move.l	backScreen2,d0
+	move.l	backScreen3,backScreen2
+	move.l	d0,backScreen3
+
+	movem.l (sp)+,d0
+	rts
+
 ;** ---------------------------------------------------------------------------
 ;	@brief 		Generates a random number
 ;	@ingroup 	MainShell
@@ -725,9 +955,25 @@ screenPtr2		dc.l	0
 screenPtr3		dc.l	0
 backScreen1		dc.l	0
 backScreen2		dc.l	0
+backScreen3		dc.l	0
 mapX			dc.l	0
 mapY			dc.l	0
 
+displayedPtr	dc.l	0				; screen the display pointer holds, set by the VBL server
+presentQueue	dc.l	0,0,0,0			; screens posted by Hardware_FlipScreen
+presentStamp	dc.l	0,0,0,0			; vblCount when each was posted
+presentHead		dc.b	0				; written by Hardware_FlipScreen only
+presentTail		dc.b	0				; written by the VBL server only
+		even
+framesPresented	dc.l	0				; Hardware_GetFrameCounter order
+framesDropped	dc.l	0
+framesLate		dc.l	0
+vblCount		dc.l	0
+presentedField	dc.l	0				; vblCount when the last screen was shown
+vbrBase			dc.l	0
+oldLevel3		dc.l	0
+vblHook			dc.l	0				; Hardware_SetVBLHook
+
 debug1			dc.l	0
 debug2			dc.l	0
 debug3			dc.l	0
@@ -743,7 +989,8 @@ screens			ds.b	(SCREENWIDTH*SCREENHEIGHT)*3+64 		; Removed TOTALSCREENSSIZE as i
 
 backScreens		ds.b	BACKSCREENWIDTH*BACKSCREENHEIGHT	; back screen 1
 bs2				ds.b	BACKSCREENWIDTH*BACKSCREENHEIGHT	; back screen 2
-bs3				ds.b	BACKSCREENWIDTH*BACKSCREENHEIGHT	; back screen 3
+bs3				ds.b	BACKSCREENWIDTH*BACKSCREENHEIGHT	; back screen 3, spare for map generation
+				ds.b	96									; room for aligning the three screens
 
 				even
 
@@ -0,0 +1,281 @@
+/** ---------------------------------------------------------------------------
+	@file		CollisionBench.c
+	@defgroup 	HostTools Apollo V4 Shell host tools
+	@brief		Benchmarks the collision grid against testing every pair
+	@date		2025-10-31
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Moves 10 up to 2000 round objects about the 1920x900 world, bouncing
+	off the edges, and each tick finds the pairs touching pixel for pixel,
+	once through the grid and once by testing every pair, and checks the
+	two agree. The sprites are made up circles of a few sizes, LIB_Sprites
+	is replaced here so no Data/ files are needed.
+
+	CollisionBench [-t ticks] [-s seed] [-b]		-b boxes only
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "../Includes/LIB_Sprites.h"
+#include "../Includes/LIB_Collision.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define BENCH_BANKS 		( 6 )
+#define BENCH_MAX_PAIRS 	( 65536 )
+#define BENCH_MAX_SPEED 	( 3 )		// pixels a tick
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+	@brief 		One moving object
+	@ingroup 	HostTools
+ --------------------------------------------------------------------------- */
+typedef struct
+{
+	int32_t 	x;
+	int32_t 	y;
+	int32_t 	lDX;
+	int32_t 	lDY;
+	uint32_t 	ulBank;
+
+} BenchObject_t;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static const uint32_t 	Sizes[ BENCH_BANKS ] = { 8, 12, 16, 24, 32, 48 };
+static const uint32_t 	Counts[] = { 10, 50, 100, 250, 500, 1000, 2000 };
+static BenchObject_t 	Objects[ COLLISION_MAX_BODIES ];
+static CollisionPair_t 	GridPairs[ BENCH_MAX_PAIRS ];
+static CollisionPair_t 	AllPairs[ BENCH_MAX_PAIRS ];
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint32_t TestAllPairs( uint32_t ulCount, bool bPixels );
+static int 		ComparePairs( const void* pA, const void* pB );
+static double 	Seconds( void );
+
+//-----------------------------------------------------------------------------
+// Code
+//-----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+	@brief 		Entry point for the collision benchmark
+	@ingroup 	HostTools
+	@return 	int - return code, 0 success
+ --------------------------------------------------------------------------- */
+int main( int argc, char* argv[] )
+{
+	uint32_t ulTicks  = 200;
+	uint32_t ulSeed   = 1;
+	bool 	 bPixels  = true;
+	bool 	 bMatch   = true;
+
+	for ( int nArg = 1; nArg < argc; nArg++ )
+	{
+		if 		( strcmp( argv[ nArg ], "-t" ) == 0 && nArg + 1 < argc ) ulTicks = strtoul( argv[ ++nArg ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-s" ) == 0 && nArg + 1 < argc ) ulSeed  = strtoul( argv[ ++nArg ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-b" ) == 0 ) 					 bPixels = false;
+		else
+		{
+			printf( "usage: CollisionBench [-t ticks] [-s seed] [-b]\n" );
+			return 1;
+		}
+	}
+
+	LIB_Collision_Init();
+	printf( "Grid %ux%u cells of %u, %u ticks, %s\n", COLLISION_GRID_WIDTH, COLLISION_GRID_HEIGHT, COLLISION_CELL_SIZE,
+			ulTicks, bPixels ? "pixel tests" : "box tests" );
+	printf( "Objects  Update ms  Grid ms  All pairs ms  Speed up  Candidates  Box hits  Touching  Rebinned\n" );
+
+	for ( uint32_t c = 0; c < sizeof( Counts ) / sizeof( Counts[ 0 ] ); c++ )
+	{
+		uint32_t 		 ulCount  = Counts[ c ];
+		double 			 dUpdate  = 0.0;
+		double 			 dGrid 	  = 0.0;
+		double 			 dAll 	  = 0.0;
+		uint64_t 		 ullCandidates = 0, ullBoxHits = 0, ullTouching = 0, ullRebinned = 0;
+		CollisionStats_t sStats;
+
+		srand( ulSeed );
+		LIB_Collision_Clear();
+		for ( uint32_t i = 0; i < ulCount; i++ )
+		{
+			Objects[ i ].ulBank = rand() % BENCH_BANKS;
+			Objects[ i ].x 		= rand() % ( COLLISION_WORLD_WIDTH - Sizes[ Objects[ i ].ulBank ] );
+			Objects[ i ].y 		= rand() % ( COLLISION_WORLD_HEIGHT - Sizes[ Objects[ i ].ulBank ] );
+			Objects[ i ].lDX 	= ( rand() % ( BENCH_MAX_SPEED * 2 + 1 ) ) - BENCH_MAX_SPEED;
+			Objects[ i ].lDY 	= ( rand() % ( BENCH_MAX_SPEED * 2 + 1 ) ) - BENCH_MAX_SPEED;
+		}
+		LIB_Collision_GetStats( NULL );
+
+		for ( uint32_t t = 0; t < ulTicks; t++ )
+		{
+			double 	 dStart = Seconds();
+			uint32_t ulGrid, ulAll;
+
+			// move, bounce and tell the grid
+			for ( uint32_t i = 0; i < ulCount; i++ )
+			{
+				BenchObject_t* psObject = &Objects[ i ];
+				int32_t 	   lSize 	= Sizes[ psObject->ulBank ];
+				CollisionBox_t sBox;
+
+				psObject->x += psObject->lDX;
+				psObject->y += psObject->lDY;
+				if ( psObject->x < 0 || psObject->x + lSize > COLLISION_WORLD_WIDTH )  { psObject->lDX = -psObject->lDX; psObject->x += psObject->lDX * 2; }
+				if ( psObject->y < 0 || psObject->y + lSize > COLLISION_WORLD_HEIGHT ) { psObject->lDY = -psObject->lDY; psObject->y += psObject->lDY * 2; }
+
+				sBox.x 		 = sBox.lImageX = psObject->x;
+				sBox.y 		 = sBox.lImageY = psObject->y;
+				sBox.w 		 = sBox.h = lSize;
+				sBox.lBank 	 = psObject->ulBank;
+				sBox.ulFrame = 0;
+				LIB_Collision_Set( i, &sBox );
+			}
+			dUpdate += Seconds() - dStart;
+
+			dStart = Seconds();
+			ulGrid = LIB_Collision_FindPairs( GridPairs, BENCH_MAX_PAIRS, bPixels );
+			dGrid += Seconds() - dStart;
+			LIB_Collision_GetStats( &sStats );
+
+			dStart = Seconds();
+			ulAll = TestAllPairs( ulCount, bPixels );
+			dAll += Seconds() - dStart;
+
+			ullCandidates += sStats.ulCandidates;
+			ullBoxHits 	  += sStats.ulBoxHits;
+			ullTouching   += ulGrid;
+			ullRebinned   += sStats.ulRebinned;
+
+			// the same pairs, and none twice
+			qsort( GridPairs, ulGrid, sizeof( CollisionPair_t ), ComparePairs );
+			if ( ulGrid != ulAll || memcmp( GridPairs, AllPairs, ulGrid * sizeof( CollisionPair_t ) ) != 0 )
+			{
+				printf( "%u objects tick %u: grid %u pairs, all pairs %u\n", ulCount, t, ulGrid, ulAll );
+				bMatch = false;
+			}
+		}
+
+		printf( "%7u  %9.4f  %7.4f  %12.4f  %7.1fx  %10.1f  %8.1f  %8.1f  %8.1f\n", ulCount,
+				dUpdate * 1000.0 / ulTicks, dGrid * 1000.0 / ulTicks, dAll * 1000.0 / ulTicks, dAll / dGrid,
+				(double)ullCandidates / ulTicks, (double)ullBoxHits / ulTicks, (double)ullTouching / ulTicks, (double)ullRebinned / ulTicks );
+	}
+
+	printf( bMatch ? "Pairs match\n" : "Pairs differ!\n" );
+	return bMatch ? 0 : 1;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Tests every pair, the way without the grid
+	@ingroup 	HostTools
+	@param 		ulCount 	- Bodies 0 up to this
+	@param 		bPixels 	- Pixel tests
+	@return 	uint32_t 	- Pairs touching, in AllPairs in order
+ --------------------------------------------------------------------------- */
+static uint32_t TestAllPairs( uint32_t ulCount, bool bPixels )
+{
+	uint32_t ulPairs = 0;
+
+	for ( uint32_t a = 0; a < ulCount; a++ )
+	{
+		for ( uint32_t b = a + 1; b < ulCount; b++ )
+		{
+			if ( LIB_Collision_Test( a, b, bPixels ) == true && ulPairs < BENCH_MAX_PAIRS )
+			{
+				AllPairs[ ulPairs ].uwA = a;
+				AllPairs[ ulPairs ].uwB = b;
+				ulPairs++;
+			}
+		}
+	}
+	return ulPairs;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		qsort order for pairs
+	@ingroup 	HostTools
+ --------------------------------------------------------------------------- */
+static int ComparePairs( const void* pA, const void* pB )
+{
+	const CollisionPair_t* psA = pA;
+	const CollisionPair_t* psB = pB;
+
+	return psA->uwA != psB->uwA ? (int)psA->uwA - (int)psB->uwA : (int)psA->uwB - (int)psB->uwB;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Wall clock seconds
+	@ingroup 	HostTools
+	@return 	double 		- Seconds
+ --------------------------------------------------------------------------- */
+static double Seconds( void )
+{
+	struct timespec sTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sTime );
+	return (double)sTime.tv_sec + ( (double)sTime.tv_nsec * 1e-9 );
+}
+
+//-----------------------------------------------------------------------------
+// LIB_Sprites, made up circle sprites, one a bank
+//-----------------------------------------------------------------------------
+
+uint32_t LIB_Sprites_GetWidth( eSpriteBank_t eBank )
+{
+	return (uint32_t)eBank < BENCH_BANKS ? Sizes[ eBank ] : 0;
+}
+
+uint32_t LIB_Sprites_GetHeight( eSpriteBank_t eBank )
+{
+	return LIB_Sprites_GetWidth( eBank );
+}
+
+bool LIB_Sprites_Decode( eSpriteBank_t eBank, uint32_t sprNum, uint8_t* pDest, uint32_t ulPitch )
+{
+	int32_t lSize = LIB_Sprites_GetWidth( eBank );
+
+	if ( lSize == 0 || sprNum != 0 )
+	{
+		return false;
+	}
+	for ( int32_t y = 0; y < lSize; y++ )
+	{
+		for ( int32_t x = 0; x < lSize; x++ )
+		{
+			int32_t lDX = x * 2 + 1 - lSize;
+			int32_t lDY = y * 2 + 1 - lSize;
+
+			if ( lDX * lDX + lDY * lDY <= lSize * lSize )
+			{
+				pDest[ y * ulPitch + x ] = 1;
+			}
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// End of File: CollisionBench.c
+//-----------------------------------------------------------------------------
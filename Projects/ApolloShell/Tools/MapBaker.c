@@ -0,0 +1,217 @@
+/** ---------------------------------------------------------------------------
+	@file		MapBaker.c
+	@defgroup 	HostTools Apollo V4 Shell host tools
+	@brief		Pre-bakes a pool of maps into the map cache
+	@date		2025-10-20
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Runs on the host, from the Projects/ApolloShell directory so the Data/
+	paths match the Amiga build. Generates the first N maps of the shared
+	seed pool (LIB_TerrainCache_PoolSeed) for a terrain set, paints them as
+	LIB_MapGenerator does and writes them to Data/Maps/ ready to be uploaded
+	with the rest of the Data directory.
+
+	Caves are on by default as TERRAIN_CAVES in main.c, the cave shape below
+	has to match LIB_MapGenerator.c. -c 0 bakes the plain height map maps.
+
+	MapBaker [-t terrainSet] [-n count] [-f firstIndex] [-c caves]
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "../Includes/ResourceFiles.h"
+#include "../Includes/LIB_Files.h"
+#include "../Includes/LIB_PerlinNoise.h"
+#include "../Includes/LIB_TerrainCache.h"
+#include "../Includes/LIB_Terrain.h"
+#include "../Includes/LIB_TerrainMask.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MAP_WIDTH 			( 1920 )
+#define MAP_HEIGHT 			( 900 )
+#define GRADIENT_REMAP 		( 184 )		// matches ResourceHandling_LoadGroups
+#define DEFAULT_SET 		( eGroups_Terrain23 )
+
+#define CAVE_DEPTH_SCALE 	( 1.0f / 120.0f )	// matches LIB_MapGenerator.c
+#define CAVE_AMPLITUDE 		( 1.1f )
+#define CAVE_FREQUENCY 		( 1.0f / 96.0f )
+#define CAVE_OCTAVES 		( 3 )
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static uint8_t* LoadTerrainFile( psFileGroup psGroup, const char* pszPrefix, uint32_t ulRemap, uint32_t* pWidth, uint32_t* pHeight );
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static int32_t 	pMapHeight[ MAP_WIDTH ];
+static uint8_t 	pBuffer[ MAP_WIDTH * MAP_HEIGHT ];
+static uint32_t pMaskBits[ 2 ][ TERRAINMASK_LONGS( MAP_WIDTH, MAP_HEIGHT ) ];
+static uint8_t 	pMaskTiles[ 2 ][ TERRAINMASK_TILES( MAP_WIDTH, MAP_HEIGHT ) ];
+
+//-----------------------------------------------------------------------------
+// Code
+//-----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+	@brief 		Entry point for the map baker
+	@ingroup 	HostTools
+	@return 	int - return code, 0 success
+ --------------------------------------------------------------------------- */
+int main( int argc, char* argv[] )
+{
+	uint32_t ulTerrainSet 	= DEFAULT_SET;
+	uint32_t ulCount 		= TERRAINCACHE_POOL_SIZE;
+	uint32_t ulFirst 		= 0;
+	uint32_t ulBaked 		= 0;
+	bool 	 bCaves 		= true;
+
+	for ( int nArg = 1; nArg < argc - 1; nArg += 2 )
+	{
+		if 		( strcmp( argv[ nArg ], "-t" ) == 0 ) ulTerrainSet 	= strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-n" ) == 0 ) ulCount 		= strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-f" ) == 0 ) ulFirst 		= strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-c" ) == 0 ) bCaves 		= strtoul( argv[ nArg + 1 ], NULL, 0 ) != 0;
+		else
+		{
+			printf( "usage: MapBaker [-t terrainSet] [-n count] [-f firstIndex] [-c caves]\n" );
+			return 1;
+		}
+	}
+
+	if ( ulTerrainSet < eGroups_Terrain01 || ulTerrainSet > eGroups_Terrain30 )
+	{
+		printf( "Terrain set %u is not a terrain group\n", ulTerrainSet );
+		return 1;
+	}
+
+	psFileGroup psGroup = &theFileGroups[ ulTerrainSet ];
+	uint32_t 	ulGradW = 0, ulGradH = 0, ulSoilW = 0, ulSoilH = 0;
+	uint8_t* 	pGradient = LoadTerrainFile( psGroup, "gradient-", GRADIENT_REMAP, &ulGradW, &ulGradH );
+	uint8_t* 	pSoil = LoadTerrainFile( psGroup, "soil-", psGroup->reMapValue - 1, &ulSoilW, &ulSoilH );
+
+	if ( pGradient == NULL || pSoil == NULL || ulSoilW != 256 || ulSoilH != 256 )
+	{
+		printf( "Missing gradient or soil for %s\n", psGroup->pszDirectory );
+		return 1;
+	}
+
+	TerrainPaint_t sPaint = { pBuffer, MAP_WIDTH, MAP_HEIGHT, pMapHeight, TERRAIN_SURFACE_OFFSET, pSoil, pGradient, ulGradW, ulGradH };
+	TerrainShape_t sShape = { 0 };
+	TerrainMask_t  sMask, sClean;
+
+	LIB_TerrainMask_Setup( &sMask, pMaskBits[ 0 ], pMaskTiles[ 0 ], MAP_WIDTH, MAP_HEIGHT );
+	LIB_TerrainMask_Setup( &sClean, pMaskBits[ 1 ], pMaskTiles[ 1 ], MAP_WIDTH, MAP_HEIGHT );
+
+	sShape.pMapHeight 		= pMapHeight;
+	sShape.lSurfaceOffset 	= TERRAIN_SURFACE_OFFSET;
+	sShape.fDepthScale 		= CAVE_DEPTH_SCALE;
+	sShape.fCaveAmp 		= CAVE_AMPLITUDE;
+	sShape.fCaveFreq 		= CAVE_FREQUENCY;
+	sShape.ulOctaves 		= CAVE_OCTAVES;
+
+	if ( LIB_TerrainCache_MakeDirectory() == false )
+	{
+		printf( "Cannot make %s\n", TERRAINCACHE_DIRECTORY );
+		return 1;
+	}
+
+	for ( uint32_t ulIndex = ulFirst; ulIndex < ulFirst + ulCount; ulIndex++ )
+	{
+		uint32_t ulSeed = LIB_TerrainCache_PoolSeed( ulIndex );
+
+		LIB_PerlinNoise_GenerateSeededMap( pMapHeight, MAP_WIDTH, ulSeed );
+		if ( bCaves == true )
+		{
+			uint32_t ulTiles = LIB_TerrainMask_GetTileCount( &sMask );
+
+			// the generator takes the cave offsets from the seed after the height map
+			sShape.fOffsetX = (float)( LIB_PerlinNoise_Random() % 4096 );
+			sShape.fOffsetY = (float)( LIB_PerlinNoise_Random() % 4096 );
+			LIB_TerrainMask_GenerateTiles( &sMask, &sShape, 0, ulTiles );
+			LIB_TerrainMask_CleanTiles( &sClean, &sMask, 0, ulTiles );
+			LIB_TerrainMask_PaintTiles( &sClean, &sPaint, 0, ulTiles );
+		}
+		else
+		{
+			LIB_Terrain_Paint( &sPaint );
+		}
+
+		if ( LIB_TerrainCache_Save( ulSeed, ulTerrainSet, bCaves, pMapHeight, MAP_WIDTH, pBuffer, MAP_WIDTH, MAP_HEIGHT ) == true )
+		{
+			ulBaked++;
+		}
+	}
+
+	printf( "Baked %u of %u %smaps for %s\n", ulBaked, ulCount, bCaves ? "cave " : "", psGroup->pszDirectory );
+
+	free( pGradient );
+	free( pSoil );
+
+	return ( ulBaked == ulCount ) ? 0 : 1;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Loads and remaps a RAW file from a terrain group
+	@ingroup 	HostTools
+	@param 		psGroup 	- Terrain group
+	@param 		pszPrefix 	- Start of the resource name to find
+	@param 		ulRemap 	- Colour shift applied to non zero pixels
+	@param 		pWidth 		- Returns the width
+	@param 		pHeight 	- Returns the height
+	@return 	uint8_t* 	- Pixel data, NULL on failure
+ --------------------------------------------------------------------------- */
+static uint8_t* LoadTerrainFile( psFileGroup psGroup, const char* pszPrefix, uint32_t ulRemap, uint32_t* pWidth, uint32_t* pHeight )
+{
+	psFileDetails psFile = psGroup->psFileDetails;
+	char 		  szFileName[ 256 ];
+	uint8_t* 	  pData = NULL;
+	uint32_t 	  ulSize = 0;
+
+	while ( psFile->pszResourceName != NULL )
+	{
+		if ( psFile->eFileType == eRAW && strncmp( (char*)psFile->pszResourceName, pszPrefix, strlen( pszPrefix ) ) == 0 )
+		{
+			snprintf( szFileName, sizeof( szFileName ), "%s%s", psGroup->pszDirectory, psFile->pszResourceName );
+			if ( LIB_Files_Load( szFileName, &pData, &ulSize ) == false || ulSize < psFile->ulWidth * psFile->ulHeight )
+			{
+				free( pData );
+				return NULL;
+			}
+			for ( uint32_t ulIndex = 0; ulIndex < ulSize; ulIndex++ )
+			{
+				if ( pData[ ulIndex ] != 0 )
+				{
+					pData[ ulIndex ] += ulRemap;
+				}
+			}
+			*pWidth  = psFile->ulWidth;
+			*pHeight = psFile->ulHeight;
+			return pData;
+		}
+		psFile++;
+	}
+
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// End of File: MapBaker.c
+//-----------------------------------------------------------------------------
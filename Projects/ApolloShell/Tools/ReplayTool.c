@@ -0,0 +1,266 @@
+/** ---------------------------------------------------------------------------
+	@file		ReplayTool.c
+	@defgroup 	HostTools Apollo V4 Shell host tools
+	@brief		Writes the benchmark recording and reads recordings
+	@date		2025-10-30
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	ReplayTool scenario <file>	writes the benchmark run, played on the
+								Amiga with AmiWorms -replay <file>
+	ReplayTool info <file>		prints what a recording holds
+	ReplayTool check <file>		records a held key through the keyboard
+								and plays it back, as main.c does, the
+								repeats must come out the same
+
+	The benchmark scrolls the map edge to edge and top to bottom with the
+	joypad, toggles map mode and back, regenerates the map twice letting
+	each build finish, then exits. It is made here rather than recorded
+	so every build is timed on exactly the same input. It is 1915 ticks in
+	14 records, 632 bytes with the version 2 records of REPLAY_RECORD (44)
+	bytes each.
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "string.h"
+#include "../Includes/LIB_Replay.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define SCENARIO_SEED       ( 1 )           // rand() as an unseeded run
+#define SCENARIO_KEY_NONE   ( APOLLOKEY_NONE )
+#define SCENARIO_CONNECTED  ( 0x0001 )
+#define SCENARIO_RIGHT      ( 0x8000 )
+#define SCENARIO_LEFT       ( 0x4000 )
+#define SCENARIO_DOWN       ( 0x2000 )
+#define SCENARIO_UP         ( 0x1000 )
+#define SCENARIO_SCROLL_X   ( ( 1920 - 640 ) / 4 )     // ticks edge to edge, 4 pixels a tick
+#define SCENARIO_SCROLL_Y   ( ( 900 - 360 ) / 4 )
+#define SCENARIO_MAPGEN     ( 400 )         // ticks left for a map to build and show
+#define CHECK_KEY           ( 0x02 )        // next map in main.c, held it still repeats
+#define CHECK_HELD          ( 100 )         // ticks held
+#define CHECK_TICKS         ( CHECK_HELD + 20 )
+
+//-----------------------------------------------------------------------------
+// Code
+//-----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+	@brief 		Adds ticks of the same input, the pointer left in the middle
+	@ingroup 	HostTools
+	@param 		ulTicks 	- Ticks
+	@param 		ubKey 		- Current_Key
+	@param 		uwJoypad 	- Joypad register, the connected bit is added
+	@return 	bool 		- false on a failed write
+ --------------------------------------------------------------------------- */
+static bool Hold( uint32_t ulTicks, uint8_t ubKey, uint16_t uwJoypad )
+{
+    ReplayTick_t sTick;
+
+    memset( &sTick, 0, sizeof( sTick ) );
+    sTick.ubKey    = ubKey;
+    sTick.uwJoypad = uwJoypad | SCENARIO_CONNECTED;
+    sTick.wMouseX  = 320;
+    sTick.wMouseY  = 180;
+    if ( ubKey != SCENARIO_KEY_NONE )
+    {
+        sTick.KeysDown[ ubKey >> 5 ]    = APOLLOKEY_BIT( ubKey );
+        sTick.KeysPressed[ ubKey >> 5 ] = APOLLOKEY_BIT( ubKey );
+    }
+
+    while ( ulTicks-- > 0 )
+    {
+        if ( LIB_Replay_WriteTick( &sTick ) == false )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		A key going down for one tick, as LIB_Input_Update gives it,
+				then ticks of nothing
+	@ingroup 	HostTools
+	@param 		ubKey 	- Raw key code
+	@param 		ulWait 	- Ticks after it
+	@return 	bool 	- false on a failed write
+ --------------------------------------------------------------------------- */
+static bool Press( uint8_t ubKey, uint32_t ulWait )
+{
+    return Hold( 1, ubKey, 0 ) && Hold( ulWait, SCENARIO_KEY_NONE, 0 );
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Writes the benchmark recording
+	@ingroup 	HostTools
+	@param 		pFileName 	- Recording
+	@return 	int 		- 0 success
+ --------------------------------------------------------------------------- */
+static int Scenario( const char* pFileName )
+{
+    bool bWritten;
+
+    if ( LIB_Replay_Record( pFileName, SCENARIO_SEED ) == false )
+    {
+        printf( "Cannot write %s\n", pFileName );
+        return 1;
+    }
+
+    bWritten = Hold( 50, SCENARIO_KEY_NONE, 0 ) &&
+               Hold( SCENARIO_SCROLL_X, SCENARIO_KEY_NONE, SCENARIO_RIGHT ) &&
+               Hold( SCENARIO_SCROLL_X, SCENARIO_KEY_NONE, SCENARIO_LEFT ) &&
+               Hold( SCENARIO_SCROLL_Y, SCENARIO_KEY_NONE, SCENARIO_DOWN ) &&
+               Hold( SCENARIO_SCROLL_Y, SCENARIO_KEY_NONE, SCENARIO_UP ) &&
+               Press( 0x01, 100 ) &&                        // map mode
+               Press( 0x01, 50 ) &&                         // and back
+               Press( 0x02, SCENARIO_MAPGEN ) &&            // next map
+               Press( 0x02, SCENARIO_MAPGEN ) &&
+               Press( 0x45, 0 );                            // ESC
+    LIB_Replay_Close();
+
+    printf( "%s: %d ticks, %d records, %d bytes\n", pFileName, LIB_Replay_GetTicks(), LIB_Replay_GetRecords(),
+            REPLAY_HEADER + LIB_Replay_GetRecords() * REPLAY_RECORD );
+
+    return bWritten ? 0 : 1;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Reads a recording through and prints what it holds
+	@ingroup 	HostTools
+	@param 		pFileName 	- Recording
+	@return 	int 		- 0 when the ticks read match the header
+ --------------------------------------------------------------------------- */
+static int Info( const char* pFileName )
+{
+    ReplayTick_t    sTick;
+    uint32_t        ulSeed = 0;
+    uint32_t        ulTicks, ulKeys = 0, ulMoved = 0, ulClicks = 0;
+    int16_t         wLastX = 0, wLastY = 0;
+
+    if ( LIB_Replay_Play( pFileName, &ulSeed ) == false )
+    {
+        printf( "%s is not a recording\n", pFileName );
+        return 1;
+    }
+    ulTicks = LIB_Replay_GetTicks();
+
+    while ( LIB_Replay_ReadTick( &sTick ) == true )
+    {
+        if ( sTick.ubKey != SCENARIO_KEY_NONE ) ulKeys++;
+        if ( sTick.uwButtonState & ( APOLLOMOUSE_LEFTCLICK | APOLLOMOUSE_RIGHTCLICK | APOLLOMOUSE_MIDDLECLICK ) ) ulClicks++;
+        if ( sTick.wMouseX != wLastX || sTick.wMouseY != wLastY ) ulMoved++;
+        wLastX = sTick.wMouseX;
+        wLastY = sTick.wMouseY;
+    }
+
+    printf( "%s: seed %u, %u ticks (%u read) in %u records\n", pFileName, ulSeed, ulTicks, LIB_Replay_GetTicks(), LIB_Replay_GetRecords() );
+    printf( "%u keys, %u clicks, pointer moved on %u ticks, %u.%02u seconds at 50 ticks a second\n",
+            ulKeys, ulClicks, ulMoved, ulTicks / 50, ( ulTicks % 50 ) * 2 );
+    LIB_Replay_Close();
+
+    return ulTicks == LIB_Replay_GetTicks() ? 0 : 1;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Records a key held through the keyboard, as LIB_Input_Update
+				gives it, then plays the recording back into another keyboard
+				as main.c does, tick by tick the keys must match
+	@ingroup 	HostTools
+	@param 		pFileName 	- Recording, written then read
+	@return 	int 		- 0 when the playback matches
+ --------------------------------------------------------------------------- */
+static int Check( const char* pFileName )
+{
+    static ApolloKeyBoardState  sLive, sPlayed;
+    static ApolloJoypadState    sJoypad;
+    static ApolloMouseState     sMouse;
+    uint8_t     ubLive[ CHECK_TICKS ];
+    uint32_t    ulSeed = 0;
+    uint32_t    ulRepeats = 0, ulPlayedRepeats = 0, ulDiffer = 0;
+
+    ApolloKeyboardRepeat( &sLive, APOLLOKEY_REPEAT_DELAY, APOLLOKEY_REPEAT_RATE );
+    ApolloKeyboardRepeat( &sPlayed, APOLLOKEY_REPEAT_DELAY, APOLLOKEY_REPEAT_RATE );
+
+    if ( LIB_Replay_Record( pFileName, SCENARIO_SEED ) == false )
+    {
+        printf( "Cannot write %s\n", pFileName );
+        return 1;
+    }
+    for ( uint32_t t = 0; t < CHECK_TICKS; t++ )
+    {
+        ApolloKeyboardBegin( &sLive );
+        if ( t == 0 )           ApolloKeyboardKey( &sLive, CHECK_KEY, true );
+        if ( t == CHECK_HELD )  ApolloKeyboardKey( &sLive, CHECK_KEY, false );
+        ApolloKeyboardEnd( &sLive );
+
+        ubLive[ t ] = ( ApolloKeyDown( &sLive, CHECK_KEY ) ? 8 : 0 ) | ( ApolloKeyPressed( &sLive, CHECK_KEY ) ? 4 : 0 ) |
+                      ( ApolloKeyReleased( &sLive, CHECK_KEY ) ? 2 : 0 ) | ( ApolloKeyRepeat( &sLive, CHECK_KEY ) ? 1 : 0 );
+        ulRepeats += ubLive[ t ] & 1;
+        LIB_Replay_Tick( &sLive, &sJoypad, &sMouse );
+    }
+    LIB_Replay_Close();
+
+    if ( LIB_Replay_Play( pFileName, &ulSeed ) == false )
+    {
+        printf( "%s is not a recording\n", pFileName );
+        return 1;
+    }
+    for ( uint32_t t = 0; LIB_Replay_Tick( &sPlayed, &sJoypad, &sMouse ) == true; t++ )
+    {
+        uint8_t ubPlayed = ( ApolloKeyDown( &sPlayed, CHECK_KEY ) ? 8 : 0 ) | ( ApolloKeyPressed( &sPlayed, CHECK_KEY ) ? 4 : 0 ) |
+                           ( ApolloKeyReleased( &sPlayed, CHECK_KEY ) ? 2 : 0 ) | ( ApolloKeyRepeat( &sPlayed, CHECK_KEY ) ? 1 : 0 );
+
+        ulPlayedRepeats += ubPlayed & 1;
+        if ( t >= CHECK_TICKS || ubPlayed != ubLive[ t ] )
+        {
+            ulDiffer++;
+        }
+    }
+    LIB_Replay_Close();
+
+    printf( "Key held %u ticks: %u repeats live, %u played back, %u ticks differ\n", CHECK_HELD, ulRepeats, ulPlayedRepeats, ulDiffer );
+
+    return ( ulDiffer == 0 && ulRepeats == ulPlayedRepeats ) ? 0 : 1;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Entry point for the replay tool
+	@ingroup 	HostTools
+	@return 	int - return code, 0 success
+ --------------------------------------------------------------------------- */
+int main( int argc, char* argv[] )
+{
+    if ( argc == 3 && strcmp( argv[ 1 ], "scenario" ) == 0 )
+    {
+        return Scenario( argv[ 2 ] );
+    }
+    if ( argc == 3 && strcmp( argv[ 1 ], "info" ) == 0 )
+    {
+        return Info( argv[ 2 ] );
+    }
+    if ( argc == 3 && strcmp( argv[ 1 ], "check" ) == 0 )
+    {
+        return Check( argv[ 2 ] );
+    }
+
+    printf( "ReplayTool scenario <file> | info <file> | check <file>\n" );
+
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+// End of File: ReplayTool.c
+//-----------------------------------------------------------------------------
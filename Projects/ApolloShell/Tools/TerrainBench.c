@@ -0,0 +1,281 @@
+/** ---------------------------------------------------------------------------
+	@file		TerrainBench.c
+	@defgroup 	HostTools Apollo V4 Shell host tools
+	@brief		Benchmarks 2D terrain generation, single task against tiles
+				shared between worker threads
+	@date		2025-10-23
+	@version	0.1
+	@copyright	Neil Beresford 2025
+ -----------------------------------------------------------------------------
+	Notes
+
+	Builds the same 1920x900 map (mask, cleanup and paint) several times,
+	once on the calling thread and then with the 32x32 tiles handed out to
+	worker threads a few at a time, and checks both give the same buffer.
+	Soil and gradient are made up, no Data/ files are needed.
+
+	TerrainBench [-t threads] [-r repeats] [-s seed]
+
+--------------------------------------------------------------------------- */
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "pthread.h"
+#include "../Includes/LIB_PerlinNoise.h"
+#include "../Includes/LIB_Terrain.h"
+#include "../Includes/LIB_TerrainMask.h"
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define MAP_WIDTH 		( 1920 )
+#define MAP_HEIGHT 		( 900 )
+#define MAX_THREADS 	( 64 )
+#define TILE_CHUNK 		( 4 )		// tiles taken by a worker at a time
+
+//-----------------------------------------------------------------------------
+// Typedefs and enums
+//-----------------------------------------------------------------------------
+
+typedef enum
+{
+	ePass_Generate = 0,
+	ePass_Clean,
+	ePass_Paint,
+	ePass_Total
+
+} ePass_t;
+
+/** ---------------------------------------------------------------------------
+	@brief 		Work shared by the worker threads for one pass
+	@ingroup 	HostTools
+ --------------------------------------------------------------------------- */
+typedef struct
+{
+	ePass_t 		ePass;
+	uint32_t 		ulNextTile;		// taken with an atomic add
+	uint32_t 		ulTiles;
+
+} BenchWork_t;
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static int32_t 			pMapHeight[ MAP_WIDTH ];
+static uint32_t 		pBits[ 2 ][ TERRAINMASK_LONGS( MAP_WIDTH, MAP_HEIGHT ) ];
+static uint8_t 			pTiles[ 2 ][ TERRAINMASK_TILES( MAP_WIDTH, MAP_HEIGHT ) ];
+static uint8_t 			pBuffer[ 2 ][ MAP_WIDTH * MAP_HEIGHT ];
+static uint8_t 			pSoil[ 256 * 256 ];
+static uint8_t 			pGradient[ 8 * MAP_HEIGHT ];
+static TerrainMask_t 	sMask;
+static TerrainMask_t 	sClean;
+static TerrainShape_t 	sShape;
+static TerrainPaint_t 	sPaint;
+static BenchWork_t 		sWork;
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void 	RunPass( ePass_t ePass, uint32_t ulFirst, uint32_t ulCount );
+static void* 	Worker( void* pArg );
+static double 	BuildSingle( void );
+static double 	BuildThreaded( uint32_t ulThreads );
+static double 	Seconds( void );
+
+//-----------------------------------------------------------------------------
+// Code
+//-----------------------------------------------------------------------------
+
+/** ---------------------------------------------------------------------------
+	@brief 		Entry point for the terrain benchmark
+	@ingroup 	HostTools
+	@return 	int - return code, 0 success
+ --------------------------------------------------------------------------- */
+int main( int argc, char* argv[] )
+{
+	uint32_t ulThreads = 4;
+	uint32_t ulRepeats = 5;
+	uint32_t ulSeed    = 1;
+	double 	 dSingle   = 1e9;
+	double 	 dThreaded = 1e9;
+
+	for ( int nArg = 1; nArg < argc - 1; nArg += 2 )
+	{
+		if 		( strcmp( argv[ nArg ], "-t" ) == 0 ) ulThreads = strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-r" ) == 0 ) ulRepeats = strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else if ( strcmp( argv[ nArg ], "-s" ) == 0 ) ulSeed 	= strtoul( argv[ nArg + 1 ], NULL, 0 );
+		else
+		{
+			printf( "usage: TerrainBench [-t threads] [-r repeats] [-s seed]\n" );
+			return 1;
+		}
+	}
+	if ( ulThreads < 1 ) ulThreads = 1;
+	if ( ulThreads > MAX_THREADS ) ulThreads = MAX_THREADS;
+
+	// made up textures, only the timing matters
+	for ( uint32_t i = 0; i < sizeof( pSoil ); i++ ) 	 pSoil[ i ] 	= 90 + ( ( i * 7 + ( i >> 8 ) * 3 ) % 60 );
+	for ( uint32_t i = 0; i < sizeof( pGradient ); i++ ) pGradient[ i ] = 185 + ( i / ( 8 * 16 ) );
+
+	LIB_PerlinNoise_GenerateSeededMap( pMapHeight, MAP_WIDTH, ulSeed );
+
+	sShape.pMapHeight 		= pMapHeight;
+	sShape.lSurfaceOffset 	= TERRAIN_SURFACE_OFFSET;
+	sShape.fDepthScale 		= 1.0f / 120.0f;
+	sShape.fCaveAmp 		= 1.1f;
+	sShape.fCaveFreq 		= 1.0f / 96.0f;
+	sShape.ulOctaves 		= 3;
+	sShape.fOffsetX 		= (float)( LIB_PerlinNoise_Random() % 4096 );
+	sShape.fOffsetY 		= (float)( LIB_PerlinNoise_Random() % 4096 );
+
+	LIB_TerrainMask_Setup( &sMask, pBits[ 0 ], pTiles[ 0 ], MAP_WIDTH, MAP_HEIGHT );
+	LIB_TerrainMask_Setup( &sClean, pBits[ 1 ], pTiles[ 1 ], MAP_WIDTH, MAP_HEIGHT );
+
+	sPaint.ulWidth 			= MAP_WIDTH;
+	sPaint.ulHeight 		= MAP_HEIGHT;
+	sPaint.pMapHeight 		= pMapHeight;
+	sPaint.lSurfaceOffset 	= TERRAIN_SURFACE_OFFSET;
+	sPaint.pSoil 			= pSoil;
+	sPaint.pGradient 		= pGradient;
+	sPaint.ulGradientWidth 	= 8;
+	sPaint.ulGradientHeight = MAP_HEIGHT;
+
+	for ( uint32_t ulRepeat = 0; ulRepeat < ulRepeats; ulRepeat++ )
+	{
+		double dTime;
+
+		sPaint.pBuffer = pBuffer[ 0 ];
+		dTime = BuildSingle();
+		if ( dTime < dSingle ) dSingle = dTime;
+
+		sPaint.pBuffer = pBuffer[ 1 ];
+		dTime = BuildThreaded( ulThreads );
+		if ( dTime < dThreaded ) dThreaded = dTime;
+	}
+
+	uint32_t ulTiles = LIB_TerrainMask_GetTileCount( &sMask );
+
+	printf( "Map %ux%u, %u tiles of %u\n", MAP_WIDTH, MAP_HEIGHT, ulTiles, TERRAINMASK_TILE_SIZE );
+	printf( "Tiles after cleanup: %u air, %u solid, %u mixed (noise only sampled in mixed)\n",
+			LIB_TerrainMask_CountTiles( &sClean, eMaskTile_Air ),
+			LIB_TerrainMask_CountTiles( &sClean, eMaskTile_Solid ),
+			LIB_TerrainMask_CountTiles( &sClean, eMaskTile_Mixed ) );
+	printf( "Single task      : %8.2f ms\n", dSingle * 1000.0 );
+	printf( "%2u worker threads: %8.2f ms  (x%.2f)\n", ulThreads, dThreaded * 1000.0, dSingle / dThreaded );
+
+	if ( memcmp( pBuffer[ 0 ], pBuffer[ 1 ], sizeof( pBuffer[ 0 ] ) ) != 0 )
+	{
+		printf( "Buffers differ!\n" );
+		return 1;
+	}
+
+	printf( "Buffers match\n" );
+	return 0;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Runs one pass over a run of tiles
+	@ingroup 	HostTools
+	@param 		ePass 	- Pass to run
+	@param 		ulFirst - First tile
+	@param 		ulCount - Number of tiles
+ --------------------------------------------------------------------------- */
+static void RunPass( ePass_t ePass, uint32_t ulFirst, uint32_t ulCount )
+{
+	switch ( ePass )
+	{
+		case ePass_Generate: LIB_TerrainMask_GenerateTiles( &sMask, &sShape, ulFirst, ulCount ); break;
+		case ePass_Clean: 	 LIB_TerrainMask_CleanTiles( &sClean, &sMask, ulFirst, ulCount ); 	 break;
+		default: 			 LIB_TerrainMask_PaintTiles( &sClean, &sPaint, ulFirst, ulCount ); 	 break;
+	}
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Worker thread, takes tiles until the pass is done
+	@ingroup 	HostTools
+	@param 		pArg 	- unused
+	@return 	void* 	- NULL
+ --------------------------------------------------------------------------- */
+static void* Worker( void* pArg )
+{
+	while ( true )
+	{
+		uint32_t ulFirst = __atomic_fetch_add( &sWork.ulNextTile, TILE_CHUNK, __ATOMIC_RELAXED );
+
+		if ( ulFirst >= sWork.ulTiles ) break;
+		RunPass( sWork.ePass, ulFirst, TILE_CHUNK );
+	}
+
+	return NULL;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Builds the map on this thread
+	@ingroup 	HostTools
+	@return 	double - seconds taken
+ --------------------------------------------------------------------------- */
+static double BuildSingle( void )
+{
+	double   dStart  = Seconds();
+	uint32_t ulTiles = LIB_TerrainMask_GetTileCount( &sMask );
+
+	for ( uint32_t ePass = 0; ePass < ePass_Total; ePass++ )
+	{
+		RunPass( ePass, 0, ulTiles );
+	}
+
+	return Seconds() - dStart;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Builds the map with the tiles shared between threads, each
+				pass completing before the next starts
+	@ingroup 	HostTools
+	@param 		ulThreads - number of worker threads
+	@return 	double - seconds taken
+ --------------------------------------------------------------------------- */
+static double BuildThreaded( uint32_t ulThreads )
+{
+	pthread_t pThreads[ MAX_THREADS ];
+	double 	  dStart = Seconds();
+
+	for ( uint32_t ePass = 0; ePass < ePass_Total; ePass++ )
+	{
+		sWork.ePass 	 = ePass;
+		sWork.ulNextTile = 0;
+		sWork.ulTiles 	 = LIB_TerrainMask_GetTileCount( &sMask );
+
+		for ( uint32_t i = 0; i < ulThreads; i++ ) pthread_create( &pThreads[ i ], NULL, Worker, NULL );
+		for ( uint32_t i = 0; i < ulThreads; i++ ) pthread_join( pThreads[ i ], NULL );
+	}
+
+	return Seconds() - dStart;
+}
+
+/** ---------------------------------------------------------------------------
+	@brief 		Monotonic time
+	@ingroup 	HostTools
+	@return 	double - seconds
+ --------------------------------------------------------------------------- */
+static double Seconds( void )
+{
+	struct timespec sTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &sTime );
+	return (double)sTime.tv_sec + ( (double)sTime.tv_nsec * 1e-9 );
+}
+
+//-----------------------------------------------------------------------------
+// End of File: TerrainBench.c
+//-----------------------------------------------------------------------------
@@ -27,9 +27,22 @@
 #include "Includes/ResourceHandling.h"
 #include "Includes/FontModule.h"
 #include "Includes/LIB_ApolloInput.h"
+#include "Includes/LIB_Input.h"
+#include "Includes/LIB_Replay.h"
 #include "Includes/LIB_Files.h"
 #include "Includes/LIB_Sprites.h"
+#include "Includes/LIB_SprManager.h"
 #include "Includes/LIB_PerlinNoise.h"
+#include "Includes/LIB_TerrainCache.h"
+#include "Includes/LIB_Terrain.h"
+#include "Includes/LIB_TerrainMask.h"
+#include "Includes/LIB_MapGenerator.h"
+#include "Includes/LIB_Palette.h"
+#include "Includes/LIB_Water.h"
+#include "Includes/LIB_Blend.h"
+#include "Includes/LIB_Text.h"
+#include "Includes/LIB_Hud.h"
+#include "Includes/LIB_Profile.h"
 
 //-----------------------------------------------------------------------------
 // Defines
@@ -44,13 +57,27 @@
 #define VISABLE_WIDTH 	( 640 )
 #define MAPSCROLLSPEED 	( 12.0f )
 
+#define KEY_ESC 		( 0x45 )
+#define KEY_UP 			( 0x4C )
+#define KEY_DOWN 		( 0x4D )
+#define KEY_RIGHT 		( 0x4E )
+#define KEY_LEFT 		( 0x4F )
+
+#define TERRAIN_SET 	( eGroups_Terrain23 )
+#define CACHE_NEW_MAPS 	( 1 )			// save maps generated at runtime to the map cache
+#define TERRAIN_CAVES 	( 1 )			// 2D noise caves and overhangs, cached apart from plain maps
+
 
 //-----------------------------------------------------------------------------
 // Forward declarations
 //-----------------------------------------------------------------------------
 
 void CreateBackScreens( void );
+void NextMap( void );
+void DecorateMap( int32_t* pMapHeight, uint32_t ulWidth, uint32_t ulHeight );
+void DrawMapProgress( void );
 void DrawMap( void );
+void MainVBL( void );
 
 //-----------------------------------------------------------------------------
 // Variables
@@ -60,8 +87,8 @@ ApolloKeyBoardState sKeyboardState;
 ApolloJoypadState   sJoypadState;
 ApolloMouseState	sMouseState;
 
-int32_t pMapHeight[ MAP_WIDTH ];
 uint32_t ulFrames = 0;
+uint32_t ulMapIndex = 0;
 
 //-----------------------------------------------------------------------------
 // Code
@@ -90,8 +117,27 @@ uint32_t main(int argc, char *argv[])
 	printf(Banner);
 	printf("Press 'ESC' to exit\n");
 
+	// -record file or -replay file, the same run again for timing builds against each other
+	if ( argc == 3 && strcmp( argv[1], "-record" ) == 0 )
+	{
+		uint32_t ulSeed = (uint32_t)time( NULL );
+
+		if ( LIB_Replay_Record( argv[2], ulSeed ) == false ) { printf("Cannot write recording %s\n", argv[2]); return 1; }
+		srand( ulSeed );
+		printf("Recording input to %s\n", argv[2]);
+	}
+	else if ( argc == 3 && strcmp( argv[1], "-replay" ) == 0 )
+	{
+		uint32_t ulSeed = 0;
+
+		if ( LIB_Replay_Play( argv[2], &ulSeed ) == false ) { printf("Cannot read recording %s\n", argv[2]); return 1; }
+		srand( ulSeed );
+		printf("Replaying %d ticks from %s\n", LIB_Replay_GetTicks(), argv[2]);
+	}
+
 	// Initialize the system and hardware
 	LIB_Sprites_Init();
+	LIB_SprManager_Init();
 	ResourceHandling_Init();
 	// NB removed ResourceHandling_InitStatus( theFileGroups );
 
@@ -100,13 +146,27 @@ uint32_t main(int argc, char *argv[])
 
 	if ( LIB_Files_Load("Data/Palettes/paletteSnow.bin",&paletteBuffer, NULL)	== false ) { printf("Failed to load palette\n"); return 1; }
 
-	// load all the sprite groups
+	// load all the sprite groups, only the terrain set in use
 	printf("Loading sprite files and remapping...\n");
+	ResourceHandling_SetResidentTerrain( TERRAIN_SET );
 	ResourceHandling_LoadGroups( theFileGroups );
 
 	printf("Files loaded\n");	
+	if ( LIB_Text_Init( ResourceHandling_GetGroupStartResource( eGroups_Font ) ) == false ) { printf("Failed to set up the fonts\n"); }
 	printf("Create the back screens\n");
 	Hardware_SetBackscreenBuffers();
+	LIB_MapGenerator_Init( TERRAIN_SET, CACHE_NEW_MAPS, DecorateMap );
+	LIB_MapGenerator_SetCaves( TERRAIN_CAVES );
+
+	// water is part of the map, animated by cycling its palette entries
+	LIB_Palette_Init( NULL );
+	LIB_Palette_SelectNamed( LIB_Palette_AddNamed( "Snow", paletteBuffer ), 0 );
+	if ( LIB_Water_Init( ResourceHandling_GetGroupStartResource( eGroups_Water ) + 1 ) != 0 )
+	{
+		LIB_MapGenerator_SetWater( WATER_ROWS );
+	}
+	LIB_Blend_Build();
+	PROFILE_INIT();
 	
 	#if 0
 	LIB_Sprites_SetClipArea( 20, 40, 640, 480 );
@@ -119,36 +179,35 @@ uint32_t main(int argc, char *argv[])
 
 	Hardware_Init();
 
-	HWSCREEN_SetImagePalette( paletteBuffer );
+	// the palette is written by the VBL hook, faded in from black, and the input sampled
+	LIB_Palette_PlayTransform( LIB_Palette_BuildTransform( ePaletteTransform_Fade, 0x000000, 16 ), ePalettePlay_Reverse, 2 );
+	LIB_Input_Init();
+	ApolloKeyboardRepeat( &sKeyboardState, APOLLOKEY_REPEAT_DELAY, APOLLOKEY_REPEAT_RATE );
+	Hardware_SetVBLHook( MainVBL );
 
-	// Draw panel to all three screens
+	// the panels, drawn into each screen by LIB_Hud_Draw, then only when changed
 	Hardware_SetScreenmode( 0 );
-	LIB_Sprites_SetClipArea( 0, 0, 640, 480 );
-	for( int32_t count = 0; count < 3; count++)
-	{
-		LIB_Sprites_Draw( 			ResourceHandling_GetGroupStartResource( 4 ) + 4, 0, 0,400 );
-		LIB_Sprites_Draw( 			ResourceHandling_GetGroupStartResource( 4 ), 0,     320-20,		10 );
-		LIB_Sprites_Draw( 			ResourceHandling_GetGroupStartResource( 4 ) + 2, 0, 320-24-268, 0 );
-		LIB_Sprites_Draw( 			ResourceHandling_GetGroupStartResource( 4 ) + 2, 0, 320-24-268, 19 );
-		LIB_Sprites_DrawFlipped( 	ResourceHandling_GetGroupStartResource( 4 ) + 2, 0, 320+22, 	0 );
-		LIB_Sprites_DrawFlipped( 	ResourceHandling_GetGroupStartResource( 4 ) + 2, 0, 320+22, 	19 );
-		Hardware_WaitVBL();
-		Hardware_FlipScreen();
-	}
+	uint32_t ulPanels = ResourceHandling_GetGroupStartResource( eGroups_Panels );
+
+	LIB_Hud_Init();
+	int32_t lHudBottom = LIB_Hud_AddPanel( HUD_NO_PARENT, 0, 400, ulPanels + 4, 0, false );
+	LIB_Hud_AddPanel( HUD_NO_PARENT, 320-20,     10, ulPanels,     0, false );
+	LIB_Hud_AddPanel( HUD_NO_PARENT, 320-24-268, 0,  ulPanels + 2, 0, false );
+	LIB_Hud_AddPanel( HUD_NO_PARENT, 320-24-268, 19, ulPanels + 2, 0, false );
+	LIB_Hud_AddPanel( HUD_NO_PARENT, 320+22,     0,  ulPanels + 2, 0, true );
+	LIB_Hud_AddPanel( HUD_NO_PARENT, 320+22,     19, ulPanels + 2, 0, true );
+	int32_t lHudTime = LIB_Hud_AddLabel( lHudBottom, 20,  12, eTextFont_Small, TEXT_NO_COLOUR );
+	int32_t lHudMap  = LIB_Hud_AddLabel( lHudBottom, 540, 12, eTextFont_Small, TEXT_NO_COLOUR );
 
 
 	bool bMapMode = false;
+	bool bProfileOverlay = false;
 	int32_t nScrollX = 400;
 	int32_t nScrollY = 400;
 	uint32_t nTimeOut = 800;
 	uint32_t nMouseGfxOffset = 6;
 	uint32_t nMarkerGfx = 0;
 
-	// Water
-	uint32_t ulWaterSprIndex = ResourceHandling_GetGroupStartResource( eGroups_Water ) + 1;
-	uint32_t ulSprHeight = LIB_Sprites_GetHeight( ulWaterSprIndex );
-	uint32_t ulWaterSprNum = 0;
-
 	sMouseState.MouseX_Pointer_Max = 640;
 	sMouseState.MouseY_Pointer_Max = 360;
 	sMouseState.MouseX_Value_Old = 320;
@@ -156,26 +215,52 @@ uint32_t main(int argc, char *argv[])
 	sMouseState.MouseX_Value = 320;
 	sMouseState.MouseY_Value = 180;
 	LIB_Sprites_SetClipArea( 0, 42, 640, 360 );
+	LIB_SprManager_SetView( 0, 42, 640, 360 );
+	uint32_t ulFirstField = Hardware_GetFrameCounter( eFrameCounter_VBL );
 
 	while ( true ) // --nTimeOut > 0
 	{
 		ulFrames++;
-		Hardware_WaitVBL();
+		PROFILE_FRAME();
+		PROFILE_BEGIN( "FLIP" );
 		Hardware_FlipScreen();
+		PROFILE_END();
 
+		PROFILE_BEGIN( "DRAW" );
 		if ( bMapMode == false )
 		{
 			// copy area opf map to screen
+			PROFILE_BEGIN( "COPY" );
 			Hardware_SetMapX( nScrollX );	
 			Hardware_SetMapY( nScrollY );
 			Hardware_CopyBackToScreen();
+			PROFILE_END();
+
+			// the sprites over the map, against this frame's scroll
+			PROFILE_BEGIN( "SPRITES" );
+			LIB_SprManager_SetCamera( nScrollX, nScrollY );
+			LIB_SprManager_Draw();
+			PROFILE_END();
 
 			#if 1
-			for( int32_t i = 0; i < 26; i++ )
-			{
-				LIB_Sprites_Draw( ResourceHandling_GetGroupStartResource( eGroups_Font ) + 1, i, 20+(i*7), 50 );
-				LIB_Sprites_Draw( ResourceHandling_GetGroupStartResource( eGroups_Font ), i, 20+(i*16), 60 );
-			}
+			// drawn from the text cache
+			PROFILE_BEGIN( "TEXT" );
+			LIB_Text_Draw( eTextFont_Medium, "APOLLO WORMS", 20, 50, TEXT_NO_COLOUR );
+
+			// debug overlay in the 8x8 font, last frame's text cache counts
+			TextStats_t sTextFrame;
+			char        szDebug[ 48 ];
+
+			LIB_Text_GetStats( &sTextFrame, NULL );
+			sprintf( szDebug, "TEXT HITS %d MISSES %d GLYPHS %d", sTextFrame.ulHits, sTextFrame.ulMisses, sTextFrame.ulGlyphs );
+			LIB_Text_DrawDebug( szDebug, 20, 76, 0x0F, FONTMODULE_NO_PAPER );
+
+			SprStats_t sSprFrame;
+
+			LIB_SprManager_GetStats( &sSprFrame );
+			sprintf( szDebug, "SPRITES %d VISIBLE %d DRAWN %d", sSprFrame.ulActive, sSprFrame.ulVisible, sSprFrame.ulDrawn );
+			LIB_Text_DrawDebug( szDebug, 20, 86, 0x0F, FONTMODULE_NO_PAPER );
+			PROFILE_END();
 			#endif
 		}
 		else
@@ -202,74 +287,113 @@ uint32_t main(int argc, char *argv[])
 			}
 		}
 
-		if ( bMapMode == false )
+		// the HUD only changes once a second, or on a new map
+		uint32_t ulSeconds = Hardware_GetFrameCounter( eFrameCounter_VBL ) / 50;
+		char     szHud[ 16 ];
+
+		sprintf( szHud, "TIME %02d:%02d", ulSeconds / 60, ulSeconds % 60 );
+		LIB_Hud_SetText( lHudTime, szHud );
+		sprintf( szHud, "MAP %d", ulMapIndex );
+		LIB_Hud_SetText( lHudMap, szHud );
+		PROFILE_BEGIN( "HUD" );
+		LIB_Hud_Draw();
+		PROFILE_END();
+		PROFILE_END();
+
+		// profiler overlay over the top HUD strip, last frame's times
+		if ( bProfileOverlay == true )
 		{
-			// water...
-			uint32_t ulMapWidth = 1920;
-			uint32_t ulMapHeight = 900;
-			int32_t ulYPos = ulMapHeight;
-			uint32_t ulBak = ulWaterSprNum;
+			PROFILE_DRAW( 0 );
+		}
 
-			for( uint32_t num = 0; num < 3; num++ )
-			{
-				for ( int32_t gX = 0; gX < ulMapWidth; gX += 256 )
-				{
-					LIB_Sprites_Draw( ulWaterSprIndex, ulWaterSprNum, gX - nScrollX, ulYPos - nScrollY );
-				}
-
-				ulWaterSprNum += 4;
-				if ( ulWaterSprNum > 11 ) ulWaterSprNum -= 11;	
-				ulYPos += (ulSprHeight / 3) - 1;
-			}
+		LIB_Text_EndFrame();
 
-			ulWaterSprNum = ulBak;
-			if ( !(ulFrames & 3) )
-			{
-				ulWaterSprNum++;
-				if ( ulWaterSprNum > 11 ) ulWaterSprNum = 0;
-			}
+		// build any new map a slice per frame
+		PROFILE_BEGIN( "MAPGEN" );
+		LIB_MapGenerator_Step();
+		if ( LIB_MapGenerator_IsBusy() == true )
+		{
+			DrawMapProgress();
 		}
+		PROFILE_END();
 
 		// check for exit
 #if 1		
-		ApolloJoypad( &sJoypadState );
-		ApolloKeyboard( &sKeyboardState );	
-		ApolloMouse( &sMouseState );
+		PROFILE_BEGIN( "INPUT" );
+		if ( LIB_Replay_GetMode() == eReplay_Play )
+		{
+			// the recording is the only input, the keyboard ticks once, drop what the VBL queued
+			InputEvent_t sEvent;
 
-		// simple joystick map position control
-		if ( sJoypadState.Joypad_X_Delta != 0 )
+			while ( LIB_Input_GetEvent( &sEvent, INPUT_ALL_FIELDS ) == true )
+			{
+			}
+		}
+		else
+		{
+			LIB_Input_Update( &sKeyboardState, &sJoypadState, &sMouseState, INPUT_ALL_FIELDS );
+		}
+		PROFILE_END();
+
+		// a replay ends the run when the recording does
+		if ( LIB_Replay_Tick( &sKeyboardState, &sJoypadState, &sMouseState ) == false )
 		{
-			nScrollX += (int32_t)sJoypadState.Joypad_X_Delta * 4;
+			break;
+		}
+
+		// simple joystick or cursor key map position control, the keys together scroll diagonally
+		int32_t nKeyX = ( ApolloKeyDown( &sKeyboardState, KEY_RIGHT ) ? 1 : 0 ) - ( ApolloKeyDown( &sKeyboardState, KEY_LEFT ) ? 1 : 0 );
+		int32_t nKeyY = ( ApolloKeyDown( &sKeyboardState, KEY_DOWN ) ? 1 : 0 ) - ( ApolloKeyDown( &sKeyboardState, KEY_UP ) ? 1 : 0 );
+
+		if ( sJoypadState.Joypad_X_Delta != 0 || nKeyX != 0 )
+		{
+			nScrollX += ( sJoypadState.Joypad_X_Delta != 0 ? (int32_t)sJoypadState.Joypad_X_Delta : nKeyX ) * 4;
 			if ( nScrollX < 0 ) nScrollX = 0;
 			if ( nScrollX > 1920-640 ) nScrollX = 1920-640;
 		}
-		if ( sJoypadState.Joypad_Y_Delta != 0 )
+		if ( sJoypadState.Joypad_Y_Delta != 0 || nKeyY != 0 )
 		{
-			nScrollY += (int32_t)sJoypadState.Joypad_Y_Delta * 4;
+			nScrollY += ( sJoypadState.Joypad_Y_Delta != 0 ? (int32_t)sJoypadState.Joypad_Y_Delta : nKeyY ) * 4;
 			if ( nScrollY < 0 ) nScrollY = 0;
 			if ( nScrollY > 900-360 ) nScrollY = 900-360;
 		}
 
-		if (sKeyboardState.Current_Key == 0x45)
+		// the sprites run a tick, after the input they may read
+		PROFILE_BEGIN( "SPRMGR" );
+		LIB_SprManager_Update();
+		PROFILE_END();
+
+		if ( ApolloKeyPressed( &sKeyboardState, KEY_ESC ) )
 		{
 			break;
 		}
-		if (sKeyboardState.Current_Key == 0x01 )
+		if ( ApolloKeyPressed( &sKeyboardState, 0x01 ) )
 		{
 			bMapMode = bMapMode ? false : true;
 		}
-		if (sKeyboardState.Current_Key == 0x02)
+		if ( ApolloKeyPressed( &sKeyboardState, 0x02 ) )
 		{
-			CreateBackScreens();
-			LIB_Sprites_SetClipArea( 0, 42, 640, 360 );
+			NextMap();
+		}
+		if ( ApolloKeyPressed( &sKeyboardState, 0x03 ) )
+		{
+			// the panels under the overlay are drawn again when it goes
+			bProfileOverlay = bProfileOverlay ? false : true;
+			if ( bProfileOverlay == false )
+			{
+				LIB_Hud_Invalidate();
+			}
+		}
+		if ( ApolloKeyPressed( &sKeyboardState, 0x04 ) )
+		{
+			PROFILE_DUMP();
 		}
 
         // check for joystick button A - change map
 		if ( sJoypadState.Joypad_A == true && sJoypadState.Joypad_AActioned == false )
 		{
 			sJoypadState.Joypad_AActioned = true;
-			CreateBackScreens();
-			LIB_Sprites_SetClipArea( 0, 42, 640, 360 );
+			NextMap();
 		}
 		else if ( sJoypadState.Joypad_A == false && sJoypadState.Joypad_AActioned == true )
 		{
@@ -293,8 +417,7 @@ uint32_t main(int argc, char *argv[])
 		// check for mouse button 1 - change map
 		if ( bMapMode == true &&sMouseState.Button_State & APOLLOMOUSE_RIGHTCLICK )
 		{
-			CreateBackScreens();
-			LIB_Sprites_SetClipArea( 0, 42, 640, 360 );
+			NextMap();
 		}
 		if ( bMapMode == true && sMouseState.Button_State & APOLLOMOUSE_LEFTDOWN )
 		{
@@ -386,96 +509,116 @@ uint32_t main(int argc, char *argv[])
 #endif
 	}
 
+	Hardware_SetVBLHook( NULL );
 	Hardware_Close();
 
+	eReplay_t eReplay = LIB_Replay_GetMode();
+	LIB_Replay_Close();
+
 	
 	free(paletteBuffer);
 
 	printf("\n%d frames displayed\n", ulFrames);
-	printf("Time played %d seconds\n", ulFrames / 50 );
+	printf("%d presented, %d dropped, %d late\n", Hardware_GetFrameCounter( eFrameCounter_Presented ),
+			Hardware_GetFrameCounter( eFrameCounter_Dropped ), Hardware_GetFrameCounter( eFrameCounter_Late ) );
+	printf("Time played %d seconds\n", Hardware_GetFrameCounter( eFrameCounter_VBL ) / 50 );
+	if ( eReplay != eReplay_Off )
+	{
+		// fields a tick, the figure to compare between builds
+		uint32_t ulTicks  = LIB_Replay_GetTicks();
+		uint32_t ulFields = Hardware_GetFrameCounter( eFrameCounter_VBL ) - ulFirstField;
+
+		printf("%s %d ticks in %d fields, %d.%02d fields a tick, %d records\n", eReplay == eReplay_Play ? "Replayed" : "Recorded",
+				ulTicks, ulFields, ulTicks ? ulFields / ulTicks : 0, ulTicks ? ( ( ulFields % ulTicks ) * 100 ) / ulTicks : 0, LIB_Replay_GetRecords() );
+		PROFILE_DUMP();
+	}
+	{
+		TextStats_t sTextStats;
+
+		LIB_Text_GetStats( NULL, &sTextStats );
+		printf("Text cache %d hits, %d misses, %d glyphs drawn\n", sTextStats.ulHits, sTextStats.ulMisses, sTextStats.ulGlyphs );
+	}
 	printf("Exiting - have a nice day!\n\n");
 	// return succes
 	return 0;
 }
 
 
+/** ---------------------------------------------------------------------------
+	@brief 		Run by the VBL server every field, palette animation then the
+				input sampling
+	@ingroup 	MainShell
+ --------------------------------------------------------------------------- */
+void MainVBL( void )
+{
+	LIB_Palette_VBL();
+	LIB_Input_VBL();
+}
+
 /** ---------------------------------------------------------------------------
 	@brief 		Create the back screens
 	@ingroup 	MainShell
  --------------------------------------------------------------------------- */
 void CreateBackScreens( void )
 {
+	// first map, built straight through before the display is up
+	LIB_MapGenerator_Run( LIB_TerrainCache_PoolSeed( ulMapIndex ) );
 
-	// Generate the map
-	CreateMap();
-
-	// create reference back screen 2
-	Hardware_SetScreenmode( 2 );	
-	uint32_t screenWidth = Hardware_GetScreenWidth();
-	uint32_t screenHeight = Hardware_GetScreenHeight();
-	uint32_t ulGradientSprIndex = ResourceHandling_GetGroupStartResource( 27 ) + 6;
-
-	LIB_Sprites_SetClipArea( 0, 0, screenWidth, screenHeight);
+	LIB_Sprites_SetClipArea( 0, 0, 640, 480 );
+}
 
-	// Gradient ..
-	for( uint32_t gX = 0; gX < screenWidth; gX += 8)
+/** ---------------------------------------------------------------------------
+	@brief 		Starts building the next map, shown once it is complete
+	@ingroup 	MainShell
+	@return 	none
+ --------------------------------------------------------------------------- */
+void NextMap( void )
+{
+	if ( LIB_MapGenerator_Start( LIB_TerrainCache_PoolSeed( ulMapIndex + 1 ) ) == true )
 	{
-		LIB_Sprites_Draw( ulGradientSprIndex, 0, gX, 0 );
+		ulMapIndex++;
 	}
+}
 
-	// Ground
-	uint8_t* pScreen = Hardware_GetScreenPtr();
-	uint32_t screenX = 0;
-	uint32_t ulSoilIndex = ResourceHandling_GetGroupStartResource( 27 ) + 21;
-	uint8_t* pSoil = NULL;
-
-	ResourceHandling_Get( ulSoilIndex, eResourceGet_Data, &pSoil );
-
-	for ( uint32_t gx = 0; gx < MAP_WIDTH; gx++ )
-	{
-		uint32_t refY = pMapHeight[ gx ] - 350;
-		for( uint32_t drY = refY; drY < screenHeight; drY ++ )
-		{
-			pScreen[ (drY * screenWidth) + gx  ] = pSoil[((drY & 0xff) * 256) + (gx & 0xff)];
-		}
-	}
+/** ---------------------------------------------------------------------------
+	@brief 		Draws the test worms into a newly built map
+	@ingroup 	MainShell
+	@param 		pMapHeight 	- Height map of the new map
+	@param 		ulWidth 	- Map width
+	@param 		ulHeight 	- Map height
+	@return 	none
+ --------------------------------------------------------------------------- */
+void DecorateMap( int32_t* pMapHeight, uint32_t ulWidth, uint32_t ulHeight )
+{
+	LIB_Sprites_SetClipArea( 0, 0, ulWidth, ulHeight );
 
 	// Test worms
-	for( uint32_t gX = 0; gX < screenWidth; gX += (rand() & 31) + 20)
+	for( uint32_t gX = 0; gX < ulWidth - 30; gX += (rand() & 31) + 20)
 	{
-		uint32_t gY = pMapHeight[ gX + 30 ] - 350 - 40;
-		if ( gY < 900-40 )
+		uint32_t gY = pMapHeight[ gX + 30 ] - TERRAIN_SURFACE_OFFSET - 40;
+		if ( gY < ulHeight-40 )
 		{
 			LIB_Sprites_Draw( ResourceHandling_GetGroupStartResource( 3 ), 0, gX, gY );
 		}
 	}
 
-	// reset the screen mode
-	Hardware_CopyBack2ToBack1();
-	Hardware_SetScreenmode( 0 );
-
-	LIB_Sprites_SetClipArea( 0, 0, 640, 480 );
-
+	LIB_Sprites_SetClipArea( 0, 42, 640, 360 );
 }
 
-
 /** ---------------------------------------------------------------------------
- 	@brief 		Creates the map
+	@brief 		Draws the map generation progress bar along the top of the view
 	@ingroup 	MainShell
- --------------------------------------------------------------------------- */ 
-void CreateMap( void )
+	@return 	none
+ --------------------------------------------------------------------------- */
+void DrawMapProgress( void )
 {
-	uint32_t ulIndex = 0;
+	uint8_t* pS = Hardware_GetScreenPtr();
+	uint32_t ulLength = ( LIB_MapGenerator_GetProgress() * VISABLE_WIDTH ) / MAPGEN_PROGRESS_MAX;
 
-	// generate maps
-	ulIndex = 0;
-	//while( ulIndex < NUM_MAPS )
+	for( uint32_t gX = 0; gX < ulLength; gX++ )
 	{
-		float fRef = 0.00075f + ( 0.003f / rand()  );
-
-		LIB_PerlinNoise_Init( 1234 );
-		LIB_PerlinNoise_GenerateMap( pMapHeight, MAP_WIDTH, 0, fRef );
-		//ulIndex++;
+		pS[ ( 42 * 640 ) + gX ] = 0x0f;
+		pS[ ( 43 * 640 ) + gX ] = 0x0f;
 	}
 }
 
@@ -41,8 +41,7 @@ void ApolloLoad(const UBYTE *filename, UBYTE **buffer, ULONG *buffer_lenght, UWO
 
     #ifdef APOLLODEBUG
     ApolloMemoryFree = AvailMem(MEMF_ANY); 
-    sprintf(ApolloDebugText,"ApolloLoad: AllocMem = %3d Kb | AvailMem = %3d Mb\n", (file_size+15)>>10, ApolloMemoryFree>>20);
-    ApolloDebugPutStr(ApolloDebugText);
+    ApolloLogPrintf(APOLLOLOG_INFO, "ApolloLoad: AllocMem = %3d Kb | AvailMem = %3d Mb\n", (file_size+15)>>10, ApolloMemoryFree>>20);
     #endif
 
 	#ifdef APOLLODEBUG
@@ -83,16 +82,14 @@ void ApolloLoad(const UBYTE *filename, UBYTE **buffer, ULONG *buffer_lenght, UWO
 	*buffer = file_buffer_aligned;
 
 	#ifdef APOLLODEBUG
-	sprintf(ApolloDebugText, "ApolloLoad: buffer = %d | aligned buffer =%d | filesize =%d | swap = %s\n", file_buffer, file_buffer_aligned, file_size, endianswap? "true":"false");
-	ApolloDebugPutStr(ApolloDebugText);
+	ApolloLogPrintf(APOLLOLOG_INFO, "ApolloLoad: buffer = %d | aligned buffer =%d | filesize =%d | swap = %s\n", file_buffer, file_buffer_aligned, file_size, endianswap? "true":"false");
 	#endif
 }
 
 void ApolloShow(UBYTE *buffer, ULONG buffer_lenght, UWORD gfx_mode, UWORD gfx_modulo)
 {
 	#ifdef APOLLODEBUG
-	sprintf(ApolloDebugText, "ApolloShow: SAGA Mode = %d | L = %d | M = %d\n", gfx_mode, buffer_lenght, gfx_modulo);
-	ApolloDebugPutStr(ApolloDebugText);
+	ApolloLogPrintf(APOLLOLOG_INFO, "ApolloShow: SAGA Mode = %d | L = %d | M = %d\n", gfx_mode, buffer_lenght, gfx_modulo);
 	#endif
 
 	*((volatile UWORD*)APOLLO_SAGAMODULO_REG)	= (UWORD)(gfx_modulo); 
@@ -114,8 +111,7 @@ void ApolloPlay(UBYTE *buffer, ULONG buffer_lenght, UWORD channel, UWORD volume_
 	}
 
 	#ifdef APOLLODEBUG
-	sprintf(ApolloDebugText, "ApolloPlay: Channel = %d | L=%d | Vol-L = %d | Vol-R = %d | Loop = %s \n", channel, buffer_lenght, volume_left, volume_right, loop? "true":"false");
-	ApolloDebugPutStr(ApolloDebugText);
+	ApolloLogPrintf(APOLLOLOG_INFO, "ApolloPlay: Channel = %d | L=%d | Vol-L = %d | Vol-R = %d | Loop = %s \n", channel, buffer_lenght, volume_left, volume_right, loop? "true":"false");
 	#endif
 
 	*((volatile ULONG*)(0xDFF400 + (channel * 0x10))) = (ULONG)buffer;        	   			// Set Channel Pointer
@@ -212,14 +208,23 @@ void ApolloCacheFile(const UBYTE *filename, UBYTE **cache, ULONG *lenght, UWORD
 }
 
 
+// Starts the fade and returns, the vertical blank steps it a volume a field
+// and stops the channel at the end. ApolloFadeDone tells when it has.
 void ApolloFadeOut(UWORD channel, UWORD volume_start, UWORD volume_end)
 {
-	for (;volume_start > volume_end;volume_start--)
+	if (volume_start <= volume_end)
 	{
-		ApolloVolume(channel, volume_start, volume_start);
-		ApolloWaitVBL();
+		ApolloStop(channel);
+		return;
 	}
-	ApolloStop(channel);
+
+	ApolloEnvelopeSet(channel, volume_start, APOLLOENV_CENTRE);
+	ApolloEnvelopeFade(channel, volume_end, volume_start - volume_end, APOLLOENV_LINEAR, true);
+}
+
+bool ApolloFadeDone(UWORD channel)
+{
+	return ApolloEnvelopeDone(channel);
 }
 
 void ApolloStop(UWORD channel)
@@ -407,10 +412,9 @@ void ApolloMouse(ApolloMouseState *MouseState)
 		*((volatile uint16_t*)APOLLO_POINTER_SET_X) = (uint16_t)(MouseState->MouseX_Pointer) + 16; 
 		*((volatile uint16_t*)APOLLO_POINTER_SET_Y) = (uint16_t)(MouseState->MouseY_Pointer) +  8;  
 
-		sprintf(ApolloDebugText,"Mouse_X = X-Pos:%4d X-New:%4d X-Old:%4d X-Delta:%4d | Mouse_Y = Y-Pos:%4d Y-New:%4d Y-Old:%4d Y-Delta:%4d\n",
+		ApolloLogPrintf(APOLLOLOG_TRACE, "Mouse_X = X-Pos:%4d X-New:%4d X-Old:%4d X-Delta:%4d | Mouse_Y = Y-Pos:%4d Y-New:%4d Y-Old:%4d Y-Delta:%4d\n",
 				MouseState->MouseX_Pointer, MouseState->MouseX_Value, MouseState->MouseX_Value_Old, MouseState->MouseX_Value_Delta,
 				MouseState->MouseY_Pointer, MouseState->MouseY_Value, MouseState->MouseY_Value_Old, MouseState->MouseY_Value_Delta);
-		ApolloDebugPutStr(ApolloDebugText);
 	} 
 
 	// Translate Mouse Buttons to Mouse ButtonState
@@ -495,8 +499,7 @@ void ApolloKeyboard(ApolloKeyBoardState *KeyboardState)
 	{
 		KeyboardState->Previous_Key = KeyboardState->Current_Key;							// Use only "Low" KB values (0-127)
 
-		sprintf(ApolloDebugText,"Keyboard_Now: %d\n", Keyboard_Now);
-		ApolloDebugPutStr(ApolloDebugText);
+		ApolloLogPrintf(APOLLOLOG_TRACE, "Keyboard_Now: %d\n", KeyboardState->Current_Key);
 
 	} else {
 		KeyboardState->Current_Key = 127;
@@ -609,30 +612,21 @@ UWORD reg_r(ULONG reg)
 	return *r;
 }
 
+// The debug output is buffered and sent by the TBE interrupt, see ApolloDebugLog.c.
+// Only a debug build takes the vector here, otherwise the first line logged
+// takes it, and serial.device keeps it while nothing is.
 void ApolloDebugInit(void)
 {
-	/* Set DTR, RTS, etc */
-	volatile UBYTE * ciab_pra = (APTR)0xBFD000;
-	volatile UBYTE * ciab_ddra = (APTR)0xBFD200;
-	*ciab_ddra = 0xc0;  /* Only DTR and RTS are driven as outputs */
-	*ciab_pra = 0;      /* Turn on DTR and RTS */
-
-	/* Set the debug UART to 115200 */
-	reg_w(SERPER, SERPER_BAUD(SERPER_BASE_PAL, 115200));
+	#ifdef APOLLODEBUG
+	ApolloLogInit();
+	#endif
 }
 
 UWORD ApolloDebugPutChar(register UWORD chr)
 {
-	if (chr == '\n')
-		ApolloDebugPutChar('\r');
-
-	while ((reg_r(SERDATR) & SERDATR_TBE) == 0);
-	reg_w(INTREQ, INTF_TBE);
-
-	/* Output a UBYTE to the debug UART */
-	reg_w(SERDAT, SERDAT_STP8 | SERDAT_DB8(chr));
+	char c = (char)chr;
 
-	return 1;
+	return ApolloLogWrite(&c, 1);
 }
 
 UWORD ApolloDebugMayGetChar(void)
@@ -652,8 +646,7 @@ UWORD ApolloDebugMayGetChar(void)
 
 void ApolloDebugPutStr(register const UBYTE *buff)
 {
-	for (; *buff != 0; buff++)
-		ApolloDebugPutChar(*buff);
+	ApolloLogWrite((const char*)buff, strlen((const char*)buff));
 }
 
 void ApolloDebugPutDec(const UBYTE *what, ULONG val)
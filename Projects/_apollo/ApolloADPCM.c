@@ -0,0 +1,500 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// The encoder decodes every code it writes, so it follows the decoder's
+// predictor exactly and errors do not build up. Headers are big endian, as
+// ApolloADPCMDecode.s reads them.
+//
+// The player works like the ApolloVoice submix: each half of the ring is
+// queued on its own, and the channel's interrupt, raised as Paula latches a
+// half, queues the other and counts the halves started. ApolloADPCMUpdate
+// decodes the half not playing once a new one has started. A clip not
+// looping has ended when a half of only silence starts, the interrupt
+// stops the channel there.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include "ApolloADPCM.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOADPCM_AMIGA
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <exec/interrupts.h>
+#include <clib/exec_protos.h>
+#include "ApolloRegParam.h"
+#include "ApolloADPCMDecode.h"
+#endif
+
+#define ADPCM_ID				0x41414450		// "AADP"
+#define ADPCM_RATE				44100
+#define ADPCM_HALF				(APOLLOADPCM_RING_BLOCKS * APOLLOADPCM_FRAMES)	// frames in half the ring
+#define ADPCM_RING_BYTES		(2 * ADPCM_HALF * 4)
+#define ADPCM_DMACON			0xDFF096		// AUD0-3
+#define ADPCM_INTENA			0xDFF09A
+#define ADPCM_INTREQ			0xDFF09C
+#define ADPCM_INTB_AUD0			7
+#define ADPCM_REG(c, r)			(0xDFF400 + ((c) * 0x10) + (r))
+
+static const int32_t ApolloADPCMSteps[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t ApolloADPCMIndex[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// One code into the predictor and step index, as the decoder does it
+static inline int32_t ApolloADPCMStep(uint32_t code, int32_t *predictor, int32_t *index)
+{
+	int32_t step = ApolloADPCMSteps[*index];
+	int32_t difference = step >> 3;
+
+	if (code & 4) difference += step;
+	if (code & 2) difference += step >> 1;
+	if (code & 1) difference += step >> 2;
+
+	if (code & 8)
+	{
+		*predictor -= difference;
+		if (*predictor < -32768) *predictor = -32768;
+	} else {
+		*predictor += difference;
+		if (*predictor > 32767) *predictor = 32767;
+	}
+
+	*index += ApolloADPCMIndex[code];
+	if (*index < 0) *index = 0;
+	if (*index > 88) *index = 88;
+
+	return *predictor;
+}
+
+uint32_t ApolloADPCMSize(uint32_t frames)
+{
+	return ((frames + APOLLOADPCM_FRAMES - 1) / APOLLOADPCM_FRAMES) * APOLLOADPCM_BLOCK_BYTES;
+}
+
+// One channel of a block, samples every other word, count of them real
+// and the rest of the block silence
+static void ApolloADPCMEncodeChannel(const int16_t *samples, uint32_t count, int32_t *predictor, int32_t *index, uint8_t *out)
+{
+	uint32_t i;
+
+	out[0] = (uint16_t)*predictor >> 8;
+	out[1] = (uint16_t)*predictor & 0xFF;
+	out[2] = (uint8_t)*index;
+	out[3] = 0;
+	out += 4;
+
+	for (i = 0; i < APOLLOADPCM_FRAMES; i++)
+	{
+		int32_t		sample = i < count ? samples[i * 2] : 0;
+		int32_t		difference = sample - *predictor;
+		int32_t		step = ApolloADPCMSteps[*index];
+		uint32_t	code = 0;
+
+		if (difference < 0)
+		{
+			code = 8;
+			difference = -difference;
+		}
+		if (difference >= step) { code |= 4; difference -= step; }
+		step >>= 1;
+		if (difference >= step) { code |= 2; difference -= step; }
+		step >>= 1;
+		if (difference >= step) code |= 1;
+
+		ApolloADPCMStep(code, predictor, index);
+
+		if (i & 1)
+		{
+			*out++ |= code << 4;
+		} else {
+			*out = code;
+		}
+	}
+}
+
+// Compresses frames of 16-bit stereo into out, ApolloADPCMSize(frames)
+// bytes. Returns the bytes written.
+uint32_t ApolloADPCMEncode(const int16_t *samples, uint32_t frames, uint8_t *out)
+{
+	int32_t		left = 0, left_index = 0, right = 0, right_index = 0;
+	uint32_t	done;
+
+	for (done = 0; done < frames; done += APOLLOADPCM_FRAMES)
+	{
+		uint32_t count = frames - done < APOLLOADPCM_FRAMES ? frames - done : APOLLOADPCM_FRAMES;
+
+		ApolloADPCMEncodeChannel(samples + (done * 2), count, &left, &left_index, out);
+		ApolloADPCMEncodeChannel(samples + (done * 2) + 1, count, &right, &right_index, out + APOLLOADPCM_CHANNEL_BYTES);
+		out += APOLLOADPCM_BLOCK_BYTES;
+	}
+
+	return ApolloADPCMSize(frames);
+}
+
+// One channel of a block into every other word of out, the C twin of
+// ApolloADPCMDecode.s
+void ApolloADPCMDecodeChannel(const uint8_t *channel, int16_t *out, uint32_t samples)
+{
+	int32_t		predictor = (int16_t)((channel[0] << 8) | channel[1]);
+	int32_t		index = channel[2] > 88 ? 88 : channel[2];
+	uint32_t	i;
+
+	channel += 4;
+
+	for (i = 0; i + 1 < samples; i += 2)
+	{
+		uint32_t codes = *channel++;
+
+		out[0] = (int16_t)ApolloADPCMStep(codes & 15, &predictor, &index);
+		out[2] = (int16_t)ApolloADPCMStep(codes >> 4, &predictor, &index);
+		out += 4;
+	}
+	if (i < samples) out[0] = (int16_t)ApolloADPCMStep(*channel & 15, &predictor, &index);
+}
+
+// Decodes count whole blocks from first into out, APOLLOADPCM_FRAMES
+// stereo frames a block
+void ApolloADPCMDecodeBlocks(const ApolloADPCMClip *clip, uint32_t first, uint32_t count, int16_t *out)
+{
+	const uint8_t *block = clip->blocks + (first * APOLLOADPCM_BLOCK_BYTES);
+
+	for (; count > 0; count--)
+	{
+#ifdef APOLLOADPCM_AMIGA
+		ApolloADPCMDecode(block, out, APOLLOADPCM_FRAMES);
+		ApolloADPCMDecode(block + APOLLOADPCM_CHANNEL_BYTES, out + 1, APOLLOADPCM_FRAMES);
+#else
+		ApolloADPCMDecodeChannel(block, out, APOLLOADPCM_FRAMES);
+		ApolloADPCMDecodeChannel(block + APOLLOADPCM_CHANNEL_BYTES, out + 1, APOLLOADPCM_FRAMES);
+#endif
+		block += APOLLOADPCM_BLOCK_BYTES;
+		out += APOLLOADPCM_FRAMES * 2;
+	}
+}
+
+static uint32_t ApolloADPCMBE32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void ApolloADPCMPutBE32(uint8_t *p, uint32_t value)
+{
+	p[0] = value >> 24;
+	p[1] = value >> 16;
+	p[2] = value >> 8;
+	p[3] = value;
+}
+
+// Reads filename.adp, the caller checks source_size against the source
+bool ApolloADPCMLoad(const char *filename, ApolloADPCMClip *clip)
+{
+	char		name[256];
+	uint8_t		header[APOLLOADPCM_HEADER];
+	uint32_t	size;
+	FILE		*file_handle;
+
+	memset(clip, 0, sizeof(ApolloADPCMClip));
+
+	snprintf(name, sizeof(name), "%s%s", filename, APOLLOADPCM_CACHE);
+	file_handle = fopen(name, "rb");
+	if (!file_handle) return false;
+
+	if (fread(header, 1, sizeof(header), file_handle) != sizeof(header) ||
+		ApolloADPCMBE32(header) != ADPCM_ID || ApolloADPCMBE32(header + 12) != ADPCM_RATE)
+	{
+		fclose(file_handle);
+		return false;
+	}
+
+	clip->source_size = ApolloADPCMBE32(header + 4);
+	clip->frames = ApolloADPCMBE32(header + 8);
+	clip->count = (clip->frames + APOLLOADPCM_FRAMES - 1) / APOLLOADPCM_FRAMES;
+	size = ApolloADPCMSize(clip->frames);
+
+	clip->blocks = (uint8_t*)malloc(size);
+	if (clip->blocks == NULL || fread(clip->blocks, 1, size, file_handle) != size)
+	{
+		fclose(file_handle);
+		ApolloADPCMFree(clip);
+		return false;
+	}
+	fclose(file_handle);
+
+	return true;
+}
+
+// Compresses frames of 16-bit stereo into filename.adp
+bool ApolloADPCMSave(const char *filename, const int16_t *samples, uint32_t frames, uint32_t source_size)
+{
+	char		name[256];
+	uint8_t		header[APOLLOADPCM_HEADER];
+	uint32_t	size = ApolloADPCMSize(frames);
+	uint8_t		*blocks = (uint8_t*)malloc(size);
+	FILE		*file_handle;
+	bool		written;
+
+	if (blocks == NULL) return false;
+	ApolloADPCMEncode(samples, frames, blocks);
+
+	snprintf(name, sizeof(name), "%s%s", filename, APOLLOADPCM_CACHE);
+	file_handle = fopen(name, "wb");
+	if (!file_handle)
+	{
+		free(blocks);
+		return false;
+	}
+
+	ApolloADPCMPutBE32(header, ADPCM_ID);
+	ApolloADPCMPutBE32(header + 4, source_size);
+	ApolloADPCMPutBE32(header + 8, frames);
+	ApolloADPCMPutBE32(header + 12, ADPCM_RATE);
+	written = fwrite(header, 1, sizeof(header), file_handle) == sizeof(header) && fwrite(blocks, 1, size, file_handle) == size;
+	free(blocks);
+
+	return fclose(file_handle) == 0 && written;
+}
+
+void ApolloADPCMFree(ApolloADPCMClip *clip)
+{
+	free(clip->blocks);
+	memset(clip, 0, sizeof(ApolloADPCMClip));
+}
+
+// Hardware, the same registers ApolloPlay writes. One interrupt a channel,
+// its data the player on it.
+
+#ifdef APOLLOADPCM_AMIGA
+static struct Interrupt	ApolloADPCMInterrupts[APOLLOADPCM_CHANNELS];
+static struct Interrupt	*ApolloADPCMOldInterrupts[APOLLOADPCM_CHANNELS];
+#endif
+
+static void ApolloADPCMQueue(ApolloADPCMPlayer *player, uint16_t half)
+{
+	player->queued = half;
+#ifdef APOLLOADPCM_AMIGA
+	*((volatile uint32_t*)ADPCM_REG(player->channel, 0x0)) = (uint32_t)(player->ring + (half * ADPCM_HALF * 2));
+#endif
+}
+
+static void ApolloADPCMChannelStop(ApolloADPCMPlayer *player)
+{
+#ifdef APOLLOADPCM_AMIGA
+	*((volatile uint16_t*)ADPCM_INTENA) = (uint16_t)(1 << (ADPCM_INTB_AUD0 + player->channel));
+	*((volatile uint16_t*)ADPCM_DMACON) = (uint16_t)(1 << player->channel);
+	*((volatile uint16_t*)ADPCM_INTREQ) = (uint16_t)(1 << (ADPCM_INTB_AUD0 + player->channel));
+#else
+	(void)player;
+#endif
+}
+
+#ifdef APOLLOADPCM_AMIGA
+
+// The queued half has started, the other follows it
+static void ApolloADPCMInterrupt(_A1(ApolloADPCMPlayer *player))
+{
+	*((volatile uint16_t*)ADPCM_INTREQ) = (uint16_t)(1 << (ADPCM_INTB_AUD0 + player->channel));
+
+	player->current = player->queued;
+	if (player->frames[player->current] == 0)
+	{
+		// all the clip has played
+		player->finished = true;
+		*((volatile uint16_t*)ADPCM_INTENA) = (uint16_t)(1 << (ADPCM_INTB_AUD0 + player->channel));
+		*((volatile uint16_t*)ADPCM_DMACON) = (uint16_t)(1 << player->channel);
+		return;
+	}
+	ApolloADPCMQueue(player, player->current ^ 1);
+	player->started++;
+}
+
+#endif
+
+static void ApolloADPCMChannelStart(ApolloADPCMPlayer *player, uint16_t volume_left, uint16_t volume_right)
+{
+	ApolloADPCMChannelStop(player);
+	ApolloADPCMQueue(player, 0);
+
+#ifdef APOLLOADPCM_AMIGA
+	struct Interrupt *interrupt = &ApolloADPCMInterrupts[player->channel];
+
+	interrupt->is_Node.ln_Type = NT_INTERRUPT;
+	interrupt->is_Node.ln_Pri = 0;
+	interrupt->is_Node.ln_Name = "ApolloADPCM";
+	interrupt->is_Data = player;
+	interrupt->is_Code = (void (*)())ApolloADPCMInterrupt;
+	ApolloADPCMOldInterrupts[player->channel] = SetIntVector(ADPCM_INTB_AUD0 + player->channel, interrupt);
+
+	// the first half latches on start, and the interrupt queues the second
+	*((volatile uint32_t*)ADPCM_REG(player->channel, 0x4)) = (ADPCM_HALF * 4) / 8;			// in 64-bit chunks, two stereo frames
+	*((volatile uint16_t*)ADPCM_REG(player->channel, 0x8)) = (uint16_t)((volume_left << 8) + volume_right);
+	*((volatile uint16_t*)ADPCM_REG(player->channel, 0xA)) = 0x0005;						// 16-bit stereo, looping on what is queued
+	*((volatile uint16_t*)ADPCM_REG(player->channel, 0xC)) = 80;							// PERIOD=44.1 Khz
+	*((volatile uint16_t*)ADPCM_INTENA) = (uint16_t)(0x8000 + (1 << (ADPCM_INTB_AUD0 + player->channel)));
+	*((volatile uint16_t*)ADPCM_DMACON) = (uint16_t)(0x8000 + (1 << player->channel));
+#else
+	(void)volume_left; (void)volume_right;
+#endif
+}
+
+static void ApolloADPCMChannelClose(ApolloADPCMPlayer *player)
+{
+	ApolloADPCMChannelStop(player);
+#ifdef APOLLOADPCM_AMIGA
+	SetIntVector(ADPCM_INTB_AUD0 + player->channel, ApolloADPCMOldInterrupts[player->channel]);
+#endif
+}
+
+// Decodes the next blocks into half of the ring, silence past the end
+static void ApolloADPCMFillHalf(ApolloADPCMPlayer *player, uint16_t half)
+{
+	int16_t		*out = player->ring + (half * ADPCM_HALF * 2);
+	uint32_t	frames = 0;
+	uint32_t	i;
+
+	for (i = 0; i < APOLLOADPCM_RING_BLOCKS; i++)
+	{
+		if (player->block >= player->clip->count && player->loop) player->block = 0;
+
+		if (player->block < player->clip->count)
+		{
+			ApolloADPCMDecodeBlocks(player->clip, player->block, 1, out);
+			player->block++;
+			frames += APOLLOADPCM_FRAMES;
+		} else {
+			memset(out, 0, APOLLOADPCM_FRAMES * 4);
+		}
+		out += APOLLOADPCM_FRAMES * 2;
+	}
+	player->frames[half] = frames;
+}
+
+// Plays a clip on channel 0-3, decoding it as it goes. The player keeps a
+// 16 KB ring, ApolloADPCMUpdate must be called at least every 46 ms, the
+// time a half plays.
+bool ApolloADPCMPlay(ApolloADPCMPlayer *player, const ApolloADPCMClip *clip, uint16_t channel, uint16_t volume_left, uint16_t volume_right, bool loop)
+{
+	if (player->playing) ApolloADPCMStop(player);
+	if (clip == NULL || clip->count == 0 || channel >= APOLLOADPCM_CHANNELS) return false;
+
+	if (player->memory == NULL)
+	{
+#ifdef APOLLOADPCM_AMIGA
+		player->memory = AllocMem(ADPCM_RING_BYTES + 15, MEMF_ANY);
+#else
+		player->memory = malloc(ADPCM_RING_BYTES + 15);
+#endif
+		if (player->memory == NULL) return false;
+		player->ring = (int16_t*)((uintptr_t)((uint8_t*)player->memory + 15) & ~(uintptr_t)15);
+	}
+
+	player->clip = clip;
+	player->channel = channel;
+	player->loop = loop;
+	player->block = 0;
+	player->current = 0;
+	player->finished = false;
+
+	// both halves now, so the start of half 0 has nothing to decode, the
+	// next start is half 1's and half 0 is decoded again
+	ApolloADPCMFillHalf(player, 0);
+	ApolloADPCMFillHalf(player, 1);
+	player->started = 0;
+	player->decoded = 1;
+	ApolloADPCMChannelStart(player, volume_left, volume_right);
+	player->playing = true;
+
+	return true;
+}
+
+// Once a field. Stops the player once the clip has played, or decodes the
+// half the channel has left once the other has started.
+void ApolloADPCMUpdate(ApolloADPCMPlayer *player)
+{
+	if (!player->playing) return;
+
+	if (player->finished)
+	{
+		ApolloADPCMStop(player);
+		return;
+	}
+
+	if (player->started != player->decoded)
+	{
+		player->decoded = player->started;
+		ApolloADPCMFillHalf(player, player->current ^ 1);
+	}
+}
+
+// Stops the channel and gives back the ring
+void ApolloADPCMStop(ApolloADPCMPlayer *player)
+{
+	if (player->playing) ApolloADPCMChannelClose(player);
+	player->playing = false;
+
+	if (player->memory)
+	{
+#ifdef APOLLOADPCM_AMIGA
+		FreeMem(player->memory, ADPCM_RING_BYTES + 15);
+#else
+		free(player->memory);
+#endif
+	}
+	player->memory = NULL;
+	player->ring = NULL;
+}
+
+// Encodes blocks of a test signal, then returns stereo frames decoded a
+// second. Runs the same on the Apollo, with the 68k decoder, and a host.
+uint32_t ApolloADPCMBenchmark(uint32_t blocks)
+{
+	ApolloADPCMClip	clip;
+	int16_t			*samples = (int16_t*)malloc(blocks * APOLLOADPCM_FRAMES * 4);
+	clock_t			start;
+	double			seconds;
+	uint32_t		i, pass;
+
+	clip.frames = blocks * APOLLOADPCM_FRAMES;
+	clip.count = blocks;
+	clip.blocks = (uint8_t*)malloc(ApolloADPCMSize(clip.frames));
+	if (samples == NULL || clip.blocks == NULL || blocks == 0)
+	{
+		free(samples);
+		free(clip.blocks);
+		return 0;
+	}
+
+	// two tones and some noise, so the step index moves about
+	for (i = 0; i < clip.frames; i++)
+	{
+		samples[i * 2] = (int16_t)(((i * 331) & 0x3FFF) - 0x2000 + ((i * 7919) & 0x3FF));
+		samples[(i * 2) + 1] = (int16_t)(((i * 97) & 0x7FFF) - 0x4000);
+	}
+	ApolloADPCMEncode(samples, clip.frames, clip.blocks);
+
+	start = clock();
+	for (pass = 0; pass < 8; pass++)
+	{
+		ApolloADPCMDecodeBlocks(&clip, 0, blocks, samples);
+	}
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	free(samples);
+	free(clip.blocks);
+
+	return seconds > 0 ? (uint32_t)(((double)clip.frames * 8) / seconds) : 0;
+}
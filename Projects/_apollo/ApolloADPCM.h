@@ -0,0 +1,82 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// IMA-ADPCM compressed sound, 4 bits a sample for a quarter of the memory.
+// A clip is 16-bit stereo at 44.1 kHz, as ApolloSample converts it, cut into
+// blocks of APOLLOADPCM_FRAMES frames. Each channel of a block starts with
+// its predictor and step index, so any block decodes on its own.
+//
+// A clip decodes at load into DMA memory with ApolloSampleLoad, or plays
+// with ApolloADPCMPlay, which decodes it just in time into a small ring a
+// channel plays, channel 0-3 as the ring is refilled from its audio
+// interrupt. The decoder is ApolloADPCMDecode.s on the Apollo and C on a
+// host. Clips are made by Tools/ApolloSoundConvert -adpcm.
+//
+// ApolloADPCMBenchmark gives the decoder's frames a second. It has only
+// been run on a host, the 68k decoder is still to be assembled and timed
+// on the Apollo, so there is no figure for it yet.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLOADPCM_H
+#define APOLLOADPCM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APOLLOADPCM_FRAMES			1024		// frames a block
+#define APOLLOADPCM_CHANNEL_BYTES	(4 + (APOLLOADPCM_FRAMES / 2))		// predictor, index, pad, codes
+#define APOLLOADPCM_BLOCK_BYTES		(2 * APOLLOADPCM_CHANNEL_BYTES)		// left then right
+#define APOLLOADPCM_CACHE			".adp"		// compressed clip, added to the source name
+#define APOLLOADPCM_HEADER			16			// "AADP", source size, frames, rate
+#define APOLLOADPCM_RING_BLOCKS		2			// blocks in each half of a player's ring
+#define APOLLOADPCM_CHANNELS		4			// channels with an audio interrupt, for a player
+
+typedef struct
+{
+	uint8_t		*blocks;
+	uint32_t	frames;
+	uint32_t	count;							// blocks
+	uint32_t	source_size;					// size of the file it was made from
+} ApolloADPCMClip;
+
+// A clip playing on a channel from a ring decoded just in time
+typedef struct
+{
+	const ApolloADPCMClip	*clip;
+	uint16_t				channel;
+	bool					loop;
+	bool					playing;
+	uint32_t				block;				// next block to decode
+	uint32_t				frames[2];			// clip frames decoded into each half, 0 for silence
+	volatile uint16_t		current;			// half the hardware is playing, set by the interrupt
+	volatile uint16_t		queued;				// half latched to follow it
+	volatile uint32_t		started;			// halves started, counted by the interrupt
+	uint32_t				decoded;			// started when a half was last decoded
+	volatile bool			finished;			// a half of silence has started, not looping
+	int16_t					*ring;
+	void					*memory;
+} ApolloADPCMPlayer;
+
+extern uint32_t	ApolloADPCMSize(uint32_t frames);
+extern uint32_t	ApolloADPCMEncode(const int16_t *samples, uint32_t frames, uint8_t *out);
+extern void		ApolloADPCMDecodeChannel(const uint8_t *channel, int16_t *out, uint32_t samples);
+extern void		ApolloADPCMDecodeBlocks(const ApolloADPCMClip *clip, uint32_t first, uint32_t count, int16_t *out);
+
+extern bool		ApolloADPCMLoad(const char *filename, ApolloADPCMClip *clip);
+extern bool		ApolloADPCMSave(const char *filename, const int16_t *samples, uint32_t frames, uint32_t source_size);
+extern void		ApolloADPCMFree(ApolloADPCMClip *clip);
+
+extern bool		ApolloADPCMPlay(ApolloADPCMPlayer *player, const ApolloADPCMClip *clip, uint16_t channel, uint16_t volume_left, uint16_t volume_right, bool loop);
+extern void		ApolloADPCMUpdate(ApolloADPCMPlayer *player);
+extern void		ApolloADPCMStop(ApolloADPCMPlayer *player);
+
+extern uint32_t	ApolloADPCMBenchmark(uint32_t blocks);
+
+#endif /* APOLLOADPCM_H */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,355 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// The writer moves the head of the ring and the TBE interrupt moves the tail,
+// so neither waits for the other. When the UART has gone idle the next write
+// sends the first character itself, with the interrupt held off while it
+// looks, and the interrupt carries on from there.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "ApolloDebugLog.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOLOG_AMIGA
+#endif
+
+#ifdef APOLLOLOG_AMIGA
+
+#include <exec/types.h>
+#include <exec/nodes.h>
+#include <exec/interrupts.h>
+#include <clib/exec_protos.h>
+
+#define LOG_REG(reg)			(*(volatile UWORD*)(0xdff000 + (reg)))
+#define LOG_SERDAT				0x30
+#define LOG_SERPER				0x32
+#define LOG_INTENA				0x9a
+#define LOG_INTREQ				0x9c
+#define LOG_INTB_TBE			0
+#define LOG_INTF_TBE			(1 << 0)
+#define LOG_INTF_SETCLR			(1 << 15)
+#define LOG_SERDAT_STP8			(1 << 8)
+#define LOG_SERPER_115200		((((3546895 + (115200 / 2))) / 115200 - 1) & 0x7fff)
+#define LOG_MASK				(APOLLOLOG_BUFFER - 1)
+
+static char					ApolloLogRing[APOLLOLOG_BUFFER];
+static volatile uint16_t	ApolloLogHead = 0;			// next free byte, moved by the writer
+static volatile uint16_t	ApolloLogTail = 0;			// next byte to send, moved by the interrupt
+static volatile uint16_t	ApolloLogIdle = 1;			// UART empty, the next write starts it
+static struct Interrupt		ApolloLogInterrupt;
+static struct Interrupt		*ApolloLogOldInterrupt = NULL;
+
+#endif
+
+static uint16_t				ApolloLogReady = 0;
+static uint16_t				ApolloLogLevel = APOLLOLOG_INFO;
+static uint32_t				ApolloLogDrops = 0;			// writes dropped in all
+static uint32_t				ApolloLogPending = 0;		// dropped since the last one sent
+
+static uint32_t ApolloLogNote(char *buffer, uint32_t size, const char *format, ...);
+
+#ifdef APOLLOLOG_AMIGA
+
+// TBE interrupt, sends the next byte or marks the UART idle
+static void ApolloLogTransmit(void)
+{
+	LOG_REG(LOG_INTREQ) = LOG_INTF_TBE;
+
+	if (ApolloLogTail != ApolloLogHead)
+	{
+		LOG_REG(LOG_SERDAT) = LOG_SERDAT_STP8 | (UBYTE)ApolloLogRing[ApolloLogTail];
+		ApolloLogTail = (ApolloLogTail + 1) & LOG_MASK;
+	} else {
+		ApolloLogIdle = 1;
+	}
+}
+
+// Copies all of the text into the ring, '\n' as "\r\n", or none of it
+static bool ApolloLogPut(const char *text, uint32_t length)
+{
+	uint32_t	needed = length;
+	uint16_t	head = ApolloLogHead;
+	uint32_t	i;
+
+	for (i = 0; i < length; i++)
+	{
+		if (text[i] == '\n') needed++;
+	}
+	if (needed > ((ApolloLogTail - head - 1) & LOG_MASK)) return false;
+
+	for (i = 0; i < length; i++)
+	{
+		if (text[i] == '\n')
+		{
+			ApolloLogRing[head] = '\r';
+			head = (head + 1) & LOG_MASK;
+		}
+		ApolloLogRing[head] = text[i];
+		head = (head + 1) & LOG_MASK;
+	}
+	ApolloLogHead = head;
+
+	return true;
+}
+
+// Starts the UART if the interrupt has stopped
+static void ApolloLogKick(void)
+{
+	LOG_REG(LOG_INTENA) = LOG_INTF_TBE;
+
+	if (ApolloLogIdle && ApolloLogTail != ApolloLogHead)
+	{
+		ApolloLogIdle = 0;
+		LOG_REG(LOG_SERDAT) = LOG_SERDAT_STP8 | (UBYTE)ApolloLogRing[ApolloLogTail];
+		ApolloLogTail = (ApolloLogTail + 1) & LOG_MASK;
+	}
+
+	LOG_REG(LOG_INTENA) = LOG_INTF_SETCLR | LOG_INTF_TBE;
+}
+
+#endif
+
+void ApolloLogInit(void)
+{
+	if (ApolloLogReady) return;
+
+#ifdef APOLLOLOG_AMIGA
+	/* Set DTR, RTS, etc */
+	volatile UBYTE * ciab_pra = (APTR)0xBFD000;
+	volatile UBYTE * ciab_ddra = (APTR)0xBFD200;
+	*ciab_ddra = 0xc0;  /* Only DTR and RTS are driven as outputs */
+	*ciab_pra = 0;      /* Turn on DTR and RTS */
+
+	/* Set the debug UART to 115200 */
+	LOG_REG(LOG_SERPER) = LOG_SERPER_115200;
+
+	LOG_REG(LOG_INTENA) = LOG_INTF_TBE;
+	LOG_REG(LOG_INTREQ) = LOG_INTF_TBE;
+
+	ApolloLogHead = 0;
+	ApolloLogTail = 0;
+	ApolloLogIdle = 1;
+
+	ApolloLogInterrupt.is_Node.ln_Type = NT_INTERRUPT;
+	ApolloLogInterrupt.is_Node.ln_Pri = 0;
+	ApolloLogInterrupt.is_Node.ln_Name = "ApolloLog";
+	ApolloLogInterrupt.is_Data = NULL;
+	ApolloLogInterrupt.is_Code = (void (*)())ApolloLogTransmit;
+	ApolloLogOldInterrupt = SetIntVector(LOG_INTB_TBE, &ApolloLogInterrupt);
+
+	LOG_REG(LOG_INTENA) = LOG_INTF_SETCLR | LOG_INTF_TBE;
+#endif
+
+	ApolloLogReady = 1;
+
+	// the interrupt must not outlive the program
+	atexit(ApolloLogClose);
+}
+
+void ApolloLogClose(void)
+{
+	if (!ApolloLogReady) return;
+
+	ApolloLogFlush();
+
+#ifdef APOLLOLOG_AMIGA
+	LOG_REG(LOG_INTENA) = LOG_INTF_TBE;
+	SetIntVector(LOG_INTB_TBE, ApolloLogOldInterrupt);
+#endif
+
+	ApolloLogReady = 0;
+}
+
+// Waits until everything written has gone, for exit or a crash
+void ApolloLogFlush(void)
+{
+#ifdef APOLLOLOG_AMIGA
+	while (ApolloLogReady && !(ApolloLogIdle && ApolloLogTail == ApolloLogHead));
+#else
+	fflush(stderr);
+#endif
+}
+
+void ApolloLogSetLevel(uint16_t level)
+{
+	ApolloLogLevel = level;
+}
+
+uint32_t ApolloLogDropped(void)
+{
+	return ApolloLogDrops;
+}
+
+// Queues the text, returns 0 and counts it as dropped if there is no room
+uint16_t ApolloLogWrite(const char *text, uint32_t length)
+{
+	if (!ApolloLogReady) ApolloLogInit();
+
+	// say what was lost before anything more is sent
+	if (ApolloLogPending)
+	{
+		char		note[40];
+		uint32_t	note_length = ApolloLogNote(note, sizeof(note), "*** %u dropped\n", ApolloLogPending);
+
+#ifdef APOLLOLOG_AMIGA
+		if (ApolloLogPut(note, note_length)) ApolloLogPending = 0;
+#else
+		fwrite(note, 1, note_length, stderr);
+		ApolloLogPending = 0;
+#endif
+	}
+
+#ifdef APOLLOLOG_AMIGA
+	if (ApolloLogPending || !ApolloLogPut(text, length))
+	{
+		ApolloLogDrops++;
+		ApolloLogPending++;
+		ApolloLogKick();
+		return 0;
+	}
+	ApolloLogKick();
+#else
+	fwrite(text, 1, length, stderr);
+#endif
+
+	return 1;
+}
+
+uint16_t ApolloLogPrintf(uint16_t level, const char *format, ...)
+{
+	va_list		args;
+	uint16_t	sent;
+
+	if (level > ApolloLogLevel) return 0;
+
+	va_start(args, format);
+	sent = ApolloLogVPrintf(level, format, args);
+	va_end(args);
+
+	return sent;
+}
+
+uint16_t ApolloLogVPrintf(uint16_t level, const char *format, va_list args)
+{
+	char		line[APOLLOLOG_LINE];
+	uint32_t	length = 0;
+
+	if (level > ApolloLogLevel) return 0;
+
+	if (level == APOLLOLOG_ERROR) length = ApolloLogNote(line, sizeof(line), "ERROR: ");
+	if (level == APOLLOLOG_WARN) length = ApolloLogNote(line, sizeof(line), "WARNING: ");
+	length += ApolloLogFormat(line + length, sizeof(line) - length, format, args);
+
+	return ApolloLogWrite(line, length);
+}
+
+// printf into a buffer, %d %i %u %x %X %p %c %s %% with '-', '0', a width
+// and 'l', no floats. Returns the length, the text is cut to fit.
+uint32_t ApolloLogFormat(char *buffer, uint32_t size, const char *format, va_list args)
+{
+	uint32_t	length = 0;
+
+	if (size == 0) return 0;
+	size--;
+
+	for (; *format != 0 && length < size; format++)
+	{
+		char			digits[24];
+		const char		*text = digits;
+		uint32_t		text_length = 0;
+		uint32_t		width = 0;
+		unsigned long	value = 0;
+		uint32_t		base = 0;
+		bool			left = false, zero = false, is_long = false, upper = false;
+		char			sign = 0;
+
+		if (*format != '%')
+		{
+			buffer[length++] = *format;
+			continue;
+		}
+
+		for (format++; *format == '-' || *format == '0'; format++)
+		{
+			if (*format == '-') left = true; else zero = true;
+		}
+		for (; *format >= '0' && *format <= '9'; format++)
+		{
+			width = (width * 10) + (*format - '0');
+		}
+		for (; *format == 'l' || *format == 'h'; format++)
+		{
+			if (*format == 'l') is_long = true;
+		}
+
+		switch (*format)
+		{
+			case 'd':
+			case 'i':
+			{
+				long number = is_long ? va_arg(args, long) : va_arg(args, int);
+
+				if (number < 0) sign = '-';
+				value = number < 0 ? 0 - (unsigned long)number : (unsigned long)number;
+				base = 10;
+				break;
+			}
+			case 'u':	value = is_long ? va_arg(args, unsigned long) : va_arg(args, unsigned int);	base = 10;	break;
+			case 'X':	upper = true;	/* fall through */
+			case 'x':	value = is_long ? va_arg(args, unsigned long) : va_arg(args, unsigned int);	base = 16;	break;
+			case 'p':	value = (unsigned long)va_arg(args, void*);	base = 16;	zero = true;	width = sizeof(void*) * 2;	break;
+			case 'c':	digits[0] = (char)va_arg(args, int);	text_length = 1;	break;
+			case 's':
+				text = va_arg(args, const char*);
+				if (text == NULL) text = "(null)";
+				text_length = strlen(text);
+				break;
+			case 0:		format--;	/* fall through, a lone '%' at the end */
+			default:	digits[0] = '%';	text_length = 1;	break;
+		}
+
+		// numbers are built from the end of digits
+		if (base != 0)
+		{
+			const char *hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+			char *digit = digits + sizeof(digits);
+
+			do
+			{
+				*--digit = hex[value % base];
+				value /= base;
+			} while (value != 0);
+
+			text = digit;
+			text_length = (digits + sizeof(digits)) - digit;
+		}
+
+		width = width > text_length + (sign ? 1 : 0) ? width - text_length - (sign ? 1 : 0) : 0;
+		if (sign && (zero && !left) && length < size) buffer[length++] = sign;
+		for (; !left && width > 0 && length < size; width--) buffer[length++] = zero ? '0' : ' ';
+		if (sign && !(zero && !left) && length < size) buffer[length++] = sign;
+		for (; text_length > 0 && length < size; text_length--) buffer[length++] = *text++;
+		for (; width > 0 && length < size; width--) buffer[length++] = ' ';
+	}
+
+	buffer[length] = 0;
+
+	return length;
+}
+
+static uint32_t ApolloLogNote(char *buffer, uint32_t size, const char *format, ...)
+{
+	va_list		args;
+	uint32_t	length;
+
+	va_start(args, format);
+	length = ApolloLogFormat(buffer, size, format, args);
+	va_end(args);
+
+	return length;
+}
@@ -0,0 +1,44 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Buffered serial debug output. Text is put in a ring buffer and sent by the
+// serial transmit (TBE) interrupt a character at a time, so logging never
+// waits for the UART. A line that does not fit is dropped and counted, never
+// waited for. Built for a host (not AmigaOS) the lines go to stderr.
+//
+// The TBE vector is taken from serial.device by ApolloLogInit, which the
+// first write calls if nothing has, and given back by ApolloLogClose.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLODEBUGLOG_H
+#define APOLLODEBUGLOG_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define APOLLOLOG_BUFFER		4096		// ring buffer bytes, a power of 2
+#define APOLLOLOG_LINE			160			// longest formatted line
+
+#define APOLLOLOG_ERROR			0			// levels, a line is kept if its level <= the set level
+#define APOLLOLOG_WARN			1
+#define APOLLOLOG_INFO			2
+#define APOLLOLOG_TRACE			3
+
+extern void		ApolloLogInit(void);
+extern void		ApolloLogClose(void);
+extern void		ApolloLogFlush(void);
+extern void		ApolloLogSetLevel(uint16_t level);
+extern uint16_t	ApolloLogWrite(const char *text, uint32_t length);
+extern uint16_t	ApolloLogPrintf(uint16_t level, const char *format, ...);
+extern uint16_t	ApolloLogVPrintf(uint16_t level, const char *format, va_list args);
+extern uint32_t	ApolloLogFormat(char *buffer, uint32_t size, const char *format, va_list args);
+extern uint32_t	ApolloLogDropped(void);
+
+#endif /* APOLLODEBUGLOG_H */
+
+#ifdef __cplusplus
+}
+#endif
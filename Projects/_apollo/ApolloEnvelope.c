@@ -0,0 +1,385 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Levels and pans are 16.16. A ramp is worked out when it is asked for, the
+// exponential share with pow(), so the interrupt only adds and multiplies.
+// The decay of an ADSR is worked out with its attack for the same reason.
+// Calls from the program change a channel with interrupts off, so the
+// server never sees half a ramp.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ApolloEnvelope.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOENV_AMIGA
+#endif
+
+#ifdef APOLLOENV_AMIGA
+
+#include <exec/types.h>
+#include <exec/interrupts.h>
+#include <hardware/intbits.h>
+#include <clib/exec_protos.h>
+
+#define ENV_LOCK()				Disable()
+#define ENV_UNLOCK()			Enable()
+
+#else
+
+#define ENV_LOCK()
+#define ENV_UNLOCK()
+
+#endif
+
+#define ENV_DMACON				0xDFF096		// AUD0-3
+#define ENV_DMACON2				0xDFF296		// AUD4-15
+#define ENV_VOLUME(c)			(0xDFF408 + ((c) * 0x10))
+#define ENV_ONE					0x10000
+#define ENV_MAX					255
+
+enum
+{
+	ENV_IDLE = 0,								// level still, nothing to write
+	ENV_ATTACK,
+	ENV_DECAY,
+	ENV_SUSTAIN,
+	ENV_FADE,
+	ENV_RELEASE
+};
+
+typedef struct
+{
+	int32_t		target;							// 16.16
+	int32_t		step;							// linear, 16.16 a field
+	int32_t		share;							// exponential, 16.16 of what is left a field
+	uint16_t	fields;
+	uint16_t	shape;
+} ApolloEnvelopeRamp;
+
+typedef struct
+{
+	volatile uint16_t		stage;
+	int32_t					level;				// 16.16, 0-255
+	ApolloEnvelopeRamp		ramp;
+	ApolloEnvelopeRamp		decay;				// ADSR, follows the attack
+	bool					stop;				// DMA off once the fade ends
+
+	int32_t					pan;				// 16.16, 0-255
+	int32_t					pan_target;
+	int32_t					pan_step;
+	volatile uint16_t		pan_fields;
+
+	volatile bool			done;				// last fade or release has ended
+	ApolloEnvelopeDoneHook	hook;
+	void					*data;
+} ApolloEnvelopeChannel;
+
+static ApolloEnvelopeChannel	ApolloEnvelopeChannels[APOLLOENV_CHANNELS];
+static bool						ApolloEnvelopeReady = false;
+
+#ifdef APOLLOENV_AMIGA
+static struct Interrupt			ApolloEnvelopeInterrupt;
+
+static ULONG ApolloEnvelopeServer(void)
+{
+	ApolloEnvelopeTick();
+
+	return 0;									// Z-Flag, the rest of the chain runs
+}
+#endif
+
+static ApolloEnvelopeRamp ApolloEnvelopeMakeRamp(int32_t from, uint16_t to, uint16_t fields, uint16_t shape)
+{
+	ApolloEnvelopeRamp ramp;
+
+	if (to > ENV_MAX) to = ENV_MAX;
+	if (fields == 0) fields = 1;
+
+	ramp.target = (int32_t)to << 16;
+	ramp.fields = fields;
+	ramp.shape = shape;
+	ramp.step = (ramp.target - from) / fields;
+	ramp.share = (int32_t)((1.0 - pow(0.01, 1.0 / fields)) * ENV_ONE);
+	if (ramp.share < 1) ramp.share = 1;
+
+	return ramp;
+}
+
+// One field of a ramp, true once it has arrived
+static bool ApolloEnvelopeStep(int32_t *level, ApolloEnvelopeRamp *ramp)
+{
+	if (--ramp->fields == 0)
+	{
+		*level = ramp->target;
+		return true;
+	}
+
+	if (ramp->shape == APOLLOENV_EXPONENTIAL)
+	{
+		*level += ((ramp->target - *level) >> 8) * (ramp->share >> 8);
+	} else {
+		*level += ramp->step;
+	}
+
+	return false;
+}
+
+// Level and pan to the volume register, left in the high byte as ApolloVolume
+static void ApolloEnvelopeWrite(uint16_t channel, ApolloEnvelopeChannel *env)
+{
+	int32_t		level = env->level >> 16;
+	int32_t		pan = env->pan >> 16;
+	int32_t		left = (256 - pan) * 2;
+	int32_t		right = pan * 2;
+
+	if (left > 256) left = 256;
+	if (right > 256) right = 256;
+
+#ifdef APOLLOENV_AMIGA
+	*((volatile UWORD*)ENV_VOLUME(channel)) = (UWORD)((((level * left) >> 8) << 8) + ((level * right) >> 8));
+#else
+	(void)channel; (void)level;
+#endif
+}
+
+static void ApolloEnvelopeChannelStop(uint16_t channel)
+{
+#ifdef APOLLOENV_AMIGA
+	if (channel < 4)
+	{
+		*((volatile UWORD*)ENV_DMACON) = (UWORD)(1 << channel);
+	} else {
+		*((volatile UWORD*)ENV_DMACON2) = (UWORD)(1 << (channel - 4));
+	}
+#else
+	(void)channel;
+#endif
+}
+
+void ApolloEnvelopeInit(void)
+{
+	uint16_t i;
+
+	if (ApolloEnvelopeReady) return;
+
+	memset(ApolloEnvelopeChannels, 0, sizeof(ApolloEnvelopeChannels));
+	for (i = 0; i < APOLLOENV_CHANNELS; i++)
+	{
+		ApolloEnvelopeChannels[i].level = ENV_MAX << 16;
+		ApolloEnvelopeChannels[i].pan = APOLLOENV_CENTRE << 16;
+		ApolloEnvelopeChannels[i].done = true;
+	}
+
+#ifdef APOLLOENV_AMIGA
+	ApolloEnvelopeInterrupt.is_Node.ln_Type = NT_INTERRUPT;
+	ApolloEnvelopeInterrupt.is_Node.ln_Pri = 0;
+	ApolloEnvelopeInterrupt.is_Node.ln_Name = "ApolloEnvelope";
+	ApolloEnvelopeInterrupt.is_Data = NULL;
+	ApolloEnvelopeInterrupt.is_Code = (void (*)())ApolloEnvelopeServer;
+	AddIntServer(INTB_VERTB, &ApolloEnvelopeInterrupt);
+#endif
+
+	ApolloEnvelopeReady = true;
+
+	// the server must not outlive the program
+	atexit(ApolloEnvelopeClose);
+}
+
+void ApolloEnvelopeClose(void)
+{
+	if (!ApolloEnvelopeReady) return;
+
+#ifdef APOLLOENV_AMIGA
+	RemIntServer(INTB_VERTB, &ApolloEnvelopeInterrupt);
+#endif
+
+	ApolloEnvelopeReady = false;
+}
+
+// Sets level and pan now, ending any fade without calling its hook
+void ApolloEnvelopeSet(uint16_t channel, uint16_t level, uint16_t pan)
+{
+	ApolloEnvelopeChannel *env;
+
+	if (channel >= APOLLOENV_CHANNELS) return;
+	if (!ApolloEnvelopeReady) ApolloEnvelopeInit();
+	env = &ApolloEnvelopeChannels[channel];
+
+	ENV_LOCK();
+	env->stage = ENV_IDLE;
+	env->pan_fields = 0;
+	env->level = (int32_t)(level > ENV_MAX ? ENV_MAX : level) << 16;
+	env->pan = (int32_t)(pan > ENV_MAX ? ENV_MAX : pan) << 16;
+	env->done = true;
+	ApolloEnvelopeWrite(channel, env);
+	ENV_UNLOCK();
+}
+
+// Fades from the level now to level over fields, stopping the channel at
+// the end if stop. ApolloEnvelopeDone is true once it has.
+void ApolloEnvelopeFade(uint16_t channel, uint16_t level, uint16_t fields, uint16_t shape, bool stop)
+{
+	ApolloEnvelopeChannel	*env;
+	ApolloEnvelopeRamp		ramp;
+
+	if (channel >= APOLLOENV_CHANNELS) return;
+	if (!ApolloEnvelopeReady) ApolloEnvelopeInit();
+	env = &ApolloEnvelopeChannels[channel];
+
+	ramp = ApolloEnvelopeMakeRamp(env->level, level, fields, shape);
+
+	ENV_LOCK();
+	env->ramp = ramp;
+	env->stop = stop;
+	env->done = false;
+	env->stage = ENV_FADE;
+	ENV_UNLOCK();
+}
+
+// Attack from silence to peak, decay to sustain, and hold there until
+// ApolloEnvelopeRelease. Times are in fields.
+void ApolloEnvelopeADSR(uint16_t channel, uint16_t peak, uint16_t sustain, uint16_t attack, uint16_t decay, uint16_t shape)
+{
+	ApolloEnvelopeChannel	*env;
+	ApolloEnvelopeRamp		attack_ramp, decay_ramp;
+
+	if (channel >= APOLLOENV_CHANNELS) return;
+	if (!ApolloEnvelopeReady) ApolloEnvelopeInit();
+	env = &ApolloEnvelopeChannels[channel];
+
+	attack_ramp = ApolloEnvelopeMakeRamp(0, peak, attack, shape);
+	decay_ramp = ApolloEnvelopeMakeRamp(attack_ramp.target, sustain, decay, shape);
+
+	ENV_LOCK();
+	env->level = 0;
+	env->ramp = attack_ramp;
+	env->decay = decay_ramp;
+	env->stop = false;
+	env->done = false;
+	env->stage = ENV_ATTACK;
+	ApolloEnvelopeWrite(channel, env);
+	ENV_UNLOCK();
+}
+
+// Fades from wherever the envelope is to silence and stops the channel
+void ApolloEnvelopeRelease(uint16_t channel, uint16_t fields, uint16_t shape)
+{
+	ApolloEnvelopeChannel	*env;
+	ApolloEnvelopeRamp		ramp;
+
+	if (channel >= APOLLOENV_CHANNELS) return;
+	if (!ApolloEnvelopeReady) ApolloEnvelopeInit();
+	env = &ApolloEnvelopeChannels[channel];
+
+	ramp = ApolloEnvelopeMakeRamp(env->level, 0, fields, shape);
+
+	ENV_LOCK();
+	env->ramp = ramp;
+	env->stop = true;
+	env->done = false;
+	env->stage = ENV_RELEASE;
+	ENV_UNLOCK();
+}
+
+// Moves the pan in a straight line, alongside whatever the level does
+void ApolloEnvelopePan(uint16_t channel, uint16_t pan, uint16_t fields)
+{
+	ApolloEnvelopeChannel	*env;
+	int32_t					target = (int32_t)(pan > ENV_MAX ? ENV_MAX : pan) << 16;
+
+	if (channel >= APOLLOENV_CHANNELS) return;
+	if (!ApolloEnvelopeReady) ApolloEnvelopeInit();
+	env = &ApolloEnvelopeChannels[channel];
+	if (fields == 0) fields = 1;
+
+	ENV_LOCK();
+	env->pan_target = target;
+	env->pan_step = (target - env->pan) / fields;
+	env->pan_fields = fields;
+	ENV_UNLOCK();
+}
+
+// Leaves level and pan where they are
+void ApolloEnvelopeStop(uint16_t channel)
+{
+	if (channel >= APOLLOENV_CHANNELS) return;
+
+	ENV_LOCK();
+	ApolloEnvelopeChannels[channel].stage = ENV_IDLE;
+	ApolloEnvelopeChannels[channel].pan_fields = 0;
+	ApolloEnvelopeChannels[channel].done = true;
+	ENV_UNLOCK();
+}
+
+void ApolloEnvelopeOnDone(uint16_t channel, ApolloEnvelopeDoneHook hook, void *data)
+{
+	if (channel >= APOLLOENV_CHANNELS) return;
+
+	ENV_LOCK();
+	ApolloEnvelopeChannels[channel].hook = hook;
+	ApolloEnvelopeChannels[channel].data = data;
+	ENV_UNLOCK();
+}
+
+// True once the last fade or release has ended, an ADSR only once released
+bool ApolloEnvelopeDone(uint16_t channel)
+{
+	return channel >= APOLLOENV_CHANNELS || ApolloEnvelopeChannels[channel].done;
+}
+
+uint16_t ApolloEnvelopeLevel(uint16_t channel)
+{
+	return channel < APOLLOENV_CHANNELS ? ApolloEnvelopeChannels[channel].level >> 16 : 0;
+}
+
+// One field for every channel, from the vertical blank server
+void ApolloEnvelopeTick(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < APOLLOENV_CHANNELS; i++)
+	{
+		ApolloEnvelopeChannel	*env = &ApolloEnvelopeChannels[i];
+		bool					ended = false;
+
+		if ((env->stage == ENV_IDLE || env->stage == ENV_SUSTAIN) && env->pan_fields == 0) continue;
+
+		switch (env->stage)
+		{
+			case ENV_ATTACK:
+				if (ApolloEnvelopeStep(&env->level, &env->ramp))
+				{
+					env->ramp = env->decay;
+					env->stage = ENV_DECAY;
+				}
+				break;
+			case ENV_DECAY:
+				if (ApolloEnvelopeStep(&env->level, &env->ramp)) env->stage = ENV_SUSTAIN;
+				break;
+			case ENV_FADE:
+			case ENV_RELEASE:
+				ended = ApolloEnvelopeStep(&env->level, &env->ramp);
+				break;
+		}
+
+		if (env->pan_fields != 0)
+		{
+			env->pan += env->pan_step;
+			if (--env->pan_fields == 0) env->pan = env->pan_target;
+		}
+
+		ApolloEnvelopeWrite(i, env);
+
+		if (ended)
+		{
+			env->stage = ENV_IDLE;
+			if (env->stop) ApolloEnvelopeChannelStop(i);
+			env->done = true;
+			if (env->hook) env->hook(i, env->data);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Volume envelopes and pan ramps for the 16 SAGA audio channels, worked by a
+// vertical blank interrupt server so nothing waits for them. A channel has
+// a level and a pan, which make its left and right volume. The level moves
+// through attack, decay, sustain and release, or fades to a target, in a
+// straight line or exponentially. Built for a host (not AmigaOS) there is
+// no interrupt, and ApolloEnvelopeTick is called once a field instead.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLOENVELOPE_H
+#define APOLLOENVELOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APOLLOENV_CHANNELS			16
+#define APOLLOENV_LINEAR			0			// same step every field
+#define APOLLOENV_EXPONENTIAL		1			// same share of what is left every field, 99% there at the end
+#define APOLLOENV_CENTRE			128			// pan, 0 left to 255 right
+
+// Called from the interrupt when a fade or release ends, keep it short
+typedef void (*ApolloEnvelopeDoneHook)(uint16_t channel, void *data);
+
+extern void		ApolloEnvelopeInit(void);
+extern void		ApolloEnvelopeClose(void);
+extern void		ApolloEnvelopeSet(uint16_t channel, uint16_t level, uint16_t pan);
+extern void		ApolloEnvelopeFade(uint16_t channel, uint16_t level, uint16_t fields, uint16_t shape, bool stop);
+extern void		ApolloEnvelopeADSR(uint16_t channel, uint16_t peak, uint16_t sustain, uint16_t attack, uint16_t decay, uint16_t shape);
+extern void		ApolloEnvelopeRelease(uint16_t channel, uint16_t fields, uint16_t shape);
+extern void		ApolloEnvelopePan(uint16_t channel, uint16_t pan, uint16_t fields);
+extern void		ApolloEnvelopeStop(uint16_t channel);
+extern void		ApolloEnvelopeOnDone(uint16_t channel, ApolloEnvelopeDoneHook hook, void *data);
+extern bool		ApolloEnvelopeDone(uint16_t channel);
+extern uint16_t	ApolloEnvelopeLevel(uint16_t channel);
+extern void		ApolloEnvelopeTick(void);
+
+#endif /* APOLLOENVELOPE_H */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,450 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// AIFF is big endian: FORM, then COMM with the format and an 80-bit
+// extended rate, and SSND with the frames. AIFC adds a compression type to
+// COMM, of which only the uncompressed NONE, twos and sowt are taken. WAV is
+// little endian: RIFF, then fmt and data. Chunks are padded to an even size
+// in both.
+//
+// Resampling steps through the source in 16.16 and interpolates between the
+// two frames either side, without a filter. At 44.1 kHz it is a plain copy.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "ApolloSample.h"
+#include "ApolloADPCM.h"
+#include "ApolloDebugLog.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOSAMPLE_AMIGA
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <clib/exec_protos.h>
+#endif
+
+#define SAMPLE_ID(a, b, c, d)	(((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+#define SAMPLE_INFO				4096		// header bytes read for ApolloSampleInfo
+
+static uint32_t ApolloSampleBE32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t ApolloSampleLE32(const uint8_t *p)
+{
+	return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+static void ApolloSamplePutBE32(uint8_t *p, uint32_t value)
+{
+	p[0] = value >> 24;
+	p[1] = value >> 16;
+	p[2] = value >> 8;
+	p[3] = value;
+}
+
+// 80-bit extended to an integer, enough for sample rates
+static uint32_t ApolloSampleExtended(const uint8_t *p)
+{
+	int32_t		exponent = (((p[0] & 0x7F) << 8) | p[1]) - 16383;
+	uint32_t	mantissa = ApolloSampleBE32(p + 2);
+
+	if (p[0] & 0x80 || exponent < 0 || exponent > 31) return 0;
+
+	return mantissa >> (31 - exponent);
+}
+
+static bool ApolloSampleParseAIFF(const uint8_t *file, uint32_t size, ApolloSampleFormat *format)
+{
+	bool		aifc = ApolloSampleBE32(file + 8) == SAMPLE_ID('A','I','F','C');
+	bool		comm = false, ssnd = false;
+	uint32_t	chunk = 12;
+
+	while (chunk + 8 <= size && !(comm && ssnd))
+	{
+		uint32_t id = ApolloSampleBE32(file + chunk);
+		uint32_t length = ApolloSampleBE32(file + chunk + 4);
+
+		if (id == SAMPLE_ID('C','O','M','M') && chunk + 8 + 18 <= size)
+		{
+			const uint8_t *p = file + chunk + 8;
+
+			format->channels = (p[0] << 8) | p[1];
+			format->frames = ApolloSampleBE32(p + 2);
+			format->bits = (p[6] << 8) | p[7];
+			format->rate = ApolloSampleExtended(p + 8);
+			format->big_endian = true;
+			format->is_unsigned = false;
+
+			if (aifc && length >= 22 && chunk + 8 + 22 <= size)
+			{
+				uint32_t compression = ApolloSampleBE32(p + 18);
+
+				if (compression == SAMPLE_ID('s','o','w','t'))
+				{
+					format->big_endian = false;
+				} else if (compression != SAMPLE_ID('N','O','N','E') && compression != SAMPLE_ID('t','w','o','s')) {
+					return false;
+				}
+			}
+			comm = true;
+		}
+		if (id == SAMPLE_ID('S','S','N','D') && chunk + 16 <= size)
+		{
+			format->offset = chunk + 16 + ApolloSampleBE32(file + chunk + 8);
+			ssnd = true;
+		}
+
+		// a corrupt length ends the walk rather than wrapping chunk
+		if (length > size - chunk - 8) length = size - chunk - 8;
+		chunk += 8 + length + (length & 1);
+	}
+
+	return comm && ssnd;
+}
+
+static bool ApolloSampleParseWAV(const uint8_t *file, uint32_t size, ApolloSampleFormat *format)
+{
+	bool		fmt = false;
+	uint32_t	chunk = 12;
+
+	while (chunk + 8 <= size)
+	{
+		uint32_t id = ApolloSampleBE32(file + chunk);
+		uint32_t length = ApolloSampleLE32(file + chunk + 4);
+
+		if (id == SAMPLE_ID('f','m','t',' ') && chunk + 8 + 16 <= size)
+		{
+			const uint8_t	*p = file + chunk + 8;
+			uint16_t		tag = p[0] | (p[1] << 8);
+
+			// PCM, or WAVE_FORMAT_EXTENSIBLE with a PCM sub format
+			if (tag == 0xFFFE && length >= 26 && chunk + 8 + 26 <= size) tag = p[24] | (p[25] << 8);
+			if (tag != 1) return false;
+
+			format->channels = p[2] | (p[3] << 8);
+			format->rate = ApolloSampleLE32(p + 4);
+			format->bits = p[14] | (p[15] << 8);
+			format->big_endian = false;
+			format->is_unsigned = format->bits == 8;
+
+			// the data chunk divides by the frame size
+			if (format->channels == 0 || (format->bits != 8 && format->bits != 16 && format->bits != 24 && format->bits != 32)) return false;
+			fmt = true;
+		}
+		if (id == SAMPLE_ID('d','a','t','a') && fmt)
+		{
+			format->offset = chunk + 8;
+			format->frames = length / (format->channels * (format->bits / 8));
+			return true;
+		}
+
+		// a corrupt length ends the walk rather than wrapping chunk
+		if (length > size - chunk - 8) length = size - chunk - 8;
+		chunk += 8 + length + (length & 1);
+	}
+
+	return false;
+}
+
+// Finds the format and audio of an AIFF, AIFC or WAV file in memory. The
+// audio need not all be there, only the chunks before it.
+bool ApolloSampleParse(const uint8_t *file, uint32_t size, ApolloSampleFormat *format)
+{
+	bool found = false;
+
+	memset(format, 0, sizeof(ApolloSampleFormat));
+	if (file == NULL || size < 12) return false;
+
+	if (ApolloSampleBE32(file) == SAMPLE_ID('F','O','R','M'))
+	{
+		uint32_t type = ApolloSampleBE32(file + 8);
+
+		if (type == SAMPLE_ID('A','I','F','F') || type == SAMPLE_ID('A','I','F','C')) found = ApolloSampleParseAIFF(file, size, format);
+	} else if (ApolloSampleBE32(file) == SAMPLE_ID('R','I','F','F') && ApolloSampleBE32(file + 8) == SAMPLE_ID('W','A','V','E')) {
+		found = ApolloSampleParseWAV(file, size, format);
+	}
+
+	if (!found) return false;
+
+	return format->channels >= 1 && format->rate != 0 &&
+		   (format->bits == 8 || format->bits == 16 || format->bits == 24 || format->bits == 32);
+}
+
+// Reads the head of a file for its format, for ApolloStreamOpen's offset
+bool ApolloSampleInfo(const char *filename, ApolloSampleFormat *format)
+{
+	static uint8_t	header[SAMPLE_INFO];
+	FILE			*file_handle = fopen(filename, "rb");
+	uint32_t		size;
+
+	memset(format, 0, sizeof(ApolloSampleFormat));
+	if (!file_handle) return false;
+
+	size = fread(header, 1, sizeof(header), file_handle);
+	fclose(file_handle);
+
+	return ApolloSampleParse(header, size, format);
+}
+
+uint32_t ApolloSampleConvertedFrames(const ApolloSampleFormat *format)
+{
+	if (format->rate == APOLLOSAMPLE_RATE) return format->frames;
+
+	return (uint32_t)(((uint64_t)format->frames * APOLLOSAMPLE_RATE) / format->rate);
+}
+
+// One channel of a source frame as 16-bit
+static int32_t ApolloSampleValue(const uint8_t *p, const ApolloSampleFormat *format)
+{
+	switch (format->bits)
+	{
+		case 8:		return format->is_unsigned ? ((int32_t)p[0] - 128) * 256 : (int32_t)(int8_t)p[0] * 256;
+		case 16:	return format->big_endian ? (int16_t)((p[0] << 8) | p[1]) : (int16_t)((p[1] << 8) | p[0]);
+		case 24:	return format->big_endian ? (int16_t)((p[0] << 8) | p[1]) : (int16_t)((p[2] << 8) | p[1]);
+		default:	return format->big_endian ? (int16_t)((p[0] << 8) | p[1]) : (int16_t)((p[3] << 8) | p[2]);
+	}
+}
+
+// Converts the audio of file into out_frames 16-bit stereo frames
+void ApolloSampleConvert(const ApolloSampleFormat *format, const uint8_t *file, int16_t *out, uint32_t out_frames)
+{
+	const uint8_t	*audio = file + format->offset;
+	uint32_t		bytes = format->bits / 8;
+	uint32_t		frame_bytes = bytes * format->channels;
+	uint32_t		right = format->channels > 1 ? bytes : 0;		// mono plays on both sides
+	uint32_t		last = format->frames ? format->frames - 1 : 0;
+	uint32_t		step = (uint32_t)(((uint64_t)format->rate << 16) / APOLLOSAMPLE_RATE);
+	uint32_t		position = 0;									// 16.16 source frame
+	uint32_t		i;
+
+	if (format->frames == 0) return;
+
+	if (step == 0x10000)
+	{
+		for (i = 0; i < out_frames && i <= last; i++)
+		{
+			const uint8_t *p = audio + (i * frame_bytes);
+
+			out[0] = ApolloSampleValue(p, format);
+			out[1] = ApolloSampleValue(p + right, format);
+			out += 2;
+		}
+		return;
+	}
+
+	for (i = 0; i < out_frames; i++)
+	{
+		uint32_t		frame = position >> 16;
+		int32_t			fraction = (position & 0xFFFF) >> 1;		// 15 bits, so the product fits
+		const uint8_t	*p0 = audio + ((frame < last ? frame : last) * frame_bytes);
+		const uint8_t	*p1 = audio + ((frame + 1 < last ? frame + 1 : last) * frame_bytes);
+		int32_t			l0 = ApolloSampleValue(p0, format), l1 = ApolloSampleValue(p1, format);
+		int32_t			r0 = ApolloSampleValue(p0 + right, format), r1 = ApolloSampleValue(p1 + right, format);
+
+		out[0] = (int16_t)(l0 + (((l1 - l0) * fraction) >> 15));
+		out[1] = (int16_t)(r0 + (((r1 - r0) * fraction) >> 15));
+		out += 2;
+		position += step;
+	}
+}
+
+// 64-bit aligned memory for frames, as ApolloLoad aligns
+static bool ApolloSampleAllocate(ApolloSample *sample, uint32_t frames)
+{
+	sample->memory_size = (frames * 4) + 15;
+#ifdef APOLLOSAMPLE_AMIGA
+	sample->memory = AllocMem(sample->memory_size, MEMF_ANY);
+#else
+	sample->memory = malloc(sample->memory_size);
+#endif
+	if (sample->memory == NULL) return false;
+
+	sample->samples = (int16_t*)((uintptr_t)((uint8_t*)sample->memory + 15) & ~(uintptr_t)15);
+	sample->frames = frames;
+	sample->length = frames * 4;
+
+	return true;
+}
+
+void ApolloSampleFree(ApolloSample *sample)
+{
+	if (sample->memory)
+	{
+#ifdef APOLLOSAMPLE_AMIGA
+		FreeMem(sample->memory, sample->memory_size);
+#else
+		free(sample->memory);
+#endif
+	}
+	memset(sample, 0, sizeof(ApolloSample));
+}
+
+static uint32_t ApolloSampleFileSize(const char *filename)
+{
+	FILE *file_handle = fopen(filename, "rb");
+	long size;
+
+	if (!file_handle) return 0;
+
+	fseek(file_handle, 0, SEEK_END);
+	size = ftell(file_handle);
+	fclose(file_handle);
+
+	return size < 0 ? 0 : (uint32_t)size;
+}
+
+// Reads filename.snd if it was converted from this source, or with no source
+static bool ApolloSampleLoadCache(const char *filename, ApolloSample *sample, uint32_t source_size)
+{
+	char		name[256];
+	uint8_t		header[APOLLOSAMPLE_HEADER];
+	uint8_t		*bytes;
+	FILE		*file_handle;
+	uint32_t	frames, i;
+
+	snprintf(name, sizeof(name), "%s%s", filename, APOLLOSAMPLE_CACHE);
+	file_handle = fopen(name, "rb");
+	if (!file_handle) return false;
+
+	if (fread(header, 1, sizeof(header), file_handle) != sizeof(header) ||
+		ApolloSampleBE32(header) != SAMPLE_ID('A','S','N','D') ||
+		(source_size != 0 && ApolloSampleBE32(header + 4) != source_size) ||
+		ApolloSampleBE32(header + 12) != APOLLOSAMPLE_RATE)
+	{
+		fclose(file_handle);
+		return false;
+	}
+
+	frames = ApolloSampleBE32(header + 8);
+	if (!ApolloSampleAllocate(sample, frames) || fread(sample->samples, 4, frames, file_handle) != frames)
+	{
+		fclose(file_handle);
+		ApolloSampleFree(sample);
+		return false;
+	}
+	fclose(file_handle);
+
+	// stored big endian, as the Apollo plays it
+	bytes = (uint8_t*)sample->samples;
+	for (i = 0; i < frames * 2; i++)
+	{
+		sample->samples[i] = (int16_t)((bytes[i * 2] << 8) | bytes[(i * 2) + 1]);
+	}
+
+	return true;
+}
+
+// Writes filename.snd, tagged with the size of the source it came from
+bool ApolloSampleSave(const char *filename, const ApolloSample *sample, uint32_t source_size)
+{
+	char		name[256];
+	uint8_t		header[APOLLOSAMPLE_HEADER];
+	uint8_t		block[256];
+	FILE		*file_handle;
+	uint32_t	i, used = 0;
+	bool		written = true;
+
+	snprintf(name, sizeof(name), "%s%s", filename, APOLLOSAMPLE_CACHE);
+	file_handle = fopen(name, "wb");
+	if (!file_handle) return false;
+
+	ApolloSamplePutBE32(header, SAMPLE_ID('A','S','N','D'));
+	ApolloSamplePutBE32(header + 4, source_size);
+	ApolloSamplePutBE32(header + 8, sample->frames);
+	ApolloSamplePutBE32(header + 12, APOLLOSAMPLE_RATE);
+	written = fwrite(header, 1, sizeof(header), file_handle) == sizeof(header);
+
+	for (i = 0; i < sample->frames * 2 && written; i++)
+	{
+		block[used++] = (uint16_t)sample->samples[i] >> 8;
+		block[used++] = (uint16_t)sample->samples[i] & 0xFF;
+		if (used == sizeof(block) || i == (sample->frames * 2) - 1)
+		{
+			written = fwrite(block, 1, used, file_handle) == used;
+			used = 0;
+		}
+	}
+
+	return fclose(file_handle) == 0 && written;
+}
+
+// Decodes filename.adp if it was made from this source, or with no source
+static bool ApolloSampleLoadADPCM(const char *filename, ApolloSample *sample, uint32_t source_size)
+{
+	ApolloADPCMClip clip;
+
+	if (!ApolloADPCMLoad(filename, &clip)) return false;
+
+	// whole blocks are decoded, the last one padded with silence
+	if ((source_size != 0 && clip.source_size != source_size) || !ApolloSampleAllocate(sample, clip.count * APOLLOADPCM_FRAMES))
+	{
+		ApolloADPCMFree(&clip);
+		return false;
+	}
+	ApolloADPCMDecodeBlocks(&clip, 0, clip.count, sample->samples);
+	sample->frames = clip.frames;
+	sample->length = clip.frames * 4;
+	ApolloADPCMFree(&clip);
+
+	return true;
+}
+
+// Loads a sample ready to play, from filename.snd or filename.adp if that is
+// current, otherwise converted from the source and with cache saved as
+// filename.snd
+bool ApolloSampleLoad(const char *filename, ApolloSample *sample, bool cache)
+{
+	ApolloSampleFormat	format;
+	uint8_t				*file;
+	FILE				*file_handle;
+	uint32_t			size = ApolloSampleFileSize(filename);
+	uint32_t			available;
+
+	memset(sample, 0, sizeof(ApolloSample));
+
+	if (ApolloSampleLoadCache(filename, sample, size)) return true;
+	if (ApolloSampleLoadADPCM(filename, sample, size)) return true;
+	if (size == 0) return false;
+
+	file = (uint8_t*)malloc(size);
+	if (file == NULL) return false;
+
+	file_handle = fopen(filename, "rb");
+	if (!file_handle || fread(file, 1, size, file_handle) != size || !ApolloSampleParse(file, size, &format) || format.offset > size)
+	{
+		if (file_handle) fclose(file_handle);
+		free(file);
+		return false;
+	}
+	fclose(file_handle);
+
+	// a file cut short plays what there is
+	available = (size - format.offset) / (format.channels * (format.bits / 8));
+	if (format.frames > available) format.frames = available;
+	if (format.frames == 0)
+	{
+		free(file);
+		return false;
+	}
+
+	if (!ApolloSampleAllocate(sample, ApolloSampleConvertedFrames(&format)))
+	{
+		free(file);
+		return false;
+	}
+	ApolloSampleConvert(&format, file, sample->samples, sample->frames);
+	free(file);
+
+	#ifdef APOLLODEBUG
+	ApolloLogPrintf(APOLLOLOG_INFO, "ApolloSampleLoad: %s | %d Hz | %d bit | %d ch | %d frames\n", filename, format.rate, format.bits, format.channels, sample->frames);
+	#endif
+
+	if (cache) ApolloSampleSave(filename, sample, size);
+
+	return true;
+}
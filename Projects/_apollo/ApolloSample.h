@@ -0,0 +1,63 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Sample loader for AIFF, AIFC and WAV. The chunks are parsed for the format
+// and the audio, which is converted once at load into what the audio DMA
+// plays: 16-bit stereo at APOLLOSAMPLE_RATE, in CPU order. 8, 16, 24 and
+// 32-bit, mono or stereo, and any rate are taken, other rates resampled
+// linearly.
+//
+// The converted sample can be kept next to the source as filename.snd,
+// which a later load reads straight in while the source is unchanged.
+// Tools/ApolloSoundConvert makes these for a folder on the host, or with
+// -adpcm a filename.adp a quarter of the size, decoded here at load.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLOSAMPLE_H
+#define APOLLOSAMPLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APOLLOSAMPLE_RATE			44100		// frames a second at PERIOD=80, as ApolloPlay
+#define APOLLOSAMPLE_CACHE			".snd"		// converted sample, added to the source name
+#define APOLLOSAMPLE_HEADER			16			// "ASND", source size, frames, rate
+
+// Audio as found in a file
+typedef struct
+{
+	uint32_t	offset;							// file offset of the first frame
+	uint32_t	frames;
+	uint32_t	rate;
+	uint16_t	channels;
+	uint16_t	bits;							// 8, 16, 24 or 32
+	bool		big_endian;
+	bool		is_unsigned;					// WAV 8-bit
+} ApolloSampleFormat;
+
+// Audio ready to play, length bytes at samples
+typedef struct
+{
+	int16_t		*samples;						// stereo frames, 64-bit aligned
+	uint32_t	frames;
+	uint32_t	length;
+	void		*memory;						// as allocated
+	uint32_t	memory_size;
+} ApolloSample;
+
+extern bool		ApolloSampleParse(const uint8_t *file, uint32_t size, ApolloSampleFormat *format);
+extern bool		ApolloSampleInfo(const char *filename, ApolloSampleFormat *format);
+extern uint32_t	ApolloSampleConvertedFrames(const ApolloSampleFormat *format);
+extern void		ApolloSampleConvert(const ApolloSampleFormat *format, const uint8_t *file, int16_t *out, uint32_t out_frames);
+extern bool		ApolloSampleLoad(const char *filename, ApolloSample *sample, bool cache);
+extern bool		ApolloSampleSave(const char *filename, const ApolloSample *sample, uint32_t source_size);
+extern void		ApolloSampleFree(ApolloSample *sample);
+
+#endif /* APOLLOSAMPLE_H */
+
+#ifdef __cplusplus
+}
+#endif
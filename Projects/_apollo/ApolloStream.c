@@ -0,0 +1,594 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// A buffer is free while its length is 0. The loader fills free buffers in
+// ring order and sets the length last. The interrupt queues the next buffer
+// with a length and frees the one that has finished, so each side only ever
+// writes a length the other is waiting on.
+//
+// Paula latches the pointer and length when a block starts and raises the
+// channel interrupt, so the registers always hold the buffer after the one
+// playing. If that buffer is not ready yet a short block of silence is
+// queued in its place and counted as an underrun.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "ApolloStream.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOSTREAM_AMIGA
+#endif
+
+#ifdef APOLLOSTREAM_AMIGA
+
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <exec/interrupts.h>
+#include <dos/dos.h>
+#include <dos/dostags.h>
+#include <clib/exec_protos.h>
+#include <clib/dos_protos.h>
+#include "ApolloRegParam.h"
+
+#define STREAM_REG16(reg)		(*(volatile UWORD*)(reg))
+#define STREAM_REG32(reg)		(*(volatile ULONG*)(reg))
+#define STREAM_DMACON			0xDFF096
+#define STREAM_INTENA			0xDFF09A
+#define STREAM_INTREQ			0xDFF09C
+#define STREAM_INTB_AUD0		7
+#define STREAM_CHANNEL(c, r)	(0xDFF400 + ((c) * 0x10) + (r))
+#define STREAM_PRIORITY			5			// above the game, so the disk keeps up
+
+typedef BPTR	StreamFile;
+
+#else
+
+typedef FILE	*StreamFile;
+
+#endif
+
+#define STREAM_NONE				0xFFFF		// no buffer
+#define STREAM_SILENCE			2048		// bytes of the block queued on an underrun
+
+struct ApolloStream
+{
+	StreamFile			file;
+	uint32_t			offset;					// file offset of the audio
+	uint32_t			size;					// bytes of audio, a multiple of 8
+	uint32_t			position;				// next byte the loader reads
+	uint16_t			channel;
+	bool				loop;
+	uint16_t			volume;					// left << 8 + right, AUDxVOL cannot be read back
+	volatile bool		ended;					// loader has read the last byte, not looping
+	bool				playing;
+
+	uint8_t				*memory;				// ring, as allocated
+	uint8_t				*buffer[APOLLOSTREAM_BUFFERS];
+	volatile uint32_t	length[APOLLOSTREAM_BUFFERS];	// 0 when free
+	uint32_t			start[APOLLOSTREAM_BUFFERS];	// audio byte each buffer starts at
+	uint16_t			fill;					// next buffer the loader fills
+	volatile uint16_t	head;					// next buffer the interrupt queues
+	volatile uint16_t	current;				// buffer the hardware is playing
+	volatile uint16_t	queued;					// buffer latched after it
+	volatile bool		finished;
+	volatile uint32_t	underruns;
+
+#ifdef APOLLOSTREAM_AMIGA
+	struct Task			*parent;
+	struct Process		*loader;
+	BYTE				ready;					// parent signal, the loader has done a request
+	volatile bool		prime;					// request: restart the ring from position
+	volatile bool		quit;					// request: the loader ends
+	struct Interrupt	interrupt;
+	struct Interrupt	*old_interrupt;
+#endif
+};
+
+static uint8_t ApolloStreamSilence[STREAM_SILENCE] __attribute__((aligned(8)));
+
+// Stream file access, AmigaDOS on the Apollo as the loader is a process
+
+static StreamFile ApolloStreamFileOpen(const char *filename)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	return Open((CONST_STRPTR)filename, MODE_OLDFILE);
+#else
+	return fopen(filename, "rb");
+#endif
+}
+
+static void ApolloStreamFileClose(StreamFile file)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	Close(file);
+#else
+	fclose(file);
+#endif
+}
+
+static uint32_t ApolloStreamFileSize(StreamFile file)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	Seek(file, 0, OFFSET_END);
+	return (uint32_t)Seek(file, 0, OFFSET_BEGINNING);
+#else
+	long size;
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	return size < 0 ? 0 : (uint32_t)size;
+#endif
+}
+
+static bool ApolloStreamFileSeek(StreamFile file, uint32_t position)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	return Seek(file, position, OFFSET_BEGINNING) != -1;
+#else
+	return fseek(file, position, SEEK_SET) == 0;
+#endif
+}
+
+static int32_t ApolloStreamFileRead(StreamFile file, uint8_t *buffer, uint32_t length)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	return Read(file, buffer, length);
+#else
+	size_t got = fread(buffer, 1, length, file);
+
+	return got == 0 && ferror(file) ? -1 : (int32_t)got;
+#endif
+}
+
+// Hardware, the same registers ApolloPlay writes
+
+static void ApolloStreamQueue(ApolloStream *stream, const uint8_t *buffer, uint32_t length)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	STREAM_REG32(STREAM_CHANNEL(stream->channel, 0x0)) = (ULONG)buffer;
+	STREAM_REG32(STREAM_CHANNEL(stream->channel, 0x4)) = length / 8;		// in 64-bit chunks, two stereo frames
+#endif
+}
+
+static void ApolloStreamHalt(ApolloStream *stream)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	STREAM_REG16(STREAM_INTENA) = (UWORD)(1 << (STREAM_INTB_AUD0 + stream->channel));
+	STREAM_REG16(STREAM_DMACON) = (UWORD)(1 << stream->channel);
+	STREAM_REG16(STREAM_INTREQ) = (UWORD)(1 << (STREAM_INTB_AUD0 + stream->channel));
+#endif
+	stream->playing = false;
+}
+
+static void ApolloStreamWake(ApolloStream *stream)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	if (stream->loader) Signal(&stream->loader->pr_Task, SIGBREAKF_CTRL_F);
+#endif
+}
+
+// The interrupt's work: the queued buffer has started, so the one before it
+// is free, and the next is latched to follow
+static void ApolloStreamAdvance(ApolloStream *stream)
+{
+	uint16_t head = stream->head;
+
+	if (stream->current != STREAM_NONE)
+	{
+		stream->length[stream->current] = 0;
+		ApolloStreamWake(stream);
+	}
+	stream->current = stream->queued;
+
+	if (stream->length[head] != 0)
+	{
+		ApolloStreamQueue(stream, stream->buffer[head], stream->length[head]);
+		stream->queued = head;
+		stream->head = (head + 1) % APOLLOSTREAM_BUFFERS;
+	} else {
+		ApolloStreamQueue(stream, ApolloStreamSilence, STREAM_SILENCE);
+		stream->queued = STREAM_NONE;
+
+		if (!stream->ended)
+		{
+			stream->underruns++;
+		} else if (stream->current == STREAM_NONE) {
+			// the last buffer has played
+			stream->finished = true;
+#ifdef APOLLOSTREAM_AMIGA
+			STREAM_REG16(STREAM_INTENA) = (UWORD)(1 << (STREAM_INTB_AUD0 + stream->channel));
+			STREAM_REG16(STREAM_DMACON) = (UWORD)(1 << stream->channel);
+#endif
+		}
+	}
+}
+
+// The loader's work: reads into the free buffers in ring order, from the
+// start again at the end when looping
+static void ApolloStreamFill(ApolloStream *stream)
+{
+	while (!stream->ended && stream->length[stream->fill] == 0)
+	{
+		uint8_t		*buffer = stream->buffer[stream->fill];
+		uint32_t	got = 0;
+		bool		end = false;
+
+		stream->start[stream->fill] = stream->position;
+
+		while (got < APOLLOSTREAM_CHUNK)
+		{
+			uint32_t	want = APOLLOSTREAM_CHUNK - got;
+			int32_t		read;
+
+			if (stream->position == stream->size)
+			{
+				if (!stream->loop || !ApolloStreamFileSeek(stream->file, stream->offset))
+				{
+					end = true;
+					break;
+				}
+				stream->position = 0;
+			}
+			if (want > stream->size - stream->position) want = stream->size - stream->position;
+
+			read = ApolloStreamFileRead(stream->file, buffer + got, want);
+			if (read <= 0)
+			{
+				// a read error ends the track where it is
+				end = true;
+				break;
+			}
+			got += read;
+			stream->position += read;
+		}
+
+		// the interrupt must not see the end before the last buffer
+		got &= ~7;
+		if (got != 0)
+		{
+			stream->length[stream->fill] = got;
+			stream->fill = (stream->fill + 1) % APOLLOSTREAM_BUFFERS;
+		}
+		if (end || got == 0) stream->ended = true;
+	}
+}
+
+// Empties the ring and fills it again from position, with the hardware halted
+static void ApolloStreamPrime(ApolloStream *stream)
+{
+	uint16_t i;
+
+	for (i = 0; i < APOLLOSTREAM_BUFFERS; i++) stream->length[i] = 0;
+	stream->fill = 0;
+	stream->head = 0;
+	stream->current = STREAM_NONE;
+	stream->queued = STREAM_NONE;
+	stream->finished = false;
+	if (stream->position >= stream->size) stream->position = 0;
+	stream->ended = !ApolloStreamFileSeek(stream->file, stream->offset + stream->position);
+
+	ApolloStreamFill(stream);
+}
+
+#ifdef APOLLOSTREAM_AMIGA
+
+static void ApolloStreamInterrupt(_A1(ApolloStream *stream))
+{
+	STREAM_REG16(STREAM_INTREQ) = (UWORD)(1 << (STREAM_INTB_AUD0 + stream->channel));
+	ApolloStreamAdvance(stream);
+}
+
+// Loader process, refills the ring when the interrupt frees a buffer
+static void ApolloStreamLoader(void)
+{
+	ApolloStream *stream = (ApolloStream*)FindTask(NULL)->tc_UserData;
+
+	for (;;)
+	{
+		Wait(SIGBREAKF_CTRL_F);
+
+		if (stream->quit) break;
+
+		if (stream->prime)
+		{
+			ApolloStreamPrime(stream);
+			stream->prime = false;
+			Signal(stream->parent, 1L << stream->ready);
+		} else {
+			ApolloStreamFill(stream);
+		}
+	}
+
+	// the parent frees the stream once signalled, the process ends before it runs
+	Forbid();
+	Signal(stream->parent, 1L << stream->ready);
+}
+
+#endif
+
+// Has the loader, or on a host the caller, prime the ring from position
+static void ApolloStreamRestart(ApolloStream *stream)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	SetSignal(0, 1L << stream->ready);
+	stream->prime = true;
+	Signal(&stream->loader->pr_Task, SIGBREAKF_CTRL_F);
+	while (stream->prime) Wait(1L << stream->ready);
+#else
+	ApolloStreamPrime(stream);
+#endif
+}
+
+// Opens a stream on channel 0-3, the audio after offset bytes of header
+ApolloStream *ApolloStreamOpen(const char *filename, uint32_t offset, uint16_t channel, bool loop)
+{
+	ApolloStream	*stream;
+	uint32_t		size;
+	uint16_t		i;
+
+	if (channel >= APOLLOSTREAM_CHANNELS) return NULL;
+
+	stream = (ApolloStream*)calloc(1, sizeof(ApolloStream));
+	if (stream == NULL) return NULL;
+
+	stream->file = ApolloStreamFileOpen(filename);
+	if (!stream->file)
+	{
+		free(stream);
+		return NULL;
+	}
+
+	size = ApolloStreamFileSize(stream->file);
+	stream->offset = offset;
+	stream->size = size > offset ? (size - offset) & ~7 : 0;
+	stream->channel = channel;
+	stream->loop = loop;
+	stream->current = STREAM_NONE;
+	stream->queued = STREAM_NONE;
+
+	// 64-bit aligned for the audio DMA, as ApolloLoad aligns
+#ifdef APOLLOSTREAM_AMIGA
+	stream->memory = (uint8_t*)AllocMem((APOLLOSTREAM_BUFFERS * APOLLOSTREAM_CHUNK) + 15, MEMF_ANY);
+#else
+	stream->memory = (uint8_t*)malloc((APOLLOSTREAM_BUFFERS * APOLLOSTREAM_CHUNK) + 15);
+#endif
+	if (stream->size == 0 || stream->memory == NULL)
+	{
+		ApolloStreamClose(stream);
+		return NULL;
+	}
+	for (i = 0; i < APOLLOSTREAM_BUFFERS; i++)
+	{
+		stream->buffer[i] = (uint8_t*)(((uintptr_t)(stream->memory + 15) & ~(uintptr_t)15) + (i * APOLLOSTREAM_CHUNK));
+	}
+
+#ifdef APOLLOSTREAM_AMIGA
+	struct TagItem tags[] =
+	{
+		{ NP_Entry,		(ULONG)ApolloStreamLoader },
+		{ NP_Name,		(ULONG)"ApolloStream" },
+		{ NP_Priority,	STREAM_PRIORITY },
+		{ TAG_DONE,		0 }
+	};
+
+	stream->parent = FindTask(NULL);
+	stream->ready = AllocSignal(-1);
+	if (stream->ready == -1)
+	{
+		ApolloStreamClose(stream);
+		return NULL;
+	}
+
+	// the loader cannot run before it knows its stream
+	Forbid();
+	stream->loader = CreateNewProc(tags);
+	if (stream->loader) stream->loader->pr_Task.tc_UserData = stream;
+	Permit();
+
+	if (stream->loader == NULL)
+	{
+		ApolloStreamClose(stream);
+		return NULL;
+	}
+
+	stream->interrupt.is_Node.ln_Type = NT_INTERRUPT;
+	stream->interrupt.is_Node.ln_Pri = 0;
+	stream->interrupt.is_Node.ln_Name = "ApolloStream";
+	stream->interrupt.is_Data = stream;
+	stream->interrupt.is_Code = (void (*)())ApolloStreamInterrupt;
+	ApolloStreamHalt(stream);
+	stream->old_interrupt = SetIntVector(STREAM_INTB_AUD0 + channel, &stream->interrupt);
+#endif
+
+	return stream;
+}
+
+void ApolloStreamClose(ApolloStream *stream)
+{
+	if (stream == NULL) return;
+
+	ApolloStreamHalt(stream);
+
+#ifdef APOLLOSTREAM_AMIGA
+	if (stream->loader)
+	{
+		SetIntVector(STREAM_INTB_AUD0 + stream->channel, stream->old_interrupt);
+
+		SetSignal(0, 1L << stream->ready);
+		stream->quit = true;
+		Signal(&stream->loader->pr_Task, SIGBREAKF_CTRL_F);
+		Wait(1L << stream->ready);
+	}
+	if (stream->ready != -1 && stream->parent) FreeSignal(stream->ready);
+	if (stream->memory) FreeMem(stream->memory, (APOLLOSTREAM_BUFFERS * APOLLOSTREAM_CHUNK) + 15);
+#else
+	free(stream->memory);
+#endif
+
+	ApolloStreamFileClose(stream->file);
+	free(stream);
+}
+
+// Plays from the position, where the stream was stopped or seeked to
+bool ApolloStreamPlay(ApolloStream *stream, uint16_t volume_left, uint16_t volume_right)
+{
+	if (stream == NULL) return false;
+	if (stream->playing && !stream->finished) return true;
+
+	ApolloStreamRestart(stream);
+	if (stream->length[0] == 0) return false;
+
+	// the first buffer latches on start, and the interrupt queues the second
+	ApolloStreamQueue(stream, stream->buffer[0], stream->length[0]);
+	stream->queued = 0;
+	stream->head = 1 % APOLLOSTREAM_BUFFERS;
+	stream->playing = true;
+	stream->volume = (uint16_t)((volume_left << 8) + volume_right);
+
+#ifdef APOLLOSTREAM_AMIGA
+	STREAM_REG16(STREAM_CHANNEL(stream->channel, 0x8)) = stream->volume;
+	STREAM_REG16(STREAM_CHANNEL(stream->channel, 0xA)) = 0x0005;		// 16-bit stereo, looping on what is queued
+	STREAM_REG16(STREAM_CHANNEL(stream->channel, 0xC)) = 80;			// PERIOD=44.1 Khz
+	STREAM_REG16(STREAM_INTENA) = (UWORD)(0x8000 + (1 << (STREAM_INTB_AUD0 + stream->channel)));
+	STREAM_REG16(STREAM_DMACON) = (UWORD)(0x8000 + (1 << stream->channel));
+#endif
+
+	return true;
+}
+
+// Stops, a later play goes on from the buffer that was playing
+void ApolloStreamStop(ApolloStream *stream)
+{
+	if (stream == NULL || !stream->playing) return;
+
+	stream->position = ApolloStreamPosition(stream) * 4;
+	ApolloStreamHalt(stream);
+}
+
+// Moves to frame, carrying on playing from there if playing
+bool ApolloStreamSeek(ApolloStream *stream, uint32_t frame)
+{
+	bool was_playing;
+
+	if (stream == NULL) return false;
+	if (frame * 4 >= stream->size) frame = 0;
+
+	was_playing = stream->playing;
+	ApolloStreamHalt(stream);
+
+	stream->position = (frame * 4) & ~7;
+
+	if (was_playing) return ApolloStreamPlay(stream, stream->volume >> 8, stream->volume & 0xFF);
+
+	return true;
+}
+
+// Frame playing, to a buffer
+uint32_t ApolloStreamPosition(ApolloStream *stream)
+{
+	uint16_t current;
+
+	if (stream == NULL) return 0;
+	if (!stream->playing) return stream->position / 4;
+
+	current = stream->current != STREAM_NONE ? stream->current : stream->queued;
+
+	return current != STREAM_NONE ? stream->start[current] / 4 : stream->position / 4;
+}
+
+uint32_t ApolloStreamFrames(ApolloStream *stream)
+{
+	return stream ? stream->size / 4 : 0;
+}
+
+bool ApolloStreamIsPlaying(ApolloStream *stream)
+{
+	return stream != NULL && stream->playing && !stream->finished;
+}
+
+uint32_t ApolloStreamUnderruns(ApolloStream *stream)
+{
+	return stream ? stream->underruns : 0;
+}
+
+// Host only: plays frames of the stream into a 16-bit stereo WAV file, the
+// buffers passing through the same ring the interrupt and loader use
+bool ApolloStreamRender(ApolloStream *stream, const char *filename, uint32_t frames)
+{
+#ifdef APOLLOSTREAM_AMIGA
+	return false;
+#else
+	static const uint8_t	header[44] = { 'R','I','F','F', 0,0,0,0, 'W','A','V','E', 'f','m','t',' ', 16,0,0,0, 1,0, 2,0,
+										   APOLLOSTREAM_RATE & 0xFF, (APOLLOSTREAM_RATE >> 8) & 0xFF, APOLLOSTREAM_RATE >> 16, 0,
+										   (APOLLOSTREAM_RATE * 4) & 0xFF, ((APOLLOSTREAM_RATE * 4) >> 8) & 0xFF, (APOLLOSTREAM_RATE * 4) >> 16, 0,
+										   4,0, 16,0, 'd','a','t','a', 0,0,0,0 };
+	uint8_t					sizes[4];
+	uint8_t					swapped[256];
+	uint32_t				written = 0;
+	FILE					*wav;
+
+	if (stream == NULL) return false;
+
+	wav = fopen(filename, "wb");
+	if (wav == NULL) return false;
+	fwrite(header, 1, sizeof(header), wav);
+
+	if (!stream->playing && !ApolloStreamPlay(stream, 0x7F, 0x7F))
+	{
+		fclose(wav);
+		return false;
+	}
+
+	while (written < frames && !stream->finished)
+	{
+		const uint8_t	*source;
+		uint32_t		length, i;
+
+		// the hardware latches the next block, the loader refills what it freed
+		ApolloStreamAdvance(stream);
+		ApolloStreamFill(stream);
+
+		if (stream->current != STREAM_NONE)
+		{
+			source = stream->buffer[stream->current];
+			length = stream->length[stream->current];
+		} else if (!stream->finished) {
+			source = ApolloStreamSilence;
+			length = STREAM_SILENCE;
+		} else {
+			break;
+		}
+		if (length / 4 > frames - written) length = (frames - written) * 4;
+
+		// big endian as the DMA reads it, little endian for the WAV
+		while (length > 0)
+		{
+			uint32_t run = length > sizeof(swapped) ? sizeof(swapped) : length;
+
+			for (i = 0; i < run; i += 2)
+			{
+				swapped[i] = source[i + 1];
+				swapped[i + 1] = source[i];
+			}
+			fwrite(swapped, 1, run, wav);
+			source += run;
+			length -= run;
+			written += run / 4;
+		}
+	}
+
+	// sizes once known
+	fseek(wav, 40, SEEK_SET);
+	sizes[0] = (written * 4) & 0xFF; sizes[1] = ((written * 4) >> 8) & 0xFF; sizes[2] = ((written * 4) >> 16) & 0xFF; sizes[3] = (written * 4) >> 24;
+	fwrite(sizes, 1, 4, wav);
+	fseek(wav, 4, SEEK_SET);
+	sizes[0] = ((written * 4) + 36) & 0xFF; sizes[1] = (((written * 4) + 36) >> 8) & 0xFF; sizes[2] = (((written * 4) + 36) >> 16) & 0xFF; sizes[3] = ((written * 4) + 36) >> 24;
+	fwrite(sizes, 1, 4, wav);
+
+	return fclose(wav) == 0;
+#endif
+}
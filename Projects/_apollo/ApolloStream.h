@@ -0,0 +1,47 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Music streamed from disk instead of loaded whole. A loader process reads
+// the file in APOLLOSTREAM_CHUNK pieces into a ring of APOLLOSTREAM_BUFFERS
+// buffers, and the channel's audio interrupt queues the next buffer each time
+// the hardware starts one. The memory used is the ring, whatever the length
+// of the track. Audio is 16-bit big endian stereo at 44.1 kHz, as ApolloPlay
+// plays it, after offset bytes of header.
+//
+// The audio interrupts are the Paula ones, so the stream plays on channel
+// 0-3. Built for a host (not AmigaOS) there is no loader or interrupt, and
+// ApolloStreamRender plays the stream into a WAV file for testing.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLOSTREAM_H
+#define APOLLOSTREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APOLLOSTREAM_BUFFERS		4			// buffers in the ring
+#define APOLLOSTREAM_CHUNK			65536		// bytes in a buffer, 0.37 s, a multiple of 8
+#define APOLLOSTREAM_CHANNELS		4			// channels with an audio interrupt
+#define APOLLOSTREAM_RATE			44100		// frames a second, for the WAV header
+
+typedef struct ApolloStream ApolloStream;
+
+extern ApolloStream	*ApolloStreamOpen(const char *filename, uint32_t offset, uint16_t channel, bool loop);
+extern void			ApolloStreamClose(ApolloStream *stream);
+extern bool			ApolloStreamPlay(ApolloStream *stream, uint16_t volume_left, uint16_t volume_right);
+extern void			ApolloStreamStop(ApolloStream *stream);
+extern bool			ApolloStreamSeek(ApolloStream *stream, uint32_t frame);
+extern uint32_t		ApolloStreamPosition(ApolloStream *stream);
+extern uint32_t		ApolloStreamFrames(ApolloStream *stream);
+extern bool			ApolloStreamIsPlaying(ApolloStream *stream);
+extern uint32_t		ApolloStreamUnderruns(ApolloStream *stream);
+extern bool			ApolloStreamRender(ApolloStream *stream, const char *filename, uint32_t frames);
+
+#endif /* APOLLOSTREAM_H */
+
+#ifdef __cplusplus
+}
+#endif
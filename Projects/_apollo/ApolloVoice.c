@@ -0,0 +1,464 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Voices are kept in slots, the hardware channels first and then the mixed
+// voices, so a free channel is used before a mixed voice and stealing looks
+// at both. A handle is the slot in the low byte and a play count above it,
+// so a handle to a voice that has since been stolen matches nothing.
+//
+// The submix channel plays a block of two halves, each queued on its own.
+// Paula latches the pointer when a half starts and raises the channel
+// interrupt, which queues the other half to follow and notes the one
+// playing, as ApolloStream does with its ring. ApolloVoiceUpdate mixes the
+// half the channel has left, so the mix follows the hardware however late
+// or seldom it is called. A new mixed voice is heard within two halves,
+// about 46 ms.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "ApolloVoice.h"
+
+#if defined(__amigaos__) || defined(AMIGA)
+#define APOLLOVOICE_AMIGA
+#endif
+
+#ifdef APOLLOVOICE_AMIGA
+#include <exec/types.h>
+#include <exec/interrupts.h>
+#include <clib/exec_protos.h>
+#endif
+
+#define VOICE_DMACONR			0xDFF002		// AUD0-3
+#define VOICE_DMACONR2			0xDFF202		// AUD4-15
+#define VOICE_DMACON			0xDFF096
+#define VOICE_DMACON2			0xDFF296
+#define VOICE_INTENA			0xDFF09A
+#define VOICE_INTREQ			0xDFF09C
+#define VOICE_INTB_AUD0			7
+#define VOICE_REG(c, r)			(0xDFF400 + ((c) * 0x10) + (r))
+#define VOICE_SLOTS				(APOLLOVOICE_CHANNELS + APOLLOMIX_VOICES)
+#define VOICE_MIXED				0xFFFF			// channel of a mixed voice
+#define VOICE_BLOCK				(APOLLOMIX_FRAMES * 2)
+
+typedef struct
+{
+	ApolloVoiceHandle	handle;					// APOLLOVOICE_NONE when free
+	uint16_t			channel;				// hardware channel, or VOICE_MIXED
+	uint16_t			priority;
+	uint16_t			volume;					// left + right, for stealing
+	uint32_t			started;				// play count when started, for stealing
+	ApolloMixVoice		*mix;					// mixed voices only
+} ApolloVoiceSlot;
+
+static ApolloVoiceSlot	ApolloVoiceSlots[VOICE_SLOTS];
+static uint16_t			ApolloVoiceCount = 0;	// slots in use, channels then mixed
+static uint32_t			ApolloVoicePlays = 0;
+static bool				ApolloVoiceReady = false;
+
+static ApolloMixVoice	ApolloMixVoices[APOLLOMIX_VOICES];
+static int16_t			ApolloMixBlock[2 * VOICE_BLOCK] __attribute__((aligned(8)));
+static int32_t			ApolloMixSum[VOICE_BLOCK];
+static uint16_t			ApolloMixChannel = VOICE_MIXED;	// channel playing the block
+static volatile uint16_t	ApolloMixPlaying = 0;	// half the hardware is playing, set by the interrupt
+static volatile uint16_t	ApolloMixQueued = 0;	// half latched to follow it
+static volatile uint32_t	ApolloMixStarted = 0;	// halves started, counted by the interrupt
+static uint32_t			ApolloMixMixed = 0;		// ApolloMixStarted when a half was last mixed
+
+#ifdef APOLLOVOICE_AMIGA
+static struct Interrupt	ApolloMixInterrupt;
+static struct Interrupt	*ApolloMixOldInterrupt = NULL;
+#endif
+
+// Hardware channel control, the same registers ApolloPlay writes
+
+static void ApolloVoiceChannelStop(uint16_t channel)
+{
+#ifdef APOLLOVOICE_AMIGA
+	if (channel < 4)
+	{
+		*((volatile uint16_t*)VOICE_DMACON) = (uint16_t)(1 << channel);
+	} else {
+		*((volatile uint16_t*)VOICE_DMACON2) = (uint16_t)(1 << (channel - 4));
+	}
+#endif
+}
+
+static bool ApolloVoiceChannelBusy(uint16_t channel)
+{
+#ifdef APOLLOVOICE_AMIGA
+	if (channel < 4)
+	{
+		return (*((volatile uint16_t*)VOICE_DMACONR) & (1 << channel)) != 0;
+	}
+	return (*((volatile uint16_t*)VOICE_DMACONR2) & (1 << (channel - 4))) != 0;
+#else
+	return false;
+#endif
+}
+
+static void ApolloVoiceChannelStart(uint16_t channel, const uint8_t *buffer, uint32_t length, uint16_t volume_left, uint16_t volume_right, bool loop)
+{
+#ifdef APOLLOVOICE_AMIGA
+	ApolloVoiceChannelStop(channel);
+
+	*((volatile uint32_t*)VOICE_REG(channel, 0x0)) = (uint32_t)buffer;
+	*((volatile uint32_t*)VOICE_REG(channel, 0x4)) = length / 8;							// in 64-bit chunks, two stereo frames
+	*((volatile uint16_t*)VOICE_REG(channel, 0x8)) = (uint16_t)((volume_left << 8) + volume_right);
+	*((volatile uint16_t*)VOICE_REG(channel, 0xA)) = loop ? 0x0005 : 0x0007;				// 16-bit stereo, one shot unless looping
+	*((volatile uint16_t*)VOICE_REG(channel, 0xC)) = APOLLOMIX_PERIOD;
+
+	if (channel < 4)
+	{
+		*((volatile uint16_t*)VOICE_DMACON) = (uint16_t)(0x8000 + (1 << channel));
+	} else {
+		*((volatile uint16_t*)VOICE_DMACON2) = (uint16_t)(0x8000 + (1 << (channel - 4)));
+	}
+#endif
+}
+
+// Submix channel, the halves queued in turn by its interrupt
+
+static void ApolloMixQueue(uint16_t half)
+{
+	ApolloMixQueued = half;
+#ifdef APOLLOVOICE_AMIGA
+	*((volatile uint32_t*)VOICE_REG(ApolloMixChannel, 0x0)) = (uint32_t)(ApolloMixBlock + (half * VOICE_BLOCK));
+#endif
+}
+
+#ifdef APOLLOVOICE_AMIGA
+
+// The queued half has started, the other follows it
+static void ApolloMixServer(void)
+{
+	*((volatile uint16_t*)VOICE_INTREQ) = (uint16_t)(1 << (VOICE_INTB_AUD0 + ApolloMixChannel));
+	ApolloMixPlaying = ApolloMixQueued;
+	ApolloMixQueue(ApolloMixQueued ^ 1);
+	ApolloMixStarted++;
+}
+
+#endif
+
+static void ApolloMixStart(void)
+{
+	ApolloMixPlaying = 0;
+	ApolloMixStarted = 0;
+	ApolloMixMixed = 0;
+	ApolloMixQueue(0);
+
+#ifdef APOLLOVOICE_AMIGA
+	ApolloVoiceChannelStop(ApolloMixChannel);
+	*((volatile uint16_t*)VOICE_INTENA) = (uint16_t)(1 << (VOICE_INTB_AUD0 + ApolloMixChannel));
+	*((volatile uint16_t*)VOICE_INTREQ) = (uint16_t)(1 << (VOICE_INTB_AUD0 + ApolloMixChannel));
+
+	ApolloMixInterrupt.is_Node.ln_Type = NT_INTERRUPT;
+	ApolloMixInterrupt.is_Node.ln_Pri = 0;
+	ApolloMixInterrupt.is_Node.ln_Name = "ApolloVoice";
+	ApolloMixInterrupt.is_Data = NULL;
+	ApolloMixInterrupt.is_Code = (void (*)())ApolloMixServer;
+	ApolloMixOldInterrupt = SetIntVector(VOICE_INTB_AUD0 + ApolloMixChannel, &ApolloMixInterrupt);
+
+	// the first half latches on start, and the interrupt queues the second
+	*((volatile uint32_t*)VOICE_REG(ApolloMixChannel, 0x4)) = (VOICE_BLOCK * sizeof(int16_t)) / 8;	// in 64-bit chunks, two stereo frames
+	*((volatile uint16_t*)VOICE_REG(ApolloMixChannel, 0x8)) = 0xFFFF;
+	*((volatile uint16_t*)VOICE_REG(ApolloMixChannel, 0xA)) = 0x0005;								// 16-bit stereo, looping on what is queued
+	*((volatile uint16_t*)VOICE_REG(ApolloMixChannel, 0xC)) = APOLLOMIX_PERIOD;
+	*((volatile uint16_t*)VOICE_INTENA) = (uint16_t)(0x8000 + (1 << (VOICE_INTB_AUD0 + ApolloMixChannel)));
+	*((volatile uint16_t*)VOICE_DMACON) = (uint16_t)(0x8000 + (1 << ApolloMixChannel));
+#endif
+}
+
+static void ApolloMixStop(void)
+{
+#ifdef APOLLOVOICE_AMIGA
+	*((volatile uint16_t*)VOICE_INTENA) = (uint16_t)(1 << (VOICE_INTB_AUD0 + ApolloMixChannel));
+	ApolloVoiceChannelStop(ApolloMixChannel);
+	*((volatile uint16_t*)VOICE_INTREQ) = (uint16_t)(1 << (VOICE_INTB_AUD0 + ApolloMixChannel));
+	SetIntVector(VOICE_INTB_AUD0 + ApolloMixChannel, ApolloMixOldInterrupt);
+#endif
+}
+
+// true if a would be stolen before b
+static bool ApolloVoiceWeaker(const ApolloVoiceSlot *a, const ApolloVoiceSlot *b)
+{
+	if (a->priority != b->priority) return a->priority < b->priority;
+	if (a->volume != b->volume) return a->volume < b->volume;
+	return (int32_t)(a->started - b->started) < 0;
+}
+
+static void ApolloVoiceFree(ApolloVoiceSlot *slot)
+{
+	if (slot->mix)
+	{
+		slot->mix->samples = NULL;
+	} else {
+		ApolloVoiceChannelStop(slot->channel);
+	}
+	slot->handle = APOLLOVOICE_NONE;
+}
+
+static ApolloVoiceSlot *ApolloVoiceFind(ApolloVoiceHandle voice)
+{
+	uint16_t slot = voice & 0xFF;
+
+	if (voice == APOLLOVOICE_NONE || slot >= ApolloVoiceCount || ApolloVoiceSlots[slot].handle != voice) return NULL;
+
+	return &ApolloVoiceSlots[slot];
+}
+
+// Manages channels first_channel on, with submix the first of them plays
+// the mix. The submix needs the channel's interrupt, from channel 4 on it is
+// left out.
+void ApolloVoiceInit(uint16_t first_channel, uint16_t channels, bool submix)
+{
+	uint16_t i;
+
+	ApolloVoiceClose();
+
+	if (first_channel >= APOLLOVOICE_CHANNELS) return;
+	if (channels > APOLLOVOICE_CHANNELS - first_channel) channels = APOLLOVOICE_CHANNELS - first_channel;
+	if (channels == 0) return;
+	if (first_channel >= APOLLOMIX_CHANNELS) submix = false;
+
+	memset(ApolloVoiceSlots, 0, sizeof(ApolloVoiceSlots));
+	memset(ApolloMixVoices, 0, sizeof(ApolloMixVoices));
+	ApolloVoiceCount = 0;
+
+	for (i = submix ? 1 : 0; i < channels; i++)
+	{
+		ApolloVoiceSlots[ApolloVoiceCount].channel = first_channel + i;
+		ApolloVoiceChannelStop(first_channel + i);
+		ApolloVoiceCount++;
+	}
+
+	if (submix)
+	{
+		for (i = 0; i < APOLLOMIX_VOICES; i++)
+		{
+			ApolloVoiceSlots[ApolloVoiceCount].channel = VOICE_MIXED;
+			ApolloVoiceSlots[ApolloVoiceCount].mix = &ApolloMixVoices[i];
+			ApolloVoiceCount++;
+		}
+
+		// silence in both halves, half 1 is mixed once half 0 has started
+		memset(ApolloMixBlock, 0, sizeof(ApolloMixBlock));
+		ApolloMixChannel = first_channel;
+		ApolloMixStart();
+	}
+
+	ApolloVoiceReady = true;
+}
+
+void ApolloVoiceClose(void)
+{
+	uint16_t i;
+
+	if (!ApolloVoiceReady) return;
+
+	for (i = 0; i < ApolloVoiceCount; i++)
+	{
+		if (ApolloVoiceSlots[i].handle != APOLLOVOICE_NONE) ApolloVoiceFree(&ApolloVoiceSlots[i]);
+	}
+	if (ApolloMixChannel != VOICE_MIXED) ApolloMixStop();
+
+	ApolloMixChannel = VOICE_MIXED;
+	ApolloVoiceCount = 0;
+	ApolloVoiceReady = false;
+}
+
+// Plays a sound on a free channel or mixed voice, or in place of the weakest
+// voice playing. Returns APOLLOVOICE_NONE if everything playing matters more.
+ApolloVoiceHandle ApolloVoicePlay(const uint8_t *buffer, uint32_t length, uint16_t priority, uint16_t volume_left, uint16_t volume_right, bool loop)
+{
+	ApolloVoiceSlot	*slot = NULL;
+	uint16_t		i;
+
+	if (!ApolloVoiceReady || buffer == NULL || length < 8) return APOLLOVOICE_NONE;
+
+	for (i = 0; i < ApolloVoiceCount && slot == NULL; i++)
+	{
+		if (ApolloVoiceSlots[i].handle == APOLLOVOICE_NONE) slot = &ApolloVoiceSlots[i];
+	}
+
+	if (slot == NULL)
+	{
+		slot = &ApolloVoiceSlots[0];
+		for (i = 1; i < ApolloVoiceCount; i++)
+		{
+			if (ApolloVoiceWeaker(&ApolloVoiceSlots[i], slot)) slot = &ApolloVoiceSlots[i];
+		}
+		if (slot->priority > priority) return APOLLOVOICE_NONE;
+
+		ApolloVoiceFree(slot);
+	}
+
+	ApolloVoicePlays++;
+	slot->handle = ((ApolloVoicePlays & 0xFFFFFF) << 8) | (uint32_t)(slot - ApolloVoiceSlots);
+	if (slot->handle == APOLLOVOICE_NONE) slot->handle = 1u << 8;
+	slot->priority = priority;
+	slot->volume = volume_left + volume_right;
+	slot->started = ApolloVoicePlays;
+
+	if (slot->mix)
+	{
+		slot->mix->frames = length / 4;
+		slot->mix->position = 0;
+		slot->mix->volume_left = volume_left;
+		slot->mix->volume_right = volume_right;
+		slot->mix->loop = loop;
+		slot->mix->samples = (const int16_t*)buffer;
+	} else {
+		ApolloVoiceChannelStart(slot->channel, buffer, length, volume_left, volume_right, loop);
+	}
+
+	return slot->handle;
+}
+
+void ApolloVoiceStop(ApolloVoiceHandle voice)
+{
+	ApolloVoiceSlot *slot = ApolloVoiceFind(voice);
+
+	if (slot) ApolloVoiceFree(slot);
+}
+
+void ApolloVoiceVolume(ApolloVoiceHandle voice, uint16_t volume_left, uint16_t volume_right)
+{
+	ApolloVoiceSlot *slot = ApolloVoiceFind(voice);
+
+	if (slot == NULL) return;
+
+	slot->volume = volume_left + volume_right;
+	if (slot->mix)
+	{
+		slot->mix->volume_left = volume_left;
+		slot->mix->volume_right = volume_right;
+	} else {
+#ifdef APOLLOVOICE_AMIGA
+		*((volatile uint16_t*)VOICE_REG(slot->channel, 0x8)) = (uint16_t)((volume_left << 8) + volume_right);
+#endif
+	}
+}
+
+bool ApolloVoiceIsPlaying(ApolloVoiceHandle voice)
+{
+	return ApolloVoiceFind(voice) != NULL;
+}
+
+// Once a field, a half is 23 ms. Frees the voices that have finished and,
+// once a half has started, mixes the other. Called late, the halves have
+// played again as they were, and the one not playing is mixed now.
+void ApolloVoiceUpdate(void)
+{
+	uint16_t i;
+
+	if (!ApolloVoiceReady) return;
+
+	if (ApolloMixChannel != VOICE_MIXED && ApolloMixStarted != ApolloMixMixed)
+	{
+		ApolloMixMixed = ApolloMixStarted;
+		ApolloMixKernel(ApolloMixBlock + ((ApolloMixPlaying ^ 1) * VOICE_BLOCK), ApolloMixSum, ApolloMixVoices, APOLLOMIX_VOICES, APOLLOMIX_FRAMES);
+	}
+
+	for (i = 0; i < ApolloVoiceCount; i++)
+	{
+		ApolloVoiceSlot *slot = &ApolloVoiceSlots[i];
+
+		if (slot->handle == APOLLOVOICE_NONE) continue;
+
+		if (slot->mix ? slot->mix->samples == NULL : !ApolloVoiceChannelBusy(slot->channel))
+		{
+			slot->handle = APOLLOVOICE_NONE;
+		}
+	}
+}
+
+// Sums count voices into frames stereo frames of out. Each voice is added
+// into the 32-bit sum at its volume, then the sum is scaled back and
+// clipped, so the voices cost a multiply and add a sample each. Finished
+// voices have samples set to NULL.
+void ApolloMixKernel(int16_t *out, int32_t *sum, ApolloMixVoice *voices, uint16_t count, uint32_t frames)
+{
+	uint32_t	i;
+	uint16_t	v;
+
+	memset(sum, 0, frames * 2 * sizeof(int32_t));
+
+	for (v = 0; v < count; v++)
+	{
+		ApolloMixVoice	*voice = &voices[v];
+		uint32_t		done = 0;
+
+		while (done < frames && voice->samples != NULL && voice->frames != 0)
+		{
+			uint32_t		run = voice->frames - voice->position;
+			const int16_t	*source = voice->samples + (voice->position * 2);
+			int32_t			*target = sum + (done * 2);
+			int32_t			left = voice->volume_left;
+			int32_t			right = voice->volume_right;
+
+			if (run > frames - done) run = frames - done;
+
+			for (i = 0; i < run; i++)
+			{
+				target[0] += source[0] * left;
+				target[1] += source[1] * right;
+				target += 2;
+				source += 2;
+			}
+
+			done += run;
+			voice->position += run;
+			if (voice->position >= voice->frames)
+			{
+				voice->position = 0;
+				if (!voice->loop) voice->samples = NULL;
+			}
+		}
+	}
+
+	for (i = 0; i < frames * 2; i++)
+	{
+		int32_t sample = sum[i] >> 8;
+
+		out[i] = sample > 32767 ? 32767 : sample < -32768 ? -32768 : (int16_t)sample;
+	}
+}
+
+// Mixes blocks of APOLLOMIX_FRAMES with voices looping voices, up to
+// APOLLOMIX_VOICES, and returns voice frames mixed a second. The kernel is
+// plain C, so this runs the same on the Apollo and a host.
+uint32_t ApolloMixBenchmark(uint16_t voices, uint32_t blocks)
+{
+	static int16_t	source[1500 * 2];
+	static int16_t	out[VOICE_BLOCK];
+	static int32_t	sum[VOICE_BLOCK];
+	ApolloMixVoice	set[APOLLOMIX_VOICES];
+	clock_t			start;
+	double			seconds;
+	uint32_t		i;
+
+	if (voices > APOLLOMIX_VOICES) voices = APOLLOMIX_VOICES;
+
+	// a ramp not a multiple of the block, so the loop point moves
+	for (i = 0; i < 1500 * 2; i++) source[i] = (int16_t)((i * 97) & 0x7FFF) - 0x4000;
+	for (i = 0; i < voices; i++)
+	{
+		set[i].samples = source;
+		set[i].frames = 1500;
+		set[i].position = (i * 131) % 1500;
+		set[i].volume_left = 0x80;
+		set[i].volume_right = 0x60;
+		set[i].loop = true;
+	}
+
+	start = clock();
+	for (i = 0; i < blocks; i++)
+	{
+		ApolloMixKernel(out, sum, set, voices, APOLLOMIX_FRAMES);
+	}
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	return seconds > 0 ? (uint32_t)(((double)voices * blocks * APOLLOMIX_FRAMES) / seconds) : 0;
+}
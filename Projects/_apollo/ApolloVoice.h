@@ -0,0 +1,60 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Voice manager over the SAGA audio channels. Sounds are played by priority
+// on whichever managed channel is free. If none is free, the weakest voice
+// playing is stolen: lowest priority first, then the quietest, then the
+// oldest. A sound of lower priority than everything playing is refused.
+// Optionally the first managed channel plays a software mix of
+// APOLLOMIX_VOICES more voices, summed into a double buffered block. Its
+// audio interrupt says which half is playing, so it must be channel 0-3.
+//
+// Sounds are 16-bit stereo frames, left then right, at 44.1 kHz as
+// ApolloPlay plays them.
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifndef APOLLOVOICE_H
+#define APOLLOVOICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APOLLOVOICE_CHANNELS		16			// SAGA audio channels
+#define APOLLOVOICE_NONE			0			// handle of no voice
+#define APOLLOMIX_VOICES			16			// voices summed on the submix channel
+#define APOLLOMIX_FRAMES			1024		// stereo frames in each half of the submix block
+#define APOLLOMIX_PERIOD			80			// channel period, as ApolloPlay
+#define APOLLOMIX_CHANNELS			4			// channels with an audio interrupt, for the submix
+
+typedef uint32_t ApolloVoiceHandle;
+
+// One software voice, the mixer moves position on
+typedef struct
+{
+	const int16_t	*samples;					// stereo frames, NULL when finished
+	uint32_t		frames;
+	uint32_t		position;					// next frame to mix
+	uint16_t		volume_left;				// 0-255, 256 for full
+	uint16_t		volume_right;
+	bool			loop;
+} ApolloMixVoice;
+
+extern void					ApolloVoiceInit(uint16_t first_channel, uint16_t channels, bool submix);
+extern void					ApolloVoiceClose(void);
+extern ApolloVoiceHandle	ApolloVoicePlay(const uint8_t *buffer, uint32_t length, uint16_t priority, uint16_t volume_left, uint16_t volume_right, bool loop);
+extern void					ApolloVoiceStop(ApolloVoiceHandle voice);
+extern void					ApolloVoiceVolume(ApolloVoiceHandle voice, uint16_t volume_left, uint16_t volume_right);
+extern bool					ApolloVoiceIsPlaying(ApolloVoiceHandle voice);
+extern void					ApolloVoiceUpdate(void);
+
+extern void					ApolloMixKernel(int16_t *out, int32_t *sum, ApolloMixVoice *voices, uint16_t count, uint32_t frames);
+extern uint32_t				ApolloMixBenchmark(uint16_t voices, uint32_t blocks);
+
+#endif /* APOLLOVOICE_H */
+
+#ifdef __cplusplus
+}
+#endif
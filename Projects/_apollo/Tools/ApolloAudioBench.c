@@ -0,0 +1,38 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Host tool: times the audio work done on the CPU, the ApolloVoice submix
+// and the ApolloADPCM decoder, in stereo frames a second. Playback needs
+// 44100 of them a second for each voice mixed or clip decoded.
+//
+// ApolloAudioBench [blocks]     default 256
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../ApolloVoice.h"
+#include "../ApolloADPCM.h"
+
+#define BENCH_BLOCKS		256
+#define BENCH_RATE			44100
+
+int main(int argc, char *argv[])
+{
+	uint32_t	blocks = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_BLOCKS;
+	uint32_t	frames;
+	uint16_t	voices;
+
+	if (blocks == 0) blocks = BENCH_BLOCKS;
+
+	for (voices = 1; voices <= APOLLOMIX_VOICES; voices *= 2)
+	{
+		frames = ApolloMixBenchmark(voices, blocks);
+		printf("mix   %2u voices %12u frames/s %8.1fx real time\n", voices, frames, (double)frames / BENCH_RATE);
+	}
+
+	frames = ApolloADPCMBenchmark(blocks);
+	printf("adpcm decode    %12u frames/s %8.1fx real time\n", frames, (double)frames / BENCH_RATE);
+
+	return 0;
+}
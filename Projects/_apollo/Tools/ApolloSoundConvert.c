@@ -0,0 +1,109 @@
+// Apollo V4 SAGA libraries
+// Willem Drijver
+//
+// Host tool: converts every AIFF, AIFC and WAV in a folder, or the files
+// given, into filename.snd with ApolloSampleLoad, so the Apollo reads the
+// converted sample straight in and does no parsing or resampling. With
+// -adpcm it writes an IMA-ADPCM filename.adp instead, a quarter the size.
+//
+// ApolloSoundConvert [-adpcm] [folder | file ...]     default Projects/ApolloDemo/Data
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include "../ApolloSample.h"
+#include "../ApolloADPCM.h"
+
+#define CONVERT_FOLDER		"Projects/ApolloDemo/Data"
+
+static bool ConvertIsSound(const char *name)
+{
+	const char *dot = strrchr(name, '.');
+
+	return dot && (strcasecmp(dot, ".aiff") == 0 || strcasecmp(dot, ".aif") == 0 || strcasecmp(dot, ".aifc") == 0 || strcasecmp(dot, ".wav") == 0);
+}
+
+static bool ConvertFile(const char *filename, bool adpcm)
+{
+	ApolloSampleFormat	format;
+	ApolloSample		sample;
+	char				cache[512], compressed[512];
+	FILE				*file_handle;
+	long				size;
+
+	if (!ApolloSampleInfo(filename, &format))
+	{
+		printf("%-40s not an AIFF, AIFC or WAV this can convert\n", filename);
+		return false;
+	}
+
+	// converts from the source, always, and writes filename.snd or filename.adp,
+	// only one of which is kept
+	snprintf(cache, sizeof(cache), "%s%s", filename, APOLLOSAMPLE_CACHE);
+	snprintf(compressed, sizeof(compressed), "%s%s", filename, APOLLOADPCM_CACHE);
+	remove(cache);
+	remove(compressed);
+	if (!ApolloSampleLoad(filename, &sample, !adpcm))
+	{
+		printf("%-40s cannot convert\n", filename);
+		return false;
+	}
+
+	if (adpcm)
+	{
+		file_handle = fopen(filename, "rb");
+		fseek(file_handle, 0, SEEK_END);
+		size = ftell(file_handle);
+		fclose(file_handle);
+
+		if (!ApolloADPCMSave(filename, sample.samples, sample.frames, (uint32_t)size))
+		{
+			printf("%-40s cannot write %s\n", filename, compressed);
+			ApolloSampleFree(&sample);
+			return false;
+		}
+	}
+
+	printf("%-40s %6u Hz %2u bit %u ch %8u frames -> %8u frames%s\n", filename, format.rate, format.bits, format.channels, format.frames, sample.frames, adpcm ? " adpcm" : "");
+	ApolloSampleFree(&sample);
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	bool		adpcm = argc > 1 && strcmp(argv[1], "-adpcm") == 0;
+	int			first = adpcm ? 2 : 1;
+	const char	*folder = argc == first + 1 ? argv[first] : CONVERT_FOLDER;
+	uint32_t	converted = 0, failed = 0;
+	DIR			*dir = argc <= first + 1 ? opendir(folder) : NULL;
+	int			i;
+
+	if (dir)
+	{
+		struct dirent *entry;
+
+		while ((entry = readdir(dir)) != NULL)
+		{
+			char name[512];
+
+			if (!ConvertIsSound(entry->d_name)) continue;
+
+			snprintf(name, sizeof(name), "%s/%s", folder, entry->d_name);
+			if (ConvertFile(name, adpcm)) converted++; else failed++;
+		}
+		closedir(dir);
+	} else {
+		for (i = first; i < argc; i++)
+		{
+			if (ConvertFile(argv[i], adpcm)) converted++; else failed++;
+		}
+	}
+
+	printf("%u converted, %u failed\n", converted, failed);
+
+	return failed ? 1 : 0;
+}